@@ -32,6 +32,7 @@
 
 #include "core/debugger/debugger_marshalls.h"
 #include "core/debugger/engine_debugger.h"
+#include "core/debugger/sampling_profiler.h"
 #include "core/debugger/script_debugger.h"
 #include "core/input/input.h"
 #include "core/os/os.h"
@@ -400,6 +401,77 @@ struct RemoteDebugger::PerformanceProfiler {
 	}
 };
 
+struct RemoteDebugger::SampledStacksProfiler {
+	Map<String, int> stacks;
+	int sample_count = 0;
+	uint64_t last_send_time = 0;
+	bool started = false;
+
+	void toggle(bool p_enable, const Array &p_opts) {
+		if (p_enable) {
+			uint32_t interval_usec = p_opts.size() > 0 ? (uint32_t)(int)p_opts[0] : 2000;
+			stacks.clear();
+			sample_count = 0;
+			last_send_time = OS::get_singleton()->get_ticks_msec();
+			Error err = SamplingProfiler::start(interval_usec);
+			started = err == OK;
+			if (!started) {
+				// The reason was already printed, let the editor release its toggle.
+				Array arr;
+				arr.push_back(err);
+				EngineDebugger::get_singleton()->send_message("sampling:start_failed", arr);
+			}
+		} else if (started) {
+			// Don't stop a profiler this toggle didn't start (e.g. --profile-sampling).
+			SamplingProfiler::stop();
+			started = false;
+			_send_frame();
+		}
+	}
+
+	void add(const Array &p_data) {}
+
+	void tick(float p_frame_time, float p_idle_time, float p_physics_time, float p_physics_frame_time) {
+		// Drain every frame so the sample buffer does not fill up, but only send once per second.
+		sample_count += SamplingProfiler::collect(stacks);
+
+		uint64_t pt = OS::get_singleton()->get_ticks_msec();
+		if (pt - last_send_time < 1000) {
+			return;
+		}
+		last_send_time = pt;
+		_send_frame();
+	}
+
+	void _send_frame() {
+		sample_count += SamplingProfiler::collect(stacks);
+		if (!sample_count) {
+			return;
+		}
+
+		PackedStringArray names;
+		PackedInt32Array counts;
+		names.resize(stacks.size());
+		counts.resize(stacks.size());
+		int idx = 0;
+		for (Map<String, int>::Element *E = stacks.front(); E; E = E->next()) {
+			names.write[idx] = E->key();
+			counts.write[idx] = E->get();
+			idx++;
+		}
+
+		Array arr;
+		arr.push_back(sample_count);
+		arr.push_back(SamplingProfiler::get_dropped_sample_count());
+		arr.push_back(names);
+		arr.push_back(counts);
+		EngineDebugger::get_singleton()->send_message("sampling:profile_frame", arr);
+
+		stacks.clear();
+		sample_count = 0;
+	}
+};
+
 void RemoteDebugger::_send_resource_usage() {
 	DebuggerMarshalls::ResourceUsage usage;
 
@@ -924,6 +996,12 @@ RemoteDebugger::RemoteDebugger(Ref<RemoteDebuggerPeer> p_peer) {
 		profiler_enable("performance", true);
 	}
 
+	// Sampled call stacks (script and native frames)
+	if (SamplingProfiler::is_supported()) {
+		sampled_stacks_profiler = memnew(SampledStacksProfiler);
+		_bind_profiler("sampling", sampled_stacks_profiler);
+	}
+
 	// Core and profiler captures.
 	Capture core_cap(this,
 			[](void *p_user, const String &p_cmd, const Array &p_data, bool &r_captured) {
@@ -956,10 +1034,16 @@ RemoteDebugger::~RemoteDebugger() {
 	if (EngineDebugger::has_profiler("performance")) {
 		EngineDebugger::get_singleton()->unregister_profiler("performance");
 	}
+	if (EngineDebugger::has_profiler("sampling")) {
+		EngineDebugger::get_singleton()->unregister_profiler("sampling");
+	}
 	memdelete(servers_profiler);
 	memdelete(network_profiler);
 	memdelete(visual_profiler);
 	if (performance_profiler) {
 		memdelete(performance_profiler);
 	}
+	if (sampled_stacks_profiler) {
+		memdelete(sampled_stacks_profiler);
+	}
 }
@@ -54,11 +54,13 @@ private:
 	struct ScriptsProfiler;
 	struct VisualProfiler;
 	struct PerformanceProfiler;
+	struct SampledStacksProfiler;
 
 	NetworkProfiler *network_profiler = nullptr;
 	ServersProfiler *servers_profiler = nullptr;
 	VisualProfiler *visual_profiler = nullptr;
 	PerformanceProfiler *performance_profiler = nullptr;
+	SampledStacksProfiler *sampled_stacks_profiler = nullptr;
 
 	Ref<RemoteDebuggerPeer> peer;
 
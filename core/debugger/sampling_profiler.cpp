@@ -0,0 +1,254 @@
+/*************************************************************************/
+/*  sampling_profiler.cpp                                                */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "sampling_profiler.h"
+
+#include "core/class_db.h"
+#include "core/os/file_access.h"
+
+#if defined(UNIX_ENABLED) && !defined(ANDROID_ENABLED)
+// Android loads the engine as a shared library, where the first access to a
+// thread local may allocate, which is not allowed from a signal handler.
+#define SAMPLING_PROFILER_ENABLED
+#endif
+
+#ifdef SAMPLING_PROFILER_ENABLED
+#include <errno.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/time.h>
+
+// Once installed, the handler is never removed: a SIGPROF still pending when the
+// timer stops would otherwise run the default action, which terminates the process.
+static bool handler_installed = false;
+#endif
+
+thread_local SamplingProfiler::ThreadStack SamplingProfiler::thread_stack;
+std::atomic<bool> SamplingProfiler::active(false);
+
+SamplingProfiler::Sample *SamplingProfiler::samples = nullptr;
+std::atomic<uint32_t> SamplingProfiler::handlers_running(0);
+std::atomic<uint32_t> SamplingProfiler::sample_index(0);
+std::atomic<uint32_t> SamplingProfiler::dropped_samples(0);
+
+Mutex SamplingProfiler::symbol_mutex;
+Vector<String> SamplingProfiler::script_symbols;
+
+void SamplingProfiler::_handle_signal(int p_signal) {
+#ifdef SAMPLING_PROFILER_ENABLED
+	// Only async-signal-safe operations past this point: no allocation, no locks.
+	int saved_errno = errno;
+
+	// Counted before active is read, so cleanup() either sees this handler
+	// running or the handler sees the profiler stopped and leaves samples alone.
+	handlers_running.fetch_add(1, std::memory_order_seq_cst);
+
+	if (active.load(std::memory_order_seq_cst)) {
+		const ThreadStack &stack = thread_stack;
+		uint32_t depth = stack.depth;
+		std::atomic_signal_fence(std::memory_order_acquire);
+
+		Sample &sample = samples[sample_index.fetch_add(1, std::memory_order_relaxed) % SAMPLE_BUFFER_SIZE];
+		uint32_t expected = SAMPLE_FREE;
+		if (sample.state.compare_exchange_strong(expected, SAMPLE_WRITING, std::memory_order_acquire)) {
+			// Keep the innermost frames when the stack is too deep.
+			uint32_t available = MIN(depth, (uint32_t)MAX_THREAD_DEPTH);
+			uint32_t count = MIN(available, (uint32_t)MAX_SAMPLE_DEPTH);
+			for (uint32_t i = 0; i < count; i++) {
+				sample.frames[i] = stack.frames[available - count + i];
+			}
+			sample.depth = count;
+			sample.truncated = depth > count;
+			sample.state.store(SAMPLE_READY, std::memory_order_release);
+		} else {
+			dropped_samples.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+	handlers_running.fetch_sub(1, std::memory_order_release);
+	errno = saved_errno;
+#endif
+}
+
+String SamplingProfiler::_get_frame_name(const Frame &p_frame) {
+	if (p_frame.type == FRAME_NATIVE) {
+		const MethodBind *method = (const MethodBind *)p_frame.symbol;
+		return method->get_instance_class() + "::" + String(method->get_name());
+	}
+
+	uint32_t id = (uint32_t)(uintptr_t)p_frame.symbol;
+	MutexLock lock(symbol_mutex);
+	ERR_FAIL_INDEX_V(id - 1, (uint32_t)script_symbols.size(), "?");
+	return script_symbols[id - 1];
+}
+
+uint32_t SamplingProfiler::register_script_symbol(const String &p_name) {
+	MutexLock lock(symbol_mutex);
+	// Semicolons separate frames in folded stacks.
+	script_symbols.push_back(p_name.replace(";", ":"));
+	return script_symbols.size();
+}
+
+bool SamplingProfiler::is_supported() {
+#ifdef SAMPLING_PROFILER_ENABLED
+	return true;
+#else
+	return false;
+#endif
+}
+
+Error SamplingProfiler::start(uint32_t p_interval_usec) {
+#ifdef SAMPLING_PROFILER_ENABLED
+	ERR_FAIL_COND_V(is_active(), ERR_ALREADY_IN_USE);
+	ERR_FAIL_COND_V(p_interval_usec == 0, ERR_INVALID_PARAMETER);
+
+	if (!samples) {
+		// Only freed by cleanup(), once no signal handler can be using it.
+		samples = memnew_arr(Sample, SAMPLE_BUFFER_SIZE);
+	}
+	dropped_samples.store(0, std::memory_order_relaxed);
+
+	if (!handler_installed) {
+		struct sigaction action;
+		memset(&action, 0, sizeof(action));
+		action.sa_handler = _handle_signal;
+		action.sa_flags = SA_RESTART;
+		sigemptyset(&action.sa_mask);
+		ERR_FAIL_COND_V_MSG(sigaction(SIGPROF, &action, nullptr) != 0, ERR_CANT_CREATE, "Could not install the sampling profiler signal handler.");
+		handler_installed = true;
+	}
+
+	active.store(true);
+
+	// ITIMER_PROF counts CPU time of the whole process, and the signal is
+	// delivered to whichever thread is running, so busy threads get sampled
+	// in proportion to the time they spend.
+	struct itimerval timer;
+	timer.it_interval.tv_sec = p_interval_usec / 1000000;
+	timer.it_interval.tv_usec = p_interval_usec % 1000000;
+	timer.it_value = timer.it_interval;
+	if (setitimer(ITIMER_PROF, &timer, nullptr) != 0) {
+		active.store(false);
+		ERR_FAIL_V_MSG(ERR_CANT_CREATE, "Could not start the sampling profiler timer.");
+	}
+
+	return OK;
+#else
+	ERR_FAIL_V_MSG(ERR_UNAVAILABLE, "The sampling profiler is not supported on this platform.");
+#endif
+}
+
+void SamplingProfiler::stop() {
+#ifdef SAMPLING_PROFILER_ENABLED
+	if (!is_active()) {
+		return;
+	}
+
+	struct itimerval timer;
+	memset(&timer, 0, sizeof(timer));
+	setitimer(ITIMER_PROF, &timer, nullptr);
+	// The handler stays installed and ignores signals from now on.
+	active.store(false);
+#endif
+}
+
+int SamplingProfiler::collect(Map<String, int> &r_stacks) {
+	if (!samples) {
+		return 0;
+	}
+
+	int collected = 0;
+	for (int i = 0; i < SAMPLE_BUFFER_SIZE; i++) {
+		Sample &sample = samples[i];
+		if (sample.state.load(std::memory_order_acquire) != SAMPLE_READY) {
+			continue;
+		}
+
+		String stack;
+		if (sample.truncated) {
+			stack = "...";
+		}
+		for (uint32_t j = 0; j < sample.depth; j++) {
+			if (!stack.empty()) {
+				stack += ";";
+			}
+			stack += _get_frame_name(sample.frames[j]);
+		}
+		if (stack.empty()) {
+			// Sampled outside of any script or bound method (rendering, physics, idle...).
+			stack = "[engine]";
+		}
+
+		sample.state.store(SAMPLE_FREE, std::memory_order_release);
+
+		Map<String, int>::Element *E = r_stacks.find(stack);
+		if (E) {
+			E->get()++;
+		} else {
+			r_stacks.insert(stack, 1);
+		}
+		collected++;
+	}
+
+	return collected;
+}
+
+uint32_t SamplingProfiler::get_dropped_sample_count() {
+	return dropped_samples.load(std::memory_order_relaxed);
+}
+
+Error SamplingProfiler::save_folded_stacks(const Map<String, int> &p_stacks, const String &p_path) {
+	Error err;
+	FileAccessRef f = FileAccess::open(p_path, FileAccess::WRITE, &err);
+	ERR_FAIL_COND_V_MSG(!f, err, "Cannot save sampled stacks to file '" + p_path + "'.");
+
+	for (const Map<String, int>::Element *E = p_stacks.front(); E; E = E->next()) {
+		f->store_line(E->key() + " " + itos(E->get()));
+	}
+
+	return OK;
+}
+
+void SamplingProfiler::cleanup() {
+	stop();
+
+	if (samples) {
+		// A signal raised before the timer stopped may still be writing a sample
+		// on another thread. Handlers entering from now on see the profiler
+		// stopped, so only those already running need to finish.
+		while (handlers_running.load(std::memory_order_acquire) != 0) {
+		}
+		memdelete_arr(samples);
+		samples = nullptr;
+	}
+
+	MutexLock lock(symbol_mutex);
+	script_symbols.clear();
+}
@@ -0,0 +1,164 @@
+/*************************************************************************/
+/*  sampling_profiler.h                                                  */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef SAMPLING_PROFILER_H
+#define SAMPLING_PROFILER_H
+
+#include "core/map.h"
+#include "core/os/mutex.h"
+#include "core/ustring.h"
+#include "core/vector.h"
+
+#include <atomic>
+
+// Statistical profiler: a timer signal periodically copies the call stack
+// of the interrupted thread into a preallocated buffer, which is drained
+// and aggregated into folded stacks ("root;...;leaf" -> count) on demand.
+//
+// Frames are pushed by the script VMs and by native method calls. Pushing
+// is a single relaxed load when the profiler is inactive.
+class SamplingProfiler {
+public:
+	enum FrameType {
+		FRAME_SCRIPT,
+		FRAME_NATIVE,
+	};
+
+	enum {
+		MAX_THREAD_DEPTH = 256,
+		MAX_SAMPLE_DEPTH = 32,
+		SAMPLE_BUFFER_SIZE = 1024,
+	};
+
+	// Pushes a frame for the lifetime of the scope when the profiler is active.
+	class Scope {
+		bool pushed;
+
+	public:
+		_FORCE_INLINE_ Scope(FrameType p_type, const void *p_symbol) {
+			pushed = push_frame(p_type, p_symbol);
+		}
+		_FORCE_INLINE_ ~Scope() {
+			if (pushed) {
+				pop_frame();
+			}
+		}
+	};
+
+private:
+	struct Frame {
+		const void *symbol;
+		FrameType type;
+	};
+
+	// Kept trivial so the thread local is zero-initialized without a
+	// guarded constructor, which the signal handler could not call.
+	struct ThreadStack {
+		Frame frames[MAX_THREAD_DEPTH];
+		uint32_t depth;
+	};
+
+	enum SampleState {
+		SAMPLE_FREE,
+		SAMPLE_WRITING,
+		SAMPLE_READY,
+	};
+
+	struct Sample {
+		std::atomic<uint32_t> state = { SAMPLE_FREE };
+		uint32_t depth = 0;
+		bool truncated = false;
+		Frame frames[MAX_SAMPLE_DEPTH];
+	};
+
+	static thread_local ThreadStack thread_stack;
+	static std::atomic<bool> active;
+
+	static Sample *samples;
+	// Handlers between entry and exit, cleanup() waits for them before freeing samples.
+	static std::atomic<uint32_t> handlers_running;
+	static std::atomic<uint32_t> sample_index;
+	static std::atomic<uint32_t> dropped_samples;
+
+	static Mutex symbol_mutex;
+	static Vector<String> script_symbols;
+
+	static void _handle_signal(int p_signal);
+	static String _get_frame_name(const Frame &p_frame);
+
+public:
+	_FORCE_INLINE_ static bool is_active() {
+		return active.load(std::memory_order_relaxed);
+	}
+
+	// Returns true if a frame was pushed, in which case pop_frame() must be called.
+	_FORCE_INLINE_ static bool push_frame(FrameType p_type, const void *p_symbol) {
+		if (likely(!is_active())) {
+			return false;
+		}
+		ThreadStack &stack = thread_stack;
+		if (stack.depth < MAX_THREAD_DEPTH) {
+			stack.frames[stack.depth].symbol = p_symbol;
+			stack.frames[stack.depth].type = p_type;
+		}
+		// The sampling signal runs on this thread, so a compiler fence is enough
+		// to make the frame visible before the depth that exposes it.
+		std::atomic_signal_fence(std::memory_order_release);
+		stack.depth++;
+		return true;
+	}
+
+	_FORCE_INLINE_ static void pop_frame() {
+		std::atomic_signal_fence(std::memory_order_release);
+		thread_stack.depth--;
+	}
+
+	// Script frames are identified by a registered name ("path:function").
+	// The returned id is never zero, and is passed to push_frame() as the symbol.
+	static uint32_t register_script_symbol(const String &p_name);
+	_FORCE_INLINE_ static const void *get_script_symbol(uint32_t p_id) {
+		return (const void *)(uintptr_t)p_id;
+	}
+
+	static bool is_supported();
+	static Error start(uint32_t p_interval_usec);
+	static void stop();
+
+	// Drains the captured samples into r_stacks and returns how many were added.
+	static int collect(Map<String, int> &r_stacks);
+	static uint32_t get_dropped_sample_count();
+
+	// Writes folded stacks, one "root;...;leaf count" per line, as consumed by flamegraph tools.
+	static Error save_folded_stacks(const Map<String, int> &p_stacks, const String &p_path);
+
+	static void cleanup();
+};
+
+#endif // SAMPLING_PROFILER_H
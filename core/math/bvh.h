@@ -0,0 +1,997 @@
+/*************************************************************************/
+/*  bvh.h                                                                */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef BVH_H
+#define BVH_H
+
+#include "core/list.h"
+#include "core/local_vector.h"
+#include "core/map.h"
+#include "core/math/aabb.h"
+#include "core/math/geometry_3d.h"
+#include "core/math/vector3.h"
+
+typedef uint32_t BVHElementID;
+
+#define BVH_ELEMENT_INVALID_ID 0
+
+// Bounding volume hierarchy with the same interface as Octree.
+// Elements are kept in three binary AABB trees: static elements (never moved since creation),
+// dynamic elements (stored with enlarged bounds, so small moves don't change the tree) and pairable
+// elements. Nodes live in contiguous arrays and the trees are balanced with rotations as they are
+// refit. Non pairable elements only need to look for pairs in the pairable tree.
+
+template <class T, bool use_pairs = false, class AL = DefaultAllocator>
+class BVH {
+public:
+	typedef void *(*PairCallback)(void *, BVHElementID, T *, int, BVHElementID, T *, int);
+	typedef void (*UnpairCallback)(void *, BVHElementID, T *, int, BVHElementID, T *, int, void *);
+
+private:
+	enum {
+		TREE_NONE = -1, // Element has no surface, so it's not in any tree.
+		TREE_STATIC,
+		TREE_DYNAMIC,
+		TREE_PAIRABLE,
+		TREE_MAX
+	};
+
+	enum {
+		NODE_NULL = -1,
+		STACK_SIZE = 128, // Traversal stack, tree height is kept logarithmic by balancing.
+	};
+
+	struct Node {
+		AABB aabb; // Enlarged for leaves outside the static tree.
+		AABB element_aabb; // Exact bounds, only used by leaves.
+
+		int parent = NODE_NULL; // Next free node when in the free list.
+		int children[2] = { NODE_NULL, NODE_NULL };
+		int height = 0;
+
+		// Leaf data, copied from the element so culling doesn't need to touch it.
+		T *userdata = nullptr;
+		uint32_t pairable_type = 0;
+		BVHElementID element = BVH_ELEMENT_INVALID_ID;
+
+		_FORCE_INLINE_ bool is_leaf() const { return children[0] == NODE_NULL; }
+	};
+
+	struct Tree {
+		LocalVector<Node> nodes;
+		int root = NODE_NULL;
+		int free_list = NODE_NULL;
+	};
+
+	struct PairData;
+
+	struct Element {
+		BVHElementID id = BVH_ELEMENT_INVALID_ID;
+		T *userdata = nullptr;
+		int subindex = 0;
+		bool pairable = false;
+		uint32_t pairable_mask = 0;
+		uint32_t pairable_type = 0;
+		bool moved = false;
+
+		AABB aabb;
+		int tree = TREE_NONE;
+		int leaf = NODE_NULL;
+
+		List<PairData *, AL> pair_list;
+	};
+
+	struct PairKey {
+		union {
+			struct {
+				BVHElementID A;
+				BVHElementID B;
+			};
+			uint64_t key;
+		};
+
+		_FORCE_INLINE_ bool operator<(const PairKey &p_pair) const {
+			return key < p_pair.key;
+		}
+
+		_FORCE_INLINE_ PairKey(BVHElementID p_A, BVHElementID p_B) {
+			if (p_A < p_B) {
+				A = p_A;
+				B = p_B;
+			} else {
+				B = p_A;
+				A = p_B;
+			}
+		}
+
+		_FORCE_INLINE_ PairKey() {}
+	};
+
+	struct PairData {
+		Element *A;
+		Element *B;
+		void *ud;
+		typename List<PairData *, AL>::Element *eA, *eB;
+	};
+
+	typedef Map<PairKey, PairData, Comparator<PairKey>, AL> PairMap;
+
+	LocalVector<Element *> elements; // Indexed by ID - 1.
+	LocalVector<BVHElementID> free_ids;
+	PairMap pair_map;
+	Tree trees[TREE_MAX];
+
+	PairCallback pair_callback;
+	UnpairCallback unpair_callback;
+	void *pair_callback_userdata;
+	void *unpair_callback_userdata;
+
+	real_t unit_size;
+	int element_count;
+	int pair_count;
+
+	_FORCE_INLINE_ static real_t _get_surface(const AABB &p_aabb) {
+		return p_aabb.size.x * p_aabb.size.y + p_aabb.size.y * p_aabb.size.z + p_aabb.size.z * p_aabb.size.x;
+	}
+
+	_FORCE_INLINE_ AABB _enlarge(const AABB &p_aabb) const {
+		return p_aabb.grow(MAX(unit_size * 0.1, p_aabb.get_longest_axis_size() * 0.125));
+	}
+
+	_FORCE_INLINE_ int _get_element_tree(const Element *p_element) const {
+		if (p_element->pairable) {
+			return TREE_PAIRABLE;
+		}
+		return p_element->moved ? TREE_DYNAMIC : TREE_STATIC;
+	}
+
+	_FORCE_INLINE_ Element *_get_element(BVHElementID p_id) const {
+		ERR_FAIL_COND_V(p_id == BVH_ELEMENT_INVALID_ID || p_id > elements.size(), nullptr);
+		return elements[p_id - 1];
+	}
+
+	_FORCE_INLINE_ bool _can_pair(const Element *p_A, const Element *p_B) const {
+		if (p_A == p_B || (p_A->userdata == p_B->userdata && p_A->userdata)) {
+			return false;
+		}
+		if (!p_A->pairable && !p_B->pairable) {
+			return false;
+		}
+		return (p_A->pairable_type & p_B->pairable_mask) || (p_B->pairable_type & p_A->pairable_mask);
+	}
+
+	int _alloc_node(Tree &p_tree);
+	void _free_node(Tree &p_tree, int p_node);
+	int _balance(Tree &p_tree, int p_node);
+	void _refit(Tree &p_tree, int p_node);
+	void _insert_leaf(Tree &p_tree, int p_leaf);
+	void _remove_leaf(Tree &p_tree, int p_leaf);
+
+	void _element_insert(Element *p_element, int p_tree);
+	void _element_remove(Element *p_element);
+
+	void _pair_add(Element *p_A, Element *p_B);
+	void _pair_remove(PairData *p_pair);
+	void _element_update_pairs(Element *p_element);
+
+	_FORCE_INLINE_ static bool _node_in_convex(const AABB &p_aabb, const Plane *p_planes, int p_plane_count, uint32_t &r_plane_mask);
+
+	int _cull_convex(const Tree &p_tree, const Plane *p_planes, int p_plane_count, const Vector3 *p_points, int p_point_count, T **p_result_array, int p_result_idx, int p_result_max, uint32_t p_mask) const;
+	int _cull_aabb(const Tree &p_tree, const AABB &p_aabb, T **p_result_array, int p_result_idx, int p_result_max, int *p_subindex_array, uint32_t p_mask) const;
+	int _cull_segment(const Tree &p_tree, const Vector3 &p_from, const Vector3 &p_to, T **p_result_array, int p_result_idx, int p_result_max, int *p_subindex_array, uint32_t p_mask) const;
+	int _cull_point(const Tree &p_tree, const Vector3 &p_point, T **p_result_array, int p_result_idx, int p_result_max, int *p_subindex_array, uint32_t p_mask) const;
+
+public:
+	BVHElementID create(T *p_userdata, const AABB &p_aabb = AABB(), int p_subindex = 0, bool p_pairable = false, uint32_t p_pairable_type = 0, uint32_t pairable_mask = 1);
+	void move(BVHElementID p_id, const AABB &p_aabb);
+	void set_pairable(BVHElementID p_id, bool p_pairable = false, uint32_t p_pairable_type = 0, uint32_t pairable_mask = 1);
+	void erase(BVHElementID p_id);
+
+	bool is_pairable(BVHElementID p_id) const;
+	T *get(BVHElementID p_id) const;
+	int get_subindex(BVHElementID p_id) const;
+
+	int cull_convex(const Vector<Plane> &p_convex, T **p_result_array, int p_result_max, uint32_t p_mask = 0xFFFFFFFF) const;
+	int cull_aabb(const AABB &p_aabb, T **p_result_array, int p_result_max, int *p_subindex_array = nullptr, uint32_t p_mask = 0xFFFFFFFF) const;
+	int cull_segment(const Vector3 &p_from, const Vector3 &p_to, T **p_result_array, int p_result_max, int *p_subindex_array = nullptr, uint32_t p_mask = 0xFFFFFFFF) const;
+
+	int cull_point(const Vector3 &p_point, T **p_result_array, int p_result_max, int *p_subindex_array = nullptr, uint32_t p_mask = 0xFFFFFFFF) const;
+
+	void set_pair_callback(PairCallback p_callback, void *p_userdata);
+	void set_unpair_callback(UnpairCallback p_callback, void *p_userdata);
+
+	int get_element_count() const { return element_count; }
+	int get_pair_count() const { return pair_count; }
+
+	BVH(real_t p_unit_size = 1.0);
+	~BVH();
+};
+
+/* NODES */
+
+template <class T, bool use_pairs, class AL>
+int BVH<T, use_pairs, AL>::_alloc_node(Tree &p_tree) {
+	if (p_tree.free_list != NODE_NULL) {
+		int node = p_tree.free_list;
+		p_tree.free_list = p_tree.nodes[node].parent;
+		p_tree.nodes[node] = Node();
+		return node;
+	}
+
+	p_tree.nodes.push_back(Node());
+	return p_tree.nodes.size() - 1;
+}
+
+template <class T, bool use_pairs, class AL>
+void BVH<T, use_pairs, AL>::_free_node(Tree &p_tree, int p_node) {
+	p_tree.nodes[p_node].parent = p_tree.free_list;
+	p_tree.nodes[p_node].height = -1;
+	p_tree.free_list = p_node;
+}
+
+// Rotates the taller grandchild up when the children of p_node differ in height by more than one.
+// Returns the node now in place of p_node.
+template <class T, bool use_pairs, class AL>
+int BVH<T, use_pairs, AL>::_balance(Tree &p_tree, int p_node) {
+	Node *nodes = &p_tree.nodes[0];
+	int iA = p_node;
+	Node &A = nodes[iA];
+	if (A.is_leaf() || A.height < 2) {
+		return iA;
+	}
+
+	int iB = A.children[0];
+	int iC = A.children[1];
+	Node &B = nodes[iB];
+	Node &C = nodes[iC];
+
+	int balance = C.height - B.height;
+
+	if (balance > 1) {
+		// Rotate C up.
+		int iF = C.children[0];
+		int iG = C.children[1];
+		Node &F = nodes[iF];
+		Node &G = nodes[iG];
+
+		C.children[0] = iA;
+		C.parent = A.parent;
+		A.parent = iC;
+
+		if (C.parent != NODE_NULL) {
+			Node &parent = nodes[C.parent];
+			parent.children[parent.children[0] == iA ? 0 : 1] = iC;
+		} else {
+			p_tree.root = iC;
+		}
+
+		if (F.height > G.height) {
+			C.children[1] = iF;
+			A.children[1] = iG;
+			G.parent = iA;
+			A.aabb = B.aabb.merge(G.aabb);
+			C.aabb = A.aabb.merge(F.aabb);
+			A.height = 1 + MAX(B.height, G.height);
+			C.height = 1 + MAX(A.height, F.height);
+		} else {
+			C.children[1] = iG;
+			A.children[1] = iF;
+			F.parent = iA;
+			A.aabb = B.aabb.merge(F.aabb);
+			C.aabb = A.aabb.merge(G.aabb);
+			A.height = 1 + MAX(B.height, F.height);
+			C.height = 1 + MAX(A.height, G.height);
+		}
+
+		return iC;
+	}
+
+	if (balance < -1) {
+		// Rotate B up.
+		int iD = B.children[0];
+		int iE = B.children[1];
+		Node &D = nodes[iD];
+		Node &E = nodes[iE];
+
+		B.children[0] = iA;
+		B.parent = A.parent;
+		A.parent = iB;
+
+		if (B.parent != NODE_NULL) {
+			Node &parent = nodes[B.parent];
+			parent.children[parent.children[0] == iA ? 0 : 1] = iB;
+		} else {
+			p_tree.root = iB;
+		}
+
+		if (D.height > E.height) {
+			B.children[1] = iD;
+			A.children[0] = iE;
+			E.parent = iA;
+			A.aabb = C.aabb.merge(E.aabb);
+			B.aabb = A.aabb.merge(D.aabb);
+			A.height = 1 + MAX(C.height, E.height);
+			B.height = 1 + MAX(A.height, D.height);
+		} else {
+			B.children[1] = iE;
+			A.children[0] = iD;
+			D.parent = iA;
+			A.aabb = C.aabb.merge(D.aabb);
+			B.aabb = A.aabb.merge(E.aabb);
+			A.height = 1 + MAX(C.height, D.height);
+			B.height = 1 + MAX(A.height, E.height);
+		}
+
+		return iB;
+	}
+
+	return iA;
+}
+
+template <class T, bool use_pairs, class AL>
+void BVH<T, use_pairs, AL>::_refit(Tree &p_tree, int p_node) {
+	int index = p_node;
+	while (index != NODE_NULL) {
+		index = _balance(p_tree, index);
+
+		Node &node = p_tree.nodes[index];
+		const Node &child0 = p_tree.nodes[node.children[0]];
+		const Node &child1 = p_tree.nodes[node.children[1]];
+
+		node.height = 1 + MAX(child0.height, child1.height);
+		node.aabb = child0.aabb.merge(child1.aabb);
+
+		index = node.parent;
+	}
+}
+
+template <class T, bool use_pairs, class AL>
+void BVH<T, use_pairs, AL>::_insert_leaf(Tree &p_tree, int p_leaf) {
+	if (p_tree.root == NODE_NULL) {
+		p_tree.root = p_leaf;
+		p_tree.nodes[p_leaf].parent = NODE_NULL;
+		return;
+	}
+
+	// Find the best sibling, using the surface area heuristic.
+	AABB leaf_aabb = p_tree.nodes[p_leaf].aabb;
+	int index = p_tree.root;
+
+	while (!p_tree.nodes[index].is_leaf()) {
+		const Node &node = p_tree.nodes[index];
+
+		real_t area = _get_surface(node.aabb);
+		real_t combined_area = _get_surface(node.aabb.merge(leaf_aabb));
+
+		// Cost of creating a new parent for this node and the new leaf.
+		real_t cost = 2.0 * combined_area;
+		// Minimum cost of pushing the leaf further down the tree.
+		real_t inheritance_cost = 2.0 * (combined_area - area);
+
+		real_t child_cost[2];
+		for (int i = 0; i < 2; i++) {
+			const Node &child = p_tree.nodes[node.children[i]];
+			child_cost[i] = _get_surface(child.aabb.merge(leaf_aabb)) + inheritance_cost;
+			if (!child.is_leaf()) {
+				child_cost[i] -= _get_surface(child.aabb);
+			}
+		}
+
+		if (cost < child_cost[0] && cost < child_cost[1]) {
+			break;
+		}
+
+		index = child_cost[0] < child_cost[1] ? node.children[0] : node.children[1];
+	}
+
+	int sibling = index;
+	int old_parent = p_tree.nodes[sibling].parent;
+	int new_parent = _alloc_node(p_tree); // May reallocate, don't hold references across this.
+
+	Node &parent = p_tree.nodes[new_parent];
+	parent.parent = old_parent;
+	parent.aabb = leaf_aabb.merge(p_tree.nodes[sibling].aabb);
+	parent.height = p_tree.nodes[sibling].height + 1;
+	parent.children[0] = sibling;
+	parent.children[1] = p_leaf;
+	p_tree.nodes[sibling].parent = new_parent;
+	p_tree.nodes[p_leaf].parent = new_parent;
+
+	if (old_parent != NODE_NULL) {
+		Node &grandparent = p_tree.nodes[old_parent];
+		grandparent.children[grandparent.children[0] == sibling ? 0 : 1] = new_parent;
+	} else {
+		p_tree.root = new_parent;
+	}
+
+	_refit(p_tree, new_parent);
+}
+
+template <class T, bool use_pairs, class AL>
+void BVH<T, use_pairs, AL>::_remove_leaf(Tree &p_tree, int p_leaf) {
+	if (p_tree.root == p_leaf) {
+		p_tree.root = NODE_NULL;
+		return;
+	}
+
+	int parent = p_tree.nodes[p_leaf].parent;
+	int grandparent = p_tree.nodes[parent].parent;
+	int sibling = p_tree.nodes[parent].children[p_tree.nodes[parent].children[0] == p_leaf ? 1 : 0];
+
+	_free_node(p_tree, parent);
+	p_tree.nodes[p_leaf].parent = NODE_NULL;
+
+	if (grandparent != NODE_NULL) {
+		Node &node = p_tree.nodes[grandparent];
+		node.children[node.children[0] == parent ? 0 : 1] = sibling;
+		p_tree.nodes[sibling].parent = grandparent;
+		_refit(p_tree, grandparent);
+	} else {
+		p_tree.root = sibling;
+		p_tree.nodes[sibling].parent = NODE_NULL;
+	}
+}
+
+/* ELEMENTS */
+
+template <class T, bool use_pairs, class AL>
+void BVH<T, use_pairs, AL>::_element_insert(Element *p_element, int p_tree) {
+	Tree &tree = trees[p_tree];
+	int leaf = _alloc_node(tree);
+
+	Node &node = tree.nodes[leaf];
+	node.aabb = p_tree == TREE_STATIC ? p_element->aabb : _enlarge(p_element->aabb);
+	node.element_aabb = p_element->aabb;
+	node.userdata = p_element->userdata;
+	node.pairable_type = p_element->pairable_type;
+	node.element = p_element->id;
+
+	p_element->tree = p_tree;
+	p_element->leaf = leaf;
+
+	_insert_leaf(tree, leaf);
+}
+
+template <class T, bool use_pairs, class AL>
+void BVH<T, use_pairs, AL>::_element_remove(Element *p_element) {
+	if (p_element->tree == TREE_NONE) {
+		return;
+	}
+
+	Tree &tree = trees[p_element->tree];
+	_remove_leaf(tree, p_element->leaf);
+	_free_node(tree, p_element->leaf);
+
+	p_element->tree = TREE_NONE;
+	p_element->leaf = NODE_NULL;
+}
+
+/* PAIRS */
+
+template <class T, bool use_pairs, class AL>
+void BVH<T, use_pairs, AL>::_pair_add(Element *p_A, Element *p_B) {
+	PairKey key(p_A->id, p_B->id);
+	if (pair_map.has(key)) {
+		return;
+	}
+
+	PairData pdata;
+	pdata.A = p_A;
+	pdata.B = p_B;
+	pdata.ud = nullptr;
+
+	PairData &pair = pair_map.insert(key, pdata)->get();
+	pair.eA = p_A->pair_list.push_back(&pair);
+	pair.eB = p_B->pair_list.push_back(&pair);
+
+	if (pair_callback) {
+		pair.ud = pair_callback(pair_callback_userdata, p_A->id, p_A->userdata, p_A->subindex, p_B->id, p_B->userdata, p_B->subindex);
+	}
+	pair_count++;
+}
+
+template <class T, bool use_pairs, class AL>
+void BVH<T, use_pairs, AL>::_pair_remove(PairData *p_pair) {
+	Element *A = p_pair->A;
+	Element *B = p_pair->B;
+
+	if (unpair_callback) {
+		unpair_callback(unpair_callback_userdata, A->id, A->userdata, A->subindex, B->id, B->userdata, B->subindex, p_pair->ud);
+	}
+	pair_count--;
+
+	A->pair_list.erase(p_pair->eA);
+	B->pair_list.erase(p_pair->eB);
+	pair_map.erase(PairKey(A->id, B->id));
+}
+
+template <class T, bool use_pairs, class AL>
+void BVH<T, use_pairs, AL>::_element_update_pairs(Element *p_element) {
+	// Drop pairs that no longer overlap or are no longer allowed.
+	typename List<PairData *, AL>::Element *E = p_element->pair_list.front();
+	while (E) {
+		typename List<PairData *, AL>::Element *N = E->next();
+		PairData *pair = E->get();
+		Element *other = pair->A == p_element ? pair->B : pair->A;
+
+		if (p_element->tree == TREE_NONE || other->tree == TREE_NONE || !_can_pair(p_element, other) || !p_element->aabb.intersects_inclusive(other->aabb)) {
+			_pair_remove(pair);
+		}
+
+		E = N;
+	}
+
+	if (p_element->tree == TREE_NONE) {
+		return;
+	}
+
+	// Find new overlaps. Two non pairable elements never pair, so those only look at the pairable tree.
+	for (int i = 0; i < TREE_MAX; i++) {
+		if (!p_element->pairable && i != TREE_PAIRABLE) {
+			continue;
+		}
+
+		const Tree &tree = trees[i];
+		if (tree.root == NODE_NULL) {
+			continue;
+		}
+
+		int stack[STACK_SIZE];
+		int stack_size = 0;
+		stack[stack_size++] = tree.root;
+
+		while (stack_size) {
+			const Node &node = tree.nodes[stack[--stack_size]];
+
+			if (node.is_leaf()) {
+				if (node.element_aabb.intersects_inclusive(p_element->aabb)) {
+					Element *other = elements[node.element - 1];
+					if (_can_pair(p_element, other)) {
+						_pair_add(p_element, other);
+					}
+				}
+			} else if (node.aabb.intersects_inclusive(p_element->aabb)) {
+				ERR_CONTINUE(stack_size + 2 > STACK_SIZE);
+				stack[stack_size++] = node.children[0];
+				stack[stack_size++] = node.children[1];
+			}
+		}
+	}
+}
+
+/* PUBLIC API */
+
+template <class T, bool use_pairs, class AL>
+BVHElementID BVH<T, use_pairs, AL>::create(T *p_userdata, const AABB &p_aabb, int p_subindex, bool p_pairable, uint32_t p_pairable_type, uint32_t p_pairable_mask) {
+	ERR_FAIL_COND_V(Math::is_nan(p_aabb.size.x) || Math::is_nan(p_aabb.size.y) || Math::is_nan(p_aabb.size.z), BVH_ELEMENT_INVALID_ID);
+	ERR_FAIL_COND_V(p_aabb.size.x < 0.0 || p_aabb.size.y < 0.0 || p_aabb.size.z < 0.0, BVH_ELEMENT_INVALID_ID);
+
+	Element *e = memnew_allocator(Element, AL);
+	e->userdata = p_userdata;
+	e->subindex = p_subindex;
+	e->pairable = p_pairable;
+	e->pairable_type = p_pairable_type;
+	e->pairable_mask = p_pairable_mask;
+	e->aabb = p_aabb;
+
+	if (free_ids.size()) {
+		e->id = free_ids[free_ids.size() - 1];
+		free_ids.resize(free_ids.size() - 1);
+		elements[e->id - 1] = e;
+	} else {
+		elements.push_back(e);
+		e->id = elements.size();
+	}
+
+	if (!p_aabb.has_no_surface()) {
+		_element_insert(e, _get_element_tree(e));
+	}
+
+	if (use_pairs) {
+		_element_update_pairs(e);
+	}
+
+	element_count++;
+	return e->id;
+}
+
+template <class T, bool use_pairs, class AL>
+void BVH<T, use_pairs, AL>::move(BVHElementID p_id, const AABB &p_aabb) {
+	ERR_FAIL_COND(Math::is_nan(p_aabb.size.x) || Math::is_nan(p_aabb.size.y) || Math::is_nan(p_aabb.size.z));
+	ERR_FAIL_COND(p_aabb.size.x < 0.0 || p_aabb.size.y < 0.0 || p_aabb.size.z < 0.0);
+
+	Element *e = _get_element(p_id);
+	ERR_FAIL_COND(!e);
+
+	if (e->aabb == p_aabb) {
+		return;
+	}
+
+	e->aabb = p_aabb;
+
+	if (!e->moved) {
+		// Moving elements are no longer static.
+		e->moved = true;
+		if (e->tree == TREE_STATIC) {
+			_element_remove(e);
+		}
+	}
+
+	if (p_aabb.has_no_surface()) {
+		_element_remove(e);
+	} else if (e->tree == TREE_NONE) {
+		_element_insert(e, _get_element_tree(e));
+	} else {
+		Tree &tree = trees[e->tree];
+		Node &leaf = tree.nodes[e->leaf];
+		leaf.element_aabb = p_aabb;
+
+		if (!leaf.aabb.encloses(p_aabb)) {
+			// Left its enlarged bounds, reinsert it.
+			_remove_leaf(tree, e->leaf);
+			tree.nodes[e->leaf].aabb = _enlarge(p_aabb);
+			_insert_leaf(tree, e->leaf);
+		}
+	}
+
+	if (use_pairs) {
+		_element_update_pairs(e);
+	}
+}
+
+template <class T, bool use_pairs, class AL>
+void BVH<T, use_pairs, AL>::set_pairable(BVHElementID p_id, bool p_pairable, uint32_t p_pairable_type, uint32_t p_pairable_mask) {
+	Element *e = _get_element(p_id);
+	ERR_FAIL_COND(!e);
+
+	if (p_pairable == e->pairable && e->pairable_type == p_pairable_type && e->pairable_mask == p_pairable_mask) {
+		return; // no changes, return
+	}
+
+	e->pairable = p_pairable;
+	e->pairable_type = p_pairable_type;
+	e->pairable_mask = p_pairable_mask;
+
+	if (e->tree != TREE_NONE) {
+		int tree = _get_element_tree(e);
+		if (tree != e->tree) {
+			_element_remove(e);
+			_element_insert(e, tree);
+		} else {
+			trees[tree].nodes[e->leaf].pairable_type = p_pairable_type;
+		}
+	}
+
+	if (use_pairs) {
+		_element_update_pairs(e);
+	}
+}
+
+template <class T, bool use_pairs, class AL>
+void BVH<T, use_pairs, AL>::erase(BVHElementID p_id) {
+	Element *e = _get_element(p_id);
+	ERR_FAIL_COND(!e);
+
+	while (e->pair_list.front()) {
+		_pair_remove(e->pair_list.front()->get());
+	}
+
+	_element_remove(e);
+
+	elements[p_id - 1] = nullptr;
+	free_ids.push_back(p_id);
+	memdelete_allocator<Element, AL>(e);
+	element_count--;
+}
+
+template <class T, bool use_pairs, class AL>
+bool BVH<T, use_pairs, AL>::is_pairable(BVHElementID p_id) const {
+	const Element *e = _get_element(p_id);
+	ERR_FAIL_COND_V(!e, false);
+	return e->pairable;
+}
+
+template <class T, bool use_pairs, class AL>
+T *BVH<T, use_pairs, AL>::get(BVHElementID p_id) const {
+	const Element *e = _get_element(p_id);
+	ERR_FAIL_COND_V(!e, nullptr);
+	return e->userdata;
+}
+
+template <class T, bool use_pairs, class AL>
+int BVH<T, use_pairs, AL>::get_subindex(BVHElementID p_id) const {
+	const Element *e = _get_element(p_id);
+	ERR_FAIL_COND_V(!e, -1);
+	return e->subindex;
+}
+
+/* CULLING */
+
+// Rejects nodes fully outside one of the planes. Planes the node is fully inside of are cleared
+// from the mask, so children don't test them again.
+template <class T, bool use_pairs, class AL>
+bool BVH<T, use_pairs, AL>::_node_in_convex(const AABB &p_aabb, const Plane *p_planes, int p_plane_count, uint32_t &r_plane_mask) {
+	Vector3 half_extents = p_aabb.size * 0.5;
+	Vector3 center = p_aabb.position + half_extents;
+
+	for (int i = 0; i < p_plane_count; i++) {
+		if (i < 32 && !(r_plane_mask & (1u << i))) {
+			continue;
+		}
+
+		const Plane &p = p_planes[i];
+		real_t dist = p.distance_to(center);
+		real_t radius = Math::abs(p.normal.x) * half_extents.x + Math::abs(p.normal.y) * half_extents.y + Math::abs(p.normal.z) * half_extents.z;
+
+		if (dist - radius > 0) {
+			return false;
+		}
+		if (dist + radius <= 0 && i < 32) {
+			r_plane_mask &= ~(1u << i);
+		}
+	}
+
+	return true;
+}
+
+template <class T, bool use_pairs, class AL>
+int BVH<T, use_pairs, AL>::_cull_convex(const Tree &p_tree, const Plane *p_planes, int p_plane_count, const Vector3 *p_points, int p_point_count, T **p_result_array, int p_result_idx, int p_result_max, uint32_t p_mask) const {
+	if (p_tree.root == NODE_NULL) {
+		return p_result_idx;
+	}
+
+	struct StackEntry {
+		int node;
+		uint32_t plane_mask;
+	};
+
+	StackEntry stack[STACK_SIZE];
+	int stack_size = 0;
+	stack[stack_size++] = { p_tree.root, p_plane_count >= 32 ? 0xFFFFFFFF : ((1u << p_plane_count) - 1) };
+
+	while (stack_size) {
+		StackEntry entry = stack[--stack_size];
+		const Node &node = p_tree.nodes[entry.node];
+
+		if (node.is_leaf()) {
+			if (use_pairs && !(node.pairable_type & p_mask)) {
+				continue;
+			}
+			if (node.element_aabb.intersects_convex_shape(p_planes, p_plane_count, p_points, p_point_count)) {
+				if (p_result_idx == p_result_max) {
+					return p_result_idx; // pointless to continue
+				}
+				p_result_array[p_result_idx++] = node.userdata;
+			}
+			continue;
+		}
+
+		if (!_node_in_convex(node.aabb, p_planes, p_plane_count, entry.plane_mask)) {
+			continue;
+		}
+
+		ERR_CONTINUE(stack_size + 2 > STACK_SIZE);
+		stack[stack_size++] = { node.children[0], entry.plane_mask };
+		stack[stack_size++] = { node.children[1], entry.plane_mask };
+	}
+
+	return p_result_idx;
+}
+
+template <class T, bool use_pairs, class AL>
+int BVH<T, use_pairs, AL>::_cull_aabb(const Tree &p_tree, const AABB &p_aabb, T **p_result_array, int p_result_idx, int p_result_max, int *p_subindex_array, uint32_t p_mask) const {
+	if (p_tree.root == NODE_NULL) {
+		return p_result_idx;
+	}
+
+	int stack[STACK_SIZE];
+	int stack_size = 0;
+	stack[stack_size++] = p_tree.root;
+
+	while (stack_size) {
+		const Node &node = p_tree.nodes[stack[--stack_size]];
+
+		if (node.is_leaf()) {
+			if (use_pairs && !(node.pairable_type & p_mask)) {
+				continue;
+			}
+			if (node.element_aabb.intersects_inclusive(p_aabb)) {
+				if (p_result_idx == p_result_max) {
+					return p_result_idx; // pointless to continue
+				}
+				if (p_subindex_array) {
+					p_subindex_array[p_result_idx] = elements[node.element - 1]->subindex;
+				}
+				p_result_array[p_result_idx++] = node.userdata;
+			}
+		} else if (node.aabb.intersects_inclusive(p_aabb)) {
+			ERR_CONTINUE(stack_size + 2 > STACK_SIZE);
+			stack[stack_size++] = node.children[0];
+			stack[stack_size++] = node.children[1];
+		}
+	}
+
+	return p_result_idx;
+}
+
+template <class T, bool use_pairs, class AL>
+int BVH<T, use_pairs, AL>::_cull_segment(const Tree &p_tree, const Vector3 &p_from, const Vector3 &p_to, T **p_result_array, int p_result_idx, int p_result_max, int *p_subindex_array, uint32_t p_mask) const {
+	if (p_tree.root == NODE_NULL) {
+		return p_result_idx;
+	}
+
+	int stack[STACK_SIZE];
+	int stack_size = 0;
+	stack[stack_size++] = p_tree.root;
+
+	while (stack_size) {
+		const Node &node = p_tree.nodes[stack[--stack_size]];
+
+		if (node.is_leaf()) {
+			if (use_pairs && !(node.pairable_type & p_mask)) {
+				continue;
+			}
+			if (node.element_aabb.intersects_segment(p_from, p_to)) {
+				if (p_result_idx == p_result_max) {
+					return p_result_idx; // pointless to continue
+				}
+				if (p_subindex_array) {
+					p_subindex_array[p_result_idx] = elements[node.element - 1]->subindex;
+				}
+				p_result_array[p_result_idx++] = node.userdata;
+			}
+		} else if (node.aabb.intersects_segment(p_from, p_to)) {
+			ERR_CONTINUE(stack_size + 2 > STACK_SIZE);
+			stack[stack_size++] = node.children[0];
+			stack[stack_size++] = node.children[1];
+		}
+	}
+
+	return p_result_idx;
+}
+
+template <class T, bool use_pairs, class AL>
+int BVH<T, use_pairs, AL>::_cull_point(const Tree &p_tree, const Vector3 &p_point, T **p_result_array, int p_result_idx, int p_result_max, int *p_subindex_array, uint32_t p_mask) const {
+	if (p_tree.root == NODE_NULL) {
+		return p_result_idx;
+	}
+
+	int stack[STACK_SIZE];
+	int stack_size = 0;
+	stack[stack_size++] = p_tree.root;
+
+	while (stack_size) {
+		const Node &node = p_tree.nodes[stack[--stack_size]];
+
+		if (node.is_leaf()) {
+			if (use_pairs && !(node.pairable_type & p_mask)) {
+				continue;
+			}
+			if (node.element_aabb.has_point(p_point)) {
+				if (p_result_idx == p_result_max) {
+					return p_result_idx; // pointless to continue
+				}
+				if (p_subindex_array) {
+					p_subindex_array[p_result_idx] = elements[node.element - 1]->subindex;
+				}
+				p_result_array[p_result_idx++] = node.userdata;
+			}
+		} else if (node.aabb.has_point(p_point)) {
+			ERR_CONTINUE(stack_size + 2 > STACK_SIZE);
+			stack[stack_size++] = node.children[0];
+			stack[stack_size++] = node.children[1];
+		}
+	}
+
+	return p_result_idx;
+}
+
+template <class T, bool use_pairs, class AL>
+int BVH<T, use_pairs, AL>::cull_convex(const Vector<Plane> &p_convex, T **p_result_array, int p_result_max, uint32_t p_mask) const {
+	if (p_convex.size() == 0) {
+		return 0;
+	}
+
+	Vector<Vector3> convex_points = Geometry3D::compute_convex_mesh_points(&p_convex[0], p_convex.size());
+	if (convex_points.size() == 0) {
+		return 0;
+	}
+
+	int result_count = 0;
+	for (int i = 0; i < TREE_MAX; i++) {
+		result_count = _cull_convex(trees[i], &p_convex[0], p_convex.size(), &convex_points[0], convex_points.size(), p_result_array, result_count, p_result_max, p_mask);
+	}
+
+	return result_count;
+}
+
+template <class T, bool use_pairs, class AL>
+int BVH<T, use_pairs, AL>::cull_aabb(const AABB &p_aabb, T **p_result_array, int p_result_max, int *p_subindex_array, uint32_t p_mask) const {
+	int result_count = 0;
+	for (int i = 0; i < TREE_MAX; i++) {
+		result_count = _cull_aabb(trees[i], p_aabb, p_result_array, result_count, p_result_max, p_subindex_array, p_mask);
+	}
+
+	return result_count;
+}
+
+template <class T, bool use_pairs, class AL>
+int BVH<T, use_pairs, AL>::cull_segment(const Vector3 &p_from, const Vector3 &p_to, T **p_result_array, int p_result_max, int *p_subindex_array, uint32_t p_mask) const {
+	int result_count = 0;
+	for (int i = 0; i < TREE_MAX; i++) {
+		result_count = _cull_segment(trees[i], p_from, p_to, p_result_array, result_count, p_result_max, p_subindex_array, p_mask);
+	}
+
+	return result_count;
+}
+
+template <class T, bool use_pairs, class AL>
+int BVH<T, use_pairs, AL>::cull_point(const Vector3 &p_point, T **p_result_array, int p_result_max, int *p_subindex_array, uint32_t p_mask) const {
+	int result_count = 0;
+	for (int i = 0; i < TREE_MAX; i++) {
+		result_count = _cull_point(trees[i], p_point, p_result_array, result_count, p_result_max, p_subindex_array, p_mask);
+	}
+
+	return result_count;
+}
+
+template <class T, bool use_pairs, class AL>
+void BVH<T, use_pairs, AL>::set_pair_callback(PairCallback p_callback, void *p_userdata) {
+	pair_callback = p_callback;
+	pair_callback_userdata = p_userdata;
+}
+
+template <class T, bool use_pairs, class AL>
+void BVH<T, use_pairs, AL>::set_unpair_callback(UnpairCallback p_callback, void *p_userdata) {
+	unpair_callback = p_callback;
+	unpair_callback_userdata = p_userdata;
+}
+
+template <class T, bool use_pairs, class AL>
+BVH<T, use_pairs, AL>::BVH(real_t p_unit_size) {
+	pair_callback = nullptr;
+	unpair_callback = nullptr;
+	pair_callback_userdata = nullptr;
+	unpair_callback_userdata = nullptr;
+	unit_size = p_unit_size;
+	element_count = 0;
+	pair_count = 0;
+}
+
+template <class T, bool use_pairs, class AL>
+BVH<T, use_pairs, AL>::~BVH() {
+	for (uint32_t i = 0; i < elements.size(); i++) {
+		if (elements[i]) {
+			memdelete_allocator<Element, AL>(elements[i]);
+		}
+	}
+}
+
+#endif // BVH_H
@@ -32,6 +32,7 @@
 
 #include "core/class_db.h"
 #include "core/core_string_names.h"
+#include "core/debugger/sampling_profiler.h"
 #include "core/message_queue.h"
 #include "core/os/os.h"
 #include "core/print_string.h"
@@ -887,6 +888,7 @@ Variant Object::call(const StringName &p_method, const Variant **p_args, int p_a
 	MethodBind *method = ClassDB::get_method(get_class_name(), p_method);
 
 	if (method) {
+		SamplingProfiler::Scope sampling_scope(SamplingProfiler::FRAME_NATIVE, method);
 		ret = method->call(this, p_args, p_argcount, r_error);
 	} else {
 		r_error.error = Callable::CallError::CALL_ERROR_INVALID_METHOD;
@@ -97,6 +97,7 @@ extern void register_global_constants();
 extern void unregister_global_constants();
 extern void register_variant_methods();
 extern void unregister_variant_methods();
+extern void register_variant_operators();
 
 void register_core_types() {
 	//consistency check
@@ -109,6 +110,7 @@ void register_core_types() {
 	ResourceLoader::initialize();
 
 	register_global_constants();
+	register_variant_operators();
 	register_variant_methods();
 
 	CoreStringNames::create();
@@ -120,6 +120,7 @@ public:
 
 private:
 	friend struct _VariantCall;
+	friend struct _VariantOp;
 	// Variant takes 20 bytes when real_t is float, and 36 if double
 	// it only allocates extra memory for aabb/matrix.
 
@@ -408,6 +409,22 @@ public:
 		return res;
 	}
 
+	typedef void (*OperatorEvaluator)(const Variant &p_a, const Variant &p_b, Variant &r_ret, bool &r_valid);
+	typedef void (*ValidatedOperatorEvaluator)(const Variant *p_a, const Variant *p_b, Variant *r_ret);
+
+	// Evaluators specialized for an operator and a pair of operand types, meant to
+	// be resolved once by callers that know their types ahead of time. They return
+	// nullptr if there is no specialization, in which case evaluate() must be used.
+	// The operands must be of the requested types. Plain evaluators can still fail
+	// (e.g. on division by zero), validated ones never do. Unary operators accept
+	// any second type.
+	static OperatorEvaluator get_operator_evaluator(Operator p_op, Type p_type_a, Type p_type_b);
+	static ValidatedOperatorEvaluator get_validated_operator_evaluator(Operator p_op, Type p_type_a, Type p_type_b);
+
+	// What evaluate() does when there is no specialized evaluator. Only meant to
+	// check the specialized evaluators against it, use evaluate() otherwise.
+	static void _evaluate_generic(const Operator &p_op, const Variant &p_a, const Variant &p_b, Variant &r_ret, bool &r_valid);
+
 	void zero();
 	Variant duplicate(bool deep = false) const;
 	static void blend(const Variant &a, const Variant &b, float c, Variant &r_dst);
@@ -430,6 +447,29 @@ public:
 	static Vector<StringName> get_method_argument_names(Variant::Type p_type, const StringName &p_method);
 	static bool is_method_const(Variant::Type p_type, const StringName &p_method);
 
+	typedef void (*ValidatedBuiltInMethod)(Variant *p_base, const Variant **p_args, Variant *r_ret);
+
+	// Builtin methods specialized for exact argument types, meant to be resolved
+	// once by callers that know their types ahead of time. Returns nullptr if there
+	// is no specialization for this signature, in which case call_ptr() must be
+	// used. The base and arguments must be of the requested types, and r_ret must
+	// be a valid Variant, which is overwritten in place when it already holds the
+	// return type. Only const methods returning a value are specialized.
+	static ValidatedBuiltInMethod get_validated_builtin_method(Variant::Type p_type, const StringName &p_method, const Variant::Type *p_argument_types, int p_argument_count);
+
+	typedef void (*ValidatedIndexedGetter)(const Variant *p_base, int64_t p_index, Variant *r_value, bool *r_oob);
+	typedef void (*ValidatedIndexedSetter)(Variant *p_base, int64_t p_index, const Variant *p_value, bool *r_oob);
+
+	// Element access for packed arrays, meant to be resolved once by callers that
+	// know the base type ahead of time. Returns nullptr if the type (or, for the
+	// setter, the value type) can't be accessed this way, in which case get() and
+	// set() must be used. Elements are read and written directly, without going
+	// through a temporary Variant. Negative indices count from the end as with
+	// get(), and r_oob is set (without reading or writing anything) if the index is
+	// out of bounds.
+	static ValidatedIndexedGetter get_validated_indexed_getter(Type p_type);
+	static ValidatedIndexedSetter get_validated_indexed_setter(Type p_type, Type p_value_type);
+
 	void set_named(const StringName &p_index, const Variant &p_value, bool *r_valid = nullptr);
 	Variant get_named(const StringName &p_index, bool *r_valid = nullptr) const;
 
@@ -37,6 +37,7 @@
 #include "core/io/compression.h"
 #include "core/object.h"
 #include "core/os/os.h"
+#include "core/variant_internal.h"
 
 typedef void (*VariantFunc)(Variant &r_ret, Variant &p_self, const Variant **p_args);
 typedef void (*VariantConstructFunc)(Variant &r_ret, const Variant **p_args);
@@ -984,6 +985,166 @@ struct _VariantCall {
 		}
 	}
 
+	// Validated variants of common math methods, for callers that know the exact
+	// base and argument types. Types are the ones stored in Variant (double for
+	// floats), results are written in place through _VariantOp::set().
+
+	struct ValidatedFuncData {
+		StringName name;
+		Variant::ValidatedBuiltInMethod func;
+		int arg_count;
+		Variant::Type arg_types[VARIANT_ARG_MAX];
+	};
+
+	static Vector<ValidatedFuncData> *validated_funcs;
+
+	static void add_validated_func(Variant::Type p_type, const StringName &p_name, Variant::ValidatedBuiltInMethod p_func, const Variant::Type *p_arg_types, int p_arg_count) {
+		ValidatedFuncData funcdata;
+		funcdata.name = p_name;
+		funcdata.func = p_func;
+		funcdata.arg_count = p_arg_count;
+		for (int i = 0; i < p_arg_count; i++) {
+			funcdata.arg_types[i] = p_arg_types[i];
+		}
+		validated_funcs[p_type].push_back(funcdata);
+	}
+
+#define VALIDATED_CALL0R(m_type, m_method, m_ret)                                                          \
+	struct Validated_##m_type##_##m_method {                                                              \
+		static void call(Variant *p_base, const Variant **p_args, Variant *r_ret) {                        \
+			_VariantOp::set<m_ret>(r_ret, _VariantOp::get<m_type>(p_base).m_method());                      \
+		}                                                                                                  \
+		static void bind() {                                                                               \
+			add_validated_func(GetTypeInfo<m_type>::VARIANT_TYPE, _scs_create(#m_method), call, nullptr, 0); \
+		}                                                                                                  \
+	};
+#define VALIDATED_CALL1R(m_type, m_method, m_ret, m_arg1)                                                                  \
+	struct Validated_##m_type##_##m_method {                                                                              \
+		static void call(Variant *p_base, const Variant **p_args, Variant *r_ret) {                                        \
+			_VariantOp::set<m_ret>(r_ret, _VariantOp::get<m_type>(p_base).m_method(_VariantOp::get<m_arg1>(p_args[0]))); \
+		}                                                                                                                  \
+		static void bind() {                                                                                               \
+			Variant::Type arg_types[] = { GetTypeInfo<m_arg1>::VARIANT_TYPE };                                             \
+			add_validated_func(GetTypeInfo<m_type>::VARIANT_TYPE, _scs_create(#m_method), call, arg_types, 1);             \
+		}                                                                                                                  \
+	};
+#define VALIDATED_CALL2R(m_type, m_method, m_ret, m_arg1, m_arg2)                                                                                                 \
+	struct Validated_##m_type##_##m_method {                                                                                                                     \
+		static void call(Variant *p_base, const Variant **p_args, Variant *r_ret) {                                                                               \
+			_VariantOp::set<m_ret>(r_ret, _VariantOp::get<m_type>(p_base).m_method(_VariantOp::get<m_arg1>(p_args[0]), _VariantOp::get<m_arg2>(p_args[1]))); \
+		}                                                                                                                                                         \
+		static void bind() {                                                                                                                                      \
+			Variant::Type arg_types[] = { GetTypeInfo<m_arg1>::VARIANT_TYPE, GetTypeInfo<m_arg2>::VARIANT_TYPE };                                                 \
+			add_validated_func(GetTypeInfo<m_type>::VARIANT_TYPE, _scs_create(#m_method), call, arg_types, 2);                                                    \
+		}                                                                                                                                                         \
+	};
+
+	VALIDATED_CALL0R(Vector2, angle, double);
+	VALIDATED_CALL1R(Vector2, angle_to, double, Vector2);
+	VALIDATED_CALL1R(Vector2, angle_to_point, double, Vector2);
+	VALIDATED_CALL1R(Vector2, direction_to, Vector2, Vector2);
+	VALIDATED_CALL1R(Vector2, distance_to, double, Vector2);
+	VALIDATED_CALL1R(Vector2, distance_squared_to, double, Vector2);
+	VALIDATED_CALL0R(Vector2, length, double);
+	VALIDATED_CALL0R(Vector2, length_squared, double);
+	VALIDATED_CALL0R(Vector2, normalized, Vector2);
+	VALIDATED_CALL0R(Vector2, is_normalized, bool);
+	VALIDATED_CALL1R(Vector2, project, Vector2, Vector2);
+	VALIDATED_CALL2R(Vector2, lerp, Vector2, Vector2, double);
+	VALIDATED_CALL2R(Vector2, slerp, Vector2, Vector2, double);
+	VALIDATED_CALL2R(Vector2, move_toward, Vector2, Vector2, double);
+	VALIDATED_CALL1R(Vector2, rotated, Vector2, double);
+	VALIDATED_CALL0R(Vector2, tangent, Vector2);
+	VALIDATED_CALL0R(Vector2, floor, Vector2);
+	VALIDATED_CALL0R(Vector2, ceil, Vector2);
+	VALIDATED_CALL0R(Vector2, round, Vector2);
+	VALIDATED_CALL1R(Vector2, dot, double, Vector2);
+	VALIDATED_CALL1R(Vector2, cross, double, Vector2);
+	VALIDATED_CALL1R(Vector2, slide, Vector2, Vector2);
+	VALIDATED_CALL1R(Vector2, bounce, Vector2, Vector2);
+	VALIDATED_CALL1R(Vector2, reflect, Vector2, Vector2);
+	VALIDATED_CALL0R(Vector2, abs, Vector2);
+	VALIDATED_CALL1R(Vector2, clamped, Vector2, double);
+	VALIDATED_CALL0R(Vector2, sign, Vector2);
+
+	VALIDATED_CALL1R(Vector3, angle_to, double, Vector3);
+	VALIDATED_CALL1R(Vector3, direction_to, Vector3, Vector3);
+	VALIDATED_CALL1R(Vector3, distance_to, double, Vector3);
+	VALIDATED_CALL1R(Vector3, distance_squared_to, double, Vector3);
+	VALIDATED_CALL0R(Vector3, length, double);
+	VALIDATED_CALL0R(Vector3, length_squared, double);
+	VALIDATED_CALL0R(Vector3, normalized, Vector3);
+	VALIDATED_CALL0R(Vector3, is_normalized, bool);
+	VALIDATED_CALL2R(Vector3, rotated, Vector3, Vector3, double);
+	VALIDATED_CALL2R(Vector3, lerp, Vector3, Vector3, double);
+	VALIDATED_CALL2R(Vector3, slerp, Vector3, Vector3, double);
+	VALIDATED_CALL2R(Vector3, move_toward, Vector3, Vector3, double);
+	VALIDATED_CALL1R(Vector3, dot, double, Vector3);
+	VALIDATED_CALL1R(Vector3, cross, Vector3, Vector3);
+	VALIDATED_CALL0R(Vector3, abs, Vector3);
+	VALIDATED_CALL0R(Vector3, floor, Vector3);
+	VALIDATED_CALL0R(Vector3, ceil, Vector3);
+	VALIDATED_CALL0R(Vector3, round, Vector3);
+	VALIDATED_CALL1R(Vector3, project, Vector3, Vector3);
+	VALIDATED_CALL1R(Vector3, slide, Vector3, Vector3);
+	VALIDATED_CALL1R(Vector3, bounce, Vector3, Vector3);
+	VALIDATED_CALL1R(Vector3, reflect, Vector3, Vector3);
+	VALIDATED_CALL0R(Vector3, sign, Vector3);
+
+	VALIDATED_CALL0R(Quat, length, double);
+	VALIDATED_CALL0R(Quat, length_squared, double);
+	VALIDATED_CALL0R(Quat, normalized, Quat);
+	VALIDATED_CALL0R(Quat, inverse, Quat);
+	VALIDATED_CALL1R(Quat, dot, double, Quat);
+	VALIDATED_CALL1R(Quat, xform, Vector3, Vector3);
+	VALIDATED_CALL2R(Quat, slerp, Quat, Quat, double);
+	VALIDATED_CALL0R(Quat, get_euler, Vector3);
+
+	VALIDATED_CALL2R(Color, lerp, Color, Color, double);
+	VALIDATED_CALL1R(Color, blend, Color, Color);
+	VALIDATED_CALL1R(Color, lightened, Color, double);
+	VALIDATED_CALL1R(Color, darkened, Color, double);
+	VALIDATED_CALL0R(Color, inverted, Color);
+	VALIDATED_CALL0R(Color, contrasted, Color);
+
+	VALIDATED_CALL0R(Transform2D, inverse, Transform2D);
+	VALIDATED_CALL0R(Transform2D, affine_inverse, Transform2D);
+	VALIDATED_CALL0R(Transform2D, get_rotation, double);
+	VALIDATED_CALL0R(Transform2D, get_origin, Vector2);
+	VALIDATED_CALL0R(Transform2D, get_scale, Vector2);
+	VALIDATED_CALL1R(Transform2D, rotated, Transform2D, double);
+	VALIDATED_CALL1R(Transform2D, scaled, Transform2D, Vector2);
+	VALIDATED_CALL1R(Transform2D, translated, Transform2D, Vector2);
+	VALIDATED_CALL1R(Transform2D, xform, Vector2, Vector2);
+	VALIDATED_CALL1R(Transform2D, xform_inv, Vector2, Vector2);
+	VALIDATED_CALL1R(Transform2D, basis_xform, Vector2, Vector2);
+	VALIDATED_CALL1R(Transform2D, basis_xform_inv, Vector2, Vector2);
+	VALIDATED_CALL2R(Transform2D, interpolate_with, Transform2D, Transform2D, double);
+
+	VALIDATED_CALL0R(Basis, inverse, Basis);
+	VALIDATED_CALL0R(Basis, transposed, Basis);
+	VALIDATED_CALL0R(Basis, orthonormalized, Basis);
+	VALIDATED_CALL0R(Basis, determinant, double);
+	VALIDATED_CALL2R(Basis, rotated, Basis, Vector3, double);
+	VALIDATED_CALL1R(Basis, scaled, Basis, Vector3);
+	VALIDATED_CALL0R(Basis, get_scale, Vector3);
+	VALIDATED_CALL0R(Basis, get_euler, Vector3);
+	VALIDATED_CALL1R(Basis, xform, Vector3, Vector3);
+	VALIDATED_CALL1R(Basis, xform_inv, Vector3, Vector3);
+	VALIDATED_CALL2R(Basis, slerp, Basis, Basis, double);
+	VALIDATED_CALL0R(Basis, get_rotation_quat, Quat);
+
+	VALIDATED_CALL0R(Transform, inverse, Transform);
+	VALIDATED_CALL0R(Transform, affine_inverse, Transform);
+	VALIDATED_CALL0R(Transform, orthonormalized, Transform);
+	VALIDATED_CALL2R(Transform, rotated, Transform, Vector3, double);
+	VALIDATED_CALL1R(Transform, scaled, Transform, Vector3);
+	VALIDATED_CALL1R(Transform, translated, Transform, Vector3);
+	VALIDATED_CALL2R(Transform, looking_at, Transform, Vector3, Vector3);
+	VALIDATED_CALL2R(Transform, interpolate_with, Transform, Transform, double);
+	VALIDATED_CALL1R(Transform, xform, Vector3, Vector3);
+	VALIDATED_CALL1R(Transform, xform_inv, Vector3, Vector3);
+
 	struct ConstructData {
 		int arg_count;
 		Vector<Variant::Type> arg_types;
@@ -1197,6 +1358,7 @@ struct _VariantCall {
 };
 
 _VariantCall::TypeFunc *_VariantCall::type_funcs = nullptr;
+Vector<_VariantCall::ValidatedFuncData> *_VariantCall::validated_funcs = nullptr;
 _VariantCall::ConstructFunc *_VariantCall::construct_funcs = nullptr;
 _VariantCall::ConstantData *_VariantCall::constant_data = nullptr;
 
@@ -1515,6 +1677,29 @@ bool Variant::is_method_const(Variant::Type p_type, const StringName &p_method)
 	return E->get()._const;
 }
 
+Variant::ValidatedBuiltInMethod Variant::get_validated_builtin_method(Variant::Type p_type, const StringName &p_method, const Variant::Type *p_argument_types, int p_argument_count) {
+	ERR_FAIL_INDEX_V(p_type, VARIANT_MAX, nullptr);
+
+	const Vector<_VariantCall::ValidatedFuncData> &funcs = _VariantCall::validated_funcs[p_type];
+	for (int i = 0; i < funcs.size(); i++) {
+		const _VariantCall::ValidatedFuncData &funcdata = funcs[i];
+		if (funcdata.name != p_method || funcdata.arg_count != p_argument_count) {
+			continue;
+		}
+		bool match = true;
+		for (int j = 0; j < p_argument_count; j++) {
+			if (funcdata.arg_types[j] != p_argument_types[j]) {
+				match = false;
+				break;
+			}
+		}
+		if (match) {
+			return funcdata.func;
+		}
+	}
+	return nullptr;
+}
+
 Vector<StringName> Variant::get_method_argument_names(Variant::Type p_type, const StringName &p_method) {
 	const _VariantCall::TypeFunc &tf = _VariantCall::type_funcs[p_type];
 
@@ -1709,6 +1894,7 @@ Variant Variant::get_constant_value(Variant::Type p_type, const StringName &p_va
 
 void register_variant_methods() {
 	_VariantCall::type_funcs = memnew_arr(_VariantCall::TypeFunc, Variant::VARIANT_MAX);
+	_VariantCall::validated_funcs = memnew_arr(Vector<_VariantCall::ValidatedFuncData>, Variant::VARIANT_MAX);
 
 	_VariantCall::construct_funcs = memnew_arr(_VariantCall::ConstructFunc, Variant::VARIANT_MAX);
 	_VariantCall::constant_data = memnew_arr(_VariantCall::ConstantData, Variant::VARIANT_MAX);
@@ -2365,10 +2551,119 @@ void register_variant_methods() {
 	_VariantCall::add_variant_constant(Variant::PLANE, "PLANE_XY", Plane(Vector3(0, 0, 1), 0));
 
 	_VariantCall::add_variant_constant(Variant::QUAT, "IDENTITY", Quat(0, 0, 0, 1));
+
+#define ADDVALIDATED(m_class, m_method) _VariantCall::Validated_##m_class##_##m_method::bind()
+
+	ADDVALIDATED(Vector2, angle);
+	ADDVALIDATED(Vector2, angle_to);
+	ADDVALIDATED(Vector2, angle_to_point);
+	ADDVALIDATED(Vector2, direction_to);
+	ADDVALIDATED(Vector2, distance_to);
+	ADDVALIDATED(Vector2, distance_squared_to);
+	ADDVALIDATED(Vector2, length);
+	ADDVALIDATED(Vector2, length_squared);
+	ADDVALIDATED(Vector2, normalized);
+	ADDVALIDATED(Vector2, is_normalized);
+	ADDVALIDATED(Vector2, project);
+	ADDVALIDATED(Vector2, lerp);
+	ADDVALIDATED(Vector2, slerp);
+	ADDVALIDATED(Vector2, move_toward);
+	ADDVALIDATED(Vector2, rotated);
+	ADDVALIDATED(Vector2, tangent);
+	ADDVALIDATED(Vector2, floor);
+	ADDVALIDATED(Vector2, ceil);
+	ADDVALIDATED(Vector2, round);
+	ADDVALIDATED(Vector2, dot);
+	ADDVALIDATED(Vector2, cross);
+	ADDVALIDATED(Vector2, slide);
+	ADDVALIDATED(Vector2, bounce);
+	ADDVALIDATED(Vector2, reflect);
+	ADDVALIDATED(Vector2, abs);
+	ADDVALIDATED(Vector2, clamped);
+	ADDVALIDATED(Vector2, sign);
+
+	ADDVALIDATED(Vector3, angle_to);
+	ADDVALIDATED(Vector3, direction_to);
+	ADDVALIDATED(Vector3, distance_to);
+	ADDVALIDATED(Vector3, distance_squared_to);
+	ADDVALIDATED(Vector3, length);
+	ADDVALIDATED(Vector3, length_squared);
+	ADDVALIDATED(Vector3, normalized);
+	ADDVALIDATED(Vector3, is_normalized);
+	ADDVALIDATED(Vector3, rotated);
+	ADDVALIDATED(Vector3, lerp);
+	ADDVALIDATED(Vector3, slerp);
+	ADDVALIDATED(Vector3, move_toward);
+	ADDVALIDATED(Vector3, dot);
+	ADDVALIDATED(Vector3, cross);
+	ADDVALIDATED(Vector3, abs);
+	ADDVALIDATED(Vector3, floor);
+	ADDVALIDATED(Vector3, ceil);
+	ADDVALIDATED(Vector3, round);
+	ADDVALIDATED(Vector3, project);
+	ADDVALIDATED(Vector3, slide);
+	ADDVALIDATED(Vector3, bounce);
+	ADDVALIDATED(Vector3, reflect);
+	ADDVALIDATED(Vector3, sign);
+
+	ADDVALIDATED(Quat, length);
+	ADDVALIDATED(Quat, length_squared);
+	ADDVALIDATED(Quat, normalized);
+	ADDVALIDATED(Quat, inverse);
+	ADDVALIDATED(Quat, dot);
+	ADDVALIDATED(Quat, xform);
+	ADDVALIDATED(Quat, slerp);
+	ADDVALIDATED(Quat, get_euler);
+
+	ADDVALIDATED(Color, lerp);
+	ADDVALIDATED(Color, blend);
+	ADDVALIDATED(Color, lightened);
+	ADDVALIDATED(Color, darkened);
+	ADDVALIDATED(Color, inverted);
+	ADDVALIDATED(Color, contrasted);
+
+	ADDVALIDATED(Transform2D, inverse);
+	ADDVALIDATED(Transform2D, affine_inverse);
+	ADDVALIDATED(Transform2D, get_rotation);
+	ADDVALIDATED(Transform2D, get_origin);
+	ADDVALIDATED(Transform2D, get_scale);
+	ADDVALIDATED(Transform2D, rotated);
+	ADDVALIDATED(Transform2D, scaled);
+	ADDVALIDATED(Transform2D, translated);
+	ADDVALIDATED(Transform2D, xform);
+	ADDVALIDATED(Transform2D, xform_inv);
+	ADDVALIDATED(Transform2D, basis_xform);
+	ADDVALIDATED(Transform2D, basis_xform_inv);
+	ADDVALIDATED(Transform2D, interpolate_with);
+
+	ADDVALIDATED(Basis, inverse);
+	ADDVALIDATED(Basis, transposed);
+	ADDVALIDATED(Basis, orthonormalized);
+	ADDVALIDATED(Basis, determinant);
+	ADDVALIDATED(Basis, rotated);
+	ADDVALIDATED(Basis, scaled);
+	ADDVALIDATED(Basis, get_scale);
+	ADDVALIDATED(Basis, get_euler);
+	ADDVALIDATED(Basis, xform);
+	ADDVALIDATED(Basis, xform_inv);
+	ADDVALIDATED(Basis, slerp);
+	ADDVALIDATED(Basis, get_rotation_quat);
+
+	ADDVALIDATED(Transform, inverse);
+	ADDVALIDATED(Transform, affine_inverse);
+	ADDVALIDATED(Transform, orthonormalized);
+	ADDVALIDATED(Transform, rotated);
+	ADDVALIDATED(Transform, scaled);
+	ADDVALIDATED(Transform, translated);
+	ADDVALIDATED(Transform, looking_at);
+	ADDVALIDATED(Transform, interpolate_with);
+	ADDVALIDATED(Transform, xform);
+	ADDVALIDATED(Transform, xform_inv);
 }
 
 void unregister_variant_methods() {
 	memdelete_arr(_VariantCall::type_funcs);
+	memdelete_arr(_VariantCall::validated_funcs);
 	memdelete_arr(_VariantCall::construct_funcs);
 	memdelete_arr(_VariantCall::constant_data);
 }
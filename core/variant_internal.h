@@ -0,0 +1,136 @@
+/*************************************************************************/
+/*  variant_internal.h                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef VARIANT_INTERNAL_H
+#define VARIANT_INTERNAL_H
+
+#include "core/type_info.h"
+#include "core/variant.h"
+
+// Direct access to the value stored in a Variant, for code that already
+// checked its type (operator evaluators, validated builtin methods, validated
+// indexed access).
+
+struct _VariantOp {
+	template <class T>
+	static _FORCE_INLINE_ const T &get(const Variant *p_v) {
+		return *reinterpret_cast<const T *>(p_v->_data._mem);
+	}
+
+	template <class T>
+	static _FORCE_INLINE_ T &get_mut(Variant *p_v) {
+		return *reinterpret_cast<T *>(p_v->_data._mem);
+	}
+
+	// Overwrite in place when the destination already holds the result type.
+	template <class T>
+	static _FORCE_INLINE_ void set(Variant *r_ret, const T &p_value) {
+		if (r_ret->type == GetTypeInfo<T>::VARIANT_TYPE) {
+			get_mut<T>(r_ret) = p_value;
+		} else {
+			*r_ret = p_value;
+		}
+	}
+
+	template <class T>
+	static _FORCE_INLINE_ const Vector<T> &get_packed_array(const Variant *p_v) {
+		return Variant::PackedArrayRef<T>::get_array(p_v->_data.packed_array);
+	}
+
+	template <class T>
+	static _FORCE_INLINE_ Vector<T> &get_packed_array_mut(Variant *p_v) {
+		return *Variant::PackedArrayRef<T>::get_array_ptr(p_v->_data.packed_array);
+	}
+
+	// Same for every Variant holding the same packed array.
+	static _FORCE_INLINE_ const void *get_packed_array_id(const Variant *p_v) {
+		return p_v->_data.packed_array;
+	}
+};
+
+template <>
+_FORCE_INLINE_ const bool &_VariantOp::get<bool>(const Variant *p_v) {
+	return p_v->_data._bool;
+}
+template <>
+_FORCE_INLINE_ const int64_t &_VariantOp::get<int64_t>(const Variant *p_v) {
+	return p_v->_data._int;
+}
+template <>
+_FORCE_INLINE_ const double &_VariantOp::get<double>(const Variant *p_v) {
+	return p_v->_data._float;
+}
+template <>
+_FORCE_INLINE_ bool &_VariantOp::get_mut<bool>(Variant *p_v) {
+	return p_v->_data._bool;
+}
+template <>
+_FORCE_INLINE_ int64_t &_VariantOp::get_mut<int64_t>(Variant *p_v) {
+	return p_v->_data._int;
+}
+template <>
+_FORCE_INLINE_ double &_VariantOp::get_mut<double>(Variant *p_v) {
+	return p_v->_data._float;
+}
+
+template <>
+_FORCE_INLINE_ const Transform2D &_VariantOp::get<Transform2D>(const Variant *p_v) {
+	return *p_v->_data._transform2d;
+}
+template <>
+_FORCE_INLINE_ const ::AABB &_VariantOp::get<::AABB>(const Variant *p_v) {
+	return *p_v->_data._aabb;
+}
+template <>
+_FORCE_INLINE_ const Basis &_VariantOp::get<Basis>(const Variant *p_v) {
+	return *p_v->_data._basis;
+}
+template <>
+_FORCE_INLINE_ const Transform &_VariantOp::get<Transform>(const Variant *p_v) {
+	return *p_v->_data._transform;
+}
+template <>
+_FORCE_INLINE_ Transform2D &_VariantOp::get_mut<Transform2D>(Variant *p_v) {
+	return *p_v->_data._transform2d;
+}
+template <>
+_FORCE_INLINE_ ::AABB &_VariantOp::get_mut<::AABB>(Variant *p_v) {
+	return *p_v->_data._aabb;
+}
+template <>
+_FORCE_INLINE_ Basis &_VariantOp::get_mut<Basis>(Variant *p_v) {
+	return *p_v->_data._basis;
+}
+template <>
+_FORCE_INLINE_ Transform &_VariantOp::get_mut<Transform>(Variant *p_v) {
+	return *p_v->_data._transform;
+}
+
+#endif // VARIANT_INTERNAL_H
@@ -33,6 +33,7 @@
 #include "core/core_string_names.h"
 #include "core/debugger/engine_debugger.h"
 #include "core/object.h"
+#include "core/variant_internal.h"
 
 #define CASE_TYPE_ALL(PREFIX, OP) \
 	CASE_TYPE(PREFIX, OP, INT)    \
@@ -458,7 +459,7 @@ bool Variant::booleanize() const {
 		_RETURN(sum);                                                                              \
 	}
 
-void Variant::evaluate(const Operator &p_op, const Variant &p_a,
+void Variant::_evaluate_generic(const Operator &p_op, const Variant &p_a,
 		const Variant &p_b, Variant &r_ret, bool &r_valid) {
 	CASES(math);
 	r_valid = true;
@@ -1417,6 +1418,270 @@ void Variant::evaluate(const Operator &p_op, const Variant &p_a,
 	}
 }
 
+/* Operator evaluators specialized by operand types */
+
+#define OPERATOR_EVALUATOR_BINARY(m_name, m_expr)                                                    \
+	template <class R, class A, class B>                                                             \
+	class OperatorEvaluator##m_name {                                                                \
+	public:                                                                                          \
+		static void validated(const Variant *p_a, const Variant *p_b, Variant *r_ret) {              \
+			const A &a = _VariantOp::get<A>(p_a);                                                    \
+			const B &b = _VariantOp::get<B>(p_b);                                                    \
+			_VariantOp::set<R>(r_ret, m_expr);                                                       \
+		}                                                                                            \
+		static void evaluate(const Variant &p_a, const Variant &p_b, Variant &r_ret, bool &r_valid) { \
+			validated(&p_a, &p_b, &r_ret);                                                           \
+			r_valid = true;                                                                          \
+		}                                                                                            \
+		static Variant::Type get_type_a() { return GetTypeInfo<A>::VARIANT_TYPE; }                   \
+		static Variant::Type get_type_b() { return GetTypeInfo<B>::VARIANT_TYPE; }                   \
+	};
+
+#define OPERATOR_EVALUATOR_UNARY(m_name, m_expr)                                                     \
+	template <class R, class A>                                                                      \
+	class OperatorEvaluator##m_name {                                                                \
+	public:                                                                                          \
+		static void validated(const Variant *p_a, const Variant *p_b, Variant *r_ret) {              \
+			const A &a = _VariantOp::get<A>(p_a);                                                    \
+			_VariantOp::set<R>(r_ret, m_expr);                                                       \
+		}                                                                                            \
+		static void evaluate(const Variant &p_a, const Variant &p_b, Variant &r_ret, bool &r_valid) { \
+			validated(&p_a, &p_b, &r_ret);                                                           \
+			r_valid = true;                                                                          \
+		}                                                                                            \
+		static Variant::Type get_type_a() { return GetTypeInfo<A>::VARIANT_TYPE; }                   \
+	};
+
+// These mirror _evaluate_generic() exactly, including the operand order used there.
+OPERATOR_EVALUATOR_BINARY(Equal, a == b)
+OPERATOR_EVALUATOR_BINARY(NotEqual, a != b)
+OPERATOR_EVALUATOR_BINARY(Less, a < b)
+OPERATOR_EVALUATOR_BINARY(LessEqual, a <= b)
+OPERATOR_EVALUATOR_BINARY(Greater, b < a)
+OPERATOR_EVALUATOR_BINARY(GreaterEqual, b <= a)
+OPERATOR_EVALUATOR_BINARY(Add, a + b)
+OPERATOR_EVALUATOR_BINARY(Subtract, a - b)
+OPERATOR_EVALUATOR_BINARY(Multiply, a * b)
+OPERATOR_EVALUATOR_BINARY(Divide, a / b)
+OPERATOR_EVALUATOR_BINARY(BitAnd, a & b)
+OPERATOR_EVALUATOR_BINARY(BitOr, a | b)
+OPERATOR_EVALUATOR_BINARY(BitXor, a ^ b)
+OPERATOR_EVALUATOR_BINARY(And, a && b)
+OPERATOR_EVALUATOR_BINARY(Or, a || b)
+OPERATOR_EVALUATOR_BINARY(Xor, a != b)
+OPERATOR_EVALUATOR_UNARY(Negate, -a)
+OPERATOR_EVALUATOR_UNARY(Positive, a)
+OPERATOR_EVALUATOR_UNARY(BitNegate, ~a)
+OPERATOR_EVALUATOR_UNARY(Not, !a)
+
+// Operators that can fail at runtime only get a plain evaluator.
+
+template <class R, class A, class B>
+class OperatorEvaluatorDivideNum {
+public:
+	static void evaluate(const Variant &p_a, const Variant &p_b, Variant &r_ret, bool &r_valid) {
+		const B &b = _VariantOp::get<B>(&p_b);
+#ifdef DEBUG_ENABLED
+		if (b == 0) {
+			r_valid = false;
+			r_ret = "Division By Zero";
+			return;
+		}
+#endif
+		_VariantOp::set<R>(&r_ret, _VariantOp::get<A>(&p_a) / b);
+		r_valid = true;
+	}
+	static Variant::Type get_type_a() { return GetTypeInfo<A>::VARIANT_TYPE; }
+	static Variant::Type get_type_b() { return GetTypeInfo<B>::VARIANT_TYPE; }
+};
+
+class OperatorEvaluatorModuleInt {
+public:
+	static void evaluate(const Variant &p_a, const Variant &p_b, Variant &r_ret, bool &r_valid) {
+		const int64_t &b = _VariantOp::get<int64_t>(&p_b);
+#ifdef DEBUG_ENABLED
+		if (b == 0) {
+			r_valid = false;
+			r_ret = "Division By Zero";
+			return;
+		}
+#endif
+		_VariantOp::set<int64_t>(&r_ret, _VariantOp::get<int64_t>(&p_a) % b);
+		r_valid = true;
+	}
+	static Variant::Type get_type_a() { return Variant::INT; }
+	static Variant::Type get_type_b() { return Variant::INT; }
+};
+
+template <bool LEFT>
+class OperatorEvaluatorShiftInt {
+public:
+	static void evaluate(const Variant &p_a, const Variant &p_b, Variant &r_ret, bool &r_valid) {
+		const int64_t &b = _VariantOp::get<int64_t>(&p_b);
+		if (b < 0 || b >= 64) {
+			r_valid = false;
+			return;
+		}
+		const int64_t &a = _VariantOp::get<int64_t>(&p_a);
+		_VariantOp::set<int64_t>(&r_ret, LEFT ? a << b : a >> b);
+		r_valid = true;
+	}
+	static Variant::Type get_type_a() { return Variant::INT; }
+	static Variant::Type get_type_b() { return Variant::INT; }
+};
+
+static Variant::OperatorEvaluator operator_evaluator_table[Variant::OP_MAX][Variant::VARIANT_MAX][Variant::VARIANT_MAX];
+static Variant::ValidatedOperatorEvaluator validated_operator_evaluator_table[Variant::OP_MAX][Variant::VARIANT_MAX][Variant::VARIANT_MAX];
+
+template <class T>
+static void register_op(Variant::Operator p_op) {
+	operator_evaluator_table[p_op][T::get_type_a()][T::get_type_b()] = T::evaluate;
+	validated_operator_evaluator_table[p_op][T::get_type_a()][T::get_type_b()] = T::validated;
+}
+
+template <class T>
+static void register_checked_op(Variant::Operator p_op) {
+	operator_evaluator_table[p_op][T::get_type_a()][T::get_type_b()] = T::evaluate;
+}
+
+// The second operand of unary operators is ignored, whatever its type.
+template <class T>
+static void register_unary_op(Variant::Operator p_op) {
+	for (int i = 0; i < Variant::VARIANT_MAX; i++) {
+		operator_evaluator_table[p_op][T::get_type_a()][i] = T::evaluate;
+		validated_operator_evaluator_table[p_op][T::get_type_a()][i] = T::validated;
+	}
+}
+
+template <class A, class B>
+static void register_equality_ops() {
+	register_op<OperatorEvaluatorEqual<bool, A, B>>(Variant::OP_EQUAL);
+	register_op<OperatorEvaluatorNotEqual<bool, A, B>>(Variant::OP_NOT_EQUAL);
+}
+
+template <class A, class B>
+static void register_comparison_ops() {
+	register_equality_ops<A, B>();
+	register_op<OperatorEvaluatorLess<bool, A, B>>(Variant::OP_LESS);
+	register_op<OperatorEvaluatorLessEqual<bool, A, B>>(Variant::OP_LESS_EQUAL);
+	register_op<OperatorEvaluatorGreater<bool, A, B>>(Variant::OP_GREATER);
+	register_op<OperatorEvaluatorGreaterEqual<bool, A, B>>(Variant::OP_GREATER_EQUAL);
+}
+
+template <class R, class A, class B>
+static void register_number_ops() {
+	register_comparison_ops<A, B>();
+	register_op<OperatorEvaluatorAdd<R, A, B>>(Variant::OP_ADD);
+	register_op<OperatorEvaluatorSubtract<R, A, B>>(Variant::OP_SUBTRACT);
+	register_op<OperatorEvaluatorMultiply<R, A, B>>(Variant::OP_MULTIPLY);
+	register_checked_op<OperatorEvaluatorDivideNum<R, A, B>>(Variant::OP_DIVIDE);
+}
+
+template <class T>
+static void register_vector_ops(bool p_divide) {
+	register_op<OperatorEvaluatorAdd<T, T, T>>(Variant::OP_ADD);
+	register_op<OperatorEvaluatorSubtract<T, T, T>>(Variant::OP_SUBTRACT);
+	register_op<OperatorEvaluatorMultiply<T, T, T>>(Variant::OP_MULTIPLY);
+	register_op<OperatorEvaluatorMultiply<T, T, int64_t>>(Variant::OP_MULTIPLY);
+	register_op<OperatorEvaluatorMultiply<T, T, double>>(Variant::OP_MULTIPLY);
+	if (p_divide) {
+		register_op<OperatorEvaluatorDivide<T, T, T>>(Variant::OP_DIVIDE);
+		register_op<OperatorEvaluatorDivide<T, T, int64_t>>(Variant::OP_DIVIDE);
+		register_op<OperatorEvaluatorDivide<T, T, double>>(Variant::OP_DIVIDE);
+	}
+	register_unary_op<OperatorEvaluatorNegate<T, T>>(Variant::OP_NEGATE);
+}
+
+void register_variant_operators() {
+	register_number_ops<int64_t, int64_t, int64_t>();
+	register_number_ops<double, int64_t, double>();
+	register_number_ops<double, double, int64_t>();
+	register_number_ops<double, double, double>();
+	register_checked_op<OperatorEvaluatorModuleInt>(Variant::OP_MODULE);
+	register_checked_op<OperatorEvaluatorShiftInt<true>>(Variant::OP_SHIFT_LEFT);
+	register_checked_op<OperatorEvaluatorShiftInt<false>>(Variant::OP_SHIFT_RIGHT);
+	register_op<OperatorEvaluatorBitAnd<int64_t, int64_t, int64_t>>(Variant::OP_BIT_AND);
+	register_op<OperatorEvaluatorBitOr<int64_t, int64_t, int64_t>>(Variant::OP_BIT_OR);
+	register_op<OperatorEvaluatorBitXor<int64_t, int64_t, int64_t>>(Variant::OP_BIT_XOR);
+	register_unary_op<OperatorEvaluatorBitNegate<int64_t, int64_t>>(Variant::OP_BIT_NEGATE);
+	register_unary_op<OperatorEvaluatorNegate<int64_t, int64_t>>(Variant::OP_NEGATE);
+	register_unary_op<OperatorEvaluatorNegate<double, double>>(Variant::OP_NEGATE);
+	register_unary_op<OperatorEvaluatorPositive<int64_t, int64_t>>(Variant::OP_POSITIVE);
+	register_unary_op<OperatorEvaluatorPositive<double, double>>(Variant::OP_POSITIVE);
+
+	register_equality_ops<bool, bool>();
+	register_op<OperatorEvaluatorLess<bool, bool, bool>>(Variant::OP_LESS);
+	register_op<OperatorEvaluatorGreater<bool, bool, bool>>(Variant::OP_GREATER);
+	register_op<OperatorEvaluatorAnd<bool, bool, bool>>(Variant::OP_AND);
+	register_op<OperatorEvaluatorOr<bool, bool, bool>>(Variant::OP_OR);
+	register_op<OperatorEvaluatorXor<bool, bool, bool>>(Variant::OP_XOR);
+	register_unary_op<OperatorEvaluatorNot<bool, bool>>(Variant::OP_NOT);
+
+	register_comparison_ops<String, String>();
+	register_op<OperatorEvaluatorAdd<String, String, String>>(Variant::OP_ADD);
+	register_equality_ops<StringName, StringName>();
+
+	// Integer vectors can't divide by zero safely, and mixed scalar * vector
+	// products are only specialized where _evaluate_generic() handles them correctly.
+	register_vector_ops<Vector2>(true);
+	register_vector_ops<Vector3>(true);
+	register_vector_ops<Vector2i>(false);
+	register_vector_ops<Vector3i>(false);
+	register_comparison_ops<Vector2, Vector2>();
+	register_comparison_ops<Vector3, Vector3>();
+	register_comparison_ops<Vector2i, Vector2i>();
+	register_comparison_ops<Vector3i, Vector3i>();
+	register_op<OperatorEvaluatorMultiply<Vector2, int64_t, Vector2>>(Variant::OP_MULTIPLY);
+	register_op<OperatorEvaluatorMultiply<Vector2, double, Vector2>>(Variant::OP_MULTIPLY);
+	register_op<OperatorEvaluatorMultiply<Vector3, int64_t, Vector3>>(Variant::OP_MULTIPLY);
+	register_op<OperatorEvaluatorMultiply<Vector3, double, Vector3>>(Variant::OP_MULTIPLY);
+	register_unary_op<OperatorEvaluatorPositive<Vector2, Vector2>>(Variant::OP_POSITIVE);
+	register_unary_op<OperatorEvaluatorPositive<Vector3, Vector3>>(Variant::OP_POSITIVE);
+	register_unary_op<OperatorEvaluatorPositive<Vector2i, Vector2i>>(Variant::OP_POSITIVE);
+	register_unary_op<OperatorEvaluatorPositive<Vector3i, Vector3i>>(Variant::OP_POSITIVE);
+
+	register_equality_ops<Rect2, Rect2>();
+	register_equality_ops<Rect2i, Rect2i>();
+	register_equality_ops<Plane, Plane>();
+	register_unary_op<OperatorEvaluatorNegate<Plane, Plane>>(Variant::OP_NEGATE);
+	register_unary_op<OperatorEvaluatorPositive<Plane, Plane>>(Variant::OP_POSITIVE);
+
+	register_equality_ops<Quat, Quat>();
+	register_op<OperatorEvaluatorAdd<Quat, Quat, Quat>>(Variant::OP_ADD);
+	register_op<OperatorEvaluatorSubtract<Quat, Quat, Quat>>(Variant::OP_SUBTRACT);
+	register_op<OperatorEvaluatorMultiply<Quat, Quat, Quat>>(Variant::OP_MULTIPLY);
+	register_op<OperatorEvaluatorMultiply<Quat, Quat, double>>(Variant::OP_MULTIPLY);
+	register_unary_op<OperatorEvaluatorNegate<Quat, Quat>>(Variant::OP_NEGATE);
+	register_unary_op<OperatorEvaluatorPositive<Quat, Quat>>(Variant::OP_POSITIVE);
+
+	register_equality_ops<Color, Color>();
+	register_vector_ops<Color>(true);
+}
+
+Variant::OperatorEvaluator Variant::get_operator_evaluator(Operator p_op, Type p_type_a, Type p_type_b) {
+	ERR_FAIL_INDEX_V(p_op, OP_MAX, nullptr);
+	ERR_FAIL_INDEX_V(p_type_a, VARIANT_MAX, nullptr);
+	ERR_FAIL_INDEX_V(p_type_b, VARIANT_MAX, nullptr);
+	return operator_evaluator_table[p_op][p_type_a][p_type_b];
+}
+
+Variant::ValidatedOperatorEvaluator Variant::get_validated_operator_evaluator(Operator p_op, Type p_type_a, Type p_type_b) {
+	ERR_FAIL_INDEX_V(p_op, OP_MAX, nullptr);
+	ERR_FAIL_INDEX_V(p_type_a, VARIANT_MAX, nullptr);
+	ERR_FAIL_INDEX_V(p_type_b, VARIANT_MAX, nullptr);
+	return validated_operator_evaluator_table[p_op][p_type_a][p_type_b];
+}
+
+void Variant::evaluate(const Operator &p_op, const Variant &p_a, const Variant &p_b, Variant &r_ret, bool &r_valid) {
+	OperatorEvaluator evaluator = operator_evaluator_table[p_op][p_a.type][p_b.type];
+	if (evaluator) {
+		evaluator(p_a, p_b, r_ret, r_valid);
+		return;
+	}
+
+	_evaluate_generic(p_op, p_a, p_b, r_ret, r_valid);
+}
+
 void Variant::set_named(const StringName &p_index, const Variant &p_value, bool *r_valid) {
 	bool valid = false;
 	switch (type) {
@@ -3034,6 +3299,104 @@ Variant Variant::get(const Variant &p_index, bool *r_valid) const {
 	return Variant();
 }
 
+// T is the element type of the packed array, S how elements are stored in a
+// Variant (e.g. int32_t elements are stored as int64_t).
+template <class T, class S>
+struct _PackedArrayIndexed {
+	static void get(const Variant *p_base, int64_t p_index, Variant *r_value, bool *r_oob) {
+		const Vector<T> &arr = _VariantOp::get_packed_array<T>(p_base);
+		int64_t size = arr.size();
+		if (p_index < 0) {
+			p_index += size;
+		}
+		if (p_index < 0 || p_index >= size) {
+			*r_oob = true;
+			return;
+		}
+		*r_oob = false;
+		_VariantOp::set<S>(r_value, S(arr.ptr()[p_index]));
+	}
+
+	// V is the type of the value being stored.
+	template <class V>
+	static void set(Variant *p_base, int64_t p_index, const Variant *p_value, bool *r_oob) {
+		Vector<T> &arr = _VariantOp::get_packed_array_mut<T>(p_base);
+		int64_t size = arr.size();
+		if (p_index < 0) {
+			p_index += size;
+		}
+		if (p_index < 0 || p_index >= size) {
+			*r_oob = true;
+			return;
+		}
+		*r_oob = false;
+		// Only copies the array if it's shared, so writing a whole array in a loop
+		// copies it at most once.
+		arr.ptrw()[p_index] = T(_VariantOp::get<V>(p_value));
+	}
+};
+
+Variant::ValidatedIndexedGetter Variant::get_validated_indexed_getter(Type p_type) {
+	switch (p_type) {
+		case PACKED_BYTE_ARRAY:
+			return _PackedArrayIndexed<uint8_t, int64_t>::get;
+		case PACKED_INT32_ARRAY:
+			return _PackedArrayIndexed<int32_t, int64_t>::get;
+		case PACKED_INT64_ARRAY:
+			return _PackedArrayIndexed<int64_t, int64_t>::get;
+		case PACKED_FLOAT32_ARRAY:
+			return _PackedArrayIndexed<float, double>::get;
+		case PACKED_FLOAT64_ARRAY:
+			return _PackedArrayIndexed<double, double>::get;
+		case PACKED_STRING_ARRAY:
+			return _PackedArrayIndexed<String, String>::get;
+		case PACKED_VECTOR2_ARRAY:
+			return _PackedArrayIndexed<Vector2, Vector2>::get;
+		case PACKED_VECTOR3_ARRAY:
+			return _PackedArrayIndexed<Vector3, Vector3>::get;
+		case PACKED_COLOR_ARRAY:
+			return _PackedArrayIndexed<Color, Color>::get;
+		default:
+			return nullptr;
+	}
+}
+
+#define INDEXED_SET_NUMBER(m_name, m_type, m_storage)                    \
+	case m_name: {                                                       \
+		if (p_value_type == INT) {                                       \
+			return _PackedArrayIndexed<m_type, m_storage>::set<int64_t>; \
+		} else if (p_value_type == FLOAT) {                              \
+			return _PackedArrayIndexed<m_type, m_storage>::set<double>;  \
+		}                                                                \
+	} break;
+
+#define INDEXED_SET_TYPED(m_name, m_variant_type, m_type)            \
+	case m_name: {                                                   \
+		if (p_value_type == m_variant_type) {                        \
+			return _PackedArrayIndexed<m_type, m_type>::set<m_type>; \
+		}                                                            \
+	} break;
+
+Variant::ValidatedIndexedSetter Variant::get_validated_indexed_setter(Type p_type, Type p_value_type) {
+	switch (p_type) {
+		INDEXED_SET_NUMBER(PACKED_BYTE_ARRAY, uint8_t, int64_t)
+		INDEXED_SET_NUMBER(PACKED_INT32_ARRAY, int32_t, int64_t)
+		INDEXED_SET_NUMBER(PACKED_INT64_ARRAY, int64_t, int64_t)
+		INDEXED_SET_NUMBER(PACKED_FLOAT32_ARRAY, float, double)
+		INDEXED_SET_NUMBER(PACKED_FLOAT64_ARRAY, double, double)
+		INDEXED_SET_TYPED(PACKED_STRING_ARRAY, STRING, String)
+		INDEXED_SET_TYPED(PACKED_VECTOR2_ARRAY, VECTOR2, Vector2)
+		INDEXED_SET_TYPED(PACKED_VECTOR3_ARRAY, VECTOR3, Vector3)
+		INDEXED_SET_TYPED(PACKED_COLOR_ARRAY, COLOR, Color)
+		default: {
+		}
+	}
+	return nullptr;
+}
+
+#undef INDEXED_SET_NUMBER
+#undef INDEXED_SET_TYPED
+
 bool Variant::in(const Variant &p_index, bool *r_valid) const {
 	if (r_valid) {
 		*r_valid = true;
@@ -32,6 +32,7 @@
 
 #include "core/debugger/debugger_marshalls.h"
 #include "core/debugger/remote_debugger.h"
+#include "core/debugger/sampling_profiler.h"
 #include "core/io/marshalls.h"
 #include "core/project_settings.h"
 #include "core/ustring.h"
@@ -188,6 +189,9 @@ void ScriptEditorDebugger::_file_selected(const String &p_file) {
 				file->store_csv_line(profiler_data[i]);
 			}
 		} break;
+		case SAVE_SAMPLED_STACKS: {
+			SamplingProfiler::save_folded_stacks(sampled_stacks, p_file);
+		} break;
 		case SAVE_VRAM_CSV: {
 			Error err;
 			FileAccessRef file = FileAccess::open(p_file, FileAccess::WRITE, &err);
@@ -700,6 +704,25 @@ void ScriptEditorDebugger::_parse_message(const String &p_msg, const Array &p_da
 		ERR_FAIL_COND(p_data.size() < 2);
 		network_profiler->set_bandwidth(p_data[0], p_data[1]);
 
+	} else if (p_msg == "sampling:profile_frame") {
+		ERR_FAIL_COND(p_data.size() < 4);
+		PackedStringArray stacks = p_data[2];
+		PackedInt32Array counts = p_data[3];
+		ERR_FAIL_COND(stacks.size() != counts.size());
+		for (int i = 0; i < stacks.size(); i++) {
+			Map<String, int>::Element *E = sampled_stacks.find(stacks[i]);
+			if (E) {
+				E->get() += counts[i];
+			} else {
+				sampled_stacks.insert(stacks[i], counts[i]);
+			}
+		}
+
+	} else if (p_msg == "sampling:start_failed") {
+		ERR_FAIL_COND(p_data.size() < 1);
+		EditorNode::get_log()->add_message(vformat(TTR("The running project could not start sampling call stacks (error %d)."), (int)p_data[0]), EditorLog::MSG_TYPE_ERROR);
+		sampling_toggle->set_pressed(false);
+
 	} else if (p_msg == "request_quit") {
 		emit_signal("stop_requested");
 		_stop_and_notify();
@@ -941,6 +964,7 @@ void ScriptEditorDebugger::_update_buttons_state() {
 	dobreak->set_disabled(!active || breaked);
 	le_clear->set_disabled(!active);
 	le_set->set_disabled(!has_editor_tree);
+	sampling_toggle->set_disabled(!active);
 }
 
 void ScriptEditorDebugger::_stop_and_notify() {
@@ -968,6 +992,7 @@ void ScriptEditorDebugger::stop() {
 	node_path_cache.clear();
 	res_path_cache.clear();
 	profiler_signature.clear();
+	sampling_toggle->set_pressed(false);
 
 	inspector->edit(nullptr);
 	_update_buttons_state();
@@ -1028,6 +1053,22 @@ void ScriptEditorDebugger::_export_csv() {
 	file_dialog->popup_centered_ratio();
 }
 
+void ScriptEditorDebugger::_sampling_toggled(bool p_enable) {
+	if (p_enable) {
+		sampled_stacks.clear();
+	}
+	Array data;
+	data.push_back(p_enable);
+	_put_msg("profiler:sampling", data);
+}
+
+void ScriptEditorDebugger::_export_sampled_stacks() {
+	file_dialog->set_file_mode(EditorFileDialog::FILE_MODE_SAVE_FILE);
+	file_dialog->set_access(EditorFileDialog::ACCESS_FILESYSTEM);
+	file_dialog_purpose = SAVE_SAMPLED_STACKS;
+	file_dialog->popup_centered_ratio();
+}
+
 String ScriptEditorDebugger::get_var_value(const String &p_var) const {
 	if (!breaked) {
 		return String();
@@ -1806,6 +1847,17 @@ ScriptEditorDebugger::ScriptEditorDebugger(EditorNode *p_editor) {
 		export_csv->connect("pressed", callable_mp(this, &ScriptEditorDebugger::_export_csv));
 		buttons->add_child(export_csv);
 
+		sampling_toggle = memnew(Button(TTR("Sample Call Stacks")));
+		sampling_toggle->set_toggle_mode(true);
+		sampling_toggle->set_tooltip(TTR("Periodically sample the script and native call stacks of the running project."));
+		sampling_toggle->connect("toggled", callable_mp(this, &ScriptEditorDebugger::_sampling_toggled));
+		buttons->add_child(sampling_toggle);
+
+		sampling_export = memnew(Button(TTR("Export sampled stacks")));
+		sampling_export->set_tooltip(TTR("Save the sampled call stacks in the folded format used by flame graph tools."));
+		sampling_export->connect("pressed", callable_mp(this, &ScriptEditorDebugger::_export_sampled_stacks));
+		buttons->add_child(sampling_export);
+
 		misc->add_child(buttons);
 	}
 
@@ -80,6 +80,8 @@ private:
 	Button *le_set;
 	Button *le_clear;
 	Button *export_csv;
+	Button *sampling_toggle;
+	Button *sampling_export;
 
 	VBoxContainer *errors_tab;
 	Tree *error_tree;
@@ -90,6 +92,7 @@ private:
 	enum FileDialogPurpose {
 		SAVE_MONITORS_CSV,
 		SAVE_VRAM_CSV,
+		SAVE_SAMPLED_STACKS,
 	};
 	FileDialogPurpose file_dialog_purpose;
 
@@ -118,6 +121,7 @@ private:
 	Vector<TreeItem *> perf_items;
 
 	Map<int, String> profiler_signature;
+	Map<String, int> sampled_stacks;
 
 	Tree *perf_monitors;
 	Control *perf_draw;
@@ -194,6 +198,8 @@ private:
 
 	void _put_msg(String p_message, Array p_data);
 	void _export_csv();
+	void _sampling_toggled(bool p_enable);
+	void _export_sampled_stacks();
 
 	void _clear_execution();
 	void _stop_and_notify();
@@ -60,6 +60,9 @@ String ResourceImporterTextureAtlas::get_resource_type() const {
 }
 
 bool ResourceImporterTextureAtlas::get_option_visibility(const String &p_option, const Map<StringName, Variant> &p_options) const {
+	if (p_option == "trim_alpha_border_from_region" || p_option == "extrude_region_edges") {
+		return int(p_options["import_mode"]) == IMPORT_MODE_REGION;
+	}
 	return true;
 }
 
@@ -74,6 +77,8 @@ String ResourceImporterTextureAtlas::get_preset_name(int p_idx) const {
 void ResourceImporterTextureAtlas::get_import_options(List<ImportOption> *r_options, int p_preset) const {
 	r_options->push_back(ImportOption(PropertyInfo(Variant::STRING, "atlas_file", PROPERTY_HINT_SAVE_FILE, "*.png"), ""));
 	r_options->push_back(ImportOption(PropertyInfo(Variant::INT, "import_mode", PROPERTY_HINT_ENUM, "Region,Mesh2D"), 0));
+	r_options->push_back(ImportOption(PropertyInfo(Variant::BOOL, "trim_alpha_border_from_region"), true));
+	r_options->push_back(ImportOption(PropertyInfo(Variant::BOOL, "extrude_region_edges"), false));
 }
 
 String ResourceImporterTextureAtlas::get_option_group_file() const {
@@ -186,6 +191,43 @@ static void _plot_triangle(Vector2 *vertices, const Vector2 &p_offset, bool p_tr
 	}
 }
 
+// Copy the outermost pixels of a packed region one pixel outwards, so filtering
+// at the region edges samples the region itself instead of the empty atlas.
+// The packer always leaves at least one pixel of free space around each chart.
+static void _extrude_region(const Rect2i &p_region, Ref<Image> p_image) {
+	int width = p_image->get_width();
+	int height = p_image->get_height();
+
+	if (p_region.size.width <= 0 || p_region.size.height <= 0) {
+		return;
+	}
+
+	int from_x = p_region.position.x;
+	int from_y = p_region.position.y;
+	int to_x = p_region.position.x + p_region.size.width - 1;
+	int to_y = p_region.position.y + p_region.size.height - 1;
+
+	for (int y = from_y - 1; y <= to_y + 1; y++) {
+		if (y < 0 || y >= height) {
+			continue;
+		}
+		int sy = CLAMP(y, from_y, to_y);
+
+		for (int x = from_x - 1; x <= to_x + 1; x++) {
+			if (x < 0 || x >= width) {
+				continue;
+			}
+			if (x >= from_x && x <= to_x && y >= from_y && y <= to_y) {
+				x = to_x; //skip the inside of the region
+				continue;
+			}
+			int sx = CLAMP(x, from_x, to_x);
+
+			p_image->set_pixel(x, y, p_image->get_pixel(sx, sy));
+		}
+	}
+}
+
 Error ResourceImporterTextureAtlas::import_group_file(const String &p_group_file, const Map<String, Map<StringName, Variant>> &p_source_file_options, const Map<String, String> &p_base_paths) {
 	ERR_FAIL_COND_V(p_source_file_options.size() == 0, ERR_BUG); //should never happen
 
@@ -215,8 +257,9 @@ Error ResourceImporterTextureAtlas::import_group_file(const String &p_group_file
 			EditorAtlasPacker::Chart chart;
 
 			//clip a region from the image
-			Rect2 used_rect = image->get_used_rect();
+			Rect2 used_rect = bool(options["trim_alpha_border_from_region"]) ? image->get_used_rect() : Rect2(Vector2(), image->get_size());
 			pack_data.region = used_rect;
+			pack_data.extrude = options["extrude_region_edges"];
 
 			chart.vertices.push_back(used_rect.position);
 			chart.vertices.push_back(used_rect.position + Vector2(used_rect.size.x, 0));
@@ -238,6 +281,7 @@ Error ResourceImporterTextureAtlas::import_group_file(const String &p_group_file
 
 		} else {
 			pack_data.is_mesh = true;
+			pack_data.extrude = false;
 
 			Ref<BitMap> bit_map;
 			bit_map.instance();
@@ -290,6 +334,11 @@ Error ResourceImporterTextureAtlas::import_group_file(const String &p_group_file
 				_plot_triangle(positions, chart.final_offset, chart.transposed, new_atlas, pack_data.image);
 			}
 		}
+
+		if (pack_data.extrude) {
+			const EditorAtlasPacker::Chart &chart = charts[pack_data.chart_pieces[0]];
+			_extrude_region(Rect2i(chart.vertices[0] + chart.final_offset, pack_data.region.size), new_atlas);
+		}
 	}
 
 	//save the atlas
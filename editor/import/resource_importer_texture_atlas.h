@@ -39,6 +39,7 @@ class ResourceImporterTextureAtlas : public ResourceImporter {
 	struct PackData {
 		Rect2 region;
 		bool is_mesh;
+		bool extrude;
 		Vector<int> chart_pieces; //one for region, many for mesh
 		Vector<Vector<Vector2>> chart_vertices; //for mesh
 		Ref<Image> image;
@@ -32,6 +32,7 @@
 
 #include "core/crypto/crypto.h"
 #include "core/debugger/engine_debugger.h"
+#include "core/debugger/sampling_profiler.h"
 #include "core/input/input.h"
 #include "core/input/input_map.h"
 #include "core/io/file_access_network.h"
@@ -152,6 +153,8 @@ static bool force_lowdpi = false;
 // Debug
 
 static bool use_debug_profiler = false;
+static String sampling_profile_path;
+static Map<String, int> sampled_stacks;
 #ifdef DEBUG_ENABLED
 static bool debug_collisions = false;
 static bool debug_navigation = false;
@@ -326,6 +329,7 @@ void Main::print_help(const char *p_binary) {
 	OS::get_singleton()->print("  -d, --debug                      Debug (local stdout debugger).\n");
 	OS::get_singleton()->print("  -b, --breakpoints                Breakpoint list as source::line comma-separated pairs, no spaces (use %%20 instead).\n");
 	OS::get_singleton()->print("  --profiling                      Enable profiling in the script debugger.\n");
+	OS::get_singleton()->print("  --profile-sampling <file>        Sample script and native call stacks, and save them as folded stacks to <file> on exit.\n");
 	OS::get_singleton()->print("  --gpu-abort                      Abort on GPU errors (usually validation layer errors), may help see the problem if your system freezes.\n");
 	OS::get_singleton()->print("  --remote-debug <uri>             Remote debug (<protocol>://<host/IP>[:<port>], e.g. tcp://127.0.0.1:6007).\n");
 #if defined(DEBUG_ENABLED) && !defined(SERVER_ENABLED)
@@ -691,6 +695,15 @@ Error Main::setup(const char *execpath, int argc, char *argv[], bool p_second_ph
 
 			use_debug_profiler = true;
 
+		} else if (I->get() == "--profile-sampling") { // sample call stacks into a file
+
+			if (I->next()) {
+				sampling_profile_path = I->next()->get();
+				N = I->next()->next();
+			} else {
+				OS::get_singleton()->print("Missing sampling profile file argument, aborting.\n");
+				goto error;
+			}
 		} else if (I->get() == "-l" || I->get() == "--language") { // language
 
 			if (I->next()) {
@@ -1017,6 +1030,7 @@ Error Main::setup(const char *execpath, int argc, char *argv[], bool p_second_ph
 
 	// Assigning here even though it's GLES2-specific, to be sure that it appears in docs
 	GLOBAL_DEF("rendering/quality/2d/gles2_use_nvidia_rect_flicker_workaround", false);
+	GLOBAL_DEF("rendering/quality/2d/use_batching", true);
 
 	GLOBAL_DEF("display/window/size/width", 1024);
 	ProjectSettings::get_singleton()->set_custom_property_info("display/window/size/width", PropertyInfo(Variant::INT, "display/window/size/width", PROPERTY_HINT_RANGE, "0,7680,or_greater")); // 8K resolution
@@ -1505,6 +1519,10 @@ Error Main::setup2(Thread::ID p_main_tid_override) {
 		EngineDebugger::get_singleton()->profiler_enable("scripts", true);
 	}
 
+	if (sampling_profile_path != "") {
+		SamplingProfiler::start(1000);
+	}
+
 	if (!project_manager) {
 		// If not running the project manager, and now that the engine is
 		// able to load resources, load the global shader variables.
@@ -2230,6 +2248,10 @@ bool Main::iteration() {
 		EngineDebugger::get_singleton()->iteration(frame_time, idle_process_ticks, physics_process_ticks, frame_slice);
 	}
 
+	if (sampling_profile_path != "") {
+		SamplingProfiler::collect(sampled_stacks);
+	}
+
 	frames++;
 	Engine::get_singleton()->_idle_frames++;
 
@@ -2310,6 +2332,14 @@ void Main::cleanup() {
 
 	EngineDebugger::deinitialize();
 
+	if (sampling_profile_path != "") {
+		SamplingProfiler::stop();
+		SamplingProfiler::collect(sampled_stacks);
+		SamplingProfiler::save_folded_stacks(sampled_stacks, sampling_profile_path);
+		sampled_stacks.clear();
+	}
+	SamplingProfiler::cleanup();
+
 	ResourceLoader::remove_custom_loaders();
 	ResourceSaver::remove_custom_savers();
 
@@ -0,0 +1,325 @@
+/*************************************************************************/
+/*  test_canvas_batching.cpp                                             */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_canvas_batching.h"
+
+#include "core/os/os.h"
+#include "core/rid_owner.h"
+#include "servers/rendering/rasterizer_canvas_batcher.h"
+
+namespace TestCanvasBatching {
+
+typedef RasterizerCanvas::Item Item;
+typedef RasterizerCanvas::Light Light;
+typedef RasterizerCanvasBatcher::Batch Batch;
+
+enum {
+	TEXTURE_A = 1,
+	TEXTURE_B = 2
+};
+
+//items and materials built without a renderer, the batcher only needs their state
+struct Canvas {
+	RasterizerCanvasBatcher batcher;
+	RID_Owner<bool> materials; //whether the material has vertex code
+	LocalVector<Item *> items;
+	LocalVector<RasterizerCanvas::TextureBinding *> bindings;
+	LocalVector<RID> material_rids;
+
+	static Size2i _get_texture_binding_size(void *p_userdata, RasterizerCanvas::TextureBindingID p_binding) {
+		return p_binding ? Size2i(16, 16) : Size2i(1, 1);
+	}
+
+	static bool _material_uses_vertex(void *p_userdata, RID p_material) {
+		bool *uses_vertex = ((Canvas *)p_userdata)->materials.getornull(p_material);
+		return uses_vertex && *uses_vertex;
+	}
+
+	Item *add_item() {
+		Item *item = memnew(Item);
+		item->global_rect_cache = Rect2(0, 0, 64, 64);
+		items.push_back(item);
+		return item;
+	}
+
+	Item::CommandRect *add_rect(Item *p_item, RasterizerCanvas::TextureBindingID p_texture, uint8_t p_flags = 0) {
+		Item::CommandRect *rect = p_item->alloc_command<Item::CommandRect>();
+		rect->rect = Rect2(0, 0, 8, 8);
+		rect->modulate = Color(1, 1, 1, 1);
+		rect->specular_shininess = Color(1, 1, 1, 1);
+		rect->flags = p_flags;
+		rect->texture_binding.binding_id = p_texture;
+		bindings.push_back(&rect->texture_binding);
+		return rect;
+	}
+
+	Item::CommandNinePatch *add_nine_patch(Item *p_item, RasterizerCanvas::TextureBindingID p_texture, RS::NinePatchAxisMode p_axis) {
+		Item::CommandNinePatch *np = p_item->alloc_command<Item::CommandNinePatch>();
+		np->rect = Rect2(0, 0, 32, 32);
+		for (int i = 0; i < 4; i++) {
+			np->margin[i] = 4;
+		}
+		np->color = Color(1, 1, 1, 1);
+		np->axis_x = p_axis;
+		np->axis_y = p_axis;
+		np->specular_shininess = Color(1, 1, 1, 1);
+		np->texture_binding.binding_id = p_texture;
+		bindings.push_back(&np->texture_binding);
+		return np;
+	}
+
+	RID add_material(bool p_uses_vertex) {
+		RID material = materials.make_rid(p_uses_vertex);
+		material_rids.push_back(material);
+		return material;
+	}
+
+	const LocalVector<Batch> &plan(const Light *p_lights = nullptr, uint32_t p_max_vertices = 65536) {
+		batcher.setup(&Canvas::_get_texture_binding_size, &Canvas::_material_uses_vertex, this, p_max_vertices, 2);
+		batcher.plan(items.size() ? &items[0] : nullptr, items.size(), Transform2D(), p_lights);
+		return batcher.batches;
+	}
+
+	~Canvas() {
+		//the bindings were never requested from a renderer, don't free them
+		for (uint32_t i = 0; i < bindings.size(); i++) {
+			bindings[i]->binding_id = 0;
+		}
+		for (uint32_t i = 0; i < items.size(); i++) {
+			memdelete(items[i]);
+		}
+		for (uint32_t i = 0; i < material_rids.size(); i++) {
+			materials.free(material_rids[i]);
+		}
+	}
+};
+
+bool test_texture_change() {
+	Canvas canvas;
+	Item *item = canvas.add_item();
+	Item::CommandRect *first = canvas.add_rect(item, TEXTURE_A);
+	canvas.add_rect(item, TEXTURE_A);
+	Item::CommandRect *third = canvas.add_rect(item, TEXTURE_B);
+	canvas.add_rect(item, TEXTURE_B);
+
+	const LocalVector<Batch> &batches = canvas.plan();
+	if (batches.size() != 2) {
+		return false;
+	}
+
+	return batches[0].command == first && batches[0].command_count == 2 && batches[0].texture_binding == TEXTURE_A &&
+		   batches[1].command == third && batches[1].command_count == 2 && batches[1].texture_binding == TEXTURE_B &&
+		   batches[1].vertex_from == 12 && canvas.batcher.vertices.size() == 24;
+}
+
+bool test_single_commands_not_batched() {
+	Canvas canvas;
+	Item *item = canvas.add_item();
+	canvas.add_rect(item, TEXTURE_A);
+	canvas.add_rect(item, TEXTURE_B);
+	canvas.add_rect(item, TEXTURE_A);
+
+	return canvas.plan().size() == 0 && canvas.batcher.vertices.size() == 0;
+}
+
+bool test_clip_uv() {
+	Canvas canvas;
+	Item *item = canvas.add_item();
+	canvas.add_rect(item, TEXTURE_A);
+	canvas.add_rect(item, TEXTURE_A, RasterizerCanvas::CANVAS_RECT_CLIP_UV);
+	Item::CommandRect *third = canvas.add_rect(item, TEXTURE_A);
+	canvas.add_rect(item, TEXTURE_A);
+
+	//the clipped rect is drawn on its own and splits the run, leaving the first rect alone
+	const LocalVector<Batch> &batches = canvas.plan();
+	return batches.size() == 1 && batches[0].command == third && batches[0].command_count == 2;
+}
+
+bool test_nine_patch() {
+	Canvas canvas;
+	Item *item = canvas.add_item();
+	Item::CommandNinePatch *first = canvas.add_nine_patch(item, TEXTURE_A, RS::NINE_PATCH_STRETCH);
+	canvas.add_nine_patch(item, TEXTURE_A, RS::NINE_PATCH_STRETCH);
+	canvas.add_nine_patch(item, TEXTURE_A, RS::NINE_PATCH_TILE);
+	canvas.add_nine_patch(item, TEXTURE_A, RS::NINE_PATCH_STRETCH);
+
+	//stretched patches are nine quads each, the tiled one breaks the run
+	const LocalVector<Batch> &batches = canvas.plan();
+	return batches.size() == 1 && batches[0].command == first && batches[0].command_count == 2 && batches[0].vertex_count == 2 * 9 * 6;
+}
+
+bool test_cross_item_span() {
+	Canvas canvas;
+	Item *first = canvas.add_item();
+	Item::CommandRect *rect = canvas.add_rect(first, TEXTURE_A);
+	Item *second = canvas.add_item();
+	second->final_transform = Transform2D(0, Vector2(100, 0));
+	canvas.add_rect(second, TEXTURE_A);
+
+	const LocalVector<Batch> &batches = canvas.plan();
+	if (batches.size() != 1) {
+		return false;
+	}
+
+	const Batch &batch = batches[0];
+	if (batch.command != rect || batch.command_count != 2 || batch.item_to != 1 || batch.end_command != nullptr || !batch.world_baked) {
+		return false;
+	}
+
+	//the second item's transform is baked into its vertices
+	const RasterizerCanvasBatcher::Vertex *vertices = &canvas.batcher.vertices[0];
+	for (uint32_t i = 0; i < 6; i++) {
+		if (vertices[i].vertex[0] > 8 || vertices[6 + i].vertex[0] < 100) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool test_cross_item_clip() {
+	Canvas canvas;
+	Item *first = canvas.add_item();
+	canvas.add_rect(first, TEXTURE_A);
+	Item *second = canvas.add_item();
+	second->final_clip_owner = second;
+	canvas.add_rect(second, TEXTURE_A);
+
+	return canvas.plan().size() == 0;
+}
+
+bool test_lights() {
+	Canvas canvas;
+	for (int i = 0; i < 2; i++) {
+		Item *item = canvas.add_item();
+		canvas.add_rect(item, TEXTURE_A);
+		canvas.add_rect(item, TEXTURE_A);
+	}
+
+	Light light;
+	light.render_index_cache = 0;
+	light.rect_cache = Rect2(0, 0, 64, 64);
+
+	//lit items are drawn with their own transform and lights, so runs stay within each item
+	const LocalVector<Batch> &lit = canvas.plan(&light);
+	if (lit.size() != 2 || lit[0].world_baked || lit[1].world_baked || lit[0].item_to != 0 || lit[1].item_to != 1) {
+		return false;
+	}
+
+	//a light culled from this render doesn't prevent spanning
+	light.render_index_cache = -1;
+	const LocalVector<Batch> &unlit = canvas.plan(&light);
+	return unlit.size() == 1 && unlit[0].command_count == 4 && unlit[0].world_baked;
+}
+
+bool test_material_vertex_code() {
+	Canvas canvas;
+	RID plain = canvas.add_material(false);
+	RID vertex = canvas.add_material(true);
+
+	for (int i = 0; i < 2; i++) {
+		Item *item = canvas.add_item();
+		item->material = plain;
+		canvas.add_rect(item, TEXTURE_A);
+	}
+	if (canvas.plan().size() != 1) {
+		return false;
+	}
+
+	//vertex code expects local vertices, so the items can't be merged
+	for (uint32_t i = 0; i < canvas.items.size(); i++) {
+		canvas.items[i]->material = vertex;
+	}
+	if (canvas.plan().size() != 0) {
+		return false;
+	}
+
+	//items with different materials are never merged either
+	canvas.items[0]->material = plain;
+	canvas.items[1]->material = RID();
+	return canvas.plan().size() == 0;
+}
+
+bool test_max_vertices() {
+	Canvas canvas;
+	Item *item = canvas.add_item();
+	for (int i = 0; i < 4; i++) {
+		canvas.add_rect(item, TEXTURE_A);
+	}
+
+	//the run is cut when the vertex buffer is full
+	const LocalVector<Batch> &batches = canvas.plan(nullptr, 18);
+	return batches.size() == 1 && batches[0].command_count == 3 && canvas.batcher.vertices.size() == 18;
+}
+
+typedef bool (*TestFunc)();
+
+TestFunc test_funcs[] = {
+
+	test_texture_change,
+	test_single_commands_not_batched,
+	test_clip_uv,
+	test_nine_patch,
+	test_cross_item_span,
+	test_cross_item_clip,
+	test_lights,
+	test_material_vertex_code,
+	test_max_vertices,
+	nullptr
+
+};
+
+MainLoop *test() {
+	int count = 0;
+	int passed = 0;
+
+	while (true) {
+		if (!test_funcs[count]) {
+			break;
+		}
+		bool pass = test_funcs[count]();
+		if (pass) {
+			passed++;
+		}
+		OS::get_singleton()->print("\t%s\n", pass ? "PASS" : "FAILED");
+
+		count++;
+	}
+
+	OS::get_singleton()->print("\n\n\n");
+	OS::get_singleton()->print("*************\n");
+	OS::get_singleton()->print("***TOTALS!***\n");
+	OS::get_singleton()->print("*************\n");
+
+	OS::get_singleton()->print("Passed %i of %i tests\n", passed, count);
+
+	return nullptr;
+}
+
+} // namespace TestCanvasBatching
@@ -503,6 +503,491 @@ static String _disassemble_addr(const Ref<GDScript> &p_script, const GDScriptFun
 	return "<err>";
 }
 
+// Returns the size of the instruction at ip, or 0 if the opcode is unknown.
+static int _disassemble_instruction(const Ref<GDScript> &p_class, const GDScriptFunction &func, int ip, const Vector<String> &p_code, String &txt) {
+	const int *code = func.get_code();
+	int incr = 0;
+
+#define DADDR(m_ip) (_disassemble_addr(p_class, func, code[ip + m_ip]))
+
+	switch (code[ip]) {
+		case GDScriptFunction::OPCODE_OPERATOR: {
+			int op = code[ip + 1];
+			txt += " op ";
+
+			String opname = Variant::get_operator_name(Variant::Operator(op));
+
+			txt += DADDR(4);
+			txt += " = ";
+			txt += DADDR(2);
+			txt += " " + opname + " ";
+			txt += DADDR(3);
+			incr += 5;
+
+		} break;
+		case GDScriptFunction::OPCODE_OPERATOR_VALIDATED: {
+			int op = code[ip + 2];
+			txt += " op_validated ";
+
+			String opname = Variant::get_operator_name(Variant::Operator(op));
+
+			txt += DADDR(5);
+			txt += " = ";
+			txt += DADDR(3);
+			txt += " " + opname + " ";
+			txt += DADDR(4);
+			incr += 6;
+
+		} break;
+		case GDScriptFunction::OPCODE_SET: {
+			txt += "set ";
+			txt += DADDR(1);
+			txt += "[";
+			txt += DADDR(2);
+			txt += "]=";
+			txt += DADDR(3);
+			incr += 4;
+
+		} break;
+		case GDScriptFunction::OPCODE_GET: {
+			txt += " get ";
+			txt += DADDR(3);
+			txt += "=";
+			txt += DADDR(1);
+			txt += "[";
+			txt += DADDR(2);
+			txt += "]";
+			incr += 4;
+
+		} break;
+		case GDScriptFunction::OPCODE_SET_INDEXED_VALIDATED: {
+			txt += " set_indexed_validated ";
+			txt += DADDR(2);
+			txt += "[";
+			txt += DADDR(3);
+			txt += "]=";
+			txt += DADDR(4);
+			incr += 5;
+
+		} break;
+		case GDScriptFunction::OPCODE_GET_INDEXED_VALIDATED: {
+			txt += " get_indexed_validated ";
+			txt += DADDR(4);
+			txt += "=";
+			txt += DADDR(2);
+			txt += "[";
+			txt += DADDR(3);
+			txt += "]";
+			incr += 5;
+
+		} break;
+		case GDScriptFunction::OPCODE_SET_NAMED: {
+			txt += " set_named ";
+			txt += DADDR(1);
+			txt += "[\"";
+			txt += func.get_global_name(code[ip + 2]);
+			txt += "\"]=";
+			txt += DADDR(3);
+			incr += 4;
+
+		} break;
+		case GDScriptFunction::OPCODE_SET_NAMED_VALIDATED: {
+			txt += " set_named_validated ";
+			txt += DADDR(2);
+			txt += "[\"";
+			txt += func.get_global_name(code[ip + 3]);
+			txt += "\"]=";
+			txt += DADDR(4);
+			incr += 5;
+
+		} break;
+		case GDScriptFunction::OPCODE_GET_NAMED: {
+			txt += " get_named ";
+			txt += DADDR(4);
+			txt += "=";
+			txt += DADDR(1);
+			txt += "[\"";
+			txt += func.get_global_name(code[ip + 2]);
+			txt += "\"]";
+			incr += 5;
+
+		} break;
+		case GDScriptFunction::OPCODE_GET_NAMED_VALIDATED: {
+			txt += " get_named_validated ";
+			txt += DADDR(4);
+			txt += "=";
+			txt += DADDR(2);
+			txt += "[\"";
+			txt += func.get_global_name(code[ip + 3]);
+			txt += "\"]";
+			incr += 5;
+
+		} break;
+		case GDScriptFunction::OPCODE_SET_MEMBER: {
+			txt += " set_member ";
+			txt += "[\"";
+			txt += func.get_global_name(code[ip + 1]);
+			txt += "\"]=";
+			txt += DADDR(2);
+			incr += 3;
+
+		} break;
+		case GDScriptFunction::OPCODE_GET_MEMBER: {
+			txt += " get_member ";
+			txt += DADDR(2);
+			txt += "=";
+			txt += "[\"";
+			txt += func.get_global_name(code[ip + 1]);
+			txt += "\"]";
+			incr += 3;
+
+		} break;
+		case GDScriptFunction::OPCODE_ASSIGN: {
+			txt += " assign ";
+			txt += DADDR(1);
+			txt += "=";
+			txt += DADDR(2);
+			incr += 3;
+
+		} break;
+		case GDScriptFunction::OPCODE_ASSIGN_TRUE: {
+			txt += " assign ";
+			txt += DADDR(1);
+			txt += "= true";
+			incr += 2;
+
+		} break;
+		case GDScriptFunction::OPCODE_ASSIGN_FALSE: {
+			txt += " assign ";
+			txt += DADDR(1);
+			txt += "= false";
+			incr += 2;
+
+		} break;
+		case GDScriptFunction::OPCODE_ASSIGN_TYPED_BUILTIN: {
+			txt += " assign typed builtin (";
+			txt += Variant::get_type_name((Variant::Type)code[ip + 1]);
+			txt += ") ";
+			txt += DADDR(2);
+			txt += " = ";
+			txt += DADDR(3);
+			incr += 4;
+
+		} break;
+		case GDScriptFunction::OPCODE_ASSIGN_TYPED_NATIVE: {
+			Variant className = func.get_constant(code[ip + 1]);
+			GDScriptNativeClass *nc = Object::cast_to<GDScriptNativeClass>(className.operator Object *());
+
+			txt += " assign typed native (";
+			txt += nc->get_name().operator String();
+			txt += ") ";
+			txt += DADDR(2);
+			txt += " = ";
+			txt += DADDR(3);
+			incr += 4;
+
+		} break;
+		case GDScriptFunction::OPCODE_ASSIGN_TYPED_SCRIPT: {
+			txt += " assign typed script (";
+			txt += DADDR(1);
+			txt += ") ";
+			txt += DADDR(2);
+			txt += " = ";
+			txt += DADDR(3);
+			incr += 4;
+
+		} break;
+		case GDScriptFunction::OPCODE_EXTENDS_TEST: {
+			txt += " is ";
+			txt += DADDR(3);
+			txt += " = ";
+			txt += DADDR(1);
+			txt += " is ";
+			txt += DADDR(2);
+			incr += 4;
+
+		} break;
+		case GDScriptFunction::OPCODE_IS_BUILTIN: {
+			txt += " is builtin ";
+			txt += DADDR(3);
+			txt += " = ";
+			txt += DADDR(1);
+			txt += " is ";
+			txt += Variant::get_type_name((Variant::Type)code[ip + 2]);
+			incr += 4;
+
+		} break;
+		case GDScriptFunction::OPCODE_CAST_TO_BUILTIN: {
+			txt += " cast builtin ";
+			txt += DADDR(3);
+			txt += "=";
+			txt += DADDR(2);
+			txt += " as ";
+			txt += Variant::get_type_name((Variant::Type)code[ip + 1]);
+			incr += 4;
+
+		} break;
+		case GDScriptFunction::OPCODE_CAST_TO_NATIVE: {
+			txt += " cast native ";
+			txt += DADDR(3);
+			txt += "=";
+			txt += DADDR(2);
+			txt += " as ";
+			txt += DADDR(1);
+			incr += 4;
+
+		} break;
+		case GDScriptFunction::OPCODE_CAST_TO_SCRIPT: {
+			txt += " cast ";
+			txt += DADDR(3);
+			txt += "=";
+			txt += DADDR(1);
+			txt += " as ";
+			txt += DADDR(2);
+			incr += 4;
+
+		} break;
+		case GDScriptFunction::OPCODE_CONSTRUCT: {
+			Variant::Type t = Variant::Type(code[ip + 1]);
+			int argc = code[ip + 2];
+
+			txt += " construct ";
+			txt += DADDR(3 + argc);
+			txt += " = ";
+
+			txt += Variant::get_type_name(t) + "(";
+			for (int i = 0; i < argc; i++) {
+				if (i > 0) {
+					txt += ", ";
+				}
+				txt += DADDR(i + 3);
+			}
+			txt += ")";
+
+			incr = 4 + argc;
+
+		} break;
+		case GDScriptFunction::OPCODE_CONSTRUCT_ARRAY: {
+			int argc = code[ip + 1];
+			txt += " make_array ";
+			txt += DADDR(2 + argc);
+			txt += " = [ ";
+
+			for (int i = 0; i < argc; i++) {
+				if (i > 0) {
+					txt += ", ";
+				}
+				txt += DADDR(2 + i);
+			}
+
+			txt += "]";
+
+			incr += 3 + argc;
+
+		} break;
+		case GDScriptFunction::OPCODE_CONSTRUCT_DICTIONARY: {
+			int argc = code[ip + 1];
+			txt += " make_dict ";
+			txt += DADDR(2 + argc * 2);
+			txt += " = { ";
+
+			for (int i = 0; i < argc; i++) {
+				if (i > 0) {
+					txt += ", ";
+				}
+				txt += DADDR(2 + i * 2 + 0);
+				txt += ":";
+				txt += DADDR(2 + i * 2 + 1);
+			}
+
+			txt += "}";
+
+			incr += 3 + argc * 2;
+
+		} break;
+
+		case GDScriptFunction::OPCODE_CALL:
+		case GDScriptFunction::OPCODE_CALL_RETURN: {
+			bool ret = code[ip] == GDScriptFunction::OPCODE_CALL_RETURN;
+
+			if (ret) {
+				txt += " call-ret ";
+			} else {
+				txt += " call ";
+			}
+
+			int argc = code[ip + 1];
+			if (ret) {
+				txt += DADDR(5 + argc) + "=";
+			}
+
+			txt += DADDR(3) + ".";
+			txt += String(func.get_global_name(code[ip + 4]));
+			txt += "(";
+
+			for (int i = 0; i < argc; i++) {
+				if (i > 0) {
+					txt += ", ";
+				}
+				txt += DADDR(5 + i);
+			}
+			txt += ")";
+
+			incr = 6 + argc;
+
+		} break;
+		case GDScriptFunction::OPCODE_CALL_BUILTIN_TYPE_VALIDATED: {
+			txt += " call-builtin-validated ";
+
+			int argc = code[ip + 1];
+			txt += DADDR(5 + argc) + "=";
+
+			txt += DADDR(3) + ".";
+			txt += String(func.get_global_name(code[ip + 4]));
+			txt += "(";
+
+			for (int i = 0; i < argc; i++) {
+				if (i > 0) {
+					txt += ", ";
+				}
+				txt += DADDR(5 + i);
+			}
+			txt += ")";
+
+			incr = 6 + argc;
+
+		} break;
+		case GDScriptFunction::OPCODE_CALL_BUILT_IN: {
+			txt += " call-built-in ";
+
+			int argc = code[ip + 2];
+			txt += DADDR(3 + argc) + "=";
+
+			txt += GDScriptFunctions::get_func_name(GDScriptFunctions::Function(code[ip + 1]));
+			txt += "(";
+
+			for (int i = 0; i < argc; i++) {
+				if (i > 0) {
+					txt += ", ";
+				}
+				txt += DADDR(3 + i);
+			}
+			txt += ")";
+
+			incr = 4 + argc;
+
+		} break;
+		case GDScriptFunction::OPCODE_CALL_SELF_BASE: {
+			txt += " call-self-base ";
+
+			int argc = code[ip + 2];
+			txt += DADDR(3 + argc) + "=";
+
+			txt += func.get_global_name(code[ip + 1]);
+			txt += "(";
+
+			for (int i = 0; i < argc; i++) {
+				if (i > 0) {
+					txt += ", ";
+				}
+				txt += DADDR(3 + i);
+			}
+			txt += ")";
+
+			incr = 4 + argc;
+
+		} break;
+		case GDScriptFunction::OPCODE_YIELD: {
+			txt += " yield ";
+			incr = 1;
+
+		} break;
+		case GDScriptFunction::OPCODE_YIELD_SIGNAL: {
+			txt += " yield_signal ";
+			txt += DADDR(1);
+			txt += ",";
+			txt += DADDR(2);
+			incr = 3;
+		} break;
+		case GDScriptFunction::OPCODE_YIELD_RESUME: {
+			txt += " yield resume: ";
+			txt += DADDR(1);
+			incr = 2;
+		} break;
+		case GDScriptFunction::OPCODE_JUMP: {
+			txt += " jump ";
+			txt += itos(code[ip + 1]);
+
+			incr = 2;
+
+		} break;
+		case GDScriptFunction::OPCODE_JUMP_IF: {
+			txt += " jump-if ";
+			txt += DADDR(1);
+			txt += " to ";
+			txt += itos(code[ip + 2]);
+
+			incr = 3;
+		} break;
+		case GDScriptFunction::OPCODE_JUMP_IF_NOT: {
+			txt += " jump-if-not ";
+			txt += DADDR(1);
+			txt += " to ";
+			txt += itos(code[ip + 2]);
+
+			incr = 3;
+		} break;
+		case GDScriptFunction::OPCODE_JUMP_TO_DEF_ARGUMENT: {
+			txt += " jump-to-default-argument ";
+			incr = 1;
+		} break;
+		case GDScriptFunction::OPCODE_RETURN: {
+			txt += " return ";
+			txt += DADDR(1);
+
+			incr = 2;
+
+		} break;
+		case GDScriptFunction::OPCODE_ITERATE_BEGIN: {
+			txt += " for-init " + DADDR(4) + " in " + DADDR(2) + " counter " + DADDR(1) + " end " + itos(code[ip + 3]);
+			incr += 5;
+
+		} break;
+		case GDScriptFunction::OPCODE_ITERATE: {
+			txt += " for-loop " + DADDR(4) + " in " + DADDR(2) + " counter " + DADDR(1) + " end " + itos(code[ip + 3]);
+			incr += 5;
+
+		} break;
+		case GDScriptFunction::OPCODE_LINE: {
+			int line = code[ip + 1] - 1;
+			if (line >= 0 && line < p_code.size()) {
+				txt = "\n" + itos(line + 1) + ": " + p_code[line] + "\n";
+			} else {
+				txt = "";
+			}
+			incr += 2;
+		} break;
+		case GDScriptFunction::OPCODE_BREAKPOINT: {
+			txt += " breakpoint";
+			incr += 1;
+		} break;
+		case GDScriptFunction::OPCODE_END: {
+			txt += " end";
+			incr += 1;
+		} break;
+		case GDScriptFunction::OPCODE_ASSERT: {
+			txt += " assert ";
+			txt += DADDR(1);
+			incr += 3;
+
+		} break;
+	}
+
+#undef DADDR
+
+	return incr;
+}
+
 static void _disassemble_class(const Ref<GDScript> &p_class, const Vector<String> &p_code) {
 	const Map<StringName, GDScriptFunction *> &mf = p_class->debug_get_member_functions();
 
@@ -523,367 +1008,962 @@ static void _disassemble_class(const Ref<GDScript> &p_class, const Vector<String
 		}
 		print_line("== function " + String(func.get_name()) + "() :: stack size: " + itos(func.get_max_stack_size()) + " " + defargs + "==");
 
-#define DADDR(m_ip) (_disassemble_addr(p_class, func, code[ip + m_ip]))
-
 		for (int ip = 0; ip < codelen;) {
-			int incr = 0;
 			String txt = itos(ip) + " ";
 
-			switch (code[ip]) {
-				case GDScriptFunction::OPCODE_OPERATOR: {
-					int op = code[ip + 1];
-					txt += " op ";
+			int incr = _disassemble_instruction(p_class, func, ip, p_code, txt);
 
-					String opname = Variant::get_operator_name(Variant::Operator(op));
+			if (incr == 0) {
+				ERR_BREAK_MSG(true, "Unhandled opcode: " + itos(code[ip]));
+			}
 
-					txt += DADDR(4);
-					txt += " = ";
-					txt += DADDR(2);
-					txt += " " + opname + " ";
-					txt += DADDR(3);
-					incr += 5;
+			ip += incr;
+			if (txt != "") {
+				print_line(txt);
+			}
+		}
+	}
+}
 
-				} break;
-				case GDScriptFunction::OPCODE_SET: {
-					txt += "set ";
-					txt += DADDR(1);
-					txt += "[";
-					txt += DADDR(2);
-					txt += "]=";
-					txt += DADDR(3);
-					incr += 4;
+/* VM behavior, compares the fast paths of the VM against the generic ones */
 
-				} break;
-				case GDScriptFunction::OPCODE_GET: {
-					txt += " get ";
-					txt += DADDR(3);
-					txt += "=";
-					txt += DADDR(1);
-					txt += "[";
-					txt += DADDR(2);
-					txt += "]";
-					incr += 4;
+// Collects the errors scripts report, so tests can compare their text.
+struct ScriptErrorCatcher {
+	ErrorHandlerList handler;
+	String error;
 
-				} break;
-				case GDScriptFunction::OPCODE_SET_NAMED: {
-					txt += " set_named ";
-					txt += DADDR(1);
-					txt += "[\"";
-					txt += func.get_global_name(code[ip + 2]);
-					txt += "\"]=";
-					txt += DADDR(3);
-					incr += 4;
+	static void _handle_error(void *p_self, const char *p_function, const char *p_file, int p_line, const char *p_error, const char *p_explanation, ErrorHandlerType p_type) {
+		if (p_type == ERR_HANDLER_SCRIPT) {
+			((ScriptErrorCatcher *)p_self)->error = String::utf8(p_error);
+		}
+	}
 
-				} break;
-				case GDScriptFunction::OPCODE_GET_NAMED: {
-					txt += " get_named ";
-					txt += DADDR(3);
-					txt += "=";
-					txt += DADDR(1);
-					txt += "[\"";
-					txt += func.get_global_name(code[ip + 2]);
-					txt += "\"]";
-					incr += 4;
+	ScriptErrorCatcher() {
+		handler.errfunc = _handle_error;
+		handler.userdata = this;
+		add_error_handler(&handler);
+	}
 
-				} break;
-				case GDScriptFunction::OPCODE_SET_MEMBER: {
-					txt += " set_member ";
-					txt += "[\"";
-					txt += func.get_global_name(code[ip + 1]);
-					txt += "\"]=";
-					txt += DADDR(2);
-					incr += 3;
+	~ScriptErrorCatcher() {
+		remove_error_handler(&handler);
+	}
+};
+
+static Ref<GDScript> _vm_create_script(const String &p_code) {
+	Ref<GDScript> script;
+	script.instance();
+	script->set_source_code(p_code);
+	if (script->reload() != OK) {
+		return Ref<GDScript>();
+	}
+	return script;
+}
 
-				} break;
-				case GDScriptFunction::OPCODE_GET_MEMBER: {
-					txt += " get_member ";
-					txt += DADDR(2);
-					txt += "=";
-					txt += "[\"";
-					txt += func.get_global_name(code[ip + 1]);
-					txt += "\"]";
-					incr += 3;
+static Variant _vm_call(const Ref<GDScript> &p_script, const StringName &p_function, const Vector<Variant> &p_args, String *r_error = nullptr) {
+	Vector<const Variant *> argptrs;
+	for (int i = 0; i < p_args.size(); i++) {
+		argptrs.push_back(&p_args[i]);
+	}
 
-				} break;
-				case GDScriptFunction::OPCODE_ASSIGN: {
-					txt += " assign ";
-					txt += DADDR(1);
-					txt += "=";
-					txt += DADDR(2);
-					incr += 3;
+	ScriptErrorCatcher catcher;
+	Variant script = p_script;
+	Callable::CallError ce;
+	Variant ret = script.call(p_function, (const Variant **)argptrs.ptr(), argptrs.size(), ce);
+	if (ce.error != Callable::CallError::CALL_OK) {
+		catcher.error = "Call error " + itos(ce.error);
+	}
+	if (r_error) {
+		*r_error = catcher.error;
+	}
+	return ret;
+}
 
-				} break;
-				case GDScriptFunction::OPCODE_ASSIGN_TRUE: {
-					txt += " assign ";
-					txt += DADDR(1);
-					txt += "= true";
-					incr += 2;
+// Calls a function that takes a fast path and one that takes the generic path,
+// and checks both return the same value and report the same error.
+static bool _vm_same_result(const Ref<GDScript> &p_script, const StringName &p_fast, const Vector<Variant> &p_fast_args, const StringName &p_generic, const Vector<Variant> &p_generic_args, String *r_error = nullptr) {
+	String fast_error;
+	String generic_error;
+	Variant fast = _vm_call(p_script, p_fast, p_fast_args, &fast_error);
+	Variant generic = _vm_call(p_script, p_generic, p_generic_args, &generic_error);
 
-				} break;
-				case GDScriptFunction::OPCODE_ASSIGN_FALSE: {
-					txt += " assign ";
-					txt += DADDR(1);
-					txt += "= false";
-					incr += 2;
+	if (r_error) {
+		*r_error = fast_error;
+	}
+	if (fast_error != generic_error || !fast.hash_compare(generic)) {
+		OS::get_singleton()->print("\t%s returned '%s' (error '%s'), %s returned '%s' (error '%s')\n", String(p_fast).utf8().get_data(), String(fast).utf8().get_data(), fast_error.utf8().get_data(), String(p_generic).utf8().get_data(), String(generic).utf8().get_data(), generic_error.utf8().get_data());
+		return false;
+	}
+	return true;
+}
 
-				} break;
-				case GDScriptFunction::OPCODE_ASSIGN_TYPED_BUILTIN: {
-					txt += " assign typed builtin (";
-					txt += Variant::get_type_name((Variant::Type)code[ip + 1]);
-					txt += ") ";
-					txt += DADDR(2);
-					txt += " = ";
-					txt += DADDR(3);
-					incr += 4;
+// Whether the compiled function contains the opcode, so tests know which path they exercise.
+static bool _vm_uses_opcode(const Ref<GDScript> &p_script, const StringName &p_function, int p_opcode) {
+	const Map<StringName, GDScriptFunction *>::Element *E = p_script->debug_get_member_functions().find(p_function);
+	ERR_FAIL_COND_V(!E, false);
 
-				} break;
-				case GDScriptFunction::OPCODE_ASSIGN_TYPED_NATIVE: {
-					Variant className = func.get_constant(code[ip + 1]);
-					GDScriptNativeClass *nc = Object::cast_to<GDScriptNativeClass>(className.operator Object *());
-
-					txt += " assign typed native (";
-					txt += nc->get_name().operator String();
-					txt += ") ";
-					txt += DADDR(2);
-					txt += " = ";
-					txt += DADDR(3);
-					incr += 4;
+	const GDScriptFunction &func = *E->get();
+	Vector<String> no_code;
+	for (int ip = 0; ip < func.get_code_size();) {
+		if (func.get_code()[ip] == p_opcode) {
+			return true;
+		}
+		String txt;
+		int incr = _disassemble_instruction(p_script, func, ip, no_code, txt);
+		ERR_FAIL_COND_V_MSG(incr == 0, false, "Unhandled opcode: " + itos(func.get_code()[ip]));
+		ip += incr;
+	}
+	return false;
+}
 
-				} break;
-				case GDScriptFunction::OPCODE_CAST_TO_SCRIPT: {
-					txt += " cast ";
-					txt += DADDR(3);
-					txt += "=";
-					txt += DADDR(1);
-					txt += " as ";
-					txt += DADDR(2);
-					incr += 4;
+static Vector<Variant> _vm_args(const Variant &p_arg1, const Variant &p_arg2 = Variant(), const Variant &p_arg3 = Variant(), const Variant &p_arg4 = Variant(), const Variant &p_arg5 = Variant()) {
+	const Variant *args[5] = { &p_arg1, &p_arg2, &p_arg3, &p_arg4, &p_arg5 };
+	Vector<Variant> ret;
+	for (int i = 0; i < 5 && args[i]->get_type() != Variant::NIL; i++) {
+		ret.push_back(*args[i]);
+	}
+	return ret;
+}
 
-				} break;
-				case GDScriptFunction::OPCODE_CONSTRUCT: {
-					Variant::Type t = Variant::Type(code[ip + 1]);
-					int argc = code[ip + 2];
+static const char *indexed_code =
+		"static func typed_set(a, i, v):\n"
+		"\tvar arr : ARRAY_TYPE = a\n"
+		"\tvar index : int = i\n"
+		"\tvar value : VALUE_TYPE = v\n"
+		"\tarr[index] = value\n"
+		"\treturn arr\n"
+		"\n"
+		"static func generic_set(a, i, v):\n"
+		"\tvar arr = a\n"
+		"\tarr[i] = v\n"
+		"\treturn arr\n"
+		"\n"
+		"static func typed_get(a, i):\n"
+		"\tvar arr : ARRAY_TYPE = a\n"
+		"\tvar index : int = i\n"
+		"\treturn arr[index]\n"
+		"\n"
+		"static func generic_get(a, i):\n"
+		"\tvar arr = a\n"
+		"\treturn arr[i]\n"
+		"\n"
+		"static func mismatched_set(a, i, typed_v, v, use_typed):\n"
+		"\tvar arr : ARRAY_TYPE = a\n"
+		"\tvar index : int = i\n"
+		"\tvar value : VALUE_TYPE = typed_v\n"
+		"\t# Statically VALUE_TYPE, but v at runtime.\n"
+		"\tarr[index] = value if use_typed else v\n"
+		"\treturn arr\n"
+		"\n"
+		"static func iterate(a):\n"
+		"\tvar out = []\n"
+		"\tfor x in a:\n"
+		"\t\tout.append(x)\n"
+		"\treturn out\n";
+
+struct PackedCase {
+	Variant::Type type;
+	Array elements;
+	Variant value;
+	Variant mismatched_value; // Same value with another type, or one the array doesn't accept.
+
+	// Variants share packed arrays, so every call gets its own copy.
+	Variant make_array() const {
+		Variant elements_variant = elements;
+		const Variant *args[1] = { &elements_variant };
+		Callable::CallError ce;
+		return Variant::construct(type, args, 1, ce);
+	}
+};
+
+static Array _vm_array(const Variant &p_a, const Variant &p_b, const Variant &p_c) {
+	Array arr;
+	arr.push_back(p_a);
+	arr.push_back(p_b);
+	arr.push_back(p_c);
+	return arr;
+}
 
-					txt += " construct ";
-					txt += DADDR(3 + argc);
-					txt += " = ";
+static Vector<PackedCase> _packed_cases() {
+	const Variant::Type number_types[5] = { Variant::PACKED_BYTE_ARRAY, Variant::PACKED_INT32_ARRAY, Variant::PACKED_INT64_ARRAY, Variant::PACKED_FLOAT32_ARRAY, Variant::PACKED_FLOAT64_ARRAY };
 
-					txt += Variant::get_type_name(t) + "(";
-					for (int i = 0; i < argc; i++) {
-						if (i > 0) {
-							txt += ", ";
-						}
-						txt += DADDR(i + 3);
-					}
-					txt += ")";
+	Vector<PackedCase> cases;
+	for (int i = 0; i < 5; i++) {
+		PackedCase c;
+		c.type = number_types[i];
+		c.elements = _vm_array(1, 2, 3);
 
-					incr = 4 + argc;
+		// Stored as an int, and as a float, which integer arrays truncate.
+		c.value = 7;
+		c.mismatched_value = 2.75;
+		cases.push_back(c);
 
-				} break;
-				case GDScriptFunction::OPCODE_CONSTRUCT_ARRAY: {
-					int argc = code[ip + 1];
-					txt += " make_array ";
-					txt += DADDR(2 + argc);
-					txt += " = [ ";
-
-					for (int i = 0; i < argc; i++) {
-						if (i > 0) {
-							txt += ", ";
-						}
-						txt += DADDR(2 + i);
-					}
+		c.value = 2.75;
+		c.mismatched_value = 7;
+		cases.push_back(c);
+	}
 
-					txt += "]";
+	PackedCase c;
+	c.type = Variant::PACKED_STRING_ARRAY;
+	c.elements = _vm_array("a", "b", "c");
+	c.value = "seven";
+	c.mismatched_value = 7;
+	cases.push_back(c);
+
+	c.type = Variant::PACKED_VECTOR2_ARRAY;
+	c.elements = _vm_array(Vector2(1, 2), Vector2(3, 4), Vector2(5, 6));
+	c.value = Vector2(7, 8);
+	c.mismatched_value = Vector3(7, 8, 9);
+	cases.push_back(c);
+
+	c.type = Variant::PACKED_VECTOR3_ARRAY;
+	c.elements = _vm_array(Vector3(1, 2, 3), Vector3(4, 5, 6), Vector3(7, 8, 9));
+	c.value = Vector3(7, 8, 9);
+	c.mismatched_value = Vector2(7, 8);
+	cases.push_back(c);
+
+	c.type = Variant::PACKED_COLOR_ARRAY;
+	c.elements = _vm_array(Color(1, 0, 0), Color(0, 1, 0), Color(0, 0, 1));
+	c.value = Color(0.5, 0.5, 0.5, 0.5);
+	c.mismatched_value = "red";
+	cases.push_back(c);
+
+	return cases;
+}
 
-					incr += 3 + argc;
+bool test_indexed_validated() {
+	Vector<PackedCase> cases = _packed_cases();
+	const int in_bounds[4] = { 0, 2, -1, -3 };
+	const int out_of_bounds[2] = { 3, -4 };
 
-				} break;
-				case GDScriptFunction::OPCODE_CONSTRUCT_DICTIONARY: {
-					int argc = code[ip + 1];
-					txt += " make_dict ";
-					txt += DADDR(2 + argc * 2);
-					txt += " = { ";
-
-					for (int i = 0; i < argc; i++) {
-						if (i > 0) {
-							txt += ", ";
-						}
-						txt += DADDR(2 + i * 2 + 0);
-						txt += ":";
-						txt += DADDR(2 + i * 2 + 1);
-					}
+	for (int i = 0; i < cases.size(); i++) {
+		const PackedCase &c = cases[i];
+		String type_name = Variant::get_type_name(c.type);
+		String value_type_name = Variant::get_type_name(c.value.get_type());
 
-					txt += "}";
+		Ref<GDScript> script = _vm_create_script(String(indexed_code).replace("ARRAY_TYPE", type_name).replace("VALUE_TYPE", value_type_name));
+		if (script.is_null()) {
+			return false;
+		}
+		if (!_vm_uses_opcode(script, "typed_set", GDScriptFunction::OPCODE_SET_INDEXED_VALIDATED) || !_vm_uses_opcode(script, "typed_get", GDScriptFunction::OPCODE_GET_INDEXED_VALIDATED) || !_vm_uses_opcode(script, "mismatched_set", GDScriptFunction::OPCODE_SET_INDEXED_VALIDATED)) {
+			OS::get_singleton()->print("\t%s[int] = %s was not compiled to the validated opcodes\n", type_name.utf8().get_data(), value_type_name.utf8().get_data());
+			return false;
+		}
 
-					incr += 3 + argc * 2;
+		for (int j = 0; j < 4; j++) {
+			int index = in_bounds[j];
+			String error;
+			if (!_vm_same_result(script, "typed_set", _vm_args(c.make_array(), index, c.value), "generic_set", _vm_args(c.make_array(), index, c.value), &error) || !error.empty()) {
+				return false;
+			}
+			if (!_vm_same_result(script, "typed_get", _vm_args(c.make_array(), index), "generic_get", _vm_args(c.make_array(), index), &error) || !error.empty()) {
+				return false;
+			}
+		}
 
-				} break;
+		// Out of bounds accesses fall back to the generic path and report its error.
+		for (int j = 0; j < 2; j++) {
+			int index = out_of_bounds[j];
+			String error;
+			if (!_vm_same_result(script, "typed_set", _vm_args(c.make_array(), index, c.value), "generic_set", _vm_args(c.make_array(), index, c.value), &error)) {
+				return false;
+			}
+#ifdef DEBUG_ENABLED
+			if (!error.begins_with("Invalid set index '" + itos(index) + "' (on base: '" + type_name + "')")) {
+				return false;
+			}
+#endif
+			if (!_vm_same_result(script, "typed_get", _vm_args(c.make_array(), index), "generic_get", _vm_args(c.make_array(), index), &error)) {
+				return false;
+			}
+#ifdef DEBUG_ENABLED
+			if (error != "Invalid get index '" + itos(index) + "' (on base: '" + type_name + "').") {
+				return false;
+			}
+#endif
+		}
 
-				case GDScriptFunction::OPCODE_CALL:
-				case GDScriptFunction::OPCODE_CALL_RETURN: {
-					bool ret = code[ip] == GDScriptFunction::OPCODE_CALL_RETURN;
+		// A value that doesn't have its static type at runtime takes the generic set,
+		// which converts it or reports the same error.
+		if (!_vm_same_result(script, "mismatched_set", _vm_args(c.make_array(), 1, c.value, c.mismatched_value, false), "generic_set", _vm_args(c.make_array(), 1, c.mismatched_value))) {
+			return false;
+		}
+		if (!_vm_same_result(script, "mismatched_set", _vm_args(c.make_array(), 1, c.value, c.mismatched_value, true), "generic_set", _vm_args(c.make_array(), 1, c.value))) {
+			return false;
+		}
 
-					if (ret) {
-						txt += " call-ret ";
-					} else {
-						txt += " call ";
-					}
+		// The packed array fast path of for loops yields the same elements.
+		Variant iterated = _vm_call(script, "iterate", _vm_args(c.make_array()));
+		if (!iterated.hash_compare(c.make_array().operator Array())) {
+			return false;
+		}
+	}
 
-					int argc = code[ip + 1];
-					if (ret) {
-						txt += DADDR(4 + argc) + "=";
-					}
+	// Floats stored in integer arrays are truncated, as by the generic path.
+	Ref<GDScript> script = _vm_create_script(String(indexed_code).replace("ARRAY_TYPE", "PackedInt32Array").replace("VALUE_TYPE", "float"));
+	if (script.is_null()) {
+		return false;
+	}
+	PackedInt32Array expected;
+	expected.push_back(1);
+	expected.push_back(2);
+	expected.push_back(2);
+	return _vm_call(script, "typed_set", _vm_args(_packed_cases()[2].make_array(), -1, 2.75)).hash_compare(expected);
+}
 
-					txt += DADDR(2) + ".";
-					txt += String(func.get_global_name(code[ip + 3]));
-					txt += "(";
+static const char *resize_in_loop_code =
+		"static func grow(a):\n"
+		"\tvar seen = []\n"
+		"\tfor x in a:\n"
+		"\t\tseen.append(x)\n"
+		"\t\tif a.size() < 6:\n"
+		"\t\t\ta.append(x * 10)\n"
+		"\treturn seen\n"
+		"\n"
+		"static func shrink(a):\n"
+		"\tvar seen = []\n"
+		"\tfor x in a:\n"
+		"\t\tseen.append(x)\n"
+		"\t\ta.resize(1)\n"
+		"\treturn seen\n";
+
+bool test_iterate_resized_packed_array() {
+	Ref<GDScript> script = _vm_create_script(resize_in_loop_code);
+	if (script.is_null()) {
+		return false;
+	}
 
-					for (int i = 0; i < argc; i++) {
-						if (i > 0) {
-							txt += ", ";
-						}
-						txt += DADDR(4 + i);
-					}
-					txt += ")";
+	// Packed arrays take the fast path of for loops, arrays the generic one,
+	// and both see the size change made inside the loop.
+	PackedInt32Array packed;
+	Array array;
+	for (int i = 1; i <= 3; i++) {
+		packed.push_back(i);
+		array.push_back(i);
+	}
 
-					incr = 5 + argc;
+	Array grown = _vm_call(script, "grow", _vm_args(PackedInt32Array(packed)));
+	Array expected = _vm_array(1, 2, 3);
+	expected.push_back(10);
+	expected.push_back(20);
+	expected.push_back(30);
+	if (!Variant(grown).hash_compare(expected) || !Variant(grown).hash_compare(_vm_call(script, "grow", _vm_args(array.duplicate())))) {
+		return false;
+	}
 
-				} break;
-				case GDScriptFunction::OPCODE_CALL_BUILT_IN: {
-					txt += " call-built-in ";
+	Array shrunk = _vm_call(script, "shrink", _vm_args(PackedInt32Array(packed)));
+	Array shrunk_expected;
+	shrunk_expected.push_back(1);
+	return Variant(shrunk).hash_compare(shrunk_expected) && Variant(shrunk).hash_compare(_vm_call(script, "shrink", _vm_args(array.duplicate())));
+}
 
-					int argc = code[ip + 2];
-					txt += DADDR(3 + argc) + "=";
+static const char *operator_code =
+		"static func typed_ops(a, b):\n"
+		"\tvar x : TYPE = a\n"
+		"\tvar y : TYPE = b\n"
+		"\treturn [x + y, x == y, x < y]\n"
+		"\n"
+		"static func generic_ops(a, b):\n"
+		"\treturn [a + b, a == b, a < b]\n"
+		"\n"
+		"static func mismatched_add(typed_a, a, b, use_typed):\n"
+		"\tvar x : TYPE = typed_a\n"
+		"\tvar y : TYPE = b\n"
+		"\t# Statically TYPE, but a at runtime.\n"
+		"\treturn (x if use_typed else a) + y\n"
+		"\n"
+		"static func generic_add(a, b):\n"
+		"\treturn a + b\n";
+
+struct OperatorCase {
+	Variant a;
+	Variant b;
+	Variant mismatched_a; // Same value with another type, or one the operator doesn't accept.
+};
+
+bool test_operator_validated() {
+	Vector<OperatorCase> cases;
+	OperatorCase c;
+	c.a = 7;
+	c.b = 2;
+	c.mismatched_a = 2.5;
+	cases.push_back(c);
+	c.a = 7.5;
+	c.b = 7.5;
+	c.mismatched_a = 7;
+	cases.push_back(c);
+	c.a = "ab";
+	c.b = "cd";
+	c.mismatched_a = StringName("ab");
+	cases.push_back(c);
+	c.a = Vector2(1, 2);
+	c.b = Vector2(3, 4);
+	c.mismatched_a = Vector3(1, 2, 3);
+	cases.push_back(c);
+	c.a = Vector3(1, 2, 3);
+	c.b = Vector3(1, 2, 4);
+	c.mismatched_a = Vector2(1, 2);
+	cases.push_back(c);
+
+	for (int i = 0; i < cases.size(); i++) {
+		const OperatorCase &oc = cases[i];
+		String type_name = Variant::get_type_name(oc.a.get_type());
+
+		Ref<GDScript> script = _vm_create_script(String(operator_code).replace("TYPE", type_name));
+		if (script.is_null()) {
+			return false;
+		}
+		if (!_vm_uses_opcode(script, "typed_ops", GDScriptFunction::OPCODE_OPERATOR_VALIDATED) || !_vm_uses_opcode(script, "mismatched_add", GDScriptFunction::OPCODE_OPERATOR_VALIDATED)) {
+			OS::get_singleton()->print("\t%s operators were not compiled to the validated opcode\n", type_name.utf8().get_data());
+			return false;
+		}
 
-					txt += GDScriptFunctions::get_func_name(GDScriptFunctions::Function(code[ip + 1]));
-					txt += "(";
+		String error;
+		if (!_vm_same_result(script, "typed_ops", _vm_args(oc.a, oc.b), "generic_ops", _vm_args(oc.a, oc.b), &error) || !error.empty()) {
+			return false;
+		}
+		if (!_vm_same_result(script, "typed_ops", _vm_args(oc.b, oc.a), "generic_ops", _vm_args(oc.b, oc.a), &error) || !error.empty()) {
+			return false;
+		}
 
-					for (int i = 0; i < argc; i++) {
-						if (i > 0) {
-							txt += ", ";
-						}
-						txt += DADDR(3 + i);
-					}
-					txt += ")";
+		// An operand that doesn't have its static type at runtime takes the generic
+		// operator, which converts it or reports the same error.
+		if (!_vm_same_result(script, "mismatched_add", _vm_args(oc.a, oc.mismatched_a, oc.b, false), "generic_add", _vm_args(oc.mismatched_a, oc.b))) {
+			return false;
+		}
+		if (!_vm_same_result(script, "mismatched_add", _vm_args(oc.a, oc.mismatched_a, oc.b, true), "generic_add", _vm_args(oc.a, oc.b))) {
+			return false;
+		}
+	}
 
-					incr = 4 + argc;
+	// Reloading the script with other static types rebuilds its evaluators,
+	// the integer ones must not be used on floats.
+	Ref<GDScript> script = _vm_create_script(String(operator_code).replace("TYPE", "int"));
+	if (script.is_null()) {
+		return false;
+	}
+	if (!_vm_same_result(script, "typed_ops", _vm_args(7, 2), "generic_ops", _vm_args(7, 2))) {
+		return false;
+	}
 
-				} break;
-				case GDScriptFunction::OPCODE_CALL_SELF_BASE: {
-					txt += " call-self-base ";
+	script->set_source_code(String(operator_code).replace("TYPE", "float"));
+	if (script->reload() != OK || !_vm_uses_opcode(script, "typed_ops", GDScriptFunction::OPCODE_OPERATOR_VALIDATED)) {
+		return false;
+	}
+	return _vm_same_result(script, "typed_ops", _vm_args(7, 2), "generic_ops", _vm_args(7.0, 2.0));
+}
 
-					int argc = code[ip + 2];
-					txt += DADDR(3 + argc) + "=";
+static const char *inline_cache_caller_code =
+		"static func call_value(obj):\n"
+		"\treturn obj.value()\n"
+		"\n"
+		"static func call_generic(obj):\n"
+		"\treturn obj.call(\"value\")\n"
+		"\n"
+		"static func get_member(obj):\n"
+		"\treturn obj.member\n"
+		"\n"
+		"static func get_generic(obj):\n"
+		"\treturn obj.get(\"member\")\n";
+
+// Receivers put the member at different indices, and the last one reads it through a getter.
+static const char *inline_cache_receiver_codes[3] = {
+	"extends Reference\n"
+	"var member = 1\n"
+	"func value():\n"
+	"\treturn 1\n",
+
+	"extends Reference\n"
+	"var before = 0\n"
+	"var member = 2\n"
+	"func value():\n"
+	"\treturn 2\n",
+
+	"extends Reference\n"
+	"var member = 3 setget , get_member_value\n"
+	"func get_member_value():\n"
+	"\treturn 30\n"
+	"func value():\n"
+	"\treturn 3\n"
+};
+
+static Variant _vm_instance(const Ref<GDScript> &p_script) {
+	Variant script = p_script;
+	return script.call("new");
+}
 
-					txt += func.get_global_name(code[ip + 1]);
-					txt += "(";
+// The cached call and get must return what Object::call() and Object::get() return.
+static bool _inline_cache_same_result(const Ref<GDScript> &p_caller, const Variant &p_receiver) {
+	String error;
+	if (!_vm_same_result(p_caller, "call_value", _vm_args(p_receiver), "call_generic", _vm_args(p_receiver), &error) || !error.empty()) {
+		return false;
+	}
+	return _vm_same_result(p_caller, "get_member", _vm_args(p_receiver), "get_generic", _vm_args(p_receiver), &error) && error.empty();
+}
 
-					for (int i = 0; i < argc; i++) {
-						if (i > 0) {
-							txt += ", ";
-						}
-						txt += DADDR(3 + i);
-					}
-					txt += ")";
+bool test_inline_cache_receivers() {
+	Ref<GDScript> caller = _vm_create_script(inline_cache_caller_code);
+	if (caller.is_null()) {
+		return false;
+	}
+	Vector<Variant> receivers;
+	for (int i = 0; i < 3; i++) {
+		Ref<GDScript> script = _vm_create_script(inline_cache_receiver_codes[i]);
+		if (script.is_null()) {
+			return false;
+		}
+		receivers.push_back(_vm_instance(script));
+	}
+	Ref<Reference> native;
+	native.instance();
+
+	// More receiver types than cache entries go through the same call sites,
+	// and every type comes back after being evicted.
+	const int order[8] = { 0, 0, 1, 0, 2, 1, 0, 2 };
+	for (int i = 0; i < 8; i++) {
+		if (!_inline_cache_same_result(caller, receivers[order[i]])) {
+			return false;
+		}
 
-					incr = 4 + argc;
+		// Names a receiver doesn't have keep failing, cached or not, and don't
+		// affect the other receivers.
+		if (i % 3 == 2) {
+			for (int j = 0; j < 2; j++) {
+				String error;
+				_vm_call(caller, "call_value", _vm_args(native), &error);
+#ifdef DEBUG_ENABLED
+				if (error.empty()) {
+					return false;
+				}
+#endif
+				_vm_call(caller, "get_member", _vm_args(native), &error);
+#ifdef DEBUG_ENABLED
+				if (error.empty()) {
+					return false;
+				}
+#endif
+			}
+		}
+	}
+	return true;
+}
 
-				} break;
-				case GDScriptFunction::OPCODE_YIELD: {
-					txt += " yield ";
-					incr = 1;
+bool test_inline_cache_reload() {
+	Ref<GDScript> caller = _vm_create_script(inline_cache_caller_code);
+	Ref<GDScript> receiver = _vm_create_script(inline_cache_receiver_codes[0]);
+	if (caller.is_null() || receiver.is_null()) {
+		return false;
+	}
 
-				} break;
-				case GDScriptFunction::OPCODE_YIELD_SIGNAL: {
-					txt += " yield_signal ";
-					txt += DADDR(1);
-					txt += ",";
-					txt += DADDR(2);
-					incr = 3;
-				} break;
-				case GDScriptFunction::OPCODE_YIELD_RESUME: {
-					txt += " yield resume: ";
-					txt += DADDR(1);
-					incr = 2;
-				} break;
-				case GDScriptFunction::OPCODE_JUMP: {
-					txt += " jump ";
-					txt += itos(code[ip + 1]);
+	{
+		Variant instance = _vm_instance(receiver);
+		if (!_inline_cache_same_result(caller, instance) || _vm_call(caller, "get_member", _vm_args(instance)) != Variant(1)) {
+			return false;
+		}
+	}
 
-					incr = 2;
+	// The reloaded script is the same object, but its member moved and its
+	// functions were replaced, so the cached entries must not be used.
+	receiver->set_source_code(inline_cache_receiver_codes[1]);
+	if (receiver->reload() != OK) {
+		return false;
+	}
+	Variant instance = _vm_instance(receiver);
+	if (!_inline_cache_same_result(caller, instance) || _vm_call(caller, "call_value", _vm_args(instance)) != Variant(2) || _vm_call(caller, "get_member", _vm_args(instance)) != Variant(2)) {
+		return false;
+	}
 
-				} break;
-				case GDScriptFunction::OPCODE_JUMP_IF: {
-					txt += " jump-if ";
-					txt += DADDR(1);
-					txt += " to ";
-					txt += itos(code[ip + 2]);
+	// Reloading the caller starts with empty caches.
+	if (caller->reload() != OK) {
+		return false;
+	}
+	return _inline_cache_same_result(caller, instance) && _vm_call(caller, "get_member", _vm_args(instance)) == Variant(2);
+}
 
-					incr = 3;
-				} break;
-				case GDScriptFunction::OPCODE_JUMP_IF_NOT: {
-					txt += " jump-if-not ";
-					txt += DADDR(1);
-					txt += " to ";
-					txt += itos(code[ip + 2]);
+static const char *folding_code =
+		"const SPEED = 3\n"
+		"const SCALE = 2.5\n"
+		"const ZERO = 0\n"
+		"const NAME = \"ship\"\n"
+		"const V = Vector2(1, 2)\n"
+		"const ARR = [1, 2, 3]\n"
+		"const DICT = {\"a\": 1}\n"
+		"\n"
+		"class Inner:\n"
+		"\tconst X = 4\n"
+		"\n"
+		"static func folded():\n"
+		"\treturn [SPEED * 2, SPEED / 2, SCALE * SPEED, -SPEED, ~SPEED, SPEED % 2, SPEED << 2, NAME + \"s\", \"h\" in NAME, V.x, V * SPEED, SPEED > 2 and NAME == \"ship\", SPEED if SPEED > 2 else 0, abs(-SPEED), Vector3(SPEED, 0, 1), Inner.X * 2]\n"
+		"\n"
+		"static func runtime(speed, scale, name, v, x):\n"
+		"\treturn [speed * 2, speed / 2, scale * speed, -speed, ~speed, speed % 2, speed << 2, name + \"s\", \"h\" in name, v.x, v * speed, speed > 2 and name == \"ship\", speed if speed > 2 else 0, abs(-speed), Vector3(speed, 0, 1), x * 2]\n"
+		"\n"
+		"static func folded_branch():\n"
+		"\tif SPEED > 2:\n"
+		"\t\treturn 1\n"
+		"\telse:\n"
+		"\t\treturn 2\n"
+		"\n"
+		"static func runtime_branch(speed):\n"
+		"\tif speed > 2:\n"
+		"\t\treturn 1\n"
+		"\telse:\n"
+		"\t\treturn 2\n"
+		"\n"
+		"static func folded_divide_by_zero():\n"
+		"\treturn SPEED / ZERO\n"
+		"\n"
+		"static func runtime_divide(a, b):\n"
+		"\treturn a / b\n"
+		"\n"
+		"static func containers():\n"
+		"\treturn [ARR, DICT]\n"
+		"\n"
+		"static func read_constants():\n"
+		"\treturn [ARR[0], 1 in ARR, ARR == [1, 2, 3], ARR.size(), DICT.a, DICT[\"a\"], Inner.resource_name]\n"
+		"\n"
+		"static func read_args(arr, dict, inner):\n"
+		"\treturn [arr[0], 1 in arr, arr == [1, 2, 3], arr.size(), dict.a, dict[\"a\"], inner.resource_name]\n"
+		"\n"
+		"static func modify():\n"
+		"\tvar arr = ARR\n"
+		"\tarr[0] = 10\n"
+		"\tarr.append(4)\n"
+		"\tvar dict = DICT\n"
+		"\tdict.a = 5\n"
+		"\tvar inner = Inner\n"
+		"\tinner.resource_name = \"renamed\"\n"
+		"\n"
+		"static func inner():\n"
+		"\treturn Inner\n";
+
+bool test_constant_folding() {
+	Ref<GDScript> script = _vm_create_script(folding_code);
+	if (script.is_null()) {
+		return false;
+	}
 
-					incr = 3;
-				} break;
-				case GDScriptFunction::OPCODE_JUMP_TO_DEF_ARGUMENT: {
-					txt += " jump-to-default-argument ";
-					incr = 1;
-				} break;
-				case GDScriptFunction::OPCODE_RETURN: {
-					txt += " return ";
-					txt += DADDR(1);
+	// Check the expressions were folded, so the comparison isn't between two runtime evaluations.
+	const int runtime_opcodes[5] = { GDScriptFunction::OPCODE_OPERATOR, GDScriptFunction::OPCODE_OPERATOR_VALIDATED, GDScriptFunction::OPCODE_GET_NAMED, GDScriptFunction::OPCODE_CALL_BUILT_IN, GDScriptFunction::OPCODE_CONSTRUCT };
+	for (int i = 0; i < 5; i++) {
+		if (_vm_uses_opcode(script, "folded", runtime_opcodes[i]) || _vm_uses_opcode(script, "folded_branch", runtime_opcodes[i])) {
+			OS::get_singleton()->print("\tConstant expressions were not folded\n");
+			return false;
+		}
+	}
+	if (_vm_uses_opcode(script, "folded_branch", GDScriptFunction::OPCODE_JUMP_IF_NOT)) {
+		OS::get_singleton()->print("\tThe constant condition was not folded\n");
+		return false;
+	}
 
-					incr = 2;
+	if (!_vm_same_result(script, "folded", Vector<Variant>(), "runtime", _vm_args(3, 2.5, "ship", Vector2(1, 2), 4))) {
+		return false;
+	}
+	if (!_vm_same_result(script, "folded_branch", Vector<Variant>(), "runtime_branch", _vm_args(3))) {
+		return false;
+	}
 
-				} break;
-				case GDScriptFunction::OPCODE_ITERATE_BEGIN: {
-					txt += " for-init " + DADDR(4) + " in " + DADDR(2) + " counter " + DADDR(1) + " end " + itos(code[ip + 3]);
-					incr += 5;
+	// Expressions that fail are left to the VM, which reports the error.
+	String error;
+	if (!_vm_same_result(script, "folded_divide_by_zero", Vector<Variant>(), "runtime_divide", _vm_args(3, 0), &error)) {
+		return false;
+	}
+#ifdef DEBUG_ENABLED
+	if (error.empty()) {
+		return false;
+	}
+#endif
 
-				} break;
-				case GDScriptFunction::OPCODE_ITERATE: {
-					txt += " for-loop " + DADDR(4) + " in " + DADDR(2) + " counter " + DADDR(1) + " end " + itos(code[ip + 3]);
-					incr += 5;
+	// Constant containers and the properties of classes can change at runtime,
+	// reads through them must see the changes.
+	Array containers = _vm_call(script, "containers", Vector<Variant>());
+	Variant inner = _vm_call(script, "inner", Vector<Variant>());
+	for (int i = 0; i < 2; i++) {
+		if (!_vm_same_result(script, "read_constants", Vector<Variant>(), "read_args", _vm_args(containers[0], containers[1], inner))) {
+			return false;
+		}
+		if (i == 0) {
+			_vm_call(script, "modify", Vector<Variant>());
+		}
+	}
 
-				} break;
-				case GDScriptFunction::OPCODE_LINE: {
-					int line = code[ip + 1] - 1;
-					if (line >= 0 && line < p_code.size()) {
-						txt = "\n" + itos(line + 1) + ": " + p_code[line] + "\n";
-					} else {
-						txt = "";
+	Array modified = _vm_call(script, "read_constants", Vector<Variant>());
+	return modified.size() == 7 && modified[0] == Variant(10) && modified[1] == Variant(false) && modified[3] == Variant(4) && modified[4] == Variant(5) && modified[6] == Variant("renamed");
+}
+
+// Values of each type for the exhaustive checks, including zeros and negative values.
+static Vector<Variant> _vm_samples(Variant::Type p_type) {
+	Vector<Variant> samples;
+	switch (p_type) {
+		case Variant::BOOL: {
+			samples.push_back(false);
+			samples.push_back(true);
+		} break;
+		case Variant::INT: {
+			samples.push_back(0);
+			samples.push_back(3);
+			samples.push_back(-7);
+		} break;
+		case Variant::FLOAT: {
+			samples.push_back(0.0);
+			samples.push_back(2.5);
+			samples.push_back(-1.25);
+		} break;
+		case Variant::STRING: {
+			samples.push_back("");
+			samples.push_back("ab");
+			samples.push_back("b");
+		} break;
+		case Variant::STRING_NAME: {
+			samples.push_back(StringName());
+			samples.push_back(StringName("ab"));
+			samples.push_back(StringName("b"));
+		} break;
+		case Variant::VECTOR2: {
+			samples.push_back(Vector2());
+			samples.push_back(Vector2(0.6, 0.8));
+			samples.push_back(Vector2(3, -4));
+		} break;
+		case Variant::VECTOR2I: {
+			samples.push_back(Vector2i());
+			samples.push_back(Vector2i(1, 2));
+			samples.push_back(Vector2i(-3, 4));
+		} break;
+		case Variant::VECTOR3: {
+			samples.push_back(Vector3());
+			samples.push_back(Vector3(0, 0.6, 0.8));
+			samples.push_back(Vector3(1, -2, 3));
+		} break;
+		case Variant::VECTOR3I: {
+			samples.push_back(Vector3i());
+			samples.push_back(Vector3i(1, 2, 3));
+			samples.push_back(Vector3i(-4, 5, -6));
+		} break;
+		case Variant::RECT2: {
+			samples.push_back(Rect2());
+			samples.push_back(Rect2(1, 2, 3, 4));
+		} break;
+		case Variant::RECT2I: {
+			samples.push_back(Rect2i());
+			samples.push_back(Rect2i(1, 2, 3, 4));
+		} break;
+		case Variant::PLANE: {
+			samples.push_back(Plane());
+			samples.push_back(Plane(0, 1, 0, 2));
+		} break;
+		case Variant::QUAT: {
+			samples.push_back(Quat());
+			samples.push_back(Quat(Vector3(0, 1, 0), 0.5));
+		} break;
+		case Variant::COLOR: {
+			samples.push_back(Color(0, 0, 0, 0));
+			samples.push_back(Color(1, 0.5, 0.25, 1));
+		} break;
+		case Variant::TRANSFORM2D: {
+			samples.push_back(Transform2D());
+			samples.push_back(Transform2D(0.5, Vector2(1, 2)));
+		} break;
+		case Variant::BASIS: {
+			samples.push_back(Basis());
+			samples.push_back(Basis(Vector3(0, 1, 0), 0.5));
+		} break;
+		case Variant::TRANSFORM: {
+			samples.push_back(Transform());
+			samples.push_back(Transform(Basis(Vector3(1, 0, 0), 0.3), Vector3(1, 2, 3)));
+		} break;
+		default: {
+			Callable::CallError ce;
+			samples.push_back(Variant::construct(p_type, nullptr, 0, ce));
+		}
+	}
+	return samples;
+}
+
+static String _vm_operator_text(Variant::Operator p_op, const Variant &p_a, const Variant &p_b) {
+	return Variant::get_operator_name(p_op) + " (" + Variant::get_type_name(p_a.get_type()) + " '" + String(p_a) + "', " + Variant::get_type_name(p_b.get_type()) + " '" + String(p_b) + "')";
+}
+
+bool test_operator_evaluators() {
+	int checked = 0;
+
+	for (int op = 0; op < Variant::OP_MAX; op++) {
+		for (int type_a = 0; type_a < Variant::VARIANT_MAX; type_a++) {
+			for (int type_b = 0; type_b < Variant::VARIANT_MAX; type_b++) {
+				Variant::Operator var_op = Variant::Operator(op);
+				Variant::OperatorEvaluator evaluator = Variant::get_operator_evaluator(var_op, Variant::Type(type_a), Variant::Type(type_b));
+				Variant::ValidatedOperatorEvaluator validated = Variant::get_validated_operator_evaluator(var_op, Variant::Type(type_a), Variant::Type(type_b));
+				if (!evaluator) {
+					if (validated) {
+						OS::get_singleton()->print("\t%s has a validated evaluator but no plain one\n", _vm_operator_text(var_op, Variant(), Variant()).utf8().get_data());
+						return false;
 					}
-					incr += 2;
-				} break;
-				case GDScriptFunction::OPCODE_END: {
-					txt += " end";
-					incr += 1;
-				} break;
-				case GDScriptFunction::OPCODE_ASSERT: {
-					txt += " assert ";
-					txt += DADDR(1);
-					incr += 2;
+					continue;
+				}
 
-				} break;
+				Vector<Variant> samples_a = _vm_samples(Variant::Type(type_a));
+				Vector<Variant> samples_b = _vm_samples(Variant::Type(type_b));
+				for (int i = 0; i < samples_a.size(); i++) {
+					for (int j = 0; j < samples_b.size(); j++) {
+						const Variant &a = samples_a[i];
+						const Variant &b = samples_b[j];
+#ifndef DEBUG_ENABLED
+						// Integer division by zero is only checked in debug builds.
+						if ((var_op == Variant::OP_DIVIDE || var_op == Variant::OP_MODULE) && a.get_type() == Variant::INT && b.get_type() == Variant::INT && int64_t(b) == 0) {
+							continue;
+						}
+#endif
+
+						// The untyped implementation is the reference, what evaluate() did before the tables.
+						Variant expected;
+						bool expected_valid = false;
+						Variant::_evaluate_generic(var_op, a, b, expected, expected_valid);
+
+						// The table is what evaluate() dispatches to.
+						Variant ret;
+						bool valid = false;
+						Variant::evaluate(var_op, a, b, ret, valid);
+						if (valid != expected_valid || (valid && !ret.hash_compare(expected))) {
+							OS::get_singleton()->print("\t%s evaluates to '%s' (valid %d), expected '%s' (valid %d)\n", _vm_operator_text(var_op, a, b).utf8().get_data(), String(ret).utf8().get_data(), valid, String(expected).utf8().get_data(), expected_valid);
+							return false;
+						}
+
+						if (!validated) {
+							continue;
+						}
+
+						// Validated evaluators never fail, and overwrite the result in place when it
+						// already has the right type, so call them twice.
+						Variant validated_ret;
+						for (int k = 0; k < 2; k++) {
+							validated(&a, &b, &validated_ret);
+							if (!expected_valid || !validated_ret.hash_compare(expected)) {
+								OS::get_singleton()->print("\t%s validated evaluates to '%s', expected '%s' (valid %d)\n", _vm_operator_text(var_op, a, b).utf8().get_data(), String(validated_ret).utf8().get_data(), String(expected).utf8().get_data(), expected_valid);
+								return false;
+							}
+						}
+						checked++;
+					}
+				}
 			}
+		}
+	}
 
-			if (incr == 0) {
-				ERR_BREAK_MSG(true, "Unhandled opcode: " + itos(code[ip]));
+	OS::get_singleton()->print("\tChecked %d validated evaluations\n", checked);
+	return checked > 0;
+}
+
+bool test_validated_builtin_methods() {
+	int checked = 0;
+
+	for (int type = 0; type < Variant::VARIANT_MAX; type++) {
+		Vector<Variant> bases = _vm_samples(Variant::Type(type));
+		List<MethodInfo> methods;
+		bases[0].get_method_list(&methods);
+
+		for (List<MethodInfo>::Element *E = methods.front(); E; E = E->next()) {
+			StringName name = E->get().name;
+			Vector<Variant::Type> argument_types = Variant::get_method_argument_types(Variant::Type(type), name);
+			Variant::ValidatedBuiltInMethod validated = Variant::get_validated_builtin_method(Variant::Type(type), name, argument_types.ptr(), argument_types.size());
+			if (!validated) {
+				continue;
+			}
+			ERR_FAIL_COND_V(argument_types.size() > 2, false);
+
+			// Every combination of the sample values, for up to two arguments.
+			Vector<Variant> samples[2];
+			int combinations = 1;
+			for (int i = 0; i < argument_types.size(); i++) {
+				samples[i] = _vm_samples(argument_types[i]);
+				combinations *= samples[i].size();
 			}
 
-			ip += incr;
-			if (txt != "") {
-				print_line(txt);
+			for (int i = 0; i < bases.size(); i++) {
+				for (int j = 0; j < combinations; j++) {
+					Variant args[2];
+					const Variant *argptrs[2];
+					String args_text;
+					for (int k = 0, c = j; k < argument_types.size(); k++) {
+						args[k] = samples[k][c % samples[k].size()];
+						argptrs[k] = &args[k];
+						args_text += (k > 0 ? ", " : "") + String(args[k]);
+						c /= samples[k].size();
+					}
+
+					Variant base = bases[i];
+					Callable::CallError ce;
+					Variant expected = base.call(name, argptrs, argument_types.size(), ce);
+					if (ce.error != Callable::CallError::CALL_OK) {
+						OS::get_singleton()->print("\t%s.%s(%s) failed with call error %d\n", Variant::get_type_name(Variant::Type(type)).utf8().get_data(), String(name).utf8().get_data(), args_text.utf8().get_data(), ce.error);
+						return false;
+					}
+
+					// The result is overwritten in place when it already has the return type, so call twice.
+					Variant ret;
+					for (int k = 0; k < 2; k++) {
+						Variant validated_base = bases[i];
+						validated(&validated_base, argptrs, &ret);
+						if (!ret.hash_compare(expected) || !validated_base.hash_compare(bases[i])) {
+							OS::get_singleton()->print("\t%s('%s').%s(%s) validated returns '%s', expected '%s'\n", Variant::get_type_name(Variant::Type(type)).utf8().get_data(), String(bases[i]).utf8().get_data(), String(name).utf8().get_data(), args_text.utf8().get_data(), String(ret).utf8().get_data(), String(expected).utf8().get_data());
+							return false;
+						}
+					}
+				}
 			}
+			checked++;
 		}
 	}
+
+	OS::get_singleton()->print("\tChecked %d validated methods\n", checked);
+	return checked > 0;
+}
+
+typedef bool (*TestFunc)();
+
+TestFunc test_funcs[] = {
+
+	test_indexed_validated,
+	test_iterate_resized_packed_array,
+	test_operator_validated,
+	test_inline_cache_receivers,
+	test_inline_cache_reload,
+	test_constant_folding,
+	test_operator_evaluators,
+	test_validated_builtin_methods,
+	nullptr
+
+};
+
+static MainLoop *_test_vm() {
+	int count = 0;
+	int passed = 0;
+
+	while (true) {
+		if (!test_funcs[count]) {
+			break;
+		}
+		bool pass = test_funcs[count]();
+		if (pass) {
+			passed++;
+		}
+		OS::get_singleton()->print("\t%s\n", pass ? "PASS" : "FAILED");
+
+		count++;
+	}
+
+	OS::get_singleton()->print("\n\n\n");
+	OS::get_singleton()->print("*************\n");
+	OS::get_singleton()->print("***TOTALS!***\n");
+	OS::get_singleton()->print("*************\n");
+
+	OS::get_singleton()->print("Passed %i of %i tests\n", passed, count);
+
+	return nullptr;
 }
 
 MainLoop *test(TestType p_type) {
+	if (p_type == TEST_VM) {
+		return _test_vm();
+	}
+
 	List<String> cmdlargs = OS::get_singleton()->get_cmdline_args();
 
 	if (cmdlargs.empty()) {
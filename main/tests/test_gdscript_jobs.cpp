@@ -0,0 +1,231 @@
+/*************************************************************************/
+/*  test_gdscript_jobs.cpp                                              */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+
+#include "test_gdscript_jobs.h"
+
+#include "core/os/os.h"
+
+#include "modules/modules_enabled.gen.h"
+#ifdef MODULE_GDSCRIPT_ENABLED
+
+#include "modules/gdscript/gdscript.h"
+#include "modules/gdscript/gdscript_jobs.h"
+
+namespace TestGDScriptJobs {
+
+static const char *script_code =
+		"const SHARED = [1, 2]\n"
+		"\n"
+		"static func scale(from, to, values, factor):\n"
+		"\tfor i in range(from, to):\n"
+		"\t\tvalues[i] *= factor\n"
+		"\n"
+		"static func append_shared(from, to, values):\n"
+		"\tvar shared = SHARED\n"
+		"\tshared.append(from)\n"
+		"\n"
+		"static func set_shared(from, to, values):\n"
+		"\tvar shared = SHARED\n"
+		"\tshared[0] = from\n"
+		"\n"
+		"static func construct_from_array(from, to, values):\n"
+		"\tvar copy = PackedFloat32Array(values)\n"
+		"\n"
+		"static func add_arrays(from, to, values):\n"
+		"\tvar sum = values + values\n"
+		"\n"
+		"static func store_array(from, to, values):\n"
+		"\tvar stored = [values]\n"
+		"\n"
+		"static func resize_array(from, to, values):\n"
+		"\tvalues.resize(0)\n"
+		"\n"
+		"static func object_to_string(from, to, values):\n"
+		"\tvar text = str(Engine, from)\n"
+		"\n"
+		"static func iterate_object(from, to, values):\n"
+		"\tfor x in Engine:\n"
+		"\t\tpass\n";
+
+static Ref<GDScript> _create_script() {
+	Ref<GDScript> script;
+	script.instance();
+	script->set_source_code(script_code);
+	if (script->reload() != OK) {
+		return Ref<GDScript>();
+	}
+	return script;
+}
+
+static PackedFloat32Array _create_values(int p_count) {
+	PackedFloat32Array values;
+	values.resize(p_count);
+	for (int i = 0; i < p_count; i++) {
+		values.write[i] = i;
+	}
+	return values;
+}
+
+static bool _job_fails(const StringName &p_function) {
+	Ref<GDScript> script = _create_script();
+	if (script.is_null()) {
+		return false;
+	}
+
+	Array arguments;
+	arguments.push_back(_create_values(64));
+	return GDScriptJobs::get_singleton()->parallel_for(Callable(script.ptr(), p_function), 64, arguments, 8) == FAILED;
+}
+
+bool test_parallel_for() {
+	Ref<GDScript> script = _create_script();
+	if (script.is_null()) {
+		return false;
+	}
+
+	PackedFloat32Array values = _create_values(1000);
+	Array arguments;
+	arguments.push_back(values);
+	arguments.push_back(2.0);
+	if (GDScriptJobs::get_singleton()->parallel_for(Callable(script.ptr(), "scale"), values.size(), arguments, 16) != OK) {
+		return false;
+	}
+
+	// The job wrote to the array the caller gave.
+	PackedFloat32Array result = arguments[0];
+	for (int i = 0; i < result.size(); i++) {
+		if (result[i] != i * 2) {
+			return false;
+		}
+	}
+	return result.size() == 1000;
+}
+
+bool test_modify_shared_container() {
+	Ref<GDScript> script = _create_script();
+	if (script.is_null()) {
+		return false;
+	}
+
+	Array arguments;
+	arguments.push_back(_create_values(64));
+	if (GDScriptJobs::get_singleton()->parallel_for(Callable(script.ptr(), "append_shared"), 64, arguments, 8) != FAILED) {
+		return false;
+	}
+	if (GDScriptJobs::get_singleton()->parallel_for(Callable(script.ptr(), "set_shared"), 64, arguments, 8) != FAILED) {
+		return false;
+	}
+
+	Array shared = script->get_constants()["SHARED"];
+	return shared.size() == 2 && int(shared[0]) == 1;
+}
+
+bool test_construct_from_job_array() {
+	return _job_fails("construct_from_array");
+}
+
+bool test_add_job_arrays() {
+	return _job_fails("add_arrays");
+}
+
+bool test_store_job_array() {
+	return _job_fails("store_array");
+}
+
+bool test_resize_job_array() {
+	return _job_fails("resize_array");
+}
+
+bool test_object_to_string() {
+	return _job_fails("object_to_string");
+}
+
+bool test_iterate_object() {
+	return _job_fails("iterate_object");
+}
+
+typedef bool (*TestFunc)();
+
+TestFunc test_funcs[] = {
+
+	test_parallel_for,
+	test_modify_shared_container,
+	test_construct_from_job_array,
+	test_add_job_arrays,
+	test_store_job_array,
+	test_resize_job_array,
+	test_object_to_string,
+	test_iterate_object,
+	nullptr
+
+};
+
+MainLoop *test() {
+	int count = 0;
+	int passed = 0;
+
+	while (true) {
+		if (!test_funcs[count]) {
+			break;
+		}
+		bool pass = test_funcs[count]();
+		if (pass) {
+			passed++;
+		}
+		OS::get_singleton()->print("\t%s\n", pass ? "PASS" : "FAILED");
+
+		count++;
+	}
+
+	OS::get_singleton()->print("\n\n\n");
+	OS::get_singleton()->print("*************\n");
+	OS::get_singleton()->print("***TOTALS!***\n");
+	OS::get_singleton()->print("*************\n");
+
+	OS::get_singleton()->print("Passed %i of %i tests\n", passed, count);
+
+	return nullptr;
+}
+
+} // namespace TestGDScriptJobs
+
+#else
+
+namespace TestGDScriptJobs {
+
+MainLoop *test() {
+	ERR_PRINT("The GDScript module is disabled, therefore GDScript tests cannot be used.");
+	return nullptr;
+}
+
+} // namespace TestGDScriptJobs
+
+#endif
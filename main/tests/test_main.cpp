@@ -35,14 +35,18 @@
 #ifdef DEBUG_ENABLED
 
 #include "test_astar.h"
+#include "test_canvas_batching.h"
 #include "test_class_db.h"
 #include "test_gdscript.h"
+#include "test_gdscript_jobs.h"
 #include "test_gui.h"
 #include "test_math.h"
 #include "test_oa_hash_map.h"
 #include "test_ordered_hash_map.h"
 #include "test_physics_2d.h"
+#include "test_physics_2d_snapshot.h"
 #include "test_physics_3d.h"
+#include "test_physics_3d_shapes.h"
 #include "test_render.h"
 #include "test_shader_lang.h"
 #include "test_string.h"
@@ -52,8 +56,11 @@ const char **tests_get_names() {
 		"string",
 		"math",
 		"physics_2d",
+		"physics_2d_snapshot",
 		"physics_3d",
+		"physics_3d_shapes",
 		"render",
+		"canvas_batching",
 		"oa_hash_map",
 		"class_db",
 		"gui",
@@ -62,6 +69,8 @@ const char **tests_get_names() {
 		"gd_parser",
 		"gd_compiler",
 		"gd_bytecode",
+		"gd_vm",
+		"gd_jobs",
 		"ordered_hash_map",
 		"astar",
 		nullptr
@@ -83,14 +92,26 @@ MainLoop *test_main(String p_test, const List<String> &p_args) {
 		return TestPhysics2D::test();
 	}
 
+	if (p_test == "physics_2d_snapshot") {
+		return TestPhysics2DSnapshot::test();
+	}
+
 	if (p_test == "physics_3d") {
 		return TestPhysics3D::test();
 	}
 
+	if (p_test == "physics_3d_shapes") {
+		return TestPhysics3DShapes::test();
+	}
+
 	if (p_test == "render") {
 		return TestRender::test();
 	}
 
+	if (p_test == "canvas_batching") {
+		return TestCanvasBatching::test();
+	}
+
 	if (p_test == "oa_hash_map") {
 		return TestOAHashMap::test();
 	}
@@ -125,6 +146,14 @@ MainLoop *test_main(String p_test, const List<String> &p_args) {
 		return TestGDScript::test(TestGDScript::TEST_BYTECODE);
 	}
 
+	if (p_test == "gd_vm") {
+		return TestGDScript::test(TestGDScript::TEST_VM);
+	}
+
+	if (p_test == "gd_jobs") {
+		return TestGDScriptJobs::test();
+	}
+
 	if (p_test == "ordered_hash_map") {
 		return TestOrderedHashMap::test();
 	}
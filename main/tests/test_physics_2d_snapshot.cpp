@@ -0,0 +1,261 @@
+/*************************************************************************/
+/*  test_physics_2d_snapshot.cpp                                         */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_physics_2d_snapshot.h"
+
+#include "core/os/os.h"
+#include "servers/physics_server_2d.h"
+
+namespace TestPhysics2DSnapshot {
+
+//stepping after a restore is compared against stepping straight through, which doesn't use snapshots
+
+#define STEP_TIME (1.0 / 60.0)
+
+//a pile of boxes and circles falling on a floor, two of them pinned together, so
+//the solver has contacts to warm start and bodies going to sleep
+struct Scene {
+	RID space;
+	Vector<RID> shapes;
+	RID floor_body;
+	Vector<RID> bodies; //rigid ones, the ones whose state is compared
+	RID joint;
+
+	RID _add_body(RID p_shape, PhysicsServer2D::BodyMode p_mode, const Vector2 &p_position, const Vector2 &p_velocity = Vector2()) {
+		PhysicsServer2D *ps = PhysicsServer2D::get_singleton();
+		RID body = ps->body_create();
+		ps->body_set_mode(body, p_mode);
+		ps->body_add_shape(body, p_shape);
+		ps->body_set_space(body, space);
+		ps->body_set_state(body, PhysicsServer2D::BODY_STATE_TRANSFORM, Transform2D(0, p_position));
+		ps->body_set_state(body, PhysicsServer2D::BODY_STATE_LINEAR_VELOCITY, p_velocity);
+		if (p_mode == PhysicsServer2D::BODY_MODE_RIGID) {
+			bodies.push_back(body);
+		}
+		return body;
+	}
+
+	void step(int p_count) {
+		for (int i = 0; i < p_count; i++) {
+			PhysicsServer2D::get_singleton()->step(STEP_TIME);
+		}
+	}
+
+	//everything the next steps depend on that can be read through the server
+	Array get_state() const {
+		PhysicsServer2D *ps = PhysicsServer2D::get_singleton();
+		Array state;
+		for (int i = 0; i < bodies.size(); i++) {
+			state.push_back(ps->body_get_state(bodies[i], PhysicsServer2D::BODY_STATE_TRANSFORM));
+			state.push_back(ps->body_get_state(bodies[i], PhysicsServer2D::BODY_STATE_LINEAR_VELOCITY));
+			state.push_back(ps->body_get_state(bodies[i], PhysicsServer2D::BODY_STATE_ANGULAR_VELOCITY));
+			state.push_back(ps->body_get_state(bodies[i], PhysicsServer2D::BODY_STATE_SLEEPING));
+		}
+		return state;
+	}
+
+	Scene() {
+		PhysicsServer2D *ps = PhysicsServer2D::get_singleton();
+		space = ps->space_create();
+		ps->area_set_param(space, PhysicsServer2D::AREA_PARAM_GRAVITY, 98);
+		ps->area_set_param(space, PhysicsServer2D::AREA_PARAM_GRAVITY_VECTOR, Vector2(0, 1));
+		ps->space_set_active(space, true);
+
+		RID floor = ps->rectangle_shape_create();
+		ps->shape_set_data(floor, Vector2(500, 10));
+		RID box = ps->rectangle_shape_create();
+		ps->shape_set_data(box, Vector2(10, 10));
+		RID circle = ps->circle_shape_create();
+		ps->shape_set_data(circle, 8);
+		shapes.push_back(floor);
+		shapes.push_back(box);
+		shapes.push_back(circle);
+
+		floor_body = _add_body(floor, PhysicsServer2D::BODY_MODE_STATIC, Vector2(0, 300));
+		for (int row = 0; row < 4; row++) {
+			for (int i = 0; i <= row; i++) {
+				_add_body(box, PhysicsServer2D::BODY_MODE_RIGID, Vector2(i * 22 - row * 11, 200 - (4 - row) * 21));
+			}
+		}
+		for (int i = 0; i < 6; i++) {
+			_add_body(circle, PhysicsServer2D::BODY_MODE_RIGID, Vector2(-60 + i * 24, 40 - (i % 2) * 20), Vector2(i * 7 - 20, 0));
+		}
+
+		RID a = bodies[bodies.size() - 2];
+		RID b = bodies[bodies.size() - 1];
+		joint = ps->pin_joint_create(Vector2(72, 30), a, b);
+	}
+
+	~Scene() {
+		PhysicsServer2D *ps = PhysicsServer2D::get_singleton();
+		ps->free(joint);
+		ps->free(floor_body);
+		for (int i = 0; i < bodies.size(); i++) {
+			ps->free(bodies[i]);
+		}
+		for (int i = 0; i < shapes.size(); i++) {
+			ps->free(shapes[i]);
+		}
+		ps->free(space);
+	}
+};
+
+#define SNAPSHOT_STEP 40
+#define REPLAY_STEPS 120
+
+static bool _same_state(const Array &p_state, const Array &p_expected, const char *p_what) {
+	if (!Variant(p_state).hash_compare(p_expected)) {
+		OS::get_singleton()->print("\t%s: state differs\n", p_what);
+		return false;
+	}
+	return true;
+}
+
+bool test_restore_replays() {
+	Scene scene;
+	scene.step(SNAPSHOT_STEP);
+	Vector<uint8_t> snapshot = PhysicsServer2D::get_singleton()->space_save_snapshot(scene.space);
+	Array at_snapshot = scene.get_state();
+
+	scene.step(REPLAY_STEPS);
+	Array expected = scene.get_state();
+
+	//restoring brings back the state, and stepping from there the same results, every time
+	for (int i = 0; i < 2; i++) {
+		PhysicsServer2D::get_singleton()->space_restore_snapshot(scene.space, snapshot);
+		if (!_same_state(scene.get_state(), at_snapshot, "restored")) {
+			return false;
+		}
+		scene.step(REPLAY_STEPS);
+		if (!_same_state(scene.get_state(), expected, "replayed")) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool test_restore_overrides_changes() {
+	Scene scene;
+	scene.step(SNAPSHOT_STEP);
+	Vector<uint8_t> snapshot = PhysicsServer2D::get_singleton()->space_save_snapshot(scene.space);
+	scene.step(REPLAY_STEPS);
+	Array expected = scene.get_state();
+
+	//bodies moved, woken up or put to sleep by hand don't leak into the replay
+	PhysicsServer2D *ps = PhysicsServer2D::get_singleton();
+	for (int i = 0; i < scene.bodies.size(); i++) {
+		ps->body_set_state(scene.bodies[i], PhysicsServer2D::BODY_STATE_TRANSFORM, Transform2D(i * 0.1, Vector2(i * 30, -100)));
+		ps->body_set_state(scene.bodies[i], PhysicsServer2D::BODY_STATE_LINEAR_VELOCITY, Vector2(-i, i));
+		ps->body_set_state(scene.bodies[i], PhysicsServer2D::BODY_STATE_SLEEPING, i % 2 == 0);
+	}
+	scene.step(3);
+
+	ps->space_restore_snapshot(scene.space, snapshot);
+	scene.step(REPLAY_STEPS);
+	return _same_state(scene.get_state(), expected, "replayed after changes");
+}
+
+bool test_fresh_run_matches() {
+	//stepping is deterministic, a new space with the same objects ends in the same state
+	Array expected;
+	{
+		Scene scene;
+		scene.step(SNAPSHOT_STEP + REPLAY_STEPS);
+		expected = scene.get_state();
+	}
+
+	Scene scene;
+	scene.step(SNAPSHOT_STEP);
+	Vector<uint8_t> snapshot = PhysicsServer2D::get_singleton()->space_save_snapshot(scene.space);
+	scene.step(REPLAY_STEPS);
+	if (!_same_state(scene.get_state(), expected, "fresh run")) {
+		return false;
+	}
+
+	PhysicsServer2D::get_singleton()->space_restore_snapshot(scene.space, snapshot);
+	scene.step(REPLAY_STEPS);
+	return _same_state(scene.get_state(), expected, "fresh run replayed");
+}
+
+bool test_invalid_snapshot() {
+	//garbage is rejected without touching the space
+	Scene scene;
+	scene.step(SNAPSHOT_STEP);
+	Array expected = scene.get_state();
+
+	Vector<uint8_t> garbage;
+	for (int i = 0; i < 64; i++) {
+		garbage.push_back(i);
+	}
+	PhysicsServer2D::get_singleton()->space_restore_snapshot(scene.space, garbage);
+	PhysicsServer2D::get_singleton()->space_restore_snapshot(scene.space, Vector<uint8_t>());
+	return _same_state(scene.get_state(), expected, "invalid snapshot");
+}
+
+typedef bool (*TestFunc)();
+
+TestFunc test_funcs[] = {
+
+	test_restore_replays,
+	test_restore_overrides_changes,
+	test_fresh_run_matches,
+	test_invalid_snapshot,
+	nullptr
+
+};
+
+MainLoop *test() {
+	int count = 0;
+	int passed = 0;
+
+	while (true) {
+		if (!test_funcs[count]) {
+			break;
+		}
+		bool pass = test_funcs[count]();
+		if (pass) {
+			passed++;
+		}
+		OS::get_singleton()->print("\t%s\n", pass ? "PASS" : "FAILED");
+
+		count++;
+	}
+
+	OS::get_singleton()->print("\n\n\n");
+	OS::get_singleton()->print("*************\n");
+	OS::get_singleton()->print("***TOTALS!***\n");
+	OS::get_singleton()->print("*************\n");
+
+	OS::get_singleton()->print("Passed %i of %i tests\n", passed, count);
+
+	return nullptr;
+}
+
+} // namespace TestPhysics2DSnapshot
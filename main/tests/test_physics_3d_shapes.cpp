@@ -0,0 +1,392 @@
+/*************************************************************************/
+/*  test_physics_3d_shapes.cpp                                           */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "test_physics_3d_shapes.h"
+
+#include "core/math/random_pcg.h"
+#include "core/os/os.h"
+#include "servers/physics_3d/shape_3d_sw.h"
+
+namespace TestPhysics3DShapes {
+
+//the accelerated queries of concave shapes (BVH, height map pyramid) are compared against testing every face
+
+static bool _same_face(const Face3 &p_a, const Face3 &p_b) {
+	return p_a.vertex[0] == p_b.vertex[0] && p_a.vertex[1] == p_b.vertex[1] && p_a.vertex[2] == p_b.vertex[2];
+}
+
+static int _find_face(const Vector<Face3> &p_faces, const Face3 &p_face) {
+	for (int i = 0; i < p_faces.size(); i++) {
+		if (_same_face(p_faces[i], p_face)) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+static void _collect_face(void *p_userdata, Shape3DSW *p_convex) {
+	const FaceShape3DSW *face = static_cast<const FaceShape3DSW *>(p_convex);
+	static_cast<Vector<Face3> *>(p_userdata)->push_back(Face3(face->vertex[0], face->vertex[1], face->vertex[2]));
+}
+
+static Vector<Face3> _to_faces(const Vector<Vector3> &p_vertices) {
+	Vector<Face3> faces;
+	for (int i = 0; i < p_vertices.size(); i += 3) {
+		faces.push_back(Face3(p_vertices[i], p_vertices[i + 1], p_vertices[i + 2]));
+	}
+	return faces;
+}
+
+//same test as the shape, on every face
+static bool _brute_intersect_segment(const Vector<Face3> &p_faces, const Vector3 &p_begin, const Vector3 &p_end, Vector3 &r_result, Vector3 &r_normal) {
+	Vector3 dir = (p_end - p_begin).normalized();
+	real_t from_d = dir.dot(p_begin);
+	real_t min_d = 1e20;
+	bool hit = false;
+
+	for (int i = 0; i < p_faces.size(); i++) {
+		const Face3 &f = p_faces[i];
+		Vector3 res;
+		if (Geometry3D::segment_intersects_triangle(p_begin, p_end, f.vertex[0], f.vertex[1], f.vertex[2], &res)) {
+			real_t d = dir.dot(res) - from_d;
+			if (d > 0 && d < min_d) {
+				min_d = d;
+				r_result = res;
+				r_normal = f.get_plane().normal;
+				hit = true;
+			}
+		}
+	}
+	return hit;
+}
+
+static bool _check_segment(const ConcaveShape3DSW &p_shape, const Vector<Face3> &p_faces, const Vector3 &p_begin, const Vector3 &p_end) {
+	Vector3 result, normal;
+	Vector3 expected_result, expected_normal;
+	bool hit = p_shape.intersect_segment(p_begin, p_end, result, normal);
+	bool expected_hit = _brute_intersect_segment(p_faces, p_begin, p_end, expected_result, expected_normal);
+
+	if (hit != expected_hit || (hit && (!result.is_equal_approx(expected_result) || !normal.is_equal_approx(expected_normal)))) {
+		OS::get_singleton()->print("\tsegment %s -> %s: hit %d at %s, expected hit %d at %s\n", String(p_begin).utf8().get_data(), String(p_end).utf8().get_data(), hit, String(result).utf8().get_data(), expected_hit, String(expected_result).utf8().get_data());
+		return false;
+	}
+	return true;
+}
+
+//culling may report a few more faces than the ones overlapping, up to p_tolerance away, but must not miss any
+static bool _check_cull(const ConcaveShape3DSW &p_shape, const Vector<Face3> &p_faces, const AABB &p_aabb, real_t p_tolerance) {
+	Vector<Face3> culled;
+	p_shape.cull(p_aabb, _collect_face, &culled);
+
+	for (int i = 0; i < culled.size(); i++) {
+		if (_find_face(culled, culled[i]) != i || !culled[i].get_aabb().intersects(p_aabb.grow(p_tolerance))) {
+			OS::get_singleton()->print("\tcull %s: face %s reported twice or too far away\n", String(p_aabb).utf8().get_data(), String(culled[i]).utf8().get_data());
+			return false;
+		}
+	}
+	for (int i = 0; i < p_faces.size(); i++) {
+		if (p_faces[i].get_aabb().intersects(p_aabb) && _find_face(culled, p_faces[i]) < 0) {
+			OS::get_singleton()->print("\tcull %s: face %s missing\n", String(p_aabb).utf8().get_data(), String(p_faces[i]).utf8().get_data());
+			return false;
+		}
+	}
+	return true;
+}
+
+static Vector3 _random_point(RandomPCG &p_rng, const AABB &p_aabb) {
+	return p_aabb.position + Vector3(p_rng.random(0.0f, 1.0f), p_rng.random(0.0f, 1.0f), p_rng.random(0.0f, 1.0f)) * p_aabb.size;
+}
+
+//random segments and boxes around the shape, plus axis aligned segments which hit the slab tests edge cases
+static bool _check_queries(const ConcaveShape3DSW &p_shape, const Vector<Face3> &p_faces, uint64_t p_seed, real_t p_cull_tolerance) {
+	RandomPCG rng(p_seed);
+	AABB bounds = p_shape.get_aabb().grow(1.0);
+	real_t tolerance = p_cull_tolerance;
+
+	for (int i = 0; i < 300; i++) {
+		Vector3 begin = _random_point(rng, bounds);
+		Vector3 end = _random_point(rng, bounds);
+		if (!_check_segment(p_shape, p_faces, begin, end)) {
+			return false;
+		}
+
+		Vector3 axis_end = begin;
+		axis_end[i % 3] = (i & 4) ? bounds.position[i % 3] : bounds.position[i % 3] + bounds.size[i % 3];
+		if (!_check_segment(p_shape, p_faces, begin, axis_end)) {
+			return false;
+		}
+	}
+
+	for (int i = 0; i < 200; i++) {
+		AABB aabb(_random_point(rng, bounds), Vector3());
+		aabb.expand_to(aabb.position + Vector3(rng.random(0.0f, 4.0f), rng.random(0.0f, 4.0f), rng.random(0.0f, 4.0f)));
+		if (!_check_cull(p_shape, p_faces, aabb, tolerance)) {
+			return false;
+		}
+	}
+
+	//whole shape, and a flat box through its middle
+	AABB flat = bounds;
+	flat.position.y += bounds.size.y * 0.5;
+	flat.size.y = 0;
+	return _check_cull(p_shape, p_faces, bounds, tolerance) && _check_cull(p_shape, p_faces, flat, tolerance);
+}
+
+//the BVH bounds are quantized, which is far below this
+static real_t _concave_tolerance(const ConcavePolygonShape3DSW &p_shape) {
+	return p_shape.get_aabb().get_longest_axis_size() * 0.001;
+}
+
+//scattered triangles of varied sizes, which overlap a lot and stress the tree build
+static Vector<Vector3> _random_soup(int p_count, uint64_t p_seed) {
+	RandomPCG rng(p_seed);
+	AABB area(Vector3(-20, -5, -20), Vector3(40, 10, 40));
+
+	Vector<Vector3> vertices;
+	for (int i = 0; i < p_count; i++) {
+		Vector3 center = _random_point(rng, area);
+		real_t size = rng.random(0.1f, i % 10 == 0 ? 15.0f : 2.0f);
+		for (int j = 0; j < 3; j++) {
+			vertices.push_back(center + Vector3(rng.random(-size, size), rng.random(-size, size), rng.random(-size, size)));
+		}
+	}
+	return vertices;
+}
+
+bool test_concave_soup() {
+	Vector<Vector3> soup = _random_soup(500, 1);
+	ConcavePolygonShape3DSW shape;
+	shape.set_data(soup);
+
+	Vector<Face3> faces = _to_faces(soup);
+	return Variant(shape.get_faces()).hash_compare(soup) && _check_queries(shape, faces, 2, _concave_tolerance(shape));
+}
+
+bool test_concave_indexed() {
+	//a bumpy grid sharing its vertices, with an unreferenced vertex in front, built both ways
+	const int size = 24;
+	RandomPCG rng(3);
+	Vector<Vector3> vertices;
+	vertices.push_back(Vector3(1000, 1000, 1000));
+	for (int z = 0; z <= size; z++) {
+		for (int x = 0; x <= size; x++) {
+			vertices.push_back(Vector3(x, rng.random(-1.0f, 1.0f), z));
+		}
+	}
+
+	Vector<int> indices;
+	Vector<Vector3> soup;
+	for (int z = 0; z < size; z++) {
+		for (int x = 0; x < size; x++) {
+			int i = 1 + z * (size + 1) + x;
+			const int quad[6] = { i, i + 1, i + size + 1, i + 1, i + size + 2, i + size + 1 };
+			for (int j = 0; j < 6; j++) {
+				indices.push_back(quad[j]);
+				soup.push_back(vertices[quad[j]]);
+			}
+		}
+	}
+	Vector<Face3> faces = _to_faces(soup);
+
+	for (int i = 0; i < 2; i++) {
+		Dictionary data;
+		data["triangles"] = vertices;
+		data["indices"] = indices;
+		data["fast_build"] = i == 1;
+
+		ConcavePolygonShape3DSW shape;
+		shape.set_data(data);
+		//the unreferenced vertex must not be picked as support
+		if (!Variant(shape.get_faces()).hash_compare(soup) || shape.get_support(Vector3(1, 1, 1).normalized()) == vertices[0]) {
+			return false;
+		}
+		if (!_check_queries(shape, faces, 4 + i, _concave_tolerance(shape))) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool test_concave_invalid_data() {
+	//bad input is rejected and keeps the previous shape
+	Vector<Vector3> soup = _random_soup(10, 5);
+	ConcavePolygonShape3DSW shape;
+	shape.set_data(soup);
+
+	Dictionary data;
+	data["triangles"] = soup;
+	Vector<int> indices;
+	indices.push_back(0);
+	indices.push_back(1);
+	indices.push_back(soup.size());
+	data["indices"] = indices;
+	shape.set_data(data);
+
+	return Variant(shape.get_faces()).hash_compare(soup) && _check_queries(shape, _to_faces(soup), 6, _concave_tolerance(shape));
+}
+
+//same faces as the height map, one quad per cell split along the same diagonal
+static Vector<Face3> _height_map_faces(const HeightMapShape3DSW &p_shape) {
+	Vector<real_t> heights = p_shape.get_heights();
+	int width = p_shape.get_width();
+	int depth = p_shape.get_depth();
+	real_t cell_size = p_shape.get_cell_size();
+	Vector3 origin((width - 1) * cell_size * -0.5, 0, (depth - 1) * cell_size * -0.5);
+
+	Vector<Face3> faces;
+	for (int z = 0; z < depth - 1; z++) {
+		for (int x = 0; x < width - 1; x++) {
+			Vector3 v00 = origin + Vector3(x * cell_size, heights[z * width + x], z * cell_size);
+			Vector3 v10 = origin + Vector3((x + 1) * cell_size, heights[z * width + x + 1], z * cell_size);
+			Vector3 v01 = origin + Vector3(x * cell_size, heights[(z + 1) * width + x], (z + 1) * cell_size);
+			Vector3 v11 = origin + Vector3((x + 1) * cell_size, heights[(z + 1) * width + x + 1], (z + 1) * cell_size);
+			faces.push_back(Face3(v00, v10, v01));
+			faces.push_back(Face3(v10, v11, v01));
+		}
+	}
+	return faces;
+}
+
+static Dictionary _height_map_data(int p_width, int p_depth, real_t p_cell_size, real_t p_amplitude, uint64_t p_seed) {
+	RandomPCG rng(p_seed);
+	Vector<real_t> heights;
+	for (int i = 0; i < p_width * p_depth; i++) {
+		heights.push_back(rng.random(-p_amplitude, p_amplitude));
+	}
+
+	Dictionary d;
+	d["width"] = p_width;
+	d["depth"] = p_depth;
+	d["cell_size"] = p_cell_size;
+	d["heights"] = heights;
+	return d;
+}
+
+//culling works on whole cells, so reported faces can be a cell and the height range of a cell away
+static real_t _height_map_tolerance(real_t p_cell_size, real_t p_amplitude) {
+	return p_cell_size + p_amplitude * 2;
+}
+
+bool test_height_map() {
+	//sizes that aren't powers of two leave partial blocks at the edges of every pyramid level
+	const int sizes[4][2] = { { 2, 2 }, { 17, 17 }, { 37, 23 }, { 64, 3 } };
+	for (int i = 0; i < 4; i++) {
+		real_t cell_size = i == 2 ? 0.5 : 1.0;
+		HeightMapShape3DSW shape;
+		shape.set_data(_height_map_data(sizes[i][0], sizes[i][1], cell_size, 3.0, 10 + i));
+
+		if (!_check_queries(shape, _height_map_faces(shape), 20 + i, _height_map_tolerance(cell_size, 3.0))) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool test_height_map_flat() {
+	//every block of the pyramid has the same (empty) height range
+	HeightMapShape3DSW shape;
+	shape.set_data(_height_map_data(20, 20, 1.0, 0.0, 30));
+	return _check_queries(shape, _height_map_faces(shape), 31, _height_map_tolerance(1.0, 0.0));
+}
+
+bool test_height_map_region_update() {
+	HeightMapShape3DSW shape;
+	shape.set_data(_height_map_data(33, 29, 1.0, 1.0, 40));
+
+	//raise a few regions, including ones on the edges, and check the pyramid follows
+	RandomPCG rng(41);
+	const Rect2i regions[4] = { Rect2i(5, 5, 4, 3), Rect2i(0, 0, 1, 1), Rect2i(30, 20, 3, 9), Rect2i(0, 10, 33, 2) };
+	for (int i = 0; i < 4; i++) {
+		Vector<real_t> heights;
+		for (int j = 0; j < regions[i].size.x * regions[i].size.y; j++) {
+			heights.push_back(rng.random(5.0f, 10.0f));
+		}
+
+		Dictionary d;
+		d["width"] = 33;
+		d["depth"] = 29;
+		d["cell_size"] = 1.0;
+		d["heights"] = heights;
+		d["region"] = regions[i];
+		shape.set_data(d);
+
+		if (!_check_queries(shape, _height_map_faces(shape), 42 + i, _height_map_tolerance(1.0, 10.0))) {
+			return false;
+		}
+	}
+
+	//same shape built from scratch
+	HeightMapShape3DSW rebuilt;
+	rebuilt.set_data(shape.get_data());
+	return rebuilt.get_aabb() == shape.get_aabb() && _check_queries(rebuilt, _height_map_faces(shape), 46, _height_map_tolerance(1.0, 10.0));
+}
+
+typedef bool (*TestFunc)();
+
+TestFunc test_funcs[] = {
+
+	test_concave_soup,
+	test_concave_indexed,
+	test_concave_invalid_data,
+	test_height_map,
+	test_height_map_flat,
+	test_height_map_region_update,
+	nullptr
+
+};
+
+MainLoop *test() {
+	int count = 0;
+	int passed = 0;
+
+	while (true) {
+		if (!test_funcs[count]) {
+			break;
+		}
+		bool pass = test_funcs[count]();
+		if (pass) {
+			passed++;
+		}
+		OS::get_singleton()->print("\t%s\n", pass ? "PASS" : "FAILED");
+
+		count++;
+	}
+
+	OS::get_singleton()->print("\n\n\n");
+	OS::get_singleton()->print("*************\n");
+	OS::get_singleton()->print("***TOTALS!***\n");
+	OS::get_singleton()->print("*************\n");
+
+	OS::get_singleton()->print("Passed %i of %i tests\n", passed, count);
+
+	return nullptr;
+}
+
+} // namespace TestPhysics3DShapes
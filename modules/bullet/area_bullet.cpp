@@ -101,11 +101,29 @@ void AreaBullet::call_event(CollisionObjectBullet *p_otherObject, PhysicsServer3
 		return;
 	}
 
-	call_event_res[0] = p_status;
-	call_event_res[1] = p_otherObject->get_self(); // Other body
-	call_event_res[2] = p_otherObject->get_instance_id(); // instance ID
-	call_event_res[3] = 0; // other_body_shape ID
-	call_event_res[4] = 0; // self_shape ID
+	if (monitor_batching) {
+		// Events are dispatched as they happen here, so every batch holds a single change
+		PackedInt32Array status;
+		status.push_back(p_status);
+		Array other;
+		other.push_back(p_otherObject->get_self());
+		PackedInt64Array instance;
+		instance.push_back(int64_t(p_otherObject->get_instance_id()));
+		PackedInt32Array shape;
+		shape.push_back(0);
+
+		call_event_res[0] = status;
+		call_event_res[1] = other;
+		call_event_res[2] = instance;
+		call_event_res[3] = shape; // other_body_shape IDs
+		call_event_res[4] = shape; // self_shape IDs
+	} else {
+		call_event_res[0] = p_status;
+		call_event_res[1] = p_otherObject->get_self(); // Other body
+		call_event_res[2] = p_otherObject->get_instance_id(); // instance ID
+		call_event_res[3] = 0; // other_body_shape ID
+		call_event_res[4] = 0; // self_shape ID
+	}
 
 	Callable::CallError outResp;
 	areaGodoObject->call(event.event_callback_method, (const Variant **)call_event_res_ptr, 5, outResp);
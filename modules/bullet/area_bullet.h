@@ -85,6 +85,7 @@ private:
 	btGhostObject *btGhost;
 	Vector<OverlappingObjectData> overlappingObjects;
 	bool monitorable = true;
+	bool monitor_batching = false;
 
 	PhysicsServer3D::AreaSpaceOverrideMode spOv_mode = PhysicsServer3D::AREA_SPACE_OVERRIDE_DISABLED;
 	bool spOv_gravityPoint = false;
@@ -166,6 +167,8 @@ public:
 	void set_event_callback(Type p_callbackObjectType, ObjectID p_id, const StringName &p_method);
 	bool has_event_callback(Type p_callbackObjectType);
 
+	_FORCE_INLINE_ void set_monitor_batching(bool p_enable) { monitor_batching = p_enable; }
+
 	virtual void on_enter_area(AreaBullet *p_area);
 	virtual void on_exit_area(AreaBullet *p_area);
 };
@@ -427,6 +427,13 @@ void BulletPhysicsServer3D::area_set_area_monitor_callback(RID p_area, Object *p
 	area->set_event_callback(CollisionObjectBullet::TYPE_AREA, p_receiver ? p_receiver->get_instance_id() : ObjectID(), p_method);
 }
 
+void BulletPhysicsServer3D::area_set_monitor_batching(RID p_area, bool p_enable) {
+	AreaBullet *area = area_owner.getornull(p_area);
+	ERR_FAIL_COND(!area);
+
+	area->set_monitor_batching(p_enable);
+}
+
 void BulletPhysicsServer3D::area_set_ray_pickable(RID p_area, bool p_enable) {
 	AreaBullet *area = area_owner.getornull(p_area);
 	ERR_FAIL_COND(!area);
@@ -39,6 +39,7 @@
 #include "core/os/file_access.h"
 #include "core/os/os.h"
 #include "core/project_settings.h"
+#include "gdscript_bytecode_cache.h"
 #include "gdscript_compiler.h"
 
 ///////////////////////////
@@ -554,6 +555,7 @@ Error GDScript::reload(bool p_keep_state) {
 	}
 
 	valid = false;
+	cache_fingerprint = String();
 	GDScriptParser parser;
 	Error err = parser.parse(source, basedir, false, path);
 	if (err) {
@@ -568,6 +570,7 @@ Error GDScript::reload(bool p_keep_state) {
 
 	GDScriptCompiler compiler;
 	err = compiler.compile(&parser, this, p_keep_state);
+	compile_dependencies = parser.get_loaded_dependencies();
 
 	if (err) {
 		if (can_run) {
@@ -806,6 +809,7 @@ Error GDScript::load_byte_code(const String &p_path) {
 	}
 
 	valid = false;
+	cache_fingerprint = String();
 	GDScriptParser parser;
 	Error err = parser.parse_bytecode(bytecode, basedir, get_path());
 	if (err) {
@@ -815,6 +819,7 @@ Error GDScript::load_byte_code(const String &p_path) {
 
 	GDScriptCompiler compiler;
 	err = compiler.compile(&parser, this);
+	compile_dependencies = parser.get_loaded_dependencies();
 
 	if (err) {
 		_err_print_error("GDScript::load_byte_code", path.empty() ? "built-in" : (const char *)path.utf8().get_data(), compiler.get_error_line(), ("Compile Error: " + compiler.get_error()).utf8().get_data(), ERR_HANDLER_SCRIPT);
@@ -1054,6 +1059,7 @@ GDScript::~GDScript() {
 	for (Map<StringName, GDScriptFunction *>::Element *E = member_functions.front(); E; E = E->next()) {
 		memdelete(E->get());
 	}
+	GDScriptFunction::invalidate_inline_caches();
 
 	_save_orphaned_subclasses();
 
@@ -1551,6 +1557,7 @@ Error GDScriptLanguage::execute_file(const String &p_path) {
 }
 
 void GDScriptLanguage::finish() {
+	GDScriptFunctionState::cleanup_frame_pool();
 }
 
 void GDScriptLanguage::profiling_start() {
@@ -2185,6 +2192,7 @@ GDScriptLanguage::GDScriptLanguage() {
 	_debug_call_stack_pos = 0;
 	int dmcs = GLOBAL_DEF("debug/settings/gdscript/max_call_stack", 1024);
 	ProjectSettings::get_singleton()->set_custom_property_info("debug/settings/gdscript/max_call_stack", PropertyInfo(Variant::INT, "debug/settings/gdscript/max_call_stack", PROPERTY_HINT_RANGE, "1024,4096,1,or_greater")); //minimum is 1024
+	GLOBAL_DEF("debug/settings/gdscript/cache_compiled_bytecode", true);
 
 	if (EngineDebugger::is_active()) {
 		//debugging enabled!
@@ -2246,11 +2254,23 @@ RES ResourceFormatLoaderGDScript::load(const String &p_path, const String &p_ori
 
 	Ref<GDScript> scriptres(script);
 
+	// Encrypted scripts are never cached, the entry would hold their bytecode in plain text.
+	bool use_cache = GDScriptBytecodeCache::is_enabled() && !p_path.ends_with(".gde");
+
 	if (p_path.ends_with(".gde") || p_path.ends_with(".gdc")) {
 		script->set_script_path(p_original_path); // script needs this.
 		script->set_path(p_original_path);
-		Error err = script->load_byte_code(p_path);
-		ERR_FAIL_COND_V_MSG(err != OK, RES(), "Cannot load byte code from file '" + p_path + "'.");
+
+		String source_hash = use_cache ? FileAccess::get_md5(p_path) : String();
+		script->set_script_path(p_path); // Same as what load_byte_code() sets.
+		if (source_hash.empty() || GDScriptBytecodeCache::load(script, source_hash) != OK) {
+			Error err = script->load_byte_code(p_path);
+			ERR_FAIL_COND_V_MSG(err != OK, RES(), "Cannot load byte code from file '" + p_path + "'.");
+
+			if (!source_hash.empty()) {
+				GDScriptBytecodeCache::save(script, source_hash);
+			}
+		}
 
 	} else {
 		Error err = script->load_source_code(p_path);
@@ -2259,7 +2279,14 @@ RES ResourceFormatLoaderGDScript::load(const String &p_path, const String &p_ori
 		script->set_script_path(p_original_path); // script needs this.
 		script->set_path(p_original_path);
 
-		script->reload();
+		String source_hash = use_cache ? script->get_source_code().md5_text() : String();
+		if (source_hash.empty() || GDScriptBytecodeCache::load(script, source_hash) != OK) {
+			script->reload();
+
+			if (!source_hash.empty()) {
+				GDScriptBytecodeCache::save(script, source_hash);
+			}
+		}
 	}
 	if (r_error) {
 		*r_error = OK;
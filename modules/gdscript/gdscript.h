@@ -72,6 +72,10 @@ class GDScript : public Script {
 	friend class GDScriptCompiler;
 	friend class GDScriptFunctions;
 	friend class GDScriptLanguage;
+	friend class GDScriptBytecodeCache;
+	friend class GDScriptCacheReader;
+	friend class GDScriptCacheWriter;
+	friend class GDScriptJobs;
 
 	Ref<GDScriptNativeClass> native;
 	Ref<GDScript> base;
@@ -115,6 +119,12 @@ class GDScript : public Script {
 	String fully_qualified_name;
 	SelfList<GDScript> script_list;
 
+	// Scripts and resources the last compilation resolved against, and the
+	// identity of the result as seen by the bytecode cache.
+	Set<String> compile_dependencies;
+	String cache_source_hash;
+	String cache_fingerprint;
+
 	SelfList<GDScriptFunctionState>::List pending_func_states;
 
 	GDScriptInstance *_create_instance(const Variant **p_args, int p_argcount, Object *p_owner, bool p_isref, Callable::CallError &r_error);
@@ -0,0 +1,1503 @@
+/*************************************************************************/
+/*  gdscript_bytecode_cache.cpp                                          */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "gdscript_bytecode_cache.h"
+
+#include "core/crypto/crypto_core.h"
+#include "core/debugger/engine_debugger.h"
+#include "core/engine.h"
+#include "core/io/marshalls.h"
+#include "core/io/resource_loader.h"
+#include "core/os/dir_access.h"
+#include "core/os/file_access.h"
+#include "core/os/mutex.h"
+#include "core/project_settings.h"
+#include "core/version.h"
+#include "core/version_hash.gen.h"
+#include "gdscript.h"
+#include "gdscript_functions.h"
+#include "gdscript_validated_ops.h"
+
+#define CACHE_DIR "user://gdscript_cache"
+#define CACHE_MAGIC 0x43424447 // "GDBC"
+#define CACHE_FORMAT_VERSION 4
+
+enum CachedVariantTag {
+	CACHED_VARIANT_VALUE,
+	CACHED_VARIANT_ARRAY,
+	CACHED_VARIANT_DICTIONARY,
+	CACHED_VARIANT_NULL_OBJECT,
+	CACHED_VARIANT_NATIVE_CLASS,
+	CACHED_VARIANT_SCRIPT,
+	CACHED_VARIANT_RESOURCE,
+};
+
+static String _get_build_id() {
+	String id = String(VERSION_FULL_BUILD) + "." + VERSION_HASH;
+#ifdef TOOLS_ENABLED
+	id += ".tools";
+#endif
+#ifdef DEBUG_ENABLED
+	id += ".debug";
+#endif
+#ifdef REAL_T_IS_DOUBLE
+	id += ".double";
+#endif
+	return id;
+}
+
+class GDScriptCacheWriter {
+	const GDScript *root = nullptr;
+
+	void _put_script(const GDScript *p_script) {
+		// Inner classes are stored as the path of the file they live in plus the chain of class names.
+		Vector<StringName> chain;
+		const GDScript *top = p_script;
+		while (top->_owner) {
+			const Map<StringName, Ref<GDScript>>::Element *E = top->_owner->subclasses.front();
+			while (E && E->get().ptr() != top) {
+				E = E->next();
+			}
+			if (!E) {
+				failed = true;
+				return;
+			}
+			chain.push_back(E->key());
+			top = top->_owner;
+		}
+
+		String path;
+		if (top != root) {
+			path = top->get_path();
+			if (path.empty() || path.find("::") != -1) {
+				failed = true;
+				return;
+			}
+			dependencies.insert(path);
+		}
+
+		put_32(CACHED_VARIANT_SCRIPT);
+		put_string(path);
+		put_32(chain.size());
+		for (int i = chain.size() - 1; i >= 0; i--) {
+			put_string(chain[i]);
+		}
+	}
+
+	void _put_object(Object *p_object) {
+		if (!p_object) {
+			put_32(CACHED_VARIANT_NULL_OBJECT);
+			return;
+		}
+
+		GDScriptNativeClass *native = Object::cast_to<GDScriptNativeClass>(p_object);
+		if (native) {
+			put_32(CACHED_VARIANT_NATIVE_CLASS);
+			put_string(native->get_name());
+			return;
+		}
+
+		GDScript *script = Object::cast_to<GDScript>(p_object);
+		if (script) {
+			_put_script(script);
+			return;
+		}
+
+		Resource *resource = Object::cast_to<Resource>(p_object);
+		if (resource && resource->get_path() != String() && resource->get_path().find("::") == -1) {
+			put_32(CACHED_VARIANT_RESOURCE);
+			put_string(resource->get_path());
+			dependencies.insert(resource->get_path());
+			return;
+		}
+
+		// Anything else can't be recreated from disk.
+		failed = true;
+	}
+
+public:
+	Vector<uint8_t> data;
+	Set<String> dependencies; // Other scripts and resources the serialized data refers to.
+	bool failed = false;
+
+	void put_32(uint32_t p_value) {
+		int ofs = data.size();
+		data.resize(ofs + 4);
+		encode_uint32(p_value, &data.write[ofs]);
+	}
+
+	void put_buffer(const uint8_t *p_buffer, int p_len) {
+		if (p_len == 0) {
+			return;
+		}
+		int ofs = data.size();
+		data.resize(ofs + p_len);
+		copymem(&data.write[ofs], p_buffer, p_len);
+	}
+
+	void put_string(const String &p_string) {
+		CharString utf8 = p_string.utf8();
+		put_32(utf8.length());
+		put_buffer((const uint8_t *)utf8.get_data(), utf8.length());
+	}
+
+	void put_variant(const Variant &p_variant) {
+		switch (p_variant.get_type()) {
+			case Variant::ARRAY: {
+				Array array = p_variant;
+				put_32(CACHED_VARIANT_ARRAY);
+				put_32(array.size());
+				for (int i = 0; i < array.size(); i++) {
+					put_variant(array[i]);
+				}
+			} break;
+			case Variant::DICTIONARY: {
+				Dictionary dict = p_variant;
+				List<Variant> keys;
+				dict.get_key_list(&keys);
+				put_32(CACHED_VARIANT_DICTIONARY);
+				put_32(keys.size());
+				for (List<Variant>::Element *E = keys.front(); E; E = E->next()) {
+					put_variant(E->get());
+					put_variant(dict[E->get()]);
+				}
+			} break;
+			case Variant::OBJECT: {
+				_put_object(p_variant.get_validated_object());
+			} break;
+			case Variant::_RID:
+			case Variant::CALLABLE:
+			case Variant::SIGNAL: {
+				failed = true;
+			} break;
+			default: {
+				int len;
+				Error err = encode_variant(p_variant, nullptr, len);
+				if (err) {
+					failed = true;
+					return;
+				}
+				put_32(CACHED_VARIANT_VALUE);
+				put_32(len);
+				int ofs = data.size();
+				data.resize(ofs + len);
+				encode_variant(p_variant, &data.write[ofs], len);
+			} break;
+		}
+	}
+
+	void put_data_type(const GDScriptDataType &p_type) {
+		put_32(p_type.kind);
+		put_32(p_type.has_type);
+		put_32(p_type.builtin_type);
+		put_string(p_type.native_type);
+		put_variant(p_type.script_type);
+	}
+
+	void put_property(const PropertyInfo &p_property) {
+		put_32(p_property.type);
+		put_string(p_property.name);
+		put_string(p_property.class_name);
+		put_32(p_property.hint);
+		put_string(p_property.hint_string);
+		put_32(p_property.usage);
+	}
+
+	void put_class_tree(const GDScript *p_script) {
+		put_32(p_script->subclasses.size());
+		for (const Map<StringName, Ref<GDScript>>::Element *E = p_script->subclasses.front(); E; E = E->next()) {
+			put_string(E->key());
+			put_class_tree(E->get().ptr());
+		}
+	}
+
+	void put_function(const GDScriptFunction *p_function) {
+		put_string(p_function->name);
+		put_32(p_function->_static);
+		put_32(p_function->rpc_mode);
+
+		put_32(p_function->argument_types.size());
+		for (int i = 0; i < p_function->argument_types.size(); i++) {
+			put_data_type(p_function->argument_types[i]);
+		}
+		put_data_type(p_function->return_type);
+#ifdef TOOLS_ENABLED
+		put_32(p_function->arg_names.size());
+		for (int i = 0; i < p_function->arg_names.size(); i++) {
+			put_string(p_function->arg_names[i]);
+		}
+#endif
+
+		put_32(p_function->constants.size());
+		for (int i = 0; i < p_function->constants.size(); i++) {
+			put_variant(p_function->constants[i]);
+		}
+		put_32(p_function->global_names.size());
+		for (int i = 0; i < p_function->global_names.size(); i++) {
+			put_string(p_function->global_names[i]);
+		}
+#ifdef TOOLS_ENABLED
+		put_32(p_function->named_globals.size());
+		for (int i = 0; i < p_function->named_globals.size(); i++) {
+			put_string(p_function->named_globals[i]);
+		}
+#endif
+		put_32(p_function->default_arguments.size());
+		for (int i = 0; i < p_function->default_arguments.size(); i++) {
+			put_32(p_function->default_arguments[i]);
+		}
+		put_32(p_function->code.size());
+		for (int i = 0; i < p_function->code.size(); i++) {
+			put_32(p_function->code[i]);
+		}
+
+		put_32(p_function->_argument_count);
+		put_32(p_function->_stack_size);
+		put_32(p_function->_call_size);
+		put_32(p_function->_initial_line);
+		put_32(p_function->_inline_cache_count);
+
+		// Evaluators are function pointers, so only what they were resolved from is stored.
+		put_32(p_function->validated_operators.size());
+		for (int i = 0; i < p_function->validated_operators.size(); i++) {
+			put_32(p_function->validated_operators[i].op);
+			put_32(p_function->validated_operators[i].type_a);
+			put_32(p_function->validated_operators[i].type_b);
+		}
+
+		put_32(p_function->validated_builtin_methods.size());
+		for (int i = 0; i < p_function->validated_builtin_methods.size(); i++) {
+			const GDScriptFunction::ValidatedBuiltInMethodCall &vbm = p_function->validated_builtin_methods[i];
+			put_32(vbm.base_type);
+			put_string(vbm.method);
+			put_32(vbm.argument_count);
+			for (int j = 0; j < vbm.argument_count; j++) {
+				put_32(vbm.argument_types[j]);
+			}
+		}
+
+		put_32(p_function->validated_indexed_accesses.size());
+		for (int i = 0; i < p_function->validated_indexed_accesses.size(); i++) {
+			put_32(p_function->validated_indexed_accesses[i].base_type);
+			put_32(p_function->validated_indexed_accesses[i].value_type);
+		}
+
+		put_32(p_function->stack_debug.size());
+		for (const List<GDScriptFunction::StackDebug>::Element *E = p_function->stack_debug.front(); E; E = E->next()) {
+			put_32(E->get().line);
+			put_32(E->get().pos);
+			put_32(E->get().added);
+			put_string(E->get().identifier);
+		}
+	}
+
+	void put_class(const GDScript *p_script) {
+		put_32(p_script->tool);
+		put_string(p_script->name);
+		put_variant(p_script->native);
+		put_variant(p_script->base);
+
+		put_32(p_script->member_indices.size());
+		for (const Map<StringName, GDScript::MemberInfo>::Element *E = p_script->member_indices.front(); E; E = E->next()) {
+			put_string(E->key());
+			put_32(E->get().index);
+			put_string(E->get().setter);
+			put_string(E->get().getter);
+			put_32(E->get().rpc_mode);
+			put_data_type(E->get().data_type);
+		}
+		put_32(p_script->members.size());
+		for (const Set<StringName>::Element *E = p_script->members.front(); E; E = E->next()) {
+			put_string(E->get());
+		}
+		put_32(p_script->member_info.size());
+		for (const Map<StringName, PropertyInfo>::Element *E = p_script->member_info.front(); E; E = E->next()) {
+			put_string(E->key());
+			put_property(E->get());
+		}
+		put_32(p_script->constants.size());
+		for (const Map<StringName, Variant>::Element *E = p_script->constants.front(); E; E = E->next()) {
+			put_string(E->key());
+			put_variant(E->get());
+		}
+		put_32(p_script->_signals.size());
+		for (const Map<StringName, Vector<StringName>>::Element *E = p_script->_signals.front(); E; E = E->next()) {
+			put_string(E->key());
+			put_32(E->get().size());
+			for (int i = 0; i < E->get().size(); i++) {
+				put_string(E->get()[i]);
+			}
+		}
+#ifdef TOOLS_ENABLED
+		put_32(p_script->member_lines.size());
+		for (const Map<StringName, int>::Element *E = p_script->member_lines.front(); E; E = E->next()) {
+			put_string(E->key());
+			put_32(E->get());
+		}
+		put_32(p_script->member_default_values.size());
+		for (const Map<StringName, Variant>::Element *E = p_script->member_default_values.front(); E; E = E->next()) {
+			put_string(E->key());
+			put_variant(E->get());
+		}
+#endif
+
+		put_32(p_script->member_functions.size());
+		for (const Map<StringName, GDScriptFunction *>::Element *E = p_script->member_functions.front(); E; E = E->next()) {
+			put_function(E->get());
+		}
+
+		for (const Map<StringName, Ref<GDScript>>::Element *E = p_script->subclasses.front(); E; E = E->next()) {
+			put_class(E->get().ptr());
+		}
+	}
+
+	GDScriptCacheWriter(const GDScript *p_root) {
+		root = p_root;
+	}
+};
+
+class GDScriptCacheReader {
+	const uint8_t *data = nullptr;
+	int len = 0;
+	int pos = 0;
+	GDScript *root = nullptr;
+
+	Variant _get_script() {
+		String path = get_string();
+		uint32_t chain_size = get_32();
+		if (failed) {
+			return Variant();
+		}
+
+		Ref<GDScript> script;
+		if (path.empty()) {
+			script = Ref<GDScript>(root);
+		} else {
+			script = ResourceLoader::load(path);
+			if (script.is_null()) {
+				failed = true;
+				return Variant();
+			}
+		}
+
+		for (uint32_t i = 0; i < chain_size && !failed; i++) {
+			StringName name = get_string();
+			if (!script->subclasses.has(name)) {
+				failed = true;
+				return Variant();
+			}
+			script = script->subclasses[name];
+		}
+
+		return script;
+	}
+
+
+	// The VM only bounds checks operands in debug builds, so bytecode from the
+	// cache (which may be stale or edited) is checked once here instead. Every
+	// operand must be valid for this function and script, and every jump must
+	// land on an instruction.
+	static bool _verify_address(const GDScriptFunction *p_function, const GDScript *p_script, int p_address) {
+		int address = p_address & GDScriptFunction::ADDR_MASK;
+		switch ((p_address & GDScriptFunction::ADDR_TYPE_MASK) >> GDScriptFunction::ADDR_BITS) {
+			case GDScriptFunction::ADDR_TYPE_SELF: {
+				return !p_function->_static;
+			}
+			case GDScriptFunction::ADDR_TYPE_MEMBER: {
+				// Instances of inheriting scripts only have more members.
+				return !p_function->_static && address < p_script->member_indices.size();
+			}
+			case GDScriptFunction::ADDR_TYPE_CLASS:
+			case GDScriptFunction::ADDR_TYPE_NIL: {
+				return true;
+			}
+			case GDScriptFunction::ADDR_TYPE_CLASS_CONSTANT: {
+				if (address >= p_function->global_names.size()) {
+					return false;
+				}
+				// Looked up by name at runtime, the same way.
+				for (const GDScript *s = p_script; s; s = s->_base) {
+					for (const GDScript *o = s; o; o = o->_owner) {
+						if (o->constants.has(p_function->global_names[address])) {
+							return true;
+						}
+					}
+				}
+				return false;
+			}
+			case GDScriptFunction::ADDR_TYPE_LOCAL_CONSTANT: {
+				return address < p_function->constants.size();
+			}
+			case GDScriptFunction::ADDR_TYPE_STACK:
+			case GDScriptFunction::ADDR_TYPE_STACK_VARIABLE: {
+				return address < p_function->_stack_size;
+			}
+			case GDScriptFunction::ADDR_TYPE_GLOBAL: {
+				return address < GDScriptLanguage::get_singleton()->get_global_array_size();
+			}
+#ifdef TOOLS_ENABLED
+			case GDScriptFunction::ADDR_TYPE_NAMED_GLOBAL: {
+				return address < p_function->named_globals.size();
+			}
+#endif
+			default: {
+				return false;
+			}
+		}
+	}
+
+	static bool _verify_code(const GDScriptFunction *p_function, const GDScript *p_script) {
+		// Larger than anything the compiler emits, frames are allocated on the C stack.
+		const int max_frame_size = 1 << 16;
+		if (p_function->_stack_size < 0 || p_function->_stack_size > max_frame_size || p_function->_call_size < 0 || p_function->_call_size > max_frame_size) {
+			return false;
+		}
+		if (p_function->_argument_count < 0 || p_function->_argument_count > p_function->_stack_size || p_function->_argument_count > p_function->argument_types.size()) {
+			return false;
+		}
+
+		const Vector<int> &code = p_function->code;
+		int size = code.size();
+		Set<int> instructions;
+		Vector<int> jumps;
+		bool uses_default_arguments = false;
+		int ip = 0;
+		int last = 0;
+
+#define VERIFY(m_cond)       \
+	if (unlikely(!(m_cond))) \
+		return false;
+#define VERIFY_SPACE(m_space) VERIFY(ip + (m_space) <= size)
+#define VERIFY_ADDR(m_ofs) VERIFY(_verify_address(p_function, p_script, code[ip + (m_ofs)]))
+#define VERIFY_NAME(m_ofs) VERIFY(code[ip + (m_ofs)] >= 0 && code[ip + (m_ofs)] < p_function->global_names.size())
+#define VERIFY_TYPE(m_ofs) VERIFY(code[ip + (m_ofs)] >= 0 && code[ip + (m_ofs)] < Variant::VARIANT_MAX)
+#define VERIFY_CACHE(m_ofs) VERIFY(code[ip + (m_ofs)] >= -1 && code[ip + (m_ofs)] < p_function->inline_caches.size())
+#define VERIFY_ARGC(m_ofs) VERIFY(code[ip + (m_ofs)] >= 0 && code[ip + (m_ofs)] <= p_function->_call_size)
+
+		while (ip < size) {
+			instructions.insert(ip);
+			last = ip;
+			int incr = 0;
+
+			switch (code[ip]) {
+				case GDScriptFunction::OPCODE_OPERATOR: {
+					VERIFY_SPACE(5);
+					VERIFY(code[ip + 1] >= 0 && code[ip + 1] < Variant::OP_MAX);
+					VERIFY_ADDR(2);
+					VERIFY_ADDR(3);
+					VERIFY_ADDR(4);
+					incr = 5;
+				} break;
+				case GDScriptFunction::OPCODE_OPERATOR_VALIDATED: {
+					VERIFY_SPACE(6);
+					VERIFY(code[ip + 1] >= 0 && code[ip + 1] < p_function->validated_operators.size());
+					VERIFY(code[ip + 2] >= 0 && code[ip + 2] < Variant::OP_MAX);
+					VERIFY_ADDR(3);
+					VERIFY_ADDR(4);
+					VERIFY_ADDR(5);
+					incr = 6;
+				} break;
+				case GDScriptFunction::OPCODE_EXTENDS_TEST:
+				case GDScriptFunction::OPCODE_SET:
+				case GDScriptFunction::OPCODE_GET:
+				case GDScriptFunction::OPCODE_ASSIGN_TYPED_NATIVE:
+				case GDScriptFunction::OPCODE_ASSIGN_TYPED_SCRIPT:
+				case GDScriptFunction::OPCODE_CAST_TO_NATIVE:
+				case GDScriptFunction::OPCODE_CAST_TO_SCRIPT: {
+					VERIFY_SPACE(4);
+					VERIFY_ADDR(1);
+					VERIFY_ADDR(2);
+					VERIFY_ADDR(3);
+					incr = 4;
+				} break;
+				case GDScriptFunction::OPCODE_IS_BUILTIN: {
+					VERIFY_SPACE(4);
+					VERIFY_ADDR(1);
+					VERIFY_TYPE(2);
+					VERIFY_ADDR(3);
+					incr = 4;
+				} break;
+				case GDScriptFunction::OPCODE_SET_INDEXED_VALIDATED:
+				case GDScriptFunction::OPCODE_GET_INDEXED_VALIDATED: {
+					VERIFY_SPACE(5);
+					int access = code[ip + 1];
+					VERIFY(access >= 0 && access < p_function->validated_indexed_accesses.size());
+					if (code[ip] == GDScriptFunction::OPCODE_SET_INDEXED_VALIDATED) {
+						VERIFY(p_function->validated_indexed_accesses[access].setter);
+					} else {
+						VERIFY(p_function->validated_indexed_accesses[access].getter);
+					}
+					VERIFY_ADDR(2);
+					VERIFY_ADDR(3);
+					VERIFY_ADDR(4);
+					incr = 5;
+				} break;
+				case GDScriptFunction::OPCODE_SET_NAMED: {
+					VERIFY_SPACE(4);
+					VERIFY_ADDR(1);
+					VERIFY_NAME(2);
+					VERIFY_ADDR(3);
+					incr = 4;
+				} break;
+				case GDScriptFunction::OPCODE_SET_NAMED_VALIDATED:
+				case GDScriptFunction::OPCODE_GET_NAMED_VALIDATED: {
+					VERIFY_SPACE(5);
+					VERIFY(code[ip + 1] >= 0 && code[ip + 1] < GDScriptValidatedOps::member_count);
+					VERIFY_ADDR(2);
+					VERIFY_NAME(3);
+					VERIFY_ADDR(4);
+					incr = 5;
+				} break;
+				case GDScriptFunction::OPCODE_GET_NAMED: {
+					VERIFY_SPACE(5);
+					VERIFY_ADDR(1);
+					VERIFY_NAME(2);
+					VERIFY_CACHE(3);
+					VERIFY_ADDR(4);
+					incr = 5;
+				} break;
+				case GDScriptFunction::OPCODE_SET_MEMBER:
+				case GDScriptFunction::OPCODE_GET_MEMBER: {
+					VERIFY(!p_function->_static);
+					VERIFY_SPACE(3);
+					VERIFY_NAME(1);
+					VERIFY_ADDR(2);
+					incr = 3;
+				} break;
+				case GDScriptFunction::OPCODE_ASSIGN: {
+					VERIFY_SPACE(3);
+					VERIFY_ADDR(1);
+					VERIFY_ADDR(2);
+					incr = 3;
+				} break;
+				case GDScriptFunction::OPCODE_ASSIGN_TRUE:
+				case GDScriptFunction::OPCODE_ASSIGN_FALSE:
+				case GDScriptFunction::OPCODE_YIELD_RESUME:
+				case GDScriptFunction::OPCODE_RETURN: {
+					VERIFY_SPACE(2);
+					VERIFY_ADDR(1);
+					incr = 2;
+				} break;
+				case GDScriptFunction::OPCODE_ASSIGN_TYPED_BUILTIN:
+				case GDScriptFunction::OPCODE_CAST_TO_BUILTIN: {
+					VERIFY_SPACE(4);
+					VERIFY_TYPE(1);
+					VERIFY_ADDR(2);
+					VERIFY_ADDR(3);
+					incr = 4;
+				} break;
+				case GDScriptFunction::OPCODE_CONSTRUCT: {
+					VERIFY_SPACE(3);
+					VERIFY_TYPE(1);
+					VERIFY_ARGC(2);
+					int argc = code[ip + 2];
+					VERIFY_SPACE(4 + argc);
+					for (int i = 0; i < argc + 1; i++) {
+						VERIFY_ADDR(3 + i);
+					}
+					incr = 4 + argc;
+				} break;
+				case GDScriptFunction::OPCODE_CONSTRUCT_ARRAY:
+				case GDScriptFunction::OPCODE_CONSTRUCT_DICTIONARY: {
+					VERIFY_SPACE(2);
+					int argc = code[ip + 1];
+					int addresses = code[ip] == GDScriptFunction::OPCODE_CONSTRUCT_ARRAY ? argc : argc * 2;
+					VERIFY(argc >= 0 && argc <= size);
+					VERIFY_SPACE(3 + addresses);
+					for (int i = 0; i < addresses + 1; i++) {
+						VERIFY_ADDR(2 + i);
+					}
+					incr = 3 + addresses;
+				} break;
+				case GDScriptFunction::OPCODE_CALL:
+				case GDScriptFunction::OPCODE_CALL_RETURN:
+				case GDScriptFunction::OPCODE_CALL_BUILTIN_TYPE_VALIDATED: {
+					VERIFY_SPACE(5);
+					VERIFY_ARGC(1);
+					if (code[ip] == GDScriptFunction::OPCODE_CALL_BUILTIN_TYPE_VALIDATED) {
+						VERIFY(code[ip + 2] >= 0 && code[ip + 2] < p_function->validated_builtin_methods.size());
+					} else {
+						VERIFY_CACHE(2);
+					}
+					VERIFY_ADDR(3);
+					VERIFY_NAME(4);
+					int argc = code[ip + 1];
+					VERIFY_SPACE(6 + argc);
+					for (int i = 0; i < argc; i++) {
+						VERIFY_ADDR(5 + i);
+					}
+					// A plain call ignores its result slot.
+					if (code[ip] != GDScriptFunction::OPCODE_CALL) {
+						VERIFY_ADDR(5 + argc);
+					}
+					incr = 6 + argc;
+				} break;
+				case GDScriptFunction::OPCODE_CALL_BUILT_IN:
+				case GDScriptFunction::OPCODE_CALL_SELF_BASE: {
+					VERIFY_SPACE(3);
+					if (code[ip] == GDScriptFunction::OPCODE_CALL_BUILT_IN) {
+						VERIFY(code[ip + 1] >= 0 && code[ip + 1] < GDScriptFunctions::FUNC_MAX);
+					} else {
+						VERIFY(!p_function->_static);
+						VERIFY_NAME(1);
+					}
+					VERIFY_ARGC(2);
+					int argc = code[ip + 2];
+					VERIFY_SPACE(4 + argc);
+					for (int i = 0; i < argc + 1; i++) {
+						VERIFY_ADDR(3 + i);
+					}
+					incr = 4 + argc;
+				} break;
+				case GDScriptFunction::OPCODE_YIELD: {
+					incr = 1;
+				} break;
+				case GDScriptFunction::OPCODE_YIELD_SIGNAL: {
+					VERIFY_SPACE(3);
+					VERIFY_ADDR(1);
+					VERIFY_ADDR(2);
+					incr = 3;
+				} break;
+				case GDScriptFunction::OPCODE_JUMP: {
+					VERIFY_SPACE(2);
+					jumps.push_back(code[ip + 1]);
+					incr = 2;
+				} break;
+				case GDScriptFunction::OPCODE_JUMP_IF:
+				case GDScriptFunction::OPCODE_JUMP_IF_NOT: {
+					VERIFY_SPACE(3);
+					VERIFY_ADDR(1);
+					jumps.push_back(code[ip + 2]);
+					incr = 3;
+				} break;
+				case GDScriptFunction::OPCODE_JUMP_TO_DEF_ARGUMENT: {
+					uses_default_arguments = true;
+					incr = 1;
+				} break;
+				case GDScriptFunction::OPCODE_ITERATE_BEGIN:
+				case GDScriptFunction::OPCODE_ITERATE: {
+					VERIFY_SPACE(5);
+					VERIFY_ADDR(1);
+					VERIFY_ADDR(2);
+					jumps.push_back(code[ip + 3]);
+					VERIFY_ADDR(4);
+					incr = 5;
+				} break;
+				case GDScriptFunction::OPCODE_ASSERT: {
+					VERIFY_SPACE(3);
+					VERIFY_ADDR(1);
+					VERIFY(code[ip + 2] == 0 || _verify_address(p_function, p_script, code[ip + 2]));
+					incr = 3;
+				} break;
+				case GDScriptFunction::OPCODE_BREAKPOINT:
+				case GDScriptFunction::OPCODE_END: {
+					incr = 1;
+				} break;
+				case GDScriptFunction::OPCODE_LINE: {
+					VERIFY_SPACE(2);
+					incr = 2;
+				} break;
+				default: {
+					// Includes OPCODE_CALL_SELF, which the compiler never emits.
+					return false;
+				}
+			}
+
+			ip += incr;
+		}
+
+		// Execution can't run past the end.
+		if (size && code[last] != GDScriptFunction::OPCODE_END) {
+			return false;
+		}
+		for (int i = 0; i < jumps.size(); i++) {
+			VERIFY(instructions.has(jumps[i]));
+		}
+		VERIFY(!uses_default_arguments || p_function->default_arguments.size());
+		for (int i = 0; i < p_function->default_arguments.size(); i++) {
+			VERIFY(instructions.has(p_function->default_arguments[i]));
+		}
+
+#undef VERIFY
+#undef VERIFY_SPACE
+#undef VERIFY_ADDR
+#undef VERIFY_NAME
+#undef VERIFY_TYPE
+#undef VERIFY_CACHE
+#undef VERIFY_ARGC
+
+		return true;
+	}
+
+public:
+	bool failed = false;
+
+	static void clear_script(GDScript *p_script) {
+		p_script->native = Ref<GDScriptNativeClass>();
+		p_script->base = Ref<GDScript>();
+		p_script->_base = nullptr;
+		p_script->members.clear();
+		p_script->constants.clear();
+		for (Map<StringName, GDScriptFunction *>::Element *E = p_script->member_functions.front(); E; E = E->next()) {
+			memdelete(E->get());
+		}
+		p_script->member_functions.clear();
+		p_script->member_indices.clear();
+		p_script->member_info.clear();
+		p_script->_signals.clear();
+		p_script->initializer = nullptr;
+#ifdef TOOLS_ENABLED
+		p_script->member_lines.clear();
+		p_script->member_default_values.clear();
+#endif
+	}
+
+	uint32_t get_32() {
+		if (failed || pos + 4 > len) {
+			failed = true;
+			return 0;
+		}
+		uint32_t value = decode_uint32(&data[pos]);
+		pos += 4;
+		return value;
+	}
+
+	const uint8_t *get_buffer(int p_len) {
+		if (failed || p_len < 0 || p_len > len - pos) {
+			failed = true;
+			return nullptr;
+		}
+		const uint8_t *buffer = &data[pos];
+		pos += p_len;
+		return buffer;
+	}
+
+	String get_string() {
+		int length = get_32();
+		const uint8_t *buffer = get_buffer(length);
+		if (!buffer) {
+			return String();
+		}
+		String string;
+		string.parse_utf8((const char *)buffer, length);
+		return string;
+	}
+
+	// Guards element counts against truncated or corrupted files before anything gets resized.
+	int get_count() {
+		uint32_t count = get_32();
+		if (count > (uint32_t)(len - pos)) {
+			failed = true;
+			return 0;
+		}
+		return count;
+	}
+
+	Variant get_variant() {
+		switch (get_32()) {
+			case CACHED_VARIANT_VALUE: {
+				int length = get_32();
+				const uint8_t *buffer = get_buffer(length);
+				if (!buffer) {
+					return Variant();
+				}
+				Variant value;
+				if (decode_variant(value, buffer, length) != OK) {
+					failed = true;
+				}
+				return value;
+			} break;
+			case CACHED_VARIANT_ARRAY: {
+				Array array;
+				int size = get_count();
+				array.resize(size);
+				for (int i = 0; i < size && !failed; i++) {
+					array[i] = get_variant();
+				}
+				return array;
+			} break;
+			case CACHED_VARIANT_DICTIONARY: {
+				Dictionary dict;
+				int size = get_count();
+				for (int i = 0; i < size && !failed; i++) {
+					Variant key = get_variant();
+					dict[key] = get_variant();
+				}
+				return dict;
+			} break;
+			case CACHED_VARIANT_NULL_OBJECT: {
+				return Variant((Object *)nullptr);
+			} break;
+			case CACHED_VARIANT_NATIVE_CLASS: {
+				StringName name = get_string();
+				const Map<StringName, int> &global_map = GDScriptLanguage::get_singleton()->get_global_map();
+				if (failed || !global_map.has(name)) {
+					failed = true;
+					return Variant();
+				}
+				Variant native = GDScriptLanguage::get_singleton()->get_global_array()[global_map[name]];
+				if (!Object::cast_to<GDScriptNativeClass>(native)) {
+					failed = true;
+					return Variant();
+				}
+				return native;
+			} break;
+			case CACHED_VARIANT_SCRIPT: {
+				return _get_script();
+			} break;
+			case CACHED_VARIANT_RESOURCE: {
+				String path = get_string();
+				RES resource = failed ? RES() : ResourceLoader::load(path);
+				if (resource.is_null()) {
+					failed = true;
+					return Variant();
+				}
+				return resource;
+			} break;
+			default: {
+				failed = true;
+				return Variant();
+			}
+		}
+	}
+
+	GDScriptDataType get_data_type() {
+		GDScriptDataType type;
+		type.kind = (GDScriptDataType::Kind)get_32();
+		type.has_type = get_32();
+		type.builtin_type = (Variant::Type)get_32();
+		type.native_type = get_string();
+		type.script_type = get_variant();
+		if (type.kind > GDScriptDataType::GDSCRIPT || type.builtin_type >= Variant::VARIANT_MAX) {
+			failed = true;
+		}
+		return type;
+	}
+
+	PropertyInfo get_property() {
+		PropertyInfo property;
+		property.type = (Variant::Type)get_32();
+		property.name = get_string();
+		property.class_name = get_string();
+		property.hint = (PropertyHint)get_32();
+		property.hint_string = get_string();
+		property.usage = get_32();
+		return property;
+	}
+
+	void get_class_tree(GDScript *p_script) {
+		p_script->subclasses.clear();
+
+		int count = get_count();
+		for (int i = 0; i < count && !failed; i++) {
+			StringName name = get_string();
+			String fully_qualified_name = p_script->fully_qualified_name + "::" + name;
+
+			// Same as the compiler, so instances of inner classes that outlived a previous version keep working.
+			Ref<GDScript> subclass = GDScriptLanguage::get_singleton()->get_orphan_subclass(fully_qualified_name);
+			if (subclass.is_null()) {
+				subclass.instance();
+			}
+
+			subclass->_owner = p_script;
+			subclass->fully_qualified_name = fully_qualified_name;
+			p_script->subclasses.insert(name, subclass);
+
+			get_class_tree(subclass.ptr());
+		}
+	}
+
+	void get_function(GDScript *p_script) {
+		StringName name = get_string();
+		if (failed) {
+			return;
+		}
+
+		GDScriptFunction *function = memnew(GDScriptFunction);
+		if (p_script->member_functions.has(name)) {
+			memdelete(p_script->member_functions[name]);
+		}
+		p_script->member_functions[name] = function;
+
+		function->name = name;
+		function->_static = get_32();
+		function->rpc_mode = (MultiplayerAPI::RPCMode)get_32();
+
+		function->argument_types.resize(get_count());
+		for (int i = 0; i < function->argument_types.size() && !failed; i++) {
+			function->argument_types.write[i] = get_data_type();
+		}
+		function->return_type = get_data_type();
+#ifdef TOOLS_ENABLED
+		function->arg_names.resize(get_count());
+		for (int i = 0; i < function->arg_names.size() && !failed; i++) {
+			function->arg_names.write[i] = get_string();
+		}
+#endif
+
+		function->constants.resize(get_count());
+		for (int i = 0; i < function->constants.size() && !failed; i++) {
+			function->constants.write[i] = get_variant();
+		}
+		function->global_names.resize(get_count());
+		for (int i = 0; i < function->global_names.size() && !failed; i++) {
+			function->global_names.write[i] = get_string();
+		}
+#ifdef TOOLS_ENABLED
+		function->named_globals.resize(get_count());
+		for (int i = 0; i < function->named_globals.size() && !failed; i++) {
+			function->named_globals.write[i] = get_string();
+		}
+#endif
+		function->default_arguments.resize(get_count());
+		for (int i = 0; i < function->default_arguments.size() && !failed; i++) {
+			function->default_arguments.write[i] = get_32();
+		}
+		function->code.resize(get_count());
+		for (int i = 0; i < function->code.size() && !failed; i++) {
+			function->code.write[i] = get_32();
+		}
+
+		function->_argument_count = get_32();
+		function->_stack_size = get_32();
+		function->_call_size = get_32();
+		function->_initial_line = get_32();
+		function->inline_caches.resize(get_count());
+
+		function->validated_operators.resize(get_count());
+		for (int i = 0; i < function->validated_operators.size() && !failed; i++) {
+			GDScriptFunction::ValidatedOperator &vop = function->validated_operators.write[i];
+			uint32_t op = get_32();
+			uint32_t type_a = get_32();
+			uint32_t type_b = get_32();
+			if (op >= Variant::OP_MAX || type_a >= Variant::VARIANT_MAX || type_b >= Variant::VARIANT_MAX) {
+				failed = true;
+				break;
+			}
+			vop.op = Variant::Operator(op);
+			vop.type_a = Variant::Type(type_a);
+			vop.type_b = Variant::Type(type_b);
+			vop.evaluator = Variant::get_validated_operator_evaluator(vop.op, vop.type_a, vop.type_b);
+			if (!vop.evaluator) {
+				failed = true;
+			}
+		}
+
+		function->validated_builtin_methods.resize(get_count());
+		for (int i = 0; i < function->validated_builtin_methods.size() && !failed; i++) {
+			GDScriptFunction::ValidatedBuiltInMethodCall &vbm = function->validated_builtin_methods.write[i];
+			uint32_t base_type = get_32();
+			vbm.method = get_string();
+			uint32_t argument_count = get_32();
+			if (base_type >= Variant::VARIANT_MAX || argument_count > VARIANT_ARG_MAX) {
+				failed = true;
+				break;
+			}
+			vbm.base_type = Variant::Type(base_type);
+			vbm.argument_count = argument_count;
+			for (int j = 0; j < vbm.argument_count; j++) {
+				uint32_t argument_type = get_32();
+				if (argument_type >= Variant::VARIANT_MAX) {
+					failed = true;
+					break;
+				}
+				vbm.argument_types[j] = Variant::Type(argument_type);
+			}
+			if (failed) {
+				break;
+			}
+			vbm.function = Variant::get_validated_builtin_method(vbm.base_type, vbm.method, vbm.argument_types, vbm.argument_count);
+			if (!vbm.function) {
+				failed = true;
+			}
+		}
+
+		function->validated_indexed_accesses.resize(get_count());
+		for (int i = 0; i < function->validated_indexed_accesses.size() && !failed; i++) {
+			GDScriptFunction::ValidatedIndexedAccess &via = function->validated_indexed_accesses.write[i];
+			uint32_t base_type = get_32();
+			uint32_t value_type = get_32();
+			if (base_type >= Variant::VARIANT_MAX || value_type >= Variant::VARIANT_MAX) {
+				failed = true;
+				break;
+			}
+			via.base_type = Variant::Type(base_type);
+			via.value_type = Variant::Type(value_type);
+			if (via.value_type == Variant::NIL) {
+				via.getter = Variant::get_validated_indexed_getter(via.base_type);
+				failed = !via.getter;
+			} else {
+				via.setter = Variant::get_validated_indexed_setter(via.base_type, via.value_type);
+				failed = !via.setter;
+			}
+		}
+
+		int stack_debug_count = get_count();
+		for (int i = 0; i < stack_debug_count && !failed; i++) {
+			GDScriptFunction::StackDebug sd;
+			sd.line = get_32();
+			sd.pos = get_32();
+			sd.added = get_32();
+			sd.identifier = get_string();
+			function->stack_debug.push_back(sd);
+		}
+
+		// Same fast pointers the compiler sets up.
+		function->_constants_ptr = function->constants.size() ? function->constants.ptrw() : nullptr;
+		function->_constant_count = function->constants.size();
+		function->_global_names_ptr = function->global_names.size() ? function->global_names.ptr() : nullptr;
+		function->_global_names_count = function->global_names.size();
+#ifdef TOOLS_ENABLED
+		function->_named_globals_ptr = function->named_globals.size() ? function->named_globals.ptr() : nullptr;
+		function->_named_globals_count = function->named_globals.size();
+#endif
+		function->_default_arg_ptr = function->default_arguments.size() ? function->default_arguments.ptr() : nullptr;
+		function->_default_arg_count = function->default_arguments.size() ? function->default_arguments.size() - 1 : 0;
+		function->_code_ptr = function->code.size() ? function->code.ptr() : nullptr;
+		function->_code_size = function->code.size();
+		function->_inline_caches_ptr = function->inline_caches.size() ? function->inline_caches.ptrw() : nullptr;
+		function->_inline_cache_count = function->inline_caches.size();
+		function->_validated_operators_ptr = function->validated_operators.size() ? function->validated_operators.ptr() : nullptr;
+		function->_validated_operator_count = function->validated_operators.size();
+		function->_validated_builtin_methods_ptr = function->validated_builtin_methods.size() ? function->validated_builtin_methods.ptr() : nullptr;
+		function->_validated_builtin_method_count = function->validated_builtin_methods.size();
+		function->_validated_indexed_accesses_ptr = function->validated_indexed_accesses.size() ? function->validated_indexed_accesses.ptr() : nullptr;
+		function->_validated_indexed_access_count = function->validated_indexed_accesses.size();
+
+		function->_script = p_script;
+		function->source = root->get_path();
+#ifdef DEBUG_ENABLED
+		function->func_cname = (String(function->source) + " - " + String(name)).utf8();
+		function->_func_cname = function->func_cname.get_data();
+#endif
+
+		if (name == "_init") {
+			p_script->initializer = function;
+		}
+
+		if (!failed && !_verify_code(function, p_script)) {
+			failed = true;
+		}
+	}
+
+	void get_class(GDScript *p_script) {
+		clear_script(p_script);
+
+		p_script->tool = get_32();
+		p_script->name = get_string();
+		p_script->native = get_variant();
+		p_script->base = get_variant();
+		p_script->_base = p_script->base.ptr();
+
+		int count = get_count();
+		for (int i = 0; i < count && !failed; i++) {
+			StringName name = get_string();
+			GDScript::MemberInfo minfo;
+			minfo.index = get_32();
+			minfo.setter = get_string();
+			minfo.getter = get_string();
+			minfo.rpc_mode = (MultiplayerAPI::RPCMode)get_32();
+			minfo.data_type = get_data_type();
+			p_script->member_indices[name] = minfo;
+		}
+		count = get_count();
+		for (int i = 0; i < count && !failed; i++) {
+			p_script->members.insert(get_string());
+		}
+		count = get_count();
+		for (int i = 0; i < count && !failed; i++) {
+			StringName name = get_string();
+			p_script->member_info[name] = get_property();
+		}
+		count = get_count();
+		for (int i = 0; i < count && !failed; i++) {
+			StringName name = get_string();
+			p_script->constants[name] = get_variant();
+		}
+		count = get_count();
+		for (int i = 0; i < count && !failed; i++) {
+			StringName name = get_string();
+			Vector<StringName> &arguments = p_script->_signals[name];
+			arguments.resize(get_count());
+			for (int j = 0; j < arguments.size() && !failed; j++) {
+				arguments.write[j] = get_string();
+			}
+		}
+#ifdef TOOLS_ENABLED
+		count = get_count();
+		for (int i = 0; i < count && !failed; i++) {
+			StringName name = get_string();
+			p_script->member_lines[name] = get_32();
+		}
+		count = get_count();
+		for (int i = 0; i < count && !failed; i++) {
+			StringName name = get_string();
+			p_script->member_default_values[name] = get_variant();
+		}
+#endif
+
+		count = get_count();
+		for (int i = 0; i < count && !failed; i++) {
+			get_function(p_script);
+		}
+
+		for (Map<StringName, Ref<GDScript>>::Element *E = p_script->subclasses.front(); E && !failed; E = E->next()) {
+			get_class(E->get().ptr());
+		}
+
+		p_script->valid = !failed;
+	}
+
+	GDScriptCacheReader(const uint8_t *p_data, int p_len, GDScript *p_root) {
+		data = p_data;
+		len = p_len;
+		root = p_root;
+	}
+};
+
+static Mutex environment_mutex;
+static String environment_hash;
+static int environment_global_count = -1;
+static int environment_named_global_count = -1;
+
+String GDScriptBytecodeCache::_get_environment_hash() {
+	// Global indices are baked into the bytecode, and the parser resolves identifiers
+	// against global classes and autoloads, so all of them are part of the key.
+	const Map<StringName, int> &global_map = GDScriptLanguage::get_singleton()->get_global_map();
+	const Map<StringName, Variant> &named_globals = GDScriptLanguage::get_singleton()->get_named_globals_map();
+
+	MutexLock lock(environment_mutex);
+
+	if (environment_global_count == global_map.size() && environment_named_global_count == named_globals.size()) {
+		return environment_hash;
+	}
+
+	String environment;
+	for (const Map<StringName, int>::Element *E = global_map.front(); E; E = E->next()) {
+		environment += String(E->key()) + ":" + itos(E->get()) + ";";
+	}
+	for (const Map<StringName, Variant>::Element *E = named_globals.front(); E; E = E->next()) {
+		environment += String(E->key()) + ";";
+	}
+
+	List<StringName> global_classes;
+	ScriptServer::get_global_class_list(&global_classes);
+	for (List<StringName>::Element *E = global_classes.front(); E; E = E->next()) {
+		environment += String(E->get()) + ":" + ScriptServer::get_global_class_path(E->get()) + ";";
+	}
+
+	List<PropertyInfo> properties;
+	ProjectSettings::get_singleton()->get_property_list(&properties);
+	for (List<PropertyInfo>::Element *E = properties.front(); E; E = E->next()) {
+		// Warnings can be turned into errors, which decides whether a script compiles at all.
+		if (E->get().name.begins_with("autoload/") || E->get().name.begins_with("debug/gdscript/warnings/")) {
+			environment += E->get().name + "=" + String(ProjectSettings::get_singleton()->get(E->get().name)) + ";";
+		}
+	}
+
+	environment_hash = environment.md5_text();
+	environment_global_count = global_map.size();
+	environment_named_global_count = named_globals.size();
+
+	return environment_hash;
+}
+
+String GDScriptBytecodeCache::_get_cache_path(const String &p_path) {
+	return String(CACHE_DIR).plus_file(p_path.md5_text() + ".gdbc");
+}
+
+String GDScriptBytecodeCache::_get_dependency_fingerprint(const String &p_path) {
+	String type = ResourceLoader::get_resource_type(p_path);
+
+	if (type == "GDScript") {
+		Ref<GDScript> script = ResourceLoader::load(p_path);
+		if (script.is_null()) {
+			return String();
+		}
+		if (!script->cache_fingerprint.empty()) {
+			return script->cache_fingerprint;
+		}
+		if (!script->valid && !script->cache_source_hash.empty()) {
+			// Still being loaded further up a cyclic dependency, so none of its
+			// members could be resolved against; only its source matters.
+			return "partial:" + script->cache_source_hash;
+		}
+		return String();
+	}
+
+	if (type.empty()) {
+		return String();
+	}
+
+	if (ClassDB::is_parent_class(type, "Script")) {
+		// Other languages may expose typed members to the parser.
+		String md5 = FileAccess::get_md5(p_path);
+		return md5.empty() ? String() : type + ":" + md5;
+	}
+
+	// For any other resource only its type is known to the parser.
+	return type;
+}
+
+static Mutex prune_mutex;
+static bool pruned = false;
+
+static String _read_header_string(FileAccess *p_file) {
+	uint32_t length = p_file->get_32();
+	if (p_file->eof_reached() || length > p_file->get_len() - p_file->get_position()) {
+		return String();
+	}
+	Vector<uint8_t> buffer;
+	buffer.resize(length);
+	if (length > 0 && p_file->get_buffer(buffer.ptrw(), length) != length) {
+		return String();
+	}
+	String string;
+	string.parse_utf8((const char *)buffer.ptr(), length);
+	return string;
+}
+
+void GDScriptBytecodeCache::_prune() {
+	MutexLock lock(prune_mutex);
+
+	if (pruned) {
+		return;
+	}
+	pruned = true;
+
+	DirAccessRef da = DirAccess::create(DirAccess::ACCESS_USERDATA);
+	if (da->change_dir(CACHE_DIR) != OK) {
+		return;
+	}
+
+	// Entries are keyed by script path, so they are only left behind by other engine
+	// builds, by scripts that were removed or encrypted since, and by interrupted writes.
+	List<String> stale;
+	String build_id = _get_build_id();
+
+	da->list_dir_begin();
+	for (String file = da->get_next(); !file.empty(); file = da->get_next()) {
+		if (da->current_is_dir()) {
+			continue;
+		}
+		if (!file.ends_with(".gdbc")) {
+			if (file.ends_with(".gdbc.tmp")) {
+				stale.push_back(file);
+			}
+			continue;
+		}
+
+		FileAccessRef f = FileAccess::open(String(CACHE_DIR).plus_file(file), FileAccess::READ);
+		if (!f) {
+			continue;
+		}
+
+		bool valid = f->get_32() == CACHE_MAGIC;
+		if (valid) {
+			f->seek(f->get_position() + 16); // Checksum.
+			valid = f->get_32() == CACHE_FORMAT_VERSION && _read_header_string(f) == build_id;
+		}
+		if (valid) {
+			_read_header_string(f); // Environment, changes with the project's own settings.
+			String path = _read_header_string(f);
+			valid = ResourceLoader::exists(path) && !ResourceLoader::path_remap(path).ends_with(".gde");
+		}
+		f->close();
+
+		if (!valid) {
+			stale.push_back(file);
+		}
+	}
+	da->list_dir_end();
+
+	for (List<String>::Element *E = stale.front(); E; E = E->next()) {
+		da->remove(E->get());
+	}
+}
+
+bool GDScriptBytecodeCache::is_enabled() {
+	if (Engine::get_singleton()->is_editor_hint() || EngineDebugger::is_active()) {
+		// The editor reloads scripts all the time, and the debugger needs the parser's warnings.
+		return false;
+	}
+	return GLOBAL_GET("debug/settings/gdscript/cache_compiled_bytecode");
+}
+
+Error GDScriptBytecodeCache::load(GDScript *p_script, const String &p_source_hash) {
+	String path = p_script->get_path();
+	if (path.empty() || path.find("::") != -1 || p_source_hash.empty()) {
+		return ERR_UNAVAILABLE;
+	}
+
+	p_script->cache_source_hash = p_source_hash;
+
+	Error err;
+	Vector<uint8_t> file = FileAccess::get_file_as_array(_get_cache_path(path), &err);
+	if (err != OK) {
+		return ERR_FILE_NOT_FOUND;
+	}
+
+	GDScriptCacheReader reader(file.ptr(), file.size(), p_script);
+	if (reader.get_32() != CACHE_MAGIC) {
+		return ERR_FILE_UNRECOGNIZED;
+	}
+	const uint8_t *checksum = reader.get_buffer(16);
+	int payload_ofs = 4 + 16;
+	if (!checksum) {
+		return ERR_FILE_CORRUPT;
+	}
+	unsigned char md5[16];
+	CryptoCore::md5(file.ptr() + payload_ofs, file.size() - payload_ofs, md5);
+	if (memcmp(md5, checksum, 16) != 0) {
+		return ERR_FILE_CORRUPT;
+	}
+
+	if (reader.get_32() != CACHE_FORMAT_VERSION || reader.get_string() != _get_build_id() || reader.get_string() != _get_environment_hash()) {
+		return ERR_INVALID_DATA;
+	}
+	if (reader.get_string() != path || reader.get_string() != p_source_hash) {
+		return ERR_INVALID_DATA;
+	}
+
+	// Every dependency must still be what it was when the script was compiled.
+	String fingerprint = p_source_hash;
+	int dependency_count = reader.get_count();
+	for (int i = 0; i < dependency_count && !reader.failed; i++) {
+		String dependency = reader.get_string();
+		String dependency_fingerprint = reader.get_string();
+		if (reader.failed || _get_dependency_fingerprint(dependency) != dependency_fingerprint) {
+			return ERR_INVALID_DATA;
+		}
+		fingerprint += ";" + dependency + ":" + dependency_fingerprint;
+	}
+	if (reader.failed) {
+		return ERR_FILE_CORRUPT;
+	}
+
+	p_script->fully_qualified_name = p_script->path;
+	p_script->_owner = nullptr;
+
+	reader.get_class_tree(p_script);
+	reader.get_class(p_script);
+
+	GDScriptFunction::invalidate_inline_caches();
+
+	if (reader.failed) {
+		GDScriptCacheReader::clear_script(p_script);
+		p_script->valid = false;
+		return ERR_FILE_CORRUPT;
+	}
+
+	p_script->cache_fingerprint = fingerprint.md5_text();
+
+	for (Map<StringName, Ref<GDScript>>::Element *E = p_script->subclasses.front(); E; E = E->next()) {
+		p_script->_set_subclass_path(E->get(), p_script->path);
+	}
+
+	p_script->_init_rpc_methods_properties();
+
+	return OK;
+}
+
+Error GDScriptBytecodeCache::save(GDScript *p_script, const String &p_source_hash) {
+	String path = p_script->get_path();
+	if (!p_script->valid || path.empty() || path.find("::") != -1 || p_source_hash.empty()) {
+		return ERR_UNAVAILABLE;
+	}
+
+	p_script->cache_source_hash = p_source_hash;
+
+	GDScriptCacheWriter payload(p_script);
+	payload.put_class_tree(p_script);
+	payload.put_class(p_script);
+
+	// Everything the parser resolved, plus what the constants refer to (normally a subset).
+	Set<String> dependencies = p_script->compile_dependencies;
+	for (Set<String>::Element *E = payload.dependencies.front(); E; E = E->next()) {
+		dependencies.insert(E->get());
+	}
+	dependencies.erase(path);
+
+	GDScriptCacheWriter header(p_script);
+	header.put_32(CACHE_FORMAT_VERSION);
+	header.put_string(_get_build_id());
+	header.put_string(_get_environment_hash());
+	header.put_string(path);
+	header.put_string(p_source_hash);
+	header.put_32(dependencies.size());
+
+	String fingerprint = p_source_hash;
+	for (Set<String>::Element *E = dependencies.front(); E; E = E->next()) {
+		String dependency_fingerprint = _get_dependency_fingerprint(E->get());
+		if (dependency_fingerprint.empty()) {
+			return ERR_UNAVAILABLE;
+		}
+		header.put_string(E->get());
+		header.put_string(dependency_fingerprint);
+		fingerprint += ";" + E->get() + ":" + dependency_fingerprint;
+	}
+
+	// Scripts depending on this one can be cached even if it can't be itself.
+	p_script->cache_fingerprint = fingerprint.md5_text();
+
+	if (payload.failed) {
+		return ERR_UNAVAILABLE;
+	}
+
+	header.put_buffer(payload.data.ptr(), payload.data.size());
+
+	unsigned char md5[16];
+	CryptoCore::md5(header.data.ptr(), header.data.size(), md5);
+
+	_prune();
+
+	DirAccessRef da = DirAccess::create(DirAccess::ACCESS_USERDATA);
+	if (!da->dir_exists(CACHE_DIR)) {
+		Error err = da->make_dir_recursive(CACHE_DIR);
+		ERR_FAIL_COND_V_MSG(err != OK, err, "Cannot create GDScript bytecode cache directory '" CACHE_DIR "'.");
+	}
+
+	// Written under a temporary name first, so a concurrent load never sees a partial file.
+	String cache_path = _get_cache_path(path);
+	String temp_path = cache_path + ".tmp";
+
+	Error err;
+	FileAccessRef f = FileAccess::open(temp_path, FileAccess::WRITE, &err);
+	ERR_FAIL_COND_V_MSG(!f, err, "Cannot write GDScript bytecode cache file '" + temp_path + "'.");
+	f->store_32(CACHE_MAGIC);
+	f->store_buffer(md5, 16);
+	f->store_buffer(header.data.ptr(), header.data.size());
+	f->close();
+
+	if (da->file_exists(cache_path)) {
+		da->remove(cache_path);
+	}
+	return da->rename(temp_path, cache_path);
+}
@@ -0,0 +1,62 @@
+/*************************************************************************/
+/*  gdscript_bytecode_cache.h                                            */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef GDSCRIPT_BYTECODE_CACHE_H
+#define GDSCRIPT_BYTECODE_CACHE_H
+
+#include "core/ustring.h"
+
+class GDScript;
+
+// On-disk cache of compiled scripts, so exported projects don't need to run
+// the parser and compiler again on every launch.
+//
+// An entry stores the bytecode, constants and member layout of a script and of
+// all its inner classes. It's only used if it was written by the same engine
+// build, for the same source, and against the same versions of every script
+// and resource the parser resolved while compiling it (see fingerprint below).
+
+class GDScriptBytecodeCache {
+	static String _get_cache_path(const String &p_path);
+	static String _get_dependency_fingerprint(const String &p_path);
+	static String _get_environment_hash();
+	static void _prune();
+
+public:
+	static bool is_enabled();
+
+	// Fills an empty script from its cache entry. Anything other than OK means
+	// the entry is missing or stale and the script must be compiled normally.
+	static Error load(GDScript *p_script, const String &p_source_hash);
+	// Writes the entry for a script that was just compiled from the given source.
+	static Error save(GDScript *p_script, const String &p_source_hash);
+};
+
+#endif // GDSCRIPT_BYTECODE_CACHE_H
@@ -31,6 +31,7 @@
 #include "gdscript_compiler.h"
 
 #include "gdscript.h"
+#include "gdscript_validated_ops.h"
 
 bool GDScriptCompiler::_is_class_member_property(CodeGen &codegen, const StringName &p_name) {
 	if (codegen.function_node && codegen.function_node->_static) {
@@ -74,6 +75,294 @@ void GDScriptCompiler::_set_error(const String &p_error, const GDScriptParser::N
 	}
 }
 
+Variant::Type GDScriptCompiler::_get_static_builtin_type(const GDScriptParser::Node *p_node) const {
+	// Only used to pick fast paths, the VM still checks the actual types.
+	GDScriptParser::DataType datatype = p_node->get_datatype();
+	if (!datatype.has_type || datatype.is_meta_type || datatype.kind != GDScriptParser::DataType::BUILTIN) {
+		return Variant::NIL;
+	}
+	return datatype.builtin_type;
+}
+
+static bool _is_stack_temporary(int p_address) {
+	// Temporaries have to be kept alive while the next operand is evaluated, unlike locals and constants.
+	return (p_address >> GDScriptFunction::ADDR_BITS) == GDScriptFunction::ADDR_TYPE_STACK;
+}
+
+static bool _is_immutable_value(const Variant &p_value) {
+	// Folded values are shared by every call, so they must not be containers or objects a caller could modify.
+	switch (p_value.get_type()) {
+		case Variant::_RID:
+		case Variant::OBJECT:
+		case Variant::CALLABLE:
+		case Variant::SIGNAL:
+		case Variant::DICTIONARY:
+		case Variant::ARRAY:
+		case Variant::PACKED_BYTE_ARRAY:
+		case Variant::PACKED_INT32_ARRAY:
+		case Variant::PACKED_INT64_ARRAY:
+		case Variant::PACKED_FLOAT32_ARRAY:
+		case Variant::PACKED_FLOAT64_ARRAY:
+		case Variant::PACKED_STRING_ARRAY:
+		case Variant::PACKED_VECTOR2_ARRAY:
+		case Variant::PACKED_VECTOR3_ARRAY:
+		case Variant::PACKED_COLOR_ARRAY:
+			return false;
+		default:
+			return true;
+	}
+}
+
+static bool _is_class_reference(const Variant &p_value) {
+	// Classes are only folded to read their constants, which can't change at runtime.
+	return p_value.get_type() == Variant::OBJECT && (Object::cast_to<GDScript>(p_value) || Object::cast_to<GDScriptNativeClass>(p_value));
+}
+
+bool GDScriptCompiler::_reduce_constant_expression(CodeGen &codegen, const GDScriptParser::Node *p_expression, Variant &r_value) {
+	// Evaluates what the parser couldn't reduce on its own, mostly expressions using class constants.
+	// Anything that could fail or have side effects is left to the VM. Constant containers can
+	// still be modified at runtime, so nothing is folded through them.
+	switch (p_expression->type) {
+		case GDScriptParser::Node::TYPE_CONSTANT: {
+			r_value = static_cast<const GDScriptParser::ConstantNode *>(p_expression)->value;
+			return _is_immutable_value(r_value) || _is_class_reference(r_value);
+		} break;
+		case GDScriptParser::Node::TYPE_IDENTIFIER: {
+			StringName identifier = static_cast<const GDScriptParser::IdentifierNode *>(p_expression)->name;
+
+			// Same lookup order as _parse_expression(), locals and members shadow constants.
+			if (codegen.stack_identifiers.has(identifier) || _is_class_member_property(codegen, identifier)) {
+				return false;
+			}
+			if ((!codegen.function_node || !codegen.function_node->_static) && codegen.script->member_indices.has(identifier)) {
+				return false;
+			}
+
+			GDScript *owner = codegen.script;
+			while (owner) {
+				GDScript *scr = owner;
+				GDScriptNativeClass *nc = nullptr;
+				while (scr) {
+					if (scr->constants.has(identifier)) {
+						r_value = scr->constants[identifier];
+						return _is_immutable_value(r_value) || _is_class_reference(r_value);
+					}
+					if (scr->native.is_valid()) {
+						nc = scr->native.ptr();
+					}
+					scr = scr->_base;
+				}
+
+				if (nc) {
+					bool success = false;
+					int constant = ClassDB::get_integer_constant(nc->get_name(), identifier, &success);
+					if (success) {
+						r_value = constant;
+						return true;
+					}
+				}
+
+				owner = owner->_owner;
+			}
+			return false;
+		} break;
+		case GDScriptParser::Node::TYPE_OPERATOR: {
+			const GDScriptParser::OperatorNode *on = static_cast<const GDScriptParser::OperatorNode *>(p_expression);
+
+			Variant::Operator var_op = Variant::OP_MAX;
+			switch (on->op) {
+				case GDScriptParser::OperatorNode::OP_CALL: {
+					if (on->arguments.size() < 1) {
+						return false;
+					}
+
+					const GDScriptParser::Node *callee = on->arguments[0];
+					bool constructor = callee->type == GDScriptParser::Node::TYPE_TYPE;
+					if (!constructor && (callee->type != GDScriptParser::Node::TYPE_BUILT_IN_FUNCTION || !GDScriptFunctions::is_deterministic(static_cast<const GDScriptParser::BuiltInFunctionNode *>(callee)->function))) {
+						return false;
+					}
+
+					Vector<Variant> args;
+					args.resize(on->arguments.size() - 1);
+					Vector<const Variant *> argptrs;
+					argptrs.resize(args.size());
+					for (int i = 0; i < args.size(); i++) {
+						if (!_reduce_constant_expression(codegen, on->arguments[i + 1], args.write[i]) || !_is_immutable_value(args[i])) {
+							return false;
+						}
+						argptrs.write[i] = &args[i];
+					}
+
+					Callable::CallError ce;
+					if (constructor) {
+						r_value = Variant::construct(static_cast<const GDScriptParser::TypeNode *>(callee)->vtype, (const Variant **)argptrs.ptr(), argptrs.size(), ce);
+					} else {
+						GDScriptFunctions::call(static_cast<const GDScriptParser::BuiltInFunctionNode *>(callee)->function, (const Variant **)argptrs.ptr(), argptrs.size(), r_value, ce);
+					}
+					return ce.error == Callable::CallError::CALL_OK && _is_immutable_value(r_value);
+				} break;
+				case GDScriptParser::OperatorNode::OP_INDEX:
+				case GDScriptParser::OperatorNode::OP_INDEX_NAMED: {
+					Variant base;
+					if (on->arguments.size() != 2 || !_reduce_constant_expression(codegen, on->arguments[0], base)) {
+						return false;
+					}
+					if (_is_class_reference(base)) {
+						// Only constants, the properties of a class (such as a script's resource_name) may change at runtime.
+						if (on->op != GDScriptParser::OperatorNode::OP_INDEX_NAMED || on->arguments[1]->type != GDScriptParser::Node::TYPE_IDENTIFIER) {
+							return false;
+						}
+						StringName name = static_cast<const GDScriptParser::IdentifierNode *>(on->arguments[1])->name;
+
+						GDScript *script = Object::cast_to<GDScript>(base);
+						if (script) {
+							for (GDScript *scr = script; scr; scr = scr->_base) {
+								if (scr->constants.has(name)) {
+									r_value = scr->constants[name];
+									return _is_immutable_value(r_value) || _is_class_reference(r_value);
+								}
+							}
+							return false;
+						}
+
+						bool success = false;
+						int constant = ClassDB::get_integer_constant(Object::cast_to<GDScriptNativeClass>(base)->get_name(), name, &success);
+						if (success) {
+							r_value = constant;
+						}
+						return success;
+					}
+					if (!_is_immutable_value(base)) {
+						return false;
+					}
+					bool valid = false;
+					if (on->op == GDScriptParser::OperatorNode::OP_INDEX_NAMED) {
+						if (on->arguments[1]->type != GDScriptParser::Node::TYPE_IDENTIFIER) {
+							return false;
+						}
+						r_value = base.get_named(static_cast<const GDScriptParser::IdentifierNode *>(on->arguments[1])->name, &valid);
+					} else {
+						Variant index;
+						if (!_reduce_constant_expression(codegen, on->arguments[1], index) || !_is_immutable_value(index)) {
+							return false;
+						}
+						r_value = base.get(index, &valid);
+					}
+					return valid && _is_immutable_value(r_value);
+				} break;
+				case GDScriptParser::OperatorNode::OP_AND:
+				case GDScriptParser::OperatorNode::OP_OR: {
+					// Only the left operand needs to be known when it short-circuits.
+					Variant a;
+					if (!_reduce_constant_expression(codegen, on->arguments[0], a) || !_is_immutable_value(a)) {
+						return false;
+					}
+					bool and_op = on->op == GDScriptParser::OperatorNode::OP_AND;
+					if (a.booleanize() != and_op) {
+						r_value = !and_op;
+						return true;
+					}
+					Variant b;
+					if (!_reduce_constant_expression(codegen, on->arguments[1], b) || !_is_immutable_value(b)) {
+						return false;
+					}
+					r_value = b.booleanize();
+					return true;
+				} break;
+				case GDScriptParser::OperatorNode::OP_TERNARY_IF: {
+					Variant condition;
+					if (!_reduce_constant_expression(codegen, on->arguments[0], condition) || !_is_immutable_value(condition)) {
+						return false;
+					}
+					return _reduce_constant_expression(codegen, on->arguments[condition.booleanize() ? 1 : 2], r_value);
+				} break;
+				case GDScriptParser::OperatorNode::OP_NEG:
+					var_op = Variant::OP_NEGATE;
+					break;
+				case GDScriptParser::OperatorNode::OP_POS:
+					var_op = Variant::OP_POSITIVE;
+					break;
+				case GDScriptParser::OperatorNode::OP_NOT:
+					var_op = Variant::OP_NOT;
+					break;
+				case GDScriptParser::OperatorNode::OP_BIT_INVERT:
+					var_op = Variant::OP_BIT_NEGATE;
+					break;
+				case GDScriptParser::OperatorNode::OP_IN:
+					var_op = Variant::OP_IN;
+					break;
+				case GDScriptParser::OperatorNode::OP_EQUAL:
+					var_op = Variant::OP_EQUAL;
+					break;
+				case GDScriptParser::OperatorNode::OP_NOT_EQUAL:
+					var_op = Variant::OP_NOT_EQUAL;
+					break;
+				case GDScriptParser::OperatorNode::OP_LESS:
+					var_op = Variant::OP_LESS;
+					break;
+				case GDScriptParser::OperatorNode::OP_LESS_EQUAL:
+					var_op = Variant::OP_LESS_EQUAL;
+					break;
+				case GDScriptParser::OperatorNode::OP_GREATER:
+					var_op = Variant::OP_GREATER;
+					break;
+				case GDScriptParser::OperatorNode::OP_GREATER_EQUAL:
+					var_op = Variant::OP_GREATER_EQUAL;
+					break;
+				case GDScriptParser::OperatorNode::OP_ADD:
+					var_op = Variant::OP_ADD;
+					break;
+				case GDScriptParser::OperatorNode::OP_SUB:
+					var_op = Variant::OP_SUBTRACT;
+					break;
+				case GDScriptParser::OperatorNode::OP_MUL:
+					var_op = Variant::OP_MULTIPLY;
+					break;
+				case GDScriptParser::OperatorNode::OP_DIV:
+					var_op = Variant::OP_DIVIDE;
+					break;
+				case GDScriptParser::OperatorNode::OP_MOD:
+					var_op = Variant::OP_MODULE;
+					break;
+				case GDScriptParser::OperatorNode::OP_SHIFT_LEFT:
+					var_op = Variant::OP_SHIFT_LEFT;
+					break;
+				case GDScriptParser::OperatorNode::OP_SHIFT_RIGHT:
+					var_op = Variant::OP_SHIFT_RIGHT;
+					break;
+				case GDScriptParser::OperatorNode::OP_BIT_AND:
+					var_op = Variant::OP_BIT_AND;
+					break;
+				case GDScriptParser::OperatorNode::OP_BIT_OR:
+					var_op = Variant::OP_BIT_OR;
+					break;
+				case GDScriptParser::OperatorNode::OP_BIT_XOR:
+					var_op = Variant::OP_BIT_XOR;
+					break;
+				default: {
+					return false;
+				}
+			}
+
+			Variant a;
+			Variant b;
+			if (!_reduce_constant_expression(codegen, on->arguments[0], a) || !_is_immutable_value(a)) {
+				return false;
+			}
+			// Unary operators are evaluated with the operand repeated, like the VM does.
+			if (on->arguments.size() > 1 && (!_reduce_constant_expression(codegen, on->arguments[1], b) || !_is_immutable_value(b))) {
+				return false;
+			}
+			bool valid = false;
+			Variant::evaluate(var_op, a, on->arguments.size() > 1 ? b : a, r_value, valid);
+			return valid && _is_immutable_value(r_value);
+		} break;
+		default: {
+			return false;
+		}
+	}
+}
+
 bool GDScriptCompiler::_create_unary_operator(CodeGen &codegen, const GDScriptParser::OperatorNode *on, Variant::Operator op, int p_stack_level) {
 	ERR_FAIL_COND_V(on->arguments.size() != 1, false);
 
@@ -82,7 +371,15 @@ bool GDScriptCompiler::_create_unary_operator(CodeGen &codegen, const GDScriptPa
 		return false;
 	}
 
-	codegen.opcodes.push_back(GDScriptFunction::OPCODE_OPERATOR); // perform operator
+	// The operand is repeated as the second argument, unary evaluators ignore it.
+	Variant::Type type_a = _get_static_builtin_type(on->arguments[0]);
+	int evaluator = codegen.get_validated_operator_pos(op, type_a, type_a);
+	if (evaluator >= 0) {
+		codegen.opcodes.push_back(GDScriptFunction::OPCODE_OPERATOR_VALIDATED); // perform operator with known types
+		codegen.opcodes.push_back(evaluator); // which evaluator
+	} else {
+		codegen.opcodes.push_back(GDScriptFunction::OPCODE_OPERATOR); // perform operator
+	}
 	codegen.opcodes.push_back(op); //which operator
 	codegen.opcodes.push_back(src_address_a); // argument 1
 	codegen.opcodes.push_back(src_address_a); // argument 2 (repeated)
@@ -97,7 +394,7 @@ bool GDScriptCompiler::_create_binary_operator(CodeGen &codegen, const GDScriptP
 	if (src_address_a < 0) {
 		return false;
 	}
-	if (src_address_a & GDScriptFunction::ADDR_TYPE_STACK << GDScriptFunction::ADDR_BITS) {
+	if (_is_stack_temporary(src_address_a)) {
 		p_stack_level++; //uses stack for return, increase stack
 	}
 
@@ -106,7 +403,13 @@ bool GDScriptCompiler::_create_binary_operator(CodeGen &codegen, const GDScriptP
 		return false;
 	}
 
-	codegen.opcodes.push_back(GDScriptFunction::OPCODE_OPERATOR); // perform operator
+	int evaluator = codegen.get_validated_operator_pos(op, _get_static_builtin_type(on->arguments[0]), _get_static_builtin_type(on->arguments[1]));
+	if (evaluator >= 0) {
+		codegen.opcodes.push_back(GDScriptFunction::OPCODE_OPERATOR_VALIDATED); // perform operator with known types
+		codegen.opcodes.push_back(evaluator); // which evaluator
+	} else {
+		codegen.opcodes.push_back(GDScriptFunction::OPCODE_OPERATOR); // perform operator
+	}
 	codegen.opcodes.push_back(op); //which operator
 	codegen.opcodes.push_back(src_address_a); // argument 1
 	codegen.opcodes.push_back(src_address_b); // argument 2 (unary only takes one parameter)
@@ -233,6 +536,13 @@ int GDScriptCompiler::_parse_assign_right_expression(CodeGen &codegen, const GDS
 }
 
 int GDScriptCompiler::_parse_expression(CodeGen &codegen, const GDScriptParser::Node *p_expression, int p_stack_level, bool p_root, bool p_initializer, int p_index_addr) {
+	if (!p_initializer && !p_index_addr && (p_expression->type == GDScriptParser::Node::TYPE_IDENTIFIER || p_expression->type == GDScriptParser::Node::TYPE_OPERATOR)) {
+		Variant value;
+		if (_reduce_constant_expression(codegen, p_expression, value) && _is_immutable_value(value)) {
+			return codegen.get_constant_pos(value) | (GDScriptFunction::ADDR_TYPE_LOCAL_CONSTANT << GDScriptFunction::ADDR_BITS);
+		}
+	}
+
 	switch (p_expression->type) {
 		//should parse variable declaration and adjust stack accordingly...
 		case GDScriptParser::Node::TYPE_IDENTIFIER: {
@@ -407,7 +717,7 @@ int GDScriptCompiler::_parse_expression(CodeGen &codegen, const GDScriptParser::
 				if (ret < 0) {
 					return ret;
 				}
-				if ((ret >> GDScriptFunction::ADDR_BITS & GDScriptFunction::ADDR_TYPE_STACK) == GDScriptFunction::ADDR_TYPE_STACK) {
+				if (_is_stack_temporary(ret)) {
 					slevel++;
 					codegen.alloc_stack(slevel);
 				}
@@ -438,7 +748,7 @@ int GDScriptCompiler::_parse_expression(CodeGen &codegen, const GDScriptParser::
 				if (ret < 0) {
 					return ret;
 				}
-				if ((ret >> GDScriptFunction::ADDR_BITS & GDScriptFunction::ADDR_TYPE_STACK) == GDScriptFunction::ADDR_TYPE_STACK) {
+				if (_is_stack_temporary(ret)) {
 					slevel++;
 					codegen.alloc_stack(slevel);
 				}
@@ -449,7 +759,7 @@ int GDScriptCompiler::_parse_expression(CodeGen &codegen, const GDScriptParser::
 				if (ret < 0) {
 					return ret;
 				}
-				if ((ret >> GDScriptFunction::ADDR_BITS & GDScriptFunction::ADDR_TYPE_STACK) == GDScriptFunction::ADDR_TYPE_STACK) {
+				if (_is_stack_temporary(ret)) {
 					slevel++;
 					codegen.alloc_stack(slevel);
 				}
@@ -477,7 +787,7 @@ int GDScriptCompiler::_parse_expression(CodeGen &codegen, const GDScriptParser::
 			if (src_addr < 0) {
 				return src_addr;
 			}
-			if (src_addr & GDScriptFunction::ADDR_TYPE_STACK << GDScriptFunction::ADDR_BITS) {
+			if (_is_stack_temporary(src_addr)) {
 				slevel++;
 				codegen.alloc_stack(slevel);
 			}
@@ -541,7 +851,7 @@ int GDScriptCompiler::_parse_expression(CodeGen &codegen, const GDScriptParser::
 						if (ret < 0) {
 							return ret;
 						}
-						if ((ret >> GDScriptFunction::ADDR_BITS & GDScriptFunction::ADDR_TYPE_STACK) == GDScriptFunction::ADDR_TYPE_STACK) {
+						if (_is_stack_temporary(ret)) {
 							slevel++;
 							codegen.alloc_stack(slevel);
 						}
@@ -574,7 +884,7 @@ int GDScriptCompiler::_parse_expression(CodeGen &codegen, const GDScriptParser::
 							if (ret < 0) {
 								return ret;
 							}
-							if ((ret >> GDScriptFunction::ADDR_BITS & GDScriptFunction::ADDR_TYPE_STACK) == GDScriptFunction::ADDR_TYPE_STACK) {
+							if (_is_stack_temporary(ret)) {
 								slevel++;
 								codegen.alloc_stack(slevel);
 							}
@@ -603,7 +913,7 @@ int GDScriptCompiler::_parse_expression(CodeGen &codegen, const GDScriptParser::
 								return ret;
 							}
 
-							if ((ret >> GDScriptFunction::ADDR_BITS & GDScriptFunction::ADDR_TYPE_STACK) == GDScriptFunction::ADDR_TYPE_STACK) {
+							if (_is_stack_temporary(ret)) {
 								slevel++;
 								codegen.alloc_stack(slevel);
 							}
@@ -651,7 +961,7 @@ int GDScriptCompiler::_parse_expression(CodeGen &codegen, const GDScriptParser::
 								if (ret < 0) {
 									return ret;
 								}
-								if ((ret >> GDScriptFunction::ADDR_BITS & GDScriptFunction::ADDR_TYPE_STACK) == GDScriptFunction::ADDR_TYPE_STACK) {
+								if (_is_stack_temporary(ret)) {
 									slevel++;
 									codegen.alloc_stack(slevel);
 								}
@@ -659,8 +969,33 @@ int GDScriptCompiler::_parse_expression(CodeGen &codegen, const GDScriptParser::
 							arguments.push_back(ret);
 						}
 
-						codegen.opcodes.push_back(p_root ? GDScriptFunction::OPCODE_CALL : GDScriptFunction::OPCODE_CALL_RETURN); // perform operator
-						codegen.opcodes.push_back(on->arguments.size() - 2);
+						StringName method_name = static_cast<const GDScriptParser::IdentifierNode *>(on->arguments[1])->name;
+
+						// Methods of builtin types with known argument types can skip the generic dispatch.
+						int validated_method = -1;
+						Variant::Type base_type = _get_static_builtin_type(on->arguments[0]);
+						if (!p_root && base_type != Variant::NIL && base_type != Variant::OBJECT) {
+							Vector<Variant::Type> argument_types;
+							for (int i = 2; i < on->arguments.size(); i++) {
+								argument_types.push_back(_get_static_builtin_type(on->arguments[i]));
+							}
+							if (argument_types.find(Variant::NIL) == -1) {
+								validated_method = codegen.get_validated_builtin_method_pos(base_type, method_name, argument_types);
+							}
+						}
+
+						if (validated_method >= 0) {
+							codegen.opcodes.push_back(GDScriptFunction::OPCODE_CALL_BUILTIN_TYPE_VALIDATED);
+							codegen.opcodes.push_back(on->arguments.size() - 2);
+							codegen.opcodes.push_back(validated_method);
+						} else {
+							// Object::call() handles 'free' specially, it can't be cached.
+							int cache = method_name == "free" ? -1 : codegen.alloc_inline_cache();
+
+							codegen.opcodes.push_back(p_root ? GDScriptFunction::OPCODE_CALL : GDScriptFunction::OPCODE_CALL_RETURN); // perform operator
+							codegen.opcodes.push_back(on->arguments.size() - 2);
+							codegen.opcodes.push_back(cache);
+						}
 						codegen.alloc_call(on->arguments.size() - 2);
 						for (int i = 0; i < arguments.size(); i++) {
 							codegen.opcodes.push_back(arguments[i]);
@@ -677,7 +1012,7 @@ int GDScriptCompiler::_parse_expression(CodeGen &codegen, const GDScriptParser::
 						if (ret < 0) {
 							return ret;
 						}
-						if ((ret >> GDScriptFunction::ADDR_BITS & GDScriptFunction::ADDR_TYPE_STACK) == GDScriptFunction::ADDR_TYPE_STACK) {
+						if (_is_stack_temporary(ret)) {
 							slevel++;
 							codegen.alloc_stack(slevel);
 						}
@@ -740,7 +1075,7 @@ int GDScriptCompiler::_parse_expression(CodeGen &codegen, const GDScriptParser::
 
 						} else {
 							//regular indexing
-							if (from & GDScriptFunction::ADDR_TYPE_STACK << GDScriptFunction::ADDR_BITS) {
+							if (_is_stack_temporary(from)) {
 								slevel++;
 								codegen.alloc_stack(slevel);
 							}
@@ -752,9 +1087,28 @@ int GDScriptCompiler::_parse_expression(CodeGen &codegen, const GDScriptParser::
 						}
 					}
 
-					codegen.opcodes.push_back(named ? GDScriptFunction::OPCODE_GET_NAMED : GDScriptFunction::OPCODE_GET); // perform operator
+					int getter = -1;
+					int indexed_getter = -1;
+					if (on->op == GDScriptParser::OperatorNode::OP_INDEX_NAMED && p_index_addr == 0) {
+						getter = GDScriptValidatedOps::find_member(_get_static_builtin_type(on->arguments[0]), static_cast<GDScriptParser::IdentifierNode *>(on->arguments[1])->name);
+					} else if (!named && _get_static_builtin_type(on->arguments[1]) == Variant::INT) {
+						indexed_getter = codegen.get_validated_indexed_access_pos(_get_static_builtin_type(on->arguments[0]), Variant::NIL);
+					}
+
+					if (getter >= 0) {
+						codegen.opcodes.push_back(GDScriptFunction::OPCODE_GET_NAMED_VALIDATED); // perform operator with known base type
+						codegen.opcodes.push_back(getter); // which getter
+					} else if (indexed_getter >= 0) {
+						codegen.opcodes.push_back(GDScriptFunction::OPCODE_GET_INDEXED_VALIDATED); // element of a packed array
+						codegen.opcodes.push_back(indexed_getter); // which getter
+					} else {
+						codegen.opcodes.push_back(named ? GDScriptFunction::OPCODE_GET_NAMED : GDScriptFunction::OPCODE_GET); // perform operator
+					}
 					codegen.opcodes.push_back(from); // argument 1
 					codegen.opcodes.push_back(index); // argument 2 (unary only takes one parameter)
+					if (getter < 0 && named) {
+						codegen.opcodes.push_back(codegen.alloc_inline_cache());
+					}
 
 				} break;
 				case GDScriptParser::OperatorNode::OP_AND: {
@@ -1047,9 +1401,18 @@ int GDScriptCompiler::_parse_expression(CodeGen &codegen, const GDScriptParser::
 						if (prev_pos < 0) {
 							return prev_pos;
 						}
+						if ((prev_pos >> GDScriptFunction::ADDR_BITS) == GDScriptFunction::ADDR_TYPE_LOCAL_CONSTANT) {
+							// Constants are shared by the whole function, never write into them.
+							int copy_pos = slevel | (GDScriptFunction::ADDR_TYPE_STACK << GDScriptFunction::ADDR_BITS);
+							codegen.opcodes.push_back(GDScriptFunction::OPCODE_ASSIGN);
+							codegen.opcodes.push_back(copy_pos);
+							codegen.opcodes.push_back(prev_pos);
+							codegen.alloc_stack(slevel);
+							prev_pos = copy_pos;
+						}
 						int retval = prev_pos;
 
-						if (retval & GDScriptFunction::ADDR_TYPE_STACK << GDScriptFunction::ADDR_BITS) {
+						if (_is_stack_temporary(retval)) {
 							slevel++;
 							codegen.alloc_stack(slevel);
 						}
@@ -1078,7 +1441,7 @@ int GDScriptCompiler::_parse_expression(CodeGen &codegen, const GDScriptParser::
 								//printf("named key %x\n",key_idx);
 
 							} else {
-								if (prev_pos & (GDScriptFunction::ADDR_TYPE_STACK << GDScriptFunction::ADDR_BITS)) {
+								if (_is_stack_temporary(prev_pos)) {
 									slevel++;
 									codegen.alloc_stack(slevel);
 								}
@@ -1097,6 +1460,9 @@ int GDScriptCompiler::_parse_expression(CodeGen &codegen, const GDScriptParser::
 							codegen.opcodes.push_back(named ? GDScriptFunction::OPCODE_GET_NAMED : GDScriptFunction::OPCODE_GET);
 							codegen.opcodes.push_back(prev_pos);
 							codegen.opcodes.push_back(key_idx);
+							if (named) {
+								codegen.opcodes.push_back(codegen.alloc_inline_cache());
+							}
 							slevel++;
 							codegen.alloc_stack(slevel);
 							int dst_pos = (GDScriptFunction::ADDR_TYPE_STACK << GDScriptFunction::ADDR_BITS) | slevel;
@@ -1130,7 +1496,7 @@ int GDScriptCompiler::_parse_expression(CodeGen &codegen, const GDScriptParser::
 							return set_index;
 						}
 
-						if (set_index & GDScriptFunction::ADDR_TYPE_STACK << GDScriptFunction::ADDR_BITS) {
+						if (_is_stack_temporary(set_index)) {
 							slevel++;
 							codegen.alloc_stack(slevel);
 						}
@@ -1140,7 +1506,27 @@ int GDScriptCompiler::_parse_expression(CodeGen &codegen, const GDScriptParser::
 							return set_value;
 						}
 
-						codegen.opcodes.push_back(named ? GDScriptFunction::OPCODE_SET_NAMED : GDScriptFunction::OPCODE_SET);
+						int setter = -1;
+						int indexed_setter = -1;
+						if (named) {
+							setter = GDScriptValidatedOps::find_member(_get_static_builtin_type(op->arguments[0]), static_cast<const GDScriptParser::IdentifierNode *>(op->arguments[1])->name);
+						} else if (on->op == GDScriptParser::OperatorNode::OP_ASSIGN && _get_static_builtin_type(op->arguments[1]) == Variant::INT) {
+							// Only plain assignments have a known value type.
+							Variant::Type value_type = _get_static_builtin_type(on->arguments[1]);
+							if (value_type != Variant::NIL) {
+								indexed_setter = codegen.get_validated_indexed_access_pos(_get_static_builtin_type(op->arguments[0]), value_type);
+							}
+						}
+
+						if (setter >= 0) {
+							codegen.opcodes.push_back(GDScriptFunction::OPCODE_SET_NAMED_VALIDATED);
+							codegen.opcodes.push_back(setter);
+						} else if (indexed_setter >= 0) {
+							codegen.opcodes.push_back(GDScriptFunction::OPCODE_SET_INDEXED_VALIDATED);
+							codegen.opcodes.push_back(indexed_setter);
+						} else {
+							codegen.opcodes.push_back(named ? GDScriptFunction::OPCODE_SET_NAMED : GDScriptFunction::OPCODE_SET);
+						}
 						codegen.opcodes.push_back(prev_pos);
 						codegen.opcodes.push_back(set_index);
 						codegen.opcodes.push_back(set_value);
@@ -1178,7 +1564,7 @@ int GDScriptCompiler::_parse_expression(CodeGen &codegen, const GDScriptParser::
 							return -1;
 						}
 
-						if (dst_address_a & GDScriptFunction::ADDR_TYPE_STACK << GDScriptFunction::ADDR_BITS) {
+						if (_is_stack_temporary(dst_address_a)) {
 							slevel++;
 							codegen.alloc_stack(slevel);
 						}
@@ -1252,7 +1638,7 @@ int GDScriptCompiler::_parse_expression(CodeGen &codegen, const GDScriptParser::
 						return -1;
 					}
 
-					if (src_address_a & GDScriptFunction::ADDR_TYPE_STACK << GDScriptFunction::ADDR_BITS) {
+					if (_is_stack_temporary(src_address_a)) {
 						slevel++; //uses stack for return, increase stack
 					}
 
@@ -1277,7 +1663,7 @@ int GDScriptCompiler::_parse_expression(CodeGen &codegen, const GDScriptParser::
 						return -1;
 					}
 
-					if (src_address_a & GDScriptFunction::ADDR_TYPE_STACK << GDScriptFunction::ADDR_BITS) {
+					if (_is_stack_temporary(src_address_a)) {
 						slevel++; //uses stack for return, increase stack
 					}
 
@@ -1310,7 +1696,9 @@ Error GDScriptCompiler::_parse_block(CodeGen &codegen, const GDScriptParser::Blo
 	int new_identifiers = 0;
 	codegen.current_line = p_block->line;
 
-	for (int i = 0; i < p_block->statements.size(); i++) {
+	bool unreachable = false; // After a return, break or continue.
+
+	for (int i = 0; i < p_block->statements.size() && !unreachable; i++) {
 		const GDScriptParser::Node *s = p_block->statements[i];
 
 		switch (s->type) {
@@ -1401,6 +1789,19 @@ Error GDScriptCompiler::_parse_block(CodeGen &codegen, const GDScriptParser::Blo
 					} break;
 
 					case GDScriptParser::ControlFlowNode::CF_IF: {
+						Variant condition;
+						if (_reduce_constant_expression(codegen, cf->arguments[0], condition)) {
+							// Only the branch that can be taken is emitted.
+							const GDScriptParser::BlockNode *taken = condition.booleanize() ? cf->body : cf->body_else;
+							if (taken) {
+								Error err = _parse_block(codegen, taken, p_stack_level, p_break_addr, p_continue_addr);
+								if (err) {
+									return err;
+								}
+							}
+							break;
+						}
+
 						int ret2 = _parse_expression(codegen, cf->arguments[0], p_stack_level, false);
 						if (ret2 < 0) {
 							return ERR_PARSE_ERROR;
@@ -1488,6 +1889,12 @@ Error GDScriptCompiler::_parse_block(CodeGen &codegen, const GDScriptParser::Blo
 
 					} break;
 					case GDScriptParser::ControlFlowNode::CF_WHILE: {
+						Variant condition;
+						bool constant_condition = _reduce_constant_expression(codegen, cf->arguments[0], condition);
+						if (constant_condition && !condition.booleanize()) {
+							break; // Never entered.
+						}
+
 						codegen.opcodes.push_back(GDScriptFunction::OPCODE_JUMP);
 						codegen.opcodes.push_back(codegen.opcodes.size() + 3);
 						int break_addr = codegen.opcodes.size();
@@ -1495,13 +1902,15 @@ Error GDScriptCompiler::_parse_block(CodeGen &codegen, const GDScriptParser::Blo
 						codegen.opcodes.push_back(0);
 						int continue_addr = codegen.opcodes.size();
 
-						int ret2 = _parse_expression(codegen, cf->arguments[0], p_stack_level, false);
-						if (ret2 < 0) {
-							return ERR_PARSE_ERROR;
+						if (!constant_condition) {
+							int ret2 = _parse_expression(codegen, cf->arguments[0], p_stack_level, false);
+							if (ret2 < 0) {
+								return ERR_PARSE_ERROR;
+							}
+							codegen.opcodes.push_back(GDScriptFunction::OPCODE_JUMP_IF_NOT);
+							codegen.opcodes.push_back(ret2);
+							codegen.opcodes.push_back(break_addr);
 						}
-						codegen.opcodes.push_back(GDScriptFunction::OPCODE_JUMP_IF_NOT);
-						codegen.opcodes.push_back(ret2);
-						codegen.opcodes.push_back(break_addr);
 						Error err = _parse_block(codegen, cf->body, p_stack_level, break_addr, continue_addr);
 						if (err) {
 							return err;
@@ -1519,6 +1928,7 @@ Error GDScriptCompiler::_parse_block(CodeGen &codegen, const GDScriptParser::Blo
 						}
 						codegen.opcodes.push_back(GDScriptFunction::OPCODE_JUMP);
 						codegen.opcodes.push_back(p_break_addr);
+						unreachable = true;
 
 					} break;
 					case GDScriptParser::ControlFlowNode::CF_CONTINUE: {
@@ -1529,6 +1939,7 @@ Error GDScriptCompiler::_parse_block(CodeGen &codegen, const GDScriptParser::Blo
 
 						codegen.opcodes.push_back(GDScriptFunction::OPCODE_JUMP);
 						codegen.opcodes.push_back(p_continue_addr);
+						unreachable = true;
 
 					} break;
 					case GDScriptParser::ControlFlowNode::CF_RETURN: {
@@ -1546,6 +1957,7 @@ Error GDScriptCompiler::_parse_block(CodeGen &codegen, const GDScriptParser::Blo
 
 						codegen.opcodes.push_back(GDScriptFunction::OPCODE_RETURN);
 						codegen.opcodes.push_back(ret2);
+						unreachable = true;
 
 					} break;
 				}
@@ -1618,6 +2030,7 @@ Error GDScriptCompiler::_parse_function(GDScript *p_script, const GDScriptParser
 	codegen.stack_max = 0;
 	codegen.current_line = 0;
 	codegen.call_max = 0;
+	codegen.inline_cache_count = 0;
 	codegen.debug_stack = EngineDebugger::is_active();
 	Vector<StringName> argnames;
 
@@ -1796,6 +2209,22 @@ Error GDScriptCompiler::_parse_function(GDScript *p_script, const GDScriptParser
 	gdfunc->_argument_count = p_func ? p_func->arguments.size() : 0;
 	gdfunc->_stack_size = codegen.stack_max;
 	gdfunc->_call_size = codegen.call_max;
+	if (codegen.inline_cache_count) {
+		gdfunc->inline_caches.resize(codegen.inline_cache_count);
+		gdfunc->_inline_caches_ptr = gdfunc->inline_caches.ptrw();
+	} else {
+		gdfunc->_inline_caches_ptr = nullptr;
+	}
+	gdfunc->_inline_cache_count = codegen.inline_cache_count;
+	gdfunc->validated_operators = codegen.validated_operators;
+	gdfunc->_validated_operators_ptr = gdfunc->validated_operators.size() ? gdfunc->validated_operators.ptr() : nullptr;
+	gdfunc->_validated_operator_count = gdfunc->validated_operators.size();
+	gdfunc->validated_builtin_methods = codegen.validated_builtin_methods;
+	gdfunc->_validated_builtin_methods_ptr = gdfunc->validated_builtin_methods.size() ? gdfunc->validated_builtin_methods.ptr() : nullptr;
+	gdfunc->_validated_builtin_method_count = gdfunc->validated_builtin_methods.size();
+	gdfunc->validated_indexed_accesses = codegen.validated_indexed_accesses;
+	gdfunc->_validated_indexed_accesses_ptr = gdfunc->validated_indexed_accesses.size() ? gdfunc->validated_indexed_accesses.ptr() : nullptr;
+	gdfunc->_validated_indexed_access_count = gdfunc->validated_indexed_accesses.size();
 	gdfunc->name = func_name;
 #ifdef DEBUG_ENABLED
 	if (EngineDebugger::is_active()) {
@@ -1881,6 +2310,7 @@ Error GDScriptCompiler::_parse_class_level(GDScript *p_script, const GDScriptPar
 	}
 	p_script->member_functions.clear();
 	p_script->member_indices.clear();
+	GDScriptFunction::invalidate_inline_caches();
 	p_script->member_info.clear();
 	p_script->_signals.clear();
 	p_script->initializer = nullptr;
@@ -129,10 +129,100 @@ class GDScriptCompiler {
 				call_max = p_params;
 			}
 		}
+		int alloc_inline_cache() {
+			return inline_cache_count++;
+		}
+
+		Vector<GDScriptFunction::ValidatedOperator> validated_operators;
+		int get_validated_operator_pos(Variant::Operator p_op, Variant::Type p_type_a, Variant::Type p_type_b) {
+			for (int i = 0; i < validated_operators.size(); i++) {
+				const GDScriptFunction::ValidatedOperator &vop = validated_operators[i];
+				if (vop.op == p_op && vop.type_a == p_type_a && vop.type_b == p_type_b) {
+					return i;
+				}
+			}
+
+			GDScriptFunction::ValidatedOperator vop;
+			vop.evaluator = Variant::get_validated_operator_evaluator(p_op, p_type_a, p_type_b);
+			if (!vop.evaluator) {
+				return -1;
+			}
+			vop.op = p_op;
+			vop.type_a = p_type_a;
+			vop.type_b = p_type_b;
+			validated_operators.push_back(vop);
+			return validated_operators.size() - 1;
+		}
+
+		Vector<GDScriptFunction::ValidatedBuiltInMethodCall> validated_builtin_methods;
+		int get_validated_builtin_method_pos(Variant::Type p_base_type, const StringName &p_method, const Vector<Variant::Type> &p_argument_types) {
+			for (int i = 0; i < validated_builtin_methods.size(); i++) {
+				const GDScriptFunction::ValidatedBuiltInMethodCall &vbm = validated_builtin_methods[i];
+				if (vbm.base_type != p_base_type || vbm.method != p_method || vbm.argument_count != p_argument_types.size()) {
+					continue;
+				}
+				bool match = true;
+				for (int j = 0; j < vbm.argument_count; j++) {
+					if (vbm.argument_types[j] != p_argument_types[j]) {
+						match = false;
+						break;
+					}
+				}
+				if (match) {
+					return i;
+				}
+			}
+
+			if (p_argument_types.size() > VARIANT_ARG_MAX) {
+				return -1;
+			}
+			GDScriptFunction::ValidatedBuiltInMethodCall vbm;
+			vbm.function = Variant::get_validated_builtin_method(p_base_type, p_method, p_argument_types.ptr(), p_argument_types.size());
+			if (!vbm.function) {
+				return -1;
+			}
+			vbm.base_type = p_base_type;
+			vbm.method = p_method;
+			vbm.argument_count = p_argument_types.size();
+			for (int j = 0; j < vbm.argument_count; j++) {
+				vbm.argument_types[j] = p_argument_types[j];
+			}
+			validated_builtin_methods.push_back(vbm);
+			return validated_builtin_methods.size() - 1;
+		}
+
+		// Pass Variant::NIL as value type for reads.
+		Vector<GDScriptFunction::ValidatedIndexedAccess> validated_indexed_accesses;
+		int get_validated_indexed_access_pos(Variant::Type p_base_type, Variant::Type p_value_type) {
+			for (int i = 0; i < validated_indexed_accesses.size(); i++) {
+				const GDScriptFunction::ValidatedIndexedAccess &via = validated_indexed_accesses[i];
+				if (via.base_type == p_base_type && via.value_type == p_value_type) {
+					return i;
+				}
+			}
+
+			GDScriptFunction::ValidatedIndexedAccess via;
+			if (p_value_type == Variant::NIL) {
+				via.getter = Variant::get_validated_indexed_getter(p_base_type);
+				if (!via.getter) {
+					return -1;
+				}
+			} else {
+				via.setter = Variant::get_validated_indexed_setter(p_base_type, p_value_type);
+				if (!via.setter) {
+					return -1;
+				}
+			}
+			via.base_type = p_base_type;
+			via.value_type = p_value_type;
+			validated_indexed_accesses.push_back(via);
+			return validated_indexed_accesses.size() - 1;
+		}
 
 		int current_line;
 		int stack_max;
 		int call_max;
+		int inline_cache_count;
 	};
 
 	bool _is_class_member_property(CodeGen &codegen, const StringName &p_name);
@@ -140,6 +230,8 @@ class GDScriptCompiler {
 
 	void _set_error(const String &p_error, const GDScriptParser::Node *p_node);
 
+	Variant::Type _get_static_builtin_type(const GDScriptParser::Node *p_node) const;
+	bool _reduce_constant_expression(CodeGen &codegen, const GDScriptParser::Node *p_expression, Variant &r_value);
 	bool _create_unary_operator(CodeGen &codegen, const GDScriptParser::OperatorNode *on, Variant::Operator op, int p_stack_level);
 	bool _create_binary_operator(CodeGen &codegen, const GDScriptParser::OperatorNode *on, Variant::Operator op, int p_stack_level, bool p_initializer = false, int p_index_addr = 0);
 
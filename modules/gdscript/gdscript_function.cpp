@@ -30,9 +30,16 @@
 
 #include "gdscript_function.h"
 
+#include "core/class_db.h"
+#include "core/debugger/sampling_profiler.h"
+#include "core/os/copymem.h"
 #include "core/os/os.h"
+#include "core/spin_lock.h"
+#include "core/variant_internal.h"
 #include "gdscript.h"
 #include "gdscript_functions.h"
+#include "gdscript_jobs.h"
+#include "gdscript_validated_ops.h"
 
 Variant *GDScriptFunction::_get_variant(int p_address, GDScriptInstance *p_instance, GDScript *p_script, Variant &self, Variant &static_ref, Variant *p_stack, String &r_error) const {
 	int address = p_address & ADDR_MASK;
@@ -155,6 +162,135 @@ static String _get_var_type(const Variant *p_var) {
 }
 #endif // DEBUG_ENABLED
 
+// Generic operator, indexing and named member paths, shared by the regular opcodes
+// and by the validated ones when their fast path doesn't apply.
+
+static _FORCE_INLINE_ bool _evaluate_operator(Variant::Operator p_op, const Variant *p_a, const Variant *p_b, Variant *r_dst, String &r_err_text) {
+	bool valid;
+#ifdef DEBUG_ENABLED
+
+	Variant ret;
+	Variant::evaluate(p_op, *p_a, *p_b, ret, valid);
+	if (!valid) {
+		if (ret.get_type() == Variant::STRING) {
+			//return a string when invalid with the error
+			r_err_text = ret;
+			r_err_text += " in operator '" + Variant::get_operator_name(p_op) + "'.";
+		} else {
+			r_err_text = "Invalid operands '" + Variant::get_type_name(p_a->get_type()) + "' and '" + Variant::get_type_name(p_b->get_type()) + "' in operator '" + Variant::get_operator_name(p_op) + "'.";
+		}
+		return false;
+	}
+	*r_dst = ret;
+#else
+	Variant::evaluate(p_op, *p_a, *p_b, *r_dst, valid);
+#endif
+	return true;
+}
+
+// Jobs can't touch most objects, only checked for object bases to stay off the common paths.
+static _FORCE_INLINE_ bool _check_job_get(const Variant *p_src, String &r_err_text) {
+	if (likely(p_src->get_type() != Variant::OBJECT)) {
+		return true;
+	}
+	GDScriptJobs::Context *job_context = GDScriptJobs::get_current_context();
+	return !job_context || job_context->check_get(p_src, r_err_text);
+}
+
+// Values jobs may modify in place live on their own stack.
+static _FORCE_INLINE_ bool _is_local_address(int p_address) {
+	int type = (p_address & GDScriptFunction::ADDR_TYPE_MASK) >> GDScriptFunction::ADDR_BITS;
+	return type == GDScriptFunction::ADDR_TYPE_STACK || type == GDScriptFunction::ADDR_TYPE_STACK_VARIABLE;
+}
+
+static _FORCE_INLINE_ bool _set_indexed(Variant *p_dst, const Variant *p_index, const Variant *p_value, String &r_err_text) {
+	bool valid;
+	p_dst->set(*p_index, *p_value, &valid);
+
+#ifdef DEBUG_ENABLED
+	if (!valid) {
+		String v = p_index->operator String();
+		if (v != "") {
+			v = "'" + v + "'";
+		} else {
+			v = "of type '" + _get_var_type(p_index) + "'";
+		}
+		r_err_text = "Invalid set index " + v + " (on base: '" + _get_var_type(p_dst) + "') with value of type '" + _get_var_type(p_value) + "'";
+		return false;
+	}
+#endif
+	return true;
+}
+
+static _FORCE_INLINE_ bool _get_indexed(const Variant *p_src, const Variant *p_index, Variant *r_dst, String &r_err_text) {
+	if (!_check_job_get(p_src, r_err_text)) {
+		return false;
+	}
+
+	bool valid;
+#ifdef DEBUG_ENABLED
+	//allow better error message in cases where src and dst are the same stack position
+	Variant ret = p_src->get(*p_index, &valid);
+#else
+	*r_dst = p_src->get(*p_index, &valid);
+
+#endif
+#ifdef DEBUG_ENABLED
+	if (!valid) {
+		String v = p_index->operator String();
+		if (v != "") {
+			v = "'" + v + "'";
+		} else {
+			v = "of type '" + _get_var_type(p_index) + "'";
+		}
+		r_err_text = "Invalid get index " + v + " (on base: '" + _get_var_type(p_src) + "').";
+		return false;
+	}
+	*r_dst = ret;
+#endif
+	return true;
+}
+
+static _FORCE_INLINE_ bool _set_named(Variant *p_dst, const StringName &p_index, const Variant *p_value, String &r_err_text) {
+	bool valid;
+	p_dst->set_named(p_index, *p_value, &valid);
+
+#ifdef DEBUG_ENABLED
+	if (!valid) {
+		r_err_text = "Invalid set index '" + String(p_index) + "' (on base: '" + _get_var_type(p_dst) + "') with value of type '" + _get_var_type(p_value) + "'.";
+		return false;
+	}
+#endif
+	return true;
+}
+
+static _FORCE_INLINE_ bool _get_named(const Variant *p_src, const StringName &p_index, Variant *r_dst, String &r_err_text) {
+	if (!_check_job_get(p_src, r_err_text)) {
+		return false;
+	}
+
+	bool valid;
+#ifdef DEBUG_ENABLED
+	//allow better error message in cases where src and dst are the same stack position
+	Variant ret = p_src->get_named(p_index, &valid);
+
+#else
+	*r_dst = p_src->get_named(p_index, &valid);
+#endif
+#ifdef DEBUG_ENABLED
+	if (!valid) {
+		if (p_src->has_method(p_index)) {
+			r_err_text = "Invalid get index '" + p_index.operator String() + "' (on base: '" + _get_var_type(p_src) + "'). Did you mean '." + p_index.operator String() + "()' or funcref(obj, \"" + p_index.operator String() + "\") ?";
+		} else {
+			r_err_text = "Invalid get index '" + p_index.operator String() + "' (on base: '" + _get_var_type(p_src) + "').";
+		}
+		return false;
+	}
+	*r_dst = ret;
+#endif
+	return true;
+}
+
 String GDScriptFunction::_get_call_error(const Callable::CallError &p_err, const String &p_where, const Variant **argptrs) const {
 	String err_text;
 
@@ -184,16 +320,154 @@ String GDScriptFunction::_get_call_error(const Callable::CallError &p_err, const
 	return err_text;
 }
 
+uint32_t GDScriptFunction::inline_cache_version = 1;
+
+void GDScriptFunction::invalidate_inline_caches() {
+	atomic_increment(&inline_cache_version);
+}
+
+const GDScriptFunction::InlineCache::Entry *GDScriptFunction::_inline_cache_find(int p_cache, Object *p_object, GDScriptInstance *&r_instance, const StringName &p_name, bool p_member) {
+	r_instance = nullptr;
+	ScriptInstance *script_instance = p_object->get_script_instance();
+	if (script_instance) {
+		// Other languages and placeholders resolve names their own way.
+		if (script_instance->get_language() != GDScriptLanguage::get_singleton() || script_instance->is_placeholder()) {
+			return nullptr;
+		}
+		r_instance = static_cast<GDScriptInstance *>(script_instance);
+	}
+
+	const GDScript *script = r_instance ? r_instance->script.ptr() : nullptr;
+	const StringName &class_name = p_object->get_class_name();
+	InlineCache &cache = _inline_caches_ptr[p_cache];
+
+	for (int i = 0; i < InlineCache::ENTRY_COUNT; i++) {
+		const InlineCache::Entry &entry = cache.entries[i];
+		if (entry.version == inline_cache_version && entry.script == script && entry.class_name == class_name) {
+			return entry.generic ? nullptr : &entry;
+		}
+	}
+
+	// Miss, resolve the same way Object::call() and Object::get() would.
+	// Names that can't be resolved here are cached too, so later lookups go
+	// straight to the generic path.
+	InlineCache::Entry resolved;
+	resolved.version = inline_cache_version;
+	resolved.script = script;
+	resolved.class_name = class_name;
+
+	if (p_member) {
+		const Map<StringName, GDScript::MemberInfo>::Element *E = script ? script->member_indices.find(p_name) : nullptr;
+		if (!E || E->get().getter) {
+			resolved.generic = true;
+		} else {
+			resolved.member_index = E->get().index;
+		}
+	} else {
+		for (const GDScript *sptr = script; sptr; sptr = sptr->_base) {
+			const Map<StringName, GDScriptFunction *>::Element *E = sptr->member_functions.find(p_name);
+			if (E) {
+				resolved.function = E->get();
+				break;
+			}
+		}
+		if (!resolved.function) {
+			resolved.method = ClassDB::get_method(class_name, p_name);
+			resolved.generic = !resolved.method;
+		}
+	}
+
+	for (int i = InlineCache::ENTRY_COUNT - 1; i > 0; i--) {
+		cache.entries[i] = cache.entries[i - 1];
+	}
+	cache.entries[0] = resolved;
+	return resolved.generic ? nullptr : &cache.entries[0];
+}
+
+bool GDScriptFunction::_inline_cache_call(int p_cache, Variant *p_base, const StringName &p_method, const Variant **p_args, int p_argcount, Variant *r_ret, Callable::CallError &r_err) {
+	if (p_cache < 0 || p_base->get_type() != Variant::OBJECT || Thread::get_caller_id() != Thread::get_main_id()) {
+		return false;
+	}
+#ifdef DEBUG_ENABLED
+	// Object::call() locks the object so it can't be freed while running its
+	// own methods, which can't be done from here. References can't be freed
+	// that way, so they are safe to call directly.
+	if (!p_base->is_ref()) {
+		return false;
+	}
+#endif
+	Object *object = p_base->operator Object *();
+	if (!object) {
+		return false;
+	}
+
+	GDScriptInstance *instance;
+	const InlineCache::Entry *entry = _inline_cache_find(p_cache, object, instance, p_method, false);
+	if (!entry) {
+		return false;
+	}
+
+	// The entry may be replaced by a recursive call through the same site.
+	GDScriptFunction *function = entry->function;
+	MethodBind *method = entry->method;
+
+	Variant ret;
+	if (function) {
+		ret = function->call(instance, p_args, p_argcount, r_err);
+	} else {
+		SamplingProfiler::Scope sampling_scope(SamplingProfiler::FRAME_NATIVE, method);
+		ret = method->call(object, p_args, p_argcount, r_err);
+	}
+	if (r_ret) {
+		*r_ret = ret;
+	}
+	return true;
+}
+
+bool GDScriptFunction::_inline_cache_get(int p_cache, const Variant *p_base, const StringName &p_name, Variant *r_dst) {
+	if (p_cache < 0 || p_base->get_type() != Variant::OBJECT || Thread::get_caller_id() != Thread::get_main_id()) {
+		return false;
+	}
+#ifdef DEBUG_ENABLED
+	Object *object = p_base->get_validated_object();
+#else
+	Object *object = p_base->operator Object *();
+#endif
+	if (!object) {
+		return false;
+	}
+
+	GDScriptInstance *instance;
+	const InlineCache::Entry *entry = _inline_cache_find(p_cache, object, instance, p_name, true);
+	if (!entry) {
+		return false;
+	}
+
+	if (entry->member_index >= instance->members.size()) {
+		return false;
+	}
+
+	// Copy first, the destination may hold the only reference to the instance.
+	Variant ret = instance->members[entry->member_index];
+	*r_dst = ret;
+	return true;
+}
+
 #if defined(__GNUC__)
 #define OPCODES_TABLE                         \
 	static const void *switch_table_ops[] = { \
 		&&OPCODE_OPERATOR,                    \
+		&&OPCODE_OPERATOR_VALIDATED,          \
 		&&OPCODE_EXTENDS_TEST,                \
 		&&OPCODE_IS_BUILTIN,                  \
 		&&OPCODE_SET,                         \
+		&&OPCODE_SET_INDEXED_VALIDATED,       \
 		&&OPCODE_GET,                         \
+		&&OPCODE_GET_INDEXED_VALIDATED,       \
 		&&OPCODE_SET_NAMED,                   \
+		&&OPCODE_SET_NAMED_VALIDATED,         \
 		&&OPCODE_GET_NAMED,                   \
+		&&OPCODE_GET_NAMED_VALIDATED,         \
 		&&OPCODE_SET_MEMBER,                  \
 		&&OPCODE_GET_MEMBER,                  \
 		&&OPCODE_ASSIGN,                      \
@@ -210,6 +484,7 @@ String GDScriptFunction::_get_call_error(const Callable::CallError &p_err, const
 		&&OPCODE_CONSTRUCT_DICTIONARY,        \
 		&&OPCODE_CALL,                        \
 		&&OPCODE_CALL_RETURN,                 \
+		&&OPCODE_CALL_BUILTIN_TYPE_VALIDATED, \
 		&&OPCODE_CALL_BUILT_IN,               \
 		&&OPCODE_CALL_SELF,                   \
 		&&OPCODE_CALL_SELF_BASE,              \
@@ -278,14 +553,16 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 	GDScript *script;
 	int ip = 0;
 	int line = _initial_line;
+	bool stack_moved = false; // Stack ownership was handed over to a yielded function state.
+	GDScriptJobs::Context *job_context = GDScriptJobs::get_current_context(); // Running as a job on a worker thread.
 
 	if (p_state) {
 		//use existing (supplied) state (yielded)
-		stack = (Variant *)p_state->stack.ptr();
-		call_args = (Variant **)&p_state->stack.ptr()[sizeof(Variant) * p_state->stack_size]; //ptr() to avoid bounds check
+		stack = (Variant *)p_state->stack;
+		call_args = (Variant **)&p_state->stack[sizeof(Variant) * p_state->stack_size];
 		line = p_state->line;
 		ip = p_state->ip;
-		alloca_size = p_state->stack.size();
+		alloca_size = p_state->alloca_size;
 		script = p_state->script;
 		p_instance = p_state->instance;
 		defarg = p_state->defarg;
@@ -326,7 +603,8 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 						r_err.expected = argument_types[i].kind == GDScriptDataType::BUILTIN ? argument_types[i].builtin_type : Variant::OBJECT;
 						return Variant();
 					}
-					if (argument_types[i].kind == GDScriptDataType::BUILTIN) {
+					// Constructing a packed array copies it, jobs get the caller's arrays so they can write to them.
+					if (argument_types[i].kind == GDScriptDataType::BUILTIN && (!job_context || p_args[i]->get_type() != argument_types[i].builtin_type)) {
 						Variant arg = Variant::construct(argument_types[i].builtin_type, &p_args[i], 1, r_err);
 						memnew_placement(&stack[i], Variant(arg));
 					} else {
@@ -367,6 +645,17 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 
 	String err_text;
 
+	bool sampled = false;
+	if (unlikely(SamplingProfiler::is_active())) {
+		uint32_t symbol = _sampling_symbol.load(std::memory_order_acquire);
+		if (!symbol) {
+			// Threads racing here register a symbol each, only the first one is kept.
+			uint32_t registered = SamplingProfiler::register_script_symbol(String(source) + ":" + String(name));
+			symbol = _sampling_symbol.compare_exchange_strong(symbol, registered, std::memory_order_acq_rel) ? registered : symbol;
+		}
+		sampled = SamplingProfiler::push_frame(SamplingProfiler::FRAME_SCRIPT, SamplingProfiler::get_script_symbol(symbol));
+	}
+
 #ifdef DEBUG_ENABLED
 
 	if (EngineDebugger::is_active()) {
@@ -425,7 +714,6 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			OPCODE(OPCODE_OPERATOR) {
 				CHECK_SPACE(5);
 
-				bool valid;
 				Variant::Operator op = (Variant::Operator)_code_ptr[ip + 1];
 				GD_ERR_BREAK(op >= Variant::OP_MAX);
 
@@ -433,30 +721,46 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				GET_VARIANT_PTR(b, 3);
 				GET_VARIANT_PTR(dst, 4);
 
-#ifdef DEBUG_ENABLED
+				if (unlikely(job_context) && !job_context->check_operator(op, a, b, err_text)) {
+					OPCODE_BREAK;
+				}
 
-				Variant ret;
-				Variant::evaluate(op, *a, *b, ret, valid);
-#else
-				Variant::evaluate(op, *a, *b, *dst, valid);
-#endif
-#ifdef DEBUG_ENABLED
-				if (!valid) {
-					if (ret.get_type() == Variant::STRING) {
-						//return a string when invalid with the error
-						err_text = ret;
-						err_text += " in operator '" + Variant::get_operator_name(op) + "'.";
-					} else {
-						err_text = "Invalid operands '" + Variant::get_type_name(a->get_type()) + "' and '" + Variant::get_type_name(b->get_type()) + "' in operator '" + Variant::get_operator_name(op) + "'.";
-					}
+				if (!_evaluate_operator(op, a, b, dst, err_text)) {
 					OPCODE_BREAK;
 				}
-				*dst = ret;
-#endif
 				ip += 5;
 			}
 			DISPATCH_OPCODE;
 
+			OPCODE(OPCODE_OPERATOR_VALIDATED) {
+				CHECK_SPACE(6);
+
+				int evaluator = _code_ptr[ip + 1];
+				GD_ERR_BREAK(evaluator < 0 || evaluator >= _validated_operator_count);
+
+				GET_VARIANT_PTR(a, 3);
+				GET_VARIANT_PTR(b, 4);
+				GET_VARIANT_PTR(dst, 5);
+
+				if (unlikely(job_context) && !job_context->check_operator((Variant::Operator)_code_ptr[ip + 2], a, b, err_text)) {
+					OPCODE_BREAK;
+				}
+
+				const ValidatedOperator &vop = _validated_operators_ptr[evaluator];
+				if (likely(a->get_type() == vop.type_a && b->get_type() == vop.type_b)) {
+					vop.evaluator(a, b, dst);
+				} else {
+					Variant::Operator op = (Variant::Operator)_code_ptr[ip + 2];
+					GD_ERR_BREAK(op >= Variant::OP_MAX);
+
+					if (!_evaluate_operator(op, a, b, dst, err_text)) {
+						OPCODE_BREAK;
+					}
+				}
+				ip += 6;
+			}
+			DISPATCH_OPCODE;
+
 			OPCODE(OPCODE_EXTENDS_TEST) {
 				CHECK_SPACE(4);
 
@@ -553,25 +857,44 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				GET_VARIANT_PTR(index, 2);
 				GET_VARIANT_PTR(value, 3);
 
-				bool valid;
-				dst->set(*index, *value, &valid);
+				if (unlikely(job_context) && !job_context->check_set(dst, _is_local_address(_code_ptr[ip + 1]), value, err_text)) {
+					OPCODE_BREAK;
+				}
 
-#ifdef DEBUG_ENABLED
-				if (!valid) {
-					String v = index->operator String();
-					if (v != "") {
-						v = "'" + v + "'";
-					} else {
-						v = "of type '" + _get_var_type(index) + "'";
-					}
-					err_text = "Invalid set index " + v + " (on base: '" + _get_var_type(dst) + "') with value of type '" + _get_var_type(value) + "'";
+				if (!_set_indexed(dst, index, value, err_text)) {
 					OPCODE_BREAK;
 				}
-#endif
 				ip += 4;
 			}
 			DISPATCH_OPCODE;
 
+			OPCODE(OPCODE_SET_INDEXED_VALIDATED) {
+				CHECK_SPACE(5);
+
+				int setter = _code_ptr[ip + 1];
+				GD_ERR_BREAK(setter < 0 || setter >= _validated_indexed_access_count);
+
+				GET_VARIANT_PTR(dst, 2);
+				GET_VARIANT_PTR(index, 3);
+				GET_VARIANT_PTR(value, 4);
+
+				if (unlikely(job_context) && !job_context->check_set(dst, _is_local_address(_code_ptr[ip + 2]), value, err_text)) {
+					OPCODE_BREAK;
+				}
+
+				const ValidatedIndexedAccess &via = _validated_indexed_accesses_ptr[setter];
+				bool oob = true;
+				if (likely(dst->get_type() == via.base_type && index->get_type() == Variant::INT && value->get_type() == via.value_type)) {
+					via.setter(dst, _VariantOp::get<int64_t>(index), value, &oob);
+				}
+				// Out of bounds accesses also go through the generic path, for its error.
+				if (unlikely(oob) && !_set_indexed(dst, index, value, err_text)) {
+					OPCODE_BREAK;
+				}
+				ip += 5;
+			}
+			DISPATCH_OPCODE;
+
 			OPCODE(OPCODE_GET) {
 				CHECK_SPACE(3);
 
@@ -579,31 +902,36 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				GET_VARIANT_PTR(index, 2);
 				GET_VARIANT_PTR(dst, 3);
 
-				bool valid;
-#ifdef DEBUG_ENABLED
-				//allow better error message in cases where src and dst are the same stack position
-				Variant ret = src->get(*index, &valid);
-#else
-				*dst = src->get(*index, &valid);
-
-#endif
-#ifdef DEBUG_ENABLED
-				if (!valid) {
-					String v = index->operator String();
-					if (v != "") {
-						v = "'" + v + "'";
-					} else {
-						v = "of type '" + _get_var_type(index) + "'";
-					}
-					err_text = "Invalid get index " + v + " (on base: '" + _get_var_type(src) + "').";
+				if (!_get_indexed(src, index, dst, err_text)) {
 					OPCODE_BREAK;
 				}
-				*dst = ret;
-#endif
 				ip += 4;
 			}
 			DISPATCH_OPCODE;
 
+			OPCODE(OPCODE_GET_INDEXED_VALIDATED) {
+				CHECK_SPACE(5);
+
+				int getter = _code_ptr[ip + 1];
+				GD_ERR_BREAK(getter < 0 || getter >= _validated_indexed_access_count);
+
+				GET_VARIANT_PTR(src, 2);
+				GET_VARIANT_PTR(index, 3);
+				GET_VARIANT_PTR(dst, 4);
+
+				const ValidatedIndexedAccess &via = _validated_indexed_accesses_ptr[getter];
+				bool oob = true;
+				if (likely(src->get_type() == via.base_type && index->get_type() == Variant::INT)) {
+					via.getter(src, _VariantOp::get<int64_t>(index), dst, &oob);
+				}
+				// Out of bounds accesses also go through the generic path, for its error.
+				if (unlikely(oob) && !_get_indexed(src, index, dst, err_text)) {
+					OPCODE_BREAK;
+				}
+				ip += 5;
+			}
+			DISPATCH_OPCODE;
+
 			OPCODE(OPCODE_SET_NAMED) {
 				CHECK_SPACE(3);
 
@@ -615,51 +943,81 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				GD_ERR_BREAK(indexname < 0 || indexname >= _global_names_count);
 				const StringName *index = &_global_names_ptr[indexname];
 
-				bool valid;
-				dst->set_named(*index, *value, &valid);
+				if (unlikely(job_context) && !job_context->check_set(dst, _is_local_address(_code_ptr[ip + 1]), value, err_text)) {
+					OPCODE_BREAK;
+				}
 
-#ifdef DEBUG_ENABLED
-				if (!valid) {
-					String err_type;
-					err_text = "Invalid set index '" + String(*index) + "' (on base: '" + _get_var_type(dst) + "') with value of type '" + _get_var_type(value) + "'.";
+				if (!_set_named(dst, *index, value, err_text)) {
 					OPCODE_BREAK;
 				}
-#endif
 				ip += 4;
 			}
 			DISPATCH_OPCODE;
 
+			OPCODE(OPCODE_SET_NAMED_VALIDATED) {
+				CHECK_SPACE(5);
+
+				int setter = _code_ptr[ip + 1];
+				GD_ERR_BREAK(setter < 0 || setter >= GDScriptValidatedOps::member_count);
+
+				GET_VARIANT_PTR(dst, 2);
+				GET_VARIANT_PTR(value, 4);
+
+				if (unlikely(job_context) && !job_context->check_set(dst, _is_local_address(_code_ptr[ip + 2]), value, err_text)) {
+					OPCODE_BREAK;
+				}
+
+				if (!GDScriptValidatedOps::members[setter].setter(*dst, *value)) {
+					int indexname = _code_ptr[ip + 3];
+					GD_ERR_BREAK(indexname < 0 || indexname >= _global_names_count);
+
+					if (!_set_named(dst, _global_names_ptr[indexname], value, err_text)) {
+						OPCODE_BREAK;
+					}
+				}
+				ip += 5;
+			}
+			DISPATCH_OPCODE;
+
 			OPCODE(OPCODE_GET_NAMED) {
-				CHECK_SPACE(4);
+				CHECK_SPACE(5);
 
 				GET_VARIANT_PTR(src, 1);
-				GET_VARIANT_PTR(dst, 3);
+				GET_VARIANT_PTR(dst, 4);
 
 				int indexname = _code_ptr[ip + 2];
 
 				GD_ERR_BREAK(indexname < 0 || indexname >= _global_names_count);
 				const StringName *index = &_global_names_ptr[indexname];
 
-				bool valid;
-#ifdef DEBUG_ENABLED
-				//allow better error message in cases where src and dst are the same stack position
-				Variant ret = src->get_named(*index, &valid);
+				int cache = _code_ptr[ip + 3];
+				GD_ERR_BREAK(cache >= _inline_cache_count);
 
-#else
-				*dst = src->get_named(*index, &valid);
-#endif
-#ifdef DEBUG_ENABLED
-				if (!valid) {
-					if (src->has_method(*index)) {
-						err_text = "Invalid get index '" + index->operator String() + "' (on base: '" + _get_var_type(src) + "'). Did you mean '." + index->operator String() + "()' or funcref(obj, \"" + index->operator String() + "\") ?";
-					} else {
-						err_text = "Invalid get index '" + index->operator String() + "' (on base: '" + _get_var_type(src) + "').";
-					}
+				if (!_inline_cache_get(cache, src, *index, dst) && !_get_named(src, *index, dst, err_text)) {
 					OPCODE_BREAK;
 				}
-				*dst = ret;
-#endif
-				ip += 4;
+				ip += 5;
+			}
+			DISPATCH_OPCODE;
+
+			OPCODE(OPCODE_GET_NAMED_VALIDATED) {
+				CHECK_SPACE(5);
+
+				int getter = _code_ptr[ip + 1];
+				GD_ERR_BREAK(getter < 0 || getter >= GDScriptValidatedOps::member_count);
+
+				GET_VARIANT_PTR(src, 2);
+				GET_VARIANT_PTR(dst, 4);
+
+				if (!GDScriptValidatedOps::members[getter].getter(*src, *dst)) {
+					int indexname = _code_ptr[ip + 3];
+					GD_ERR_BREAK(indexname < 0 || indexname >= _global_names_count);
+
+					if (!_get_named(src, _global_names_ptr[indexname], dst, err_text)) {
+						OPCODE_BREAK;
+					}
+				}
+				ip += 5;
 			}
 			DISPATCH_OPCODE;
 
@@ -750,6 +1108,9 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 #ifdef DEBUG_ENABLED
 					if (Variant::can_convert_strict(src->get_type(), var_type)) {
 #endif // DEBUG_ENABLED
+						if (unlikely(job_context) && !job_context->check_construct(const_cast<const Variant **>(&src), 1, err_text)) {
+							OPCODE_BREAK;
+						}
 						Callable::CallError ce;
 						*dst = Variant::construct(var_type, const_cast<const Variant **>(&src), 1, ce);
 					} else {
@@ -852,6 +1213,10 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 
 				GD_ERR_BREAK(to_type < 0 || to_type >= Variant::VARIANT_MAX);
 
+				if (unlikely(job_context) && !job_context->check_construct((const Variant **)&src, 1, err_text)) {
+					OPCODE_BREAK;
+				}
+
 				Callable::CallError err;
 				*dst = Variant::construct(to_type, (const Variant **)&src, 1, err);
 
@@ -950,6 +1315,11 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				}
 
 				GET_VARIANT_PTR(dst, 3 + argc);
+
+				if (unlikely(job_context) && !job_context->check_construct((const Variant **)argptrs, argc, err_text)) {
+					OPCODE_BREAK;
+				}
+
 				Callable::CallError err;
 				*dst = Variant::construct(t, (const Variant **)argptrs, argc, err);
 
@@ -974,6 +1344,9 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 
 				for (int i = 0; i < argc; i++) {
 					GET_VARIANT_PTR(v, 2 + i);
+					if (unlikely(job_context) && !job_context->check_construct((const Variant **)&v, 1, err_text)) {
+						OPCODE_BREAK;
+					}
 					array[i] = *v;
 				}
 
@@ -995,6 +1368,9 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				for (int i = 0; i < argc; i++) {
 					GET_VARIANT_PTR(k, 2 + i * 2 + 0);
 					GET_VARIANT_PTR(v, 2 + i * 2 + 1);
+					if (unlikely(job_context) && (!job_context->check_construct((const Variant **)&k, 1, err_text) || !job_context->check_construct((const Variant **)&v, 1, err_text))) {
+						OPCODE_BREAK;
+					}
 					dict[*k] = *v;
 				}
 
@@ -1008,18 +1384,21 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 
 			OPCODE(OPCODE_CALL_RETURN)
 			OPCODE(OPCODE_CALL) {
-				CHECK_SPACE(4);
+				CHECK_SPACE(5);
 				bool call_ret = _code_ptr[ip] == OPCODE_CALL_RETURN;
 
 				int argc = _code_ptr[ip + 1];
-				GET_VARIANT_PTR(base, 2);
-				int nameg = _code_ptr[ip + 3];
+				int cache = _code_ptr[ip + 2];
+				GD_ERR_BREAK(cache >= _inline_cache_count);
+				GET_VARIANT_PTR(base, 3);
+				bool base_local = _is_local_address(_code_ptr[ip + 3]);
+				int nameg = _code_ptr[ip + 4];
 
 				GD_ERR_BREAK(nameg < 0 || nameg >= _global_names_count);
 				const StringName *methodname = &_global_names_ptr[nameg];
 
 				GD_ERR_BREAK(argc < 0);
-				ip += 4;
+				ip += 5;
 				CHECK_SPACE(argc + 1);
 				Variant **argptrs = call_args;
 
@@ -1036,12 +1415,18 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				}
 
 #endif
+				if (unlikely(job_context) && !job_context->check_call(base, base_local, *methodname, (const Variant **)argptrs, argc, err_text)) {
+					OPCODE_BREAK;
+				}
+
 				Callable::CallError err;
+				Variant *ret_ptr = nullptr;
 				if (call_ret) {
 					GET_VARIANT_PTR(ret, argc);
-					base->call_ptr(*methodname, (const Variant **)argptrs, argc, ret, err);
-				} else {
-					base->call_ptr(*methodname, (const Variant **)argptrs, argc, nullptr, err);
+					ret_ptr = ret;
+				}
+				if (!_inline_cache_call(cache, base, *methodname, (const Variant **)argptrs, argc, ret_ptr, err)) {
+					base->call_ptr(*methodname, (const Variant **)argptrs, argc, ret_ptr, err);
 				}
 #ifdef DEBUG_ENABLED
 				if (GDScriptLanguage::get_singleton()->profiling) {
@@ -1080,6 +1465,52 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 			}
 			DISPATCH_OPCODE;
 
+			OPCODE(OPCODE_CALL_BUILTIN_TYPE_VALIDATED) {
+				CHECK_SPACE(5);
+
+				int argc = _code_ptr[ip + 1];
+				int method = _code_ptr[ip + 2];
+				GD_ERR_BREAK(method < 0 || method >= _validated_builtin_method_count);
+				GET_VARIANT_PTR(base, 3);
+				bool base_local = _is_local_address(_code_ptr[ip + 3]);
+				int nameg = _code_ptr[ip + 4];
+				GD_ERR_BREAK(nameg < 0 || nameg >= _global_names_count);
+
+				GD_ERR_BREAK(argc < 0);
+				ip += 5;
+				CHECK_SPACE(argc + 1);
+				Variant **argptrs = call_args;
+
+				const ValidatedBuiltInMethodCall &vbm = _validated_builtin_methods_ptr[method];
+				bool valid = base->get_type() == vbm.base_type && argc == vbm.argument_count;
+				for (int i = 0; i < argc; i++) {
+					GET_VARIANT_PTR(v, i);
+					argptrs[i] = v;
+					valid = valid && v->get_type() == vbm.argument_types[i];
+				}
+
+				GET_VARIANT_PTR(dst, argc);
+
+				if (unlikely(job_context) && !job_context->check_call(base, base_local, _global_names_ptr[nameg], (const Variant **)argptrs, argc, err_text)) {
+					OPCODE_BREAK;
+				}
+
+				if (likely(valid)) {
+					vbm.function(base, (const Variant **)argptrs, dst);
+				} else {
+					Callable::CallError err;
+					base->call_ptr(_global_names_ptr[nameg], (const Variant **)argptrs, argc, dst, err);
+#ifdef DEBUG_ENABLED
+					if (err.error != Callable::CallError::CALL_OK) {
+						err_text = _get_call_error(err, "function '" + String(_global_names_ptr[nameg]) + "' in base '" + _get_var_type(base) + "'", (const Variant **)argptrs);
+						OPCODE_BREAK;
+					}
+#endif
+				}
+				ip += argc + 1;
+			}
+			DISPATCH_OPCODE;
+
 			OPCODE(OPCODE_CALL_BUILT_IN) {
 				CHECK_SPACE(4);
 
@@ -1098,6 +1529,10 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 
 				GET_VARIANT_PTR(dst, argc);
 
+				if (unlikely(job_context) && !job_context->check_builtin_function(func, (const Variant **)argptrs, argc, err_text)) {
+					OPCODE_BREAK;
+				}
+
 				Callable::CallError err;
 
 				GDScriptFunctions::call(func, (const Variant **)argptrs, argc, *dst, err);
@@ -1168,6 +1603,7 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 						if (!mb) {
 							err.error = Callable::CallError::CALL_ERROR_INVALID_METHOD;
 						} else {
+							SamplingProfiler::Scope sampling_scope(SamplingProfiler::FRAME_NATIVE, mb);
 							*dst = mb->call(p_instance->owner, (const Variant **)argptrs, argc, err);
 						}
 					} else {
@@ -1194,6 +1630,10 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 
 			OPCODE(OPCODE_YIELD)
 			OPCODE(OPCODE_YIELD_SIGNAL) {
+				if (unlikely(job_context) && !job_context->check_yield(err_text)) {
+					OPCODE_BREAK;
+				}
+
 				int ipofs = 1;
 				if (_code_ptr[ip] == OPCODE_YIELD_SIGNAL) {
 					CHECK_SPACE(4);
@@ -1205,11 +1645,20 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				Ref<GDScriptFunctionState> gdfs = memnew(GDScriptFunctionState);
 				gdfs->function = this;
 
-				gdfs->state.stack.resize(alloca_size);
-				//copy variant stack
-				for (int i = 0; i < _stack_size; i++) {
-					memnew_placement(&gdfs->state.stack.write[sizeof(Variant) * i], Variant(stack[i]));
+				if (p_state && p_state->stack) {
+					// Yielding again after a resume, the frame simply changes owner.
+					gdfs->state.stack = p_state->stack;
+					p_state->stack = nullptr;
+					p_state->stack_size = 0;
+				} else if (alloca_size) {
+					// Variants are relocatable, so the stack is moved bitwise instead of
+					// copy constructed; the alloca'd originals are never destroyed.
+					gdfs->state.stack = GDScriptFunctionState::_alloc_frame(alloca_size);
+					copymem(gdfs->state.stack, stack, sizeof(Variant) * _stack_size);
 				}
+				stack = (Variant *)gdfs->state.stack;
+				stack_moved = true;
+
 				gdfs->state.stack_size = _stack_size;
 				gdfs->state.self = self;
 				gdfs->state.alloca_size = alloca_size;
@@ -1369,6 +1818,10 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				GET_VARIANT_PTR(counter, 1);
 				GET_VARIANT_PTR(container, 2);
 
+				if (unlikely(job_context) && !job_context->check_iterate(container, err_text)) {
+					OPCODE_BREAK;
+				}
+
 				bool valid;
 				if (!container->iter_init(*counter, valid)) {
 #ifdef DEBUG_ENABLED
@@ -1383,7 +1836,15 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				} else {
 					GET_VARIANT_PTR(iterator, 4);
 
-					*iterator = container->iter_get(*counter, valid);
+					Variant::ValidatedIndexedGetter getter = Variant::get_validated_indexed_getter(container->get_type());
+					if (getter && counter->get_type() == Variant::INT) {
+						// Packed arrays, write the element straight into the iterator.
+						bool oob;
+						getter(container, _VariantOp::get<int64_t>(counter), iterator, &oob);
+						valid = !oob;
+					} else {
+						*iterator = container->iter_get(*counter, valid);
+					}
 #ifdef DEBUG_ENABLED
 					if (!valid) {
 						err_text = "Unable to obtain iterator object of type '" + Variant::get_type_name(container->get_type()) + "'.";
@@ -1401,6 +1862,30 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 				GET_VARIANT_PTR(counter, 1);
 				GET_VARIANT_PTR(container, 2);
 
+				Variant::ValidatedIndexedGetter getter = Variant::get_validated_indexed_getter(container->get_type());
+				if (getter && counter->get_type() == Variant::INT) {
+					// Packed arrays, same as iter_next() and iter_get() but without boxing each
+					// element into a temporary Variant.
+					GET_VARIANT_PTR(iterator, 4);
+
+					int64_t &index = _VariantOp::get_mut<int64_t>(counter);
+					bool oob;
+					getter(container, index + 1, iterator, &oob);
+					if (oob) {
+						int jumpto = _code_ptr[ip + 3];
+						GD_ERR_BREAK(jumpto < 0 || jumpto > _code_size);
+						ip = jumpto;
+					} else {
+						index++;
+						ip += 5; //loop again
+					}
+					DISPATCH_OPCODE;
+				}
+
+				if (unlikely(job_context) && !job_context->check_iterate(container, err_text)) {
+					OPCODE_BREAK;
+				}
+
 				bool valid;
 				if (!container->iter_next(*counter, valid)) {
 #ifdef DEBUG_ENABLED
@@ -1515,6 +2000,9 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 		if (exit_ok) {
 			OPCODE_OUT;
 		}
+		if (job_context) {
+			job_context->failed = true;
+		}
 		//error
 		// function, file, line, error, explanation
 		String err_file;
@@ -1564,18 +2052,20 @@ Variant GDScriptFunction::call(GDScriptInstance *p_instance, const Variant **p_a
 		if (EngineDebugger::is_active()) {
 			GDScriptLanguage::get_singleton()->exit_function();
 		}
+	}
 #endif
 
-		if (_stack_size) {
-			//free stack
-			for (int i = 0; i < _stack_size; i++) {
-				stack[i].~Variant();
-			}
-		}
+	if (sampled) {
+		SamplingProfiler::pop_frame();
+	}
 
-#ifdef DEBUG_ENABLED
+	// A resumed stack belongs to its state, which releases it once resume() is done.
+	if (_stack_size && !stack_moved && !p_state) {
+		//free stack
+		for (int i = 0; i < _stack_size; i++) {
+			stack[i].~Variant();
+		}
 	}
-#endif
 
 	return retvalue;
 }
@@ -1691,7 +2181,16 @@ GDScriptFunction::GDScriptFunction() :
 		function_list(this) {
 	_stack_size = 0;
 	_call_size = 0;
+	_inline_caches_ptr = nullptr;
+	_inline_cache_count = 0;
+	_validated_operators_ptr = nullptr;
+	_validated_operator_count = 0;
+	_validated_builtin_methods_ptr = nullptr;
+	_validated_builtin_method_count = 0;
+	_validated_indexed_accesses_ptr = nullptr;
+	_validated_indexed_access_count = 0;
 	rpc_mode = MultiplayerAPI::RPC_MODE_DISABLED;
+	_sampling_symbol = 0;
 	name = "<anonymous>";
 #ifdef DEBUG_ENABLED
 	_func_cname = nullptr;
@@ -1836,17 +2335,104 @@ Variant GDScriptFunctionState::resume(const Variant &p_arg) {
 #endif
 	}
 
+	// Hand the frame back to the pool now instead of when the last reference goes away.
+	_clear_stack();
+
 	return ret;
 }
 
 void GDScriptFunctionState::_clear_stack() {
 	if (state.stack_size) {
-		Variant *stack = (Variant *)state.stack.ptr();
+		Variant *stack = (Variant *)state.stack;
 		for (int i = 0; i < state.stack_size; i++) {
 			stack[i].~Variant();
 		}
 		state.stack_size = 0;
 	}
+	if (state.stack) {
+		_free_frame(state.stack, state.alloca_size);
+		state.stack = nullptr;
+	}
+}
+
+// Frame pool. Sizes are rounded up to a power of two; each class keeps an
+// intrusive free list fed from slabs that live until the language is finished.
+
+#define FRAME_POOL_MIN_SHIFT 6
+#define FRAME_POOL_MAX_SHIFT 16
+#define FRAME_POOL_SLAB_SIZE (64 * 1024)
+
+struct GDScriptFramePool {
+	SpinLock spin_lock;
+	uint8_t *free_list[FRAME_POOL_MAX_SHIFT - FRAME_POOL_MIN_SHIFT + 1] = {};
+	Vector<uint8_t *> slabs;
+	uint32_t frames_in_use = 0;
+};
+
+static GDScriptFramePool frame_pool;
+
+static _FORCE_INLINE_ int _get_frame_class(uint32_t p_size) {
+	int shift = FRAME_POOL_MIN_SHIFT;
+	while ((1u << shift) < p_size) {
+		shift++;
+	}
+	return shift - FRAME_POOL_MIN_SHIFT;
+}
+
+uint8_t *GDScriptFunctionState::_alloc_frame(uint32_t p_size) {
+	if (p_size > (1u << FRAME_POOL_MAX_SHIFT)) {
+		return (uint8_t *)memalloc(p_size);
+	}
+
+	int frame_class = _get_frame_class(p_size);
+	uint32_t frame_size = 1u << (frame_class + FRAME_POOL_MIN_SHIFT);
+
+	frame_pool.spin_lock.lock();
+	if (!frame_pool.free_list[frame_class]) {
+		// Carve a new slab into frames of this class.
+		uint8_t *slab = (uint8_t *)memalloc(FRAME_POOL_SLAB_SIZE);
+		frame_pool.slabs.push_back(slab);
+		for (uint32_t ofs = 0; ofs < FRAME_POOL_SLAB_SIZE; ofs += frame_size) {
+			*(uint8_t **)&slab[ofs] = frame_pool.free_list[frame_class];
+			frame_pool.free_list[frame_class] = &slab[ofs];
+		}
+	}
+	uint8_t *frame = frame_pool.free_list[frame_class];
+	frame_pool.free_list[frame_class] = *(uint8_t **)frame;
+	frame_pool.frames_in_use++;
+	frame_pool.spin_lock.unlock();
+
+	return frame;
+}
+
+void GDScriptFunctionState::_free_frame(uint8_t *p_frame, uint32_t p_size) {
+	if (p_size > (1u << FRAME_POOL_MAX_SHIFT)) {
+		memfree(p_frame);
+		return;
+	}
+
+	int frame_class = _get_frame_class(p_size);
+
+	frame_pool.spin_lock.lock();
+	*(uint8_t **)p_frame = frame_pool.free_list[frame_class];
+	frame_pool.free_list[frame_class] = p_frame;
+	frame_pool.frames_in_use--;
+	frame_pool.spin_lock.unlock();
+}
+
+void GDScriptFunctionState::cleanup_frame_pool() {
+	frame_pool.spin_lock.lock();
+	// Suspended states may outlive the language; keep the slabs alive for them.
+	if (frame_pool.frames_in_use == 0) {
+		for (int i = 0; i < frame_pool.slabs.size(); i++) {
+			memfree(frame_pool.slabs[i]);
+		}
+		frame_pool.slabs.clear();
+		for (int i = 0; i <= FRAME_POOL_MAX_SHIFT - FRAME_POOL_MIN_SHIFT; i++) {
+			frame_pool.free_list[i] = nullptr;
+		}
+	}
+	frame_pool.spin_lock.unlock();
 }
 
 void GDScriptFunctionState::_bind_methods() {
@@ -39,8 +39,11 @@
 #include "core/string_name.h"
 #include "core/variant.h"
 
+#include <atomic>
+
 class GDScriptInstance;
 class GDScript;
+class MethodBind;
 
 struct GDScriptDataType {
 	enum Kind {
@@ -158,12 +161,17 @@ class GDScriptFunction {
 public:
 	enum Opcode {
 		OPCODE_OPERATOR,
+		OPCODE_OPERATOR_VALIDATED,
 		OPCODE_EXTENDS_TEST,
 		OPCODE_IS_BUILTIN,
 		OPCODE_SET,
+		OPCODE_SET_INDEXED_VALIDATED,
 		OPCODE_GET,
+		OPCODE_GET_INDEXED_VALIDATED,
 		OPCODE_SET_NAMED,
+		OPCODE_SET_NAMED_VALIDATED,
 		OPCODE_GET_NAMED,
+		OPCODE_GET_NAMED_VALIDATED,
 		OPCODE_SET_MEMBER,
 		OPCODE_GET_MEMBER,
 		OPCODE_ASSIGN,
@@ -180,6 +188,7 @@ public:
 		OPCODE_CONSTRUCT_DICTIONARY,
 		OPCODE_CALL,
 		OPCODE_CALL_RETURN,
+		OPCODE_CALL_BUILTIN_TYPE_VALIDATED,
 		OPCODE_CALL_BUILT_IN,
 		OPCODE_CALL_SELF,
 		OPCODE_CALL_SELF_BASE,
@@ -224,6 +233,9 @@ public:
 
 private:
 	friend class GDScriptCompiler;
+	friend class GDScriptCacheReader;
+	friend class GDScriptCacheWriter;
+	friend class GDScriptJobs;
 
 	StringName source;
 
@@ -246,6 +258,7 @@ private:
 	int _initial_line;
 	bool _static;
 	MultiplayerAPI::RPCMode rpc_mode;
+	std::atomic<uint32_t> _sampling_symbol; // Registered on first sampled call, from any thread.
 
 	GDScript *_script;
 
@@ -266,6 +279,76 @@ private:
 
 	List<StackDebug> stack_debug;
 
+	// Per call site cache of resolved methods and members, keyed on the script
+	// and native class of the receiver. Only used from the main thread.
+	struct InlineCache {
+		enum {
+			ENTRY_COUNT = 2
+		};
+
+		struct Entry {
+			uint32_t version = 0;
+			const GDScript *script = nullptr;
+			StringName class_name;
+			GDScriptFunction *function = nullptr;
+			MethodBind *method = nullptr;
+			int member_index = -1;
+			bool generic = false; // Not resolvable here, use the generic path.
+		};
+
+		Entry entries[ENTRY_COUNT];
+	};
+
+	static uint32_t inline_cache_version;
+
+	InlineCache *_inline_caches_ptr;
+	int _inline_cache_count;
+	Vector<InlineCache> inline_caches;
+
+	// Operators resolved by the compiler for statically typed operands. The VM
+	// still compares the actual operand types before calling the evaluator.
+	struct ValidatedOperator {
+		Variant::Operator op = Variant::OP_MAX;
+		Variant::Type type_a = Variant::NIL;
+		Variant::Type type_b = Variant::NIL;
+		Variant::ValidatedOperatorEvaluator evaluator = nullptr;
+	};
+
+	const ValidatedOperator *_validated_operators_ptr;
+	int _validated_operator_count;
+	Vector<ValidatedOperator> validated_operators;
+
+	// Builtin type methods resolved by the compiler for a statically typed base
+	// and arguments, checked the same way as operators.
+	struct ValidatedBuiltInMethodCall {
+		Variant::Type base_type = Variant::NIL;
+		StringName method;
+		int argument_count = 0;
+		Variant::Type argument_types[VARIANT_ARG_MAX];
+		Variant::ValidatedBuiltInMethod function = nullptr;
+	};
+
+	const ValidatedBuiltInMethodCall *_validated_builtin_methods_ptr;
+	int _validated_builtin_method_count;
+	Vector<ValidatedBuiltInMethodCall> validated_builtin_methods;
+
+	// Packed array element accesses resolved by the compiler for a statically
+	// typed base and integer index. Reads have a NIL value type and no setter.
+	struct ValidatedIndexedAccess {
+		Variant::Type base_type = Variant::NIL;
+		Variant::Type value_type = Variant::NIL;
+		Variant::ValidatedIndexedGetter getter = nullptr;
+		Variant::ValidatedIndexedSetter setter = nullptr;
+	};
+
+	const ValidatedIndexedAccess *_validated_indexed_accesses_ptr;
+	int _validated_indexed_access_count;
+	Vector<ValidatedIndexedAccess> validated_indexed_accesses;
+
+	const InlineCache::Entry *_inline_cache_find(int p_cache, Object *p_object, GDScriptInstance *&r_instance, const StringName &p_name, bool p_member);
+	bool _inline_cache_call(int p_cache, Variant *p_base, const StringName &p_method, const Variant **p_args, int p_argcount, Variant *r_ret, Callable::CallError &r_err);
+	bool _inline_cache_get(int p_cache, const Variant *p_base, const StringName &p_name, Variant *r_dst);
+
 	_FORCE_INLINE_ Variant *_get_variant(int p_address, GDScriptInstance *p_instance, GDScript *p_script, Variant &self, Variant &static_ref, Variant *p_stack, String &r_error) const;
 	_FORCE_INLINE_ String _get_call_error(const Callable::CallError &p_err, const String &p_where, const Variant **argptrs) const;
 
@@ -299,10 +382,10 @@ public:
 		StringName function_name;
 		String script_path;
 #endif
-		Vector<uint8_t> stack;
-		int stack_size;
+		uint8_t *stack = nullptr; // Pooled frame, owned by the state (see GDScriptFunctionState::_alloc_frame()).
+		int stack_size = 0;
 		Variant self;
-		uint32_t alloca_size;
+		uint32_t alloca_size = 0;
 		int ip;
 		int line;
 		int defarg;
@@ -345,6 +428,10 @@ public:
 	Variant call(GDScriptInstance *p_instance, const Variant **p_args, int p_argcount, Callable::CallError &r_err, CallState *p_state = nullptr);
 
 	_FORCE_INLINE_ MultiplayerAPI::RPCMode get_rpc_mode() const { return rpc_mode; }
+
+	// Must be called whenever script functions or member layouts may have changed.
+	static void invalidate_inline_caches();
+
 	GDScriptFunction();
 	~GDScriptFunction();
 };
@@ -360,6 +447,11 @@ class GDScriptFunctionState : public Reference {
 	SelfList<GDScriptFunctionState> scripts_list;
 	SelfList<GDScriptFunctionState> instances_list;
 
+	// Suspended frames are recycled through size-classed free lists carved out of
+	// larger slabs, so yielding doesn't hit the general purpose allocator.
+	static uint8_t *_alloc_frame(uint32_t p_size);
+	static void _free_frame(uint8_t *p_frame, uint32_t p_size);
+
 protected:
 	static void _bind_methods();
 
@@ -369,6 +461,8 @@ public:
 
 	void _clear_stack();
 
+	static void cleanup_frame_pool();
+
 	GDScriptFunctionState();
 	~GDScriptFunctionState();
 };
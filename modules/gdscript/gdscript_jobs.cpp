@@ -0,0 +1,561 @@
+/*************************************************************************/
+/*  gdscript_jobs.cpp                                                    */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "gdscript_jobs.h"
+
+#include "core/core_string_names.h"
+#include "core/engine.h"
+#include "core/os/os.h"
+#include "core/os/thread.h"
+#include "core/project_settings.h"
+#include "core/variant_internal.h"
+#include "gdscript.h"
+#include "gdscript_functions.h"
+
+GDScriptJobs *GDScriptJobs::singleton = nullptr;
+thread_local GDScriptJobs::Context *GDScriptJobs::current_context = nullptr;
+
+static GDScriptFunction *_find_static_function(const GDScript *p_script, const StringName &p_name) {
+	while (p_script) {
+		const Map<StringName, GDScriptFunction *>::Element *E = p_script->get_member_functions().find(p_name);
+		if (E) {
+			return E->get()->is_static() ? E->get() : nullptr;
+		}
+		Ref<GDScript> base = p_script->get_base_script();
+		p_script = base.ptr();
+	}
+	return nullptr;
+}
+
+// Copy the array now if its buffer is shared, so writes from jobs never have to
+// (which could happen on several threads at once). Returns false for other types.
+static bool _make_array_unique(Variant *p_array) {
+	switch (p_array->get_type()) {
+		case Variant::PACKED_BYTE_ARRAY: {
+			_VariantOp::get_packed_array_mut<uint8_t>(p_array).ptrw();
+		} break;
+		case Variant::PACKED_INT32_ARRAY: {
+			_VariantOp::get_packed_array_mut<int32_t>(p_array).ptrw();
+		} break;
+		case Variant::PACKED_INT64_ARRAY: {
+			_VariantOp::get_packed_array_mut<int64_t>(p_array).ptrw();
+		} break;
+		case Variant::PACKED_FLOAT32_ARRAY: {
+			_VariantOp::get_packed_array_mut<float>(p_array).ptrw();
+		} break;
+		case Variant::PACKED_FLOAT64_ARRAY: {
+			_VariantOp::get_packed_array_mut<double>(p_array).ptrw();
+		} break;
+		case Variant::PACKED_STRING_ARRAY: {
+			_VariantOp::get_packed_array_mut<String>(p_array).ptrw();
+		} break;
+		case Variant::PACKED_VECTOR2_ARRAY: {
+			_VariantOp::get_packed_array_mut<Vector2>(p_array).ptrw();
+		} break;
+		case Variant::PACKED_VECTOR3_ARRAY: {
+			_VariantOp::get_packed_array_mut<Vector3>(p_array).ptrw();
+		} break;
+		case Variant::PACKED_COLOR_ARRAY: {
+			_VariantOp::get_packed_array_mut<Color>(p_array).ptrw();
+		} break;
+		default: {
+			return false;
+		}
+	}
+	return true;
+}
+
+static bool _is_packed_array(Variant::Type p_type) {
+	return p_type >= Variant::PACKED_BYTE_ARRAY && p_type <= Variant::PACKED_COLOR_ARRAY;
+}
+
+bool GDScriptJobs::Context::_is_job_array(const Variant *p_value) const {
+	return _is_packed_array(p_value->get_type()) && arrays->find(_VariantOp::get_packed_array_id(p_value)) != -1;
+}
+
+bool GDScriptJobs::Context::_is_shared(const Variant *p_value) const {
+	switch (p_value->get_type()) {
+		case Variant::ARRAY: {
+			return shared->has(p_value->operator Array().id());
+		}
+		case Variant::DICTIONARY: {
+			return shared->has(p_value->operator Dictionary().id());
+		}
+		default: {
+			// The job's own arrays may also be constants, they are still its to write.
+			return _is_packed_array(p_value->get_type()) && shared->has(_VariantOp::get_packed_array_id(p_value)) && !_is_job_array(p_value);
+		}
+	}
+}
+
+// Objects other than class references, even inside containers, could run script
+// code (e.g. _to_string()) when passed to built-in functions.
+static bool _has_object(const Variant &p_value, int p_depth = 0) {
+	if (p_depth > 64) {
+		return true; // Probably contains itself, don't try further.
+	}
+	switch (p_value.get_type()) {
+		case Variant::OBJECT: {
+			Object *object = p_value.get_validated_object();
+			return object && !Object::cast_to<GDScript>(object) && !Object::cast_to<GDScriptNativeClass>(object);
+		}
+		case Variant::ARRAY: {
+			const Array array = p_value;
+			for (int i = 0; i < array.size(); i++) {
+				if (_has_object(array[i], p_depth + 1)) {
+					return true;
+				}
+			}
+			return false;
+		}
+		case Variant::DICTIONARY: {
+			const Dictionary dict = p_value;
+			const Variant *K = nullptr;
+			while ((K = dict.next(K))) {
+				if (_has_object(*K, p_depth + 1) || _has_object(dict[*K], p_depth + 1)) {
+					return true;
+				}
+			}
+			return false;
+		}
+		default: {
+			return false;
+		}
+	}
+}
+
+bool GDScriptJobs::Context::_check_copy(const Variant *p_value, String &r_err_text) {
+	if (!_is_job_array(p_value)) {
+		return true;
+	}
+	return _fail("Jobs can't copy, convert or store the arrays they were given, only index them, iterate them or pass them to static functions.", r_err_text);
+}
+
+bool GDScriptJobs::Context::_fail(const String &p_text, String &r_err_text) {
+	r_err_text = p_text;
+	failed = true;
+	return false;
+}
+
+bool GDScriptJobs::Context::check_call(const Variant *p_base, bool p_local, const StringName &p_method, const Variant **p_args, int p_argcount, String &r_err_text) {
+	Variant::Type type = p_base->get_type();
+	if (type == Variant::OBJECT) {
+		Object *object = p_base->get_validated_object();
+		if (!object) {
+			return true; // Fails like any call on a null instance.
+		}
+		const GDScript *script = Object::cast_to<GDScript>(object);
+		if (script && _find_static_function(script, p_method)) {
+			return true; // Arguments are passed by reference to the function, like any other.
+		}
+		if (servers->find(object) == -1) {
+			return _fail("Jobs can only call static functions and servers running on their own thread, not function '" + String(p_method) + "' in base '" + object->get_class() + "'.", r_err_text);
+		}
+
+		// Only void methods of the server itself are queued for its thread,
+		// anything returning a value would wait for it.
+		MethodBind *method = ClassDB::has_method(object->get_class_name(), p_method, true) ? ClassDB::get_method(object->get_class_name(), p_method) : nullptr;
+		if (!method || method->has_return()) {
+			return _fail("Jobs can only call server functions which don't return a value, not function '" + String(p_method) + "' in base '" + object->get_class() + "'.", r_err_text);
+		}
+	} else {
+		if (type == Variant::CALLABLE || type == Variant::SIGNAL) {
+			return _fail("Jobs can't call function '" + String(p_method) + "' on a '" + Variant::get_type_name(type) + "', which could reach any object.", r_err_text);
+		}
+
+		// insert() is bound as const on packed arrays, but resizes them.
+		if (!Variant::is_method_const(type, p_method) || p_method == "insert") {
+			if (_is_job_array(p_base)) {
+				return _fail("Jobs can't call function '" + String(p_method) + "' on the arrays they were given, only index them.", r_err_text);
+			}
+			if (!p_local || _is_shared(p_base)) {
+				return _fail("Jobs can't call function '" + String(p_method) + "' on a '" + Variant::get_type_name(type) + "' shared with other threads, only on local values (copy it with duplicate() first).", r_err_text);
+			}
+		}
+	}
+
+	for (int i = 0; i < p_argcount; i++) {
+		if (!_check_copy(p_args[i], r_err_text)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool GDScriptJobs::Context::check_get(const Variant *p_base, String &r_err_text) {
+	if (p_base->get_type() != Variant::OBJECT) {
+		return true;
+	}
+	Object *object = p_base->get_validated_object();
+	if (!object || Object::cast_to<GDScript>(object)) {
+		return true; // Script constants are fine.
+	}
+	return _fail("Jobs can't access properties of objects (on base: '" + object->get_class() + "').", r_err_text);
+}
+
+bool GDScriptJobs::Context::check_set(const Variant *p_base, bool p_local, const Variant *p_value, String &r_err_text) {
+	if (p_base->get_type() == Variant::OBJECT) {
+		Object *object = p_base->get_validated_object();
+		if (!object) {
+			return true;
+		}
+		return _fail("Jobs can't access properties of objects (on base: '" + object->get_class() + "').", r_err_text);
+	}
+
+	if (!_is_job_array(p_base) && (!p_local || _is_shared(p_base))) {
+		return _fail("Jobs can't modify a '" + Variant::get_type_name(p_base->get_type()) + "' shared with other threads, only local values (copy it with duplicate() first).", r_err_text);
+	}
+	return _check_copy(p_value, r_err_text);
+}
+
+bool GDScriptJobs::Context::check_construct(const Variant **p_args, int p_argcount, String &r_err_text) {
+	for (int i = 0; i < p_argcount; i++) {
+		if (!_check_copy(p_args[i], r_err_text)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool GDScriptJobs::Context::check_operator(Variant::Operator p_op, const Variant *p_a, const Variant *p_b, String &r_err_text) {
+	switch (p_op) {
+		case Variant::OP_EQUAL:
+		case Variant::OP_NOT_EQUAL:
+		case Variant::OP_LESS:
+		case Variant::OP_LESS_EQUAL:
+		case Variant::OP_GREATER:
+		case Variant::OP_GREATER_EQUAL:
+		case Variant::OP_AND:
+		case Variant::OP_OR:
+		case Variant::OP_XOR:
+		case Variant::OP_NOT: {
+			return true; // Compare or test the arrays in place.
+		}
+		default: {
+			return _check_copy(p_a, r_err_text) && _check_copy(p_b, r_err_text);
+		}
+	}
+}
+
+bool GDScriptJobs::Context::check_builtin_function(int p_function, const Variant **p_args, int p_argcount, String &r_err_text) {
+	switch (p_function) {
+		case GDScriptFunctions::OBJ_WEAKREF:
+		case GDScriptFunctions::FUNC_FUNCREF:
+		case GDScriptFunctions::RESOURCE_LOAD:
+		case GDScriptFunctions::INST2DICT:
+		case GDScriptFunctions::DICT2INST:
+		case GDScriptFunctions::PRINT_STACK:
+		case GDScriptFunctions::GET_STACK:
+		case GDScriptFunctions::INSTANCE_FROM_ID: {
+			return _fail("Jobs can't call built-in function '" + String(GDScriptFunctions::get_func_name(GDScriptFunctions::Function(p_function))) + "'.", r_err_text);
+		}
+		default: {
+		}
+	}
+
+	// Most built-in functions (even len()) take packed arrays by value.
+	for (int i = 0; i < p_argcount; i++) {
+		if (!_check_copy(p_args[i], r_err_text)) {
+			return false;
+		}
+		if (_has_object(*p_args[i])) {
+			return _fail("Jobs can't pass objects to built-in function '" + String(GDScriptFunctions::get_func_name(GDScriptFunctions::Function(p_function))) + "', only class references.", r_err_text);
+		}
+	}
+	return true;
+}
+
+bool GDScriptJobs::Context::check_iterate(const Variant *p_container, String &r_err_text) {
+	if (p_container->get_type() != Variant::OBJECT) {
+		return true;
+	}
+	// Iterating an object calls its _iter_*() methods.
+	return check_call(p_container, true, CoreStringNames::get_singleton()->_iter_init, nullptr, 0, r_err_text);
+}
+
+bool GDScriptJobs::Context::check_yield(String &r_err_text) {
+	return _fail("Jobs can't yield.", r_err_text);
+}
+
+void GDScriptJobs::_find_shared(const Variant &p_value, Set<const void *> &r_shared) {
+	switch (p_value.get_type()) {
+		case Variant::ARRAY: {
+			const Array array = p_value;
+			if (r_shared.has(array.id())) {
+				return;
+			}
+			r_shared.insert(array.id());
+			for (int i = 0; i < array.size(); i++) {
+				_find_shared(array[i], r_shared);
+			}
+		} break;
+		case Variant::DICTIONARY: {
+			const Dictionary dict = p_value;
+			if (r_shared.has(dict.id())) {
+				return;
+			}
+			r_shared.insert(dict.id());
+			const Variant *K = nullptr;
+			while ((K = dict.next(K))) {
+				_find_shared(*K, r_shared);
+				_find_shared(dict[*K], r_shared);
+			}
+		} break;
+		case Variant::OBJECT: {
+			// Constants of other scripts can be reached through this one.
+			_find_shared_in_script(Object::cast_to<GDScript>(p_value.get_validated_object()), r_shared);
+		} break;
+		default: {
+			if (_is_packed_array(p_value.get_type())) {
+				r_shared.insert(_VariantOp::get_packed_array_id(&p_value));
+			}
+		}
+	}
+}
+
+void GDScriptJobs::_find_shared_in_script(const GDScript *p_script, Set<const void *> &r_shared) {
+	if (!p_script || r_shared.has(p_script)) {
+		return;
+	}
+	r_shared.insert(p_script);
+
+	for (const Map<StringName, Variant>::Element *E = p_script->constants.front(); E; E = E->next()) {
+		_find_shared(E->get(), r_shared);
+	}
+	for (const Map<StringName, GDScriptFunction *>::Element *E = p_script->member_functions.front(); E; E = E->next()) {
+		for (int i = 0; i < E->get()->constants.size(); i++) {
+			_find_shared(E->get()->constants[i], r_shared);
+		}
+	}
+	for (const Map<StringName, Ref<GDScript>>::Element *E = p_script->subclasses.front(); E; E = E->next()) {
+		_find_shared_in_script(E->get().ptr(), r_shared);
+	}
+	_find_shared_in_script(p_script->_base, r_shared);
+	_find_shared_in_script(p_script->_owner, r_shared);
+}
+
+Error GDScriptJobs::_make_job(const Callable &p_function, int p_count, const Array &p_arguments, int p_chunk_size, Job &r_job) {
+	ERR_FAIL_COND_V_MSG(p_count < 0, ERR_INVALID_PARAMETER, "The element count of a job can't be negative.");
+
+	GDScript *script = Object::cast_to<GDScript>(p_function.get_object());
+	ERR_FAIL_COND_V_MSG(!script, ERR_INVALID_PARAMETER, "Jobs must be static functions of a GDScript.");
+	GDScriptFunction *function = _find_static_function(script, p_function.get_method());
+	ERR_FAIL_COND_V_MSG(!function, ERR_INVALID_PARAMETER, "Jobs must be static functions of a GDScript, '" + String(p_function.get_method()) + "' isn't one.");
+
+	// The range of elements to process comes first.
+	int argument_count = p_arguments.size() + 2;
+	ERR_FAIL_COND_V_MSG(argument_count > function->get_argument_count() || argument_count < function->get_argument_count() - function->get_default_argument_count(), ERR_INVALID_PARAMETER,
+			"Job function '" + String(p_function.get_method()) + "' must take the first and past the last element to process, followed by " + itos(p_arguments.size()) + " argument(s).");
+
+	r_job.script = Ref<GDScript>(script);
+	r_job.function = function;
+	r_job.count = p_count;
+	r_job.chunk_size = p_chunk_size;
+	r_job.arguments.resize(p_arguments.size());
+	for (int i = 0; i < p_arguments.size(); i++) {
+		switch (p_arguments[i].get_type()) {
+			case Variant::OBJECT:
+			case Variant::CALLABLE:
+			case Variant::SIGNAL:
+			case Variant::DICTIONARY:
+			case Variant::ARRAY: {
+				ERR_FAIL_V_MSG(ERR_INVALID_PARAMETER, "Job arguments must be packed arrays or values, argument " + itos(i) + " is of type '" + Variant::get_type_name(p_arguments[i].get_type()) + "'.");
+			} break;
+			default: {
+			}
+		}
+
+		// Shares the array with the caller, so jobs write to it.
+		r_job.arguments.write[i] = p_arguments[i];
+		if (_make_array_unique(&r_job.arguments.write[i])) {
+			r_job.arrays.push_back(_VariantOp::get_packed_array_id(&r_job.arguments[i]));
+		}
+	}
+	return OK;
+}
+
+void GDScriptJobs::_run_chunk(uint32_t p_index, const Chunk *p_chunks) {
+	const Chunk &chunk = p_chunks[p_index];
+	const Job &job = *chunk.job;
+
+	int argument_count = job.arguments.size() + 2;
+	const Variant **args = (const Variant **)alloca(sizeof(Variant *) * argument_count);
+	Variant from = chunk.from;
+	Variant to = chunk.to;
+	args[0] = &from;
+	args[1] = &to;
+	for (int i = 0; i < job.arguments.size(); i++) {
+		args[i + 2] = &job.arguments[i];
+	}
+
+	Context context;
+	context.arrays = &job.arrays;
+	context.shared = &shared;
+	context.servers = &servers;
+
+	current_context = &context;
+	Callable::CallError ce;
+	job.function->call(nullptr, args, argument_count, ce);
+	current_context = nullptr;
+
+	if (context.failed || ce.error != Callable::CallError::CALL_OK) {
+		chunk_failed.store(true);
+	}
+}
+
+Error GDScriptJobs::_run(const Vector<Job> &p_jobs) {
+	ERR_FAIL_COND_V_MSG(Thread::get_caller_id() != Thread::get_main_id(), ERR_UNAVAILABLE, "Jobs can only be run from the main thread.");
+
+	if (!pool_initialized) {
+		pool.init();
+		pool_initialized = true;
+
+		// Only servers running on their own thread queue calls from any other
+		// one, otherwise they would wait for the main thread (or not lock at all).
+		if (OS::get_singleton()->get_render_thread_mode() == OS::RENDER_SEPARATE_THREAD && Engine::get_singleton()->has_singleton("RenderingServer")) {
+			servers.push_back(Engine::get_singleton()->get_singleton_object("RenderingServer"));
+		}
+		if (int(GLOBAL_GET("physics/2d/thread_model")) == 2 && Engine::get_singleton()->has_singleton("PhysicsServer2D")) {
+			servers.push_back(Engine::get_singleton()->get_singleton_object("PhysicsServer2D"));
+		}
+	}
+
+	// Containers reachable from the jobs without being given to them, which
+	// they must not modify. Found again on each run, as scripts may change.
+	shared.clear();
+	for (int i = 0; i < p_jobs.size(); i++) {
+		_find_shared_in_script(p_jobs[i].script.ptr(), shared);
+	}
+	GDScriptLanguage *language = GDScriptLanguage::get_singleton();
+	for (int i = 0; i < language->get_global_array_size(); i++) {
+		_find_shared(language->get_global_array()[i], shared);
+	}
+
+	// Dependencies always point to earlier jobs, so jobs can be grouped in one
+	// pass into stages, each running after the previous one is done.
+	Vector<int> stages;
+	stages.resize(p_jobs.size());
+	int stage_count = 0;
+	for (int i = 0; i < p_jobs.size(); i++) {
+		int stage = 0;
+		for (int j = 0; j < p_jobs[i].dependencies.size(); j++) {
+			stage = MAX(stage, stages[p_jobs[i].dependencies[j]] + 1);
+		}
+		stages.write[i] = stage;
+		stage_count = MAX(stage_count, stage + 1);
+	}
+
+	int thread_count = get_thread_count();
+	Error err = OK;
+	for (int stage = 0; stage < stage_count && err == OK; stage++) {
+		chunks.clear();
+		for (int i = 0; i < p_jobs.size(); i++) {
+			if (stages[i] != stage) {
+				continue;
+			}
+			const Job &job = p_jobs[i];
+			// A few chunks per thread by default, to even out their durations.
+			int chunk_size = job.chunk_size > 0 ? job.chunk_size : MAX(1, job.count / (thread_count * 4));
+			for (int from = 0; from < job.count; from += chunk_size) {
+				Chunk chunk;
+				chunk.job = &job;
+				chunk.from = from;
+				chunk.to = MIN(from + chunk_size, job.count);
+				chunks.push_back(chunk);
+			}
+		}
+
+		if (chunks.empty()) {
+			continue;
+		}
+
+		chunk_failed.store(false);
+		pool.do_work(chunks.size(), this, &GDScriptJobs::_run_chunk, chunks.ptr());
+		if (chunk_failed.load()) {
+			err = FAILED;
+		}
+	}
+
+	chunks.clear();
+	shared.clear();
+	return err;
+}
+
+Error GDScriptJobs::parallel_for(const Callable &p_function, int p_count, const Array &p_arguments, int p_chunk_size) {
+	Vector<Job> single;
+	single.resize(1);
+	Error err = _make_job(p_function, p_count, p_arguments, p_chunk_size, single.write[0]);
+	if (err != OK) {
+		return err;
+	}
+	return _run(single);
+}
+
+int GDScriptJobs::add_job(const Callable &p_function, int p_count, const Array &p_arguments, const Vector<int> &p_dependencies, int p_chunk_size) {
+	for (int i = 0; i < p_dependencies.size(); i++) {
+		ERR_FAIL_INDEX_V_MSG(p_dependencies[i], jobs.size(), -1, "Jobs can only depend on jobs added before them.");
+	}
+
+	Job job;
+	if (_make_job(p_function, p_count, p_arguments, p_chunk_size, job) != OK) {
+		return -1;
+	}
+	job.dependencies = p_dependencies;
+	jobs.push_back(job);
+	return jobs.size() - 1;
+}
+
+Error GDScriptJobs::run_jobs() {
+	// Cleared first, jobs added from here on are for the next run.
+	Vector<Job> to_run = jobs;
+	jobs.clear();
+	return _run(to_run);
+}
+
+int GDScriptJobs::get_thread_count() const {
+	return OS::get_singleton()->get_processor_count();
+}
+
+void GDScriptJobs::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("parallel_for", "function", "count", "arguments", "chunk_size"), &GDScriptJobs::parallel_for, DEFVAL(Array()), DEFVAL(0));
+	ClassDB::bind_method(D_METHOD("add_job", "function", "count", "arguments", "dependencies", "chunk_size"), &GDScriptJobs::add_job, DEFVAL(Array()), DEFVAL(Vector<int>()), DEFVAL(0));
+	ClassDB::bind_method(D_METHOD("run_jobs"), &GDScriptJobs::run_jobs);
+	ClassDB::bind_method(D_METHOD("get_thread_count"), &GDScriptJobs::get_thread_count);
+}
+
+GDScriptJobs::GDScriptJobs() {
+	singleton = this;
+	chunk_failed.store(false);
+}
+
+GDScriptJobs::~GDScriptJobs() {
+	pool.finish();
+	singleton = nullptr;
+}
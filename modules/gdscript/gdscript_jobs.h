@@ -0,0 +1,136 @@
+/*************************************************************************/
+/*  gdscript_jobs.h                                                      */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef GDSCRIPT_JOBS_H
+#define GDSCRIPT_JOBS_H
+
+#include "core/object.h"
+#include "core/reference.h"
+#include "core/set.h"
+#include "core/thread_work_pool.h"
+
+class GDScript;
+class GDScriptFunction;
+
+// Runs static GDScript functions over ranges of elements on worker threads.
+// Jobs receive packed arrays to read and write, and the VM checks that they
+// don't touch anything else which isn't safe to use from several threads at
+// once (see Context).
+
+class GDScriptJobs : public Object {
+	GDCLASS(GDScriptJobs, Object);
+
+public:
+	// State of the job running on the current thread. Jobs may only call static
+	// script functions and the void methods of servers running on their own
+	// thread (which are queued), may not access properties of objects, iterate
+	// them, pass them to built-in functions (all of which could run script code)
+	// or yield, and may only modify values local to them. The arrays they were given can
+	// be indexed, iterated and passed to static functions, but anything which
+	// could resize them or take another reference to their buffer (copying,
+	// converting or storing them) is rejected, since writes from other chunks
+	// would race with it. Each check fails the job on violation.
+	struct Context {
+		const Vector<const void *> *arrays = nullptr;
+		const Set<const void *> *shared = nullptr;
+		const Vector<Object *> *servers = nullptr;
+		bool failed = false;
+
+		bool check_call(const Variant *p_base, bool p_local, const StringName &p_method, const Variant **p_args, int p_argcount, String &r_err_text);
+		bool check_get(const Variant *p_base, String &r_err_text);
+		bool check_set(const Variant *p_base, bool p_local, const Variant *p_value, String &r_err_text);
+		bool check_construct(const Variant **p_args, int p_argcount, String &r_err_text);
+		bool check_operator(Variant::Operator p_op, const Variant *p_a, const Variant *p_b, String &r_err_text);
+		bool check_builtin_function(int p_function, const Variant **p_args, int p_argcount, String &r_err_text);
+		bool check_iterate(const Variant *p_container, String &r_err_text);
+		bool check_yield(String &r_err_text);
+
+	private:
+		bool _is_job_array(const Variant *p_value) const;
+		bool _is_shared(const Variant *p_value) const;
+		bool _check_copy(const Variant *p_value, String &r_err_text);
+		bool _fail(const String &p_text, String &r_err_text);
+	};
+
+private:
+	struct Job {
+		Ref<GDScript> script;
+		GDScriptFunction *function = nullptr;
+		int count = 0;
+		int chunk_size = 0;
+		Vector<Variant> arguments;
+		Vector<const void *> arrays;
+		Vector<int> dependencies;
+	};
+
+	struct Chunk {
+		const Job *job;
+		int from;
+		int to;
+	};
+
+	static GDScriptJobs *singleton;
+	static thread_local Context *current_context;
+
+	ThreadWorkPool pool;
+	bool pool_initialized = false;
+	Vector<Object *> servers;
+	Set<const void *> shared;
+
+	Vector<Job> jobs;
+	Vector<Chunk> chunks;
+	std::atomic<bool> chunk_failed;
+
+	static void _find_shared(const Variant &p_value, Set<const void *> &r_shared);
+	static void _find_shared_in_script(const GDScript *p_script, Set<const void *> &r_shared);
+
+	Error _make_job(const Callable &p_function, int p_count, const Array &p_arguments, int p_chunk_size, Job &r_job);
+	void _run_chunk(uint32_t p_index, const Chunk *p_chunks);
+	Error _run(const Vector<Job> &p_jobs);
+
+protected:
+	static void _bind_methods();
+
+public:
+	static GDScriptJobs *get_singleton() { return singleton; }
+	static _FORCE_INLINE_ Context *get_current_context() { return current_context; }
+
+	Error parallel_for(const Callable &p_function, int p_count, const Array &p_arguments = Array(), int p_chunk_size = 0);
+
+	int add_job(const Callable &p_function, int p_count, const Array &p_arguments = Array(), const Vector<int> &p_dependencies = Vector<int>(), int p_chunk_size = 0);
+	Error run_jobs();
+
+	int get_thread_count() const;
+
+	GDScriptJobs();
+	~GDScriptJobs();
+};
+
+#endif // GDSCRIPT_JOBS_H
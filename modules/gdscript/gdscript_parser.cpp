@@ -482,7 +482,7 @@ GDScriptParser::Node *GDScriptParser::_parse_expression(Node *p_parent, bool p_s
 					if (for_completion && ScriptCodeCompletionCache::get_singleton() && FileAccess::exists(path)) {
 						res = ScriptCodeCompletionCache::get_singleton()->get_cached_resource(path);
 					} else if (!for_completion || FileAccess::exists(path)) {
-						res = ResourceLoader::load(path);
+						res = _load_dependency(path);
 					}
 				} else {
 					if (!FileAccess::exists(path)) {
@@ -817,7 +817,7 @@ GDScriptParser::Node *GDScriptParser::_parse_expression(Node *p_parent, bool p_s
 
 				if (!dependencies_only) {
 					if (!bfn && ScriptServer::is_global_class(identifier)) {
-						Ref<Script> scr = ResourceLoader::load(ScriptServer::get_global_class_path(identifier));
+						Ref<Script> scr = _load_dependency(ScriptServer::get_global_class_path(identifier));
 						if (scr.is_valid() && scr->is_valid()) {
 							ConstantNode *constant = alloc_node<ConstantNode>();
 							constant->value = scr;
@@ -5366,7 +5366,7 @@ void GDScriptParser::_determine_inheritance(ClassNode *p_class, bool p_recursive
 				}
 				path = base.plus_file(path).simplify_path();
 			}
-			script = ResourceLoader::load(path);
+			script = _load_dependency(path);
 			if (script.is_null()) {
 				_set_error("Couldn't load the base class: " + path, p_class->line);
 				return;
@@ -5402,7 +5402,7 @@ void GDScriptParser::_determine_inheritance(ClassNode *p_class, bool p_recursive
 			Ref<GDScript> base_script;
 
 			if (ScriptServer::is_global_class(base)) {
-				base_script = ResourceLoader::load(ScriptServer::get_global_class_path(base));
+				base_script = _load_dependency(ScriptServer::get_global_class_path(base));
 				if (!base_script.is_valid()) {
 					_set_error("The class \"" + base + "\" couldn't be fully loaded (script error or cyclic dependency).", p_class->line);
 					return;
@@ -5425,7 +5425,7 @@ void GDScriptParser::_determine_inheritance(ClassNode *p_class, bool p_recursive
 						if (!singleton_path.begins_with("res://")) {
 							singleton_path = "res://" + singleton_path;
 						}
-						base_script = ResourceLoader::load(singleton_path);
+						base_script = _load_dependency(singleton_path);
 						if (!base_script.is_valid()) {
 							_set_error("Class '" + base + "' could not be fully loaded (script error or cyclic inheritance).", p_class->line);
 							return;
@@ -5760,7 +5760,7 @@ GDScriptParser::DataType GDScriptParser::_resolve_type(const DataType &p_source,
 					result.kind = DataType::CLASS;
 					result.class_type = static_cast<ClassNode *>(head);
 				} else {
-					Ref<Script> script = ResourceLoader::load(script_path);
+					Ref<Script> script = _load_dependency(script_path);
 					Ref<GDScript> gds = script;
 					if (gds.is_valid()) {
 						if (!gds->is_valid()) {
@@ -5801,7 +5801,7 @@ GDScriptParser::DataType GDScriptParser::_resolve_type(const DataType &p_source,
 				}
 			}
 			if (!singleton_path.empty()) {
-				Ref<Script> script = ResourceLoader::load(singleton_path);
+				Ref<Script> script = _load_dependency(singleton_path);
 				Ref<GDScript> gds = script;
 				if (gds.is_valid()) {
 					if (!gds->is_valid()) {
@@ -7665,7 +7665,7 @@ GDScriptParser::DataType GDScriptParser::_reduce_identifier_type(const DataType
 		}
 
 		if (ScriptServer::is_global_class(p_identifier)) {
-			Ref<Script> scr = ResourceLoader::load(ScriptServer::get_global_class_path(p_identifier));
+			Ref<Script> scr = _load_dependency(ScriptServer::get_global_class_path(p_identifier));
 			if (scr.is_valid()) {
 				DataType result;
 				result.has_type = true;
@@ -7717,7 +7717,7 @@ GDScriptParser::DataType GDScriptParser::_reduce_identifier_type(const DataType
 				if (!script.begins_with("res://")) {
 					script = "res://" + script;
 				}
-				Ref<Script> singleton = ResourceLoader::load(script);
+				Ref<Script> singleton = _load_dependency(script);
 				if (singleton.is_valid()) {
 					DataType result;
 					result.has_type = true;
@@ -8583,6 +8583,12 @@ void GDScriptParser::_set_error(const String &p_error, int p_line, int p_column)
 	error_set = true;
 }
 
+RES GDScriptParser::_load_dependency(const String &p_path) {
+	// Everything the parsed code was resolved against, so compiled results can be invalidated when any of it changes.
+	loaded_dependencies.insert(p_path);
+	return ResourceLoader::load(p_path);
+}
+
 #ifdef DEBUG_ENABLED
 void GDScriptParser::_add_warning(int p_code, int p_line, const String &p_symbol1, const String &p_symbol2, const String &p_symbol3, const String &p_symbol4) {
 	Vector<String> symbols;
@@ -8828,6 +8834,7 @@ void GDScriptParser::clear() {
 	check_types = true;
 	dependencies_only = false;
 	dependencies.clear();
+	loaded_dependencies.clear();
 	error = "";
 #ifdef DEBUG_ENABLED
 	safe_lines = nullptr;
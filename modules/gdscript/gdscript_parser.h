@@ -539,6 +539,7 @@ private:
 	bool check_types;
 	bool dependencies_only;
 	List<String> dependencies;
+	Set<String> loaded_dependencies;
 #ifdef DEBUG_ENABLED
 	Set<int> *safe_lines;
 #endif // DEBUG_ENABLED
@@ -601,6 +602,7 @@ private:
 	void _add_warning(int p_code, int p_line, const Vector<String> &p_symbols);
 #endif // DEBUG_ENABLED
 	bool _recover_from_completion();
+	RES _load_dependency(const String &p_path);
 
 	bool _parse_arguments(Node *p_parent, Vector<Node *> &p_args, bool p_static, bool p_can_codecomplete = false, bool p_parsing_constant = false);
 	bool _enter_indent_block(BlockNode *p_block = nullptr);
@@ -686,6 +688,7 @@ public:
 	bool get_completion_identifier_is_function();
 
 	const List<String> &get_dependencies() const { return dependencies; }
+	const Set<String> &get_loaded_dependencies() const { return loaded_dependencies; }
 
 	void clear();
 	GDScriptParser();
@@ -0,0 +1,99 @@
+/*************************************************************************/
+/*  gdscript_validated_ops.cpp                                           */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "gdscript_validated_ops.h"
+
+#define MEMBER(m_type, m_ctype, m_member, m_value_type, m_value_ctype)                             \
+	static bool _get_##m_type##_##m_member(const Variant &p_base, Variant &r_ret) {                \
+		if (p_base.get_type() != Variant::m_type) {                                                \
+			return false;                                                                          \
+		}                                                                                          \
+		r_ret = p_base.operator m_ctype().m_member;                                                \
+		return true;                                                                               \
+	}                                                                                              \
+	static bool _set_##m_type##_##m_member(Variant &p_base, const Variant &p_value) {              \
+		if (p_base.get_type() != Variant::m_type || p_value.get_type() != Variant::m_value_type) { \
+			return false;                                                                          \
+		}                                                                                          \
+		m_ctype v = p_base.operator m_ctype();                                                     \
+		v.m_member = p_value.operator m_value_ctype();                                             \
+		p_base = v;                                                                                \
+		return true;                                                                               \
+	}
+
+MEMBER(VECTOR2, Vector2, x, FLOAT, real_t)
+MEMBER(VECTOR2, Vector2, y, FLOAT, real_t)
+MEMBER(VECTOR3, Vector3, x, FLOAT, real_t)
+MEMBER(VECTOR3, Vector3, y, FLOAT, real_t)
+MEMBER(VECTOR3, Vector3, z, FLOAT, real_t)
+MEMBER(RECT2, Rect2, position, VECTOR2, Vector2)
+MEMBER(RECT2, Rect2, size, VECTOR2, Vector2)
+MEMBER(QUAT, Quat, x, FLOAT, real_t)
+MEMBER(QUAT, Quat, y, FLOAT, real_t)
+MEMBER(QUAT, Quat, z, FLOAT, real_t)
+MEMBER(QUAT, Quat, w, FLOAT, real_t)
+MEMBER(COLOR, Color, r, FLOAT, float)
+MEMBER(COLOR, Color, g, FLOAT, float)
+MEMBER(COLOR, Color, b, FLOAT, float)
+MEMBER(COLOR, Color, a, FLOAT, float)
+
+#define MEMBER_INFO(m_type, m_member) \
+	{ Variant::m_type, #m_member, _get_##m_type##_##m_member, _set_##m_type##_##m_member }
+
+const GDScriptValidatedOps::MemberInfo GDScriptValidatedOps::members[] = {
+	MEMBER_INFO(VECTOR2, x),
+	MEMBER_INFO(VECTOR2, y),
+	MEMBER_INFO(VECTOR3, x),
+	MEMBER_INFO(VECTOR3, y),
+	MEMBER_INFO(VECTOR3, z),
+	MEMBER_INFO(RECT2, position),
+	MEMBER_INFO(RECT2, size),
+	MEMBER_INFO(QUAT, x),
+	MEMBER_INFO(QUAT, y),
+	MEMBER_INFO(QUAT, z),
+	MEMBER_INFO(QUAT, w),
+	MEMBER_INFO(COLOR, r),
+	MEMBER_INFO(COLOR, g),
+	MEMBER_INFO(COLOR, b),
+	MEMBER_INFO(COLOR, a),
+};
+
+const int GDScriptValidatedOps::member_count = sizeof(GDScriptValidatedOps::members) / sizeof(GDScriptValidatedOps::MemberInfo);
+
+int GDScriptValidatedOps::find_member(Variant::Type p_type, const StringName &p_name) {
+	String name = p_name;
+	for (int i = 0; i < member_count; i++) {
+		const MemberInfo &info = members[i];
+		if (info.type == p_type && name == info.name) {
+			return i;
+		}
+	}
+	return -1;
+}
@@ -0,0 +1,64 @@
+/*************************************************************************/
+/*  gdscript_validated_ops.h                                             */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef GDSCRIPT_VALIDATED_OPS_H
+#define GDSCRIPT_VALIDATED_OPS_H
+
+#include "core/variant.h"
+
+// Fast paths for member accesses whose base type is known at compile time. The
+// compiler resolves an entry once and stores its index in the bytecode, so the
+// VM can skip the generic Variant dispatch. Operators use the evaluators
+// provided by Variant instead (see Variant::get_validated_operator_evaluator()).
+//
+// Every function still checks the actual types (the parser's static types are
+// not a hard guarantee) and returns false when it can't handle them, in which
+// case the VM falls back to the generic path.
+
+class GDScriptValidatedOps {
+public:
+	typedef bool (*MemberGetter)(const Variant &p_base, Variant &r_ret);
+	typedef bool (*MemberSetter)(Variant &p_base, const Variant &p_value);
+
+	struct MemberInfo {
+		Variant::Type type;
+		const char *name;
+		MemberGetter getter;
+		MemberSetter setter;
+	};
+
+	static const MemberInfo members[];
+	static const int member_count;
+
+	// Return the table index, or -1 if there is no fast path.
+	static int find_member(Variant::Type p_type, const StringName &p_name);
+};
+
+#endif // GDSCRIPT_VALIDATED_OPS_H
@@ -30,14 +30,17 @@
 
 #include "register_types.h"
 
+#include "core/engine.h"
 #include "core/io/file_access_encrypted.h"
 #include "core/io/resource_loader.h"
 #include "core/os/dir_access.h"
 #include "core/os/file_access.h"
 #include "gdscript.h"
+#include "gdscript_jobs.h"
 #include "gdscript_tokenizer.h"
 
 GDScriptLanguage *script_language_gd = nullptr;
+GDScriptJobs *script_jobs_gd = nullptr;
 Ref<ResourceFormatLoaderGDScript> resource_loader_gd;
 Ref<ResourceFormatSaverGDScript> resource_saver_gd;
 
@@ -49,7 +52,6 @@ Ref<ResourceFormatSaverGDScript> resource_saver_gd;
 #include "editor/gdscript_highlighter.h"
 
 #ifndef GDSCRIPT_NO_LSP
-#include "core/engine.h"
 #include "language_server/gdscript_language_server.h"
 #endif // !GDSCRIPT_NO_LSP
 
@@ -151,10 +153,14 @@ static void _editor_init() {
 void register_gdscript_types() {
 	ClassDB::register_class<GDScript>();
 	ClassDB::register_virtual_class<GDScriptFunctionState>();
+	ClassDB::register_class<GDScriptJobs>();
 
 	script_language_gd = memnew(GDScriptLanguage);
 	ScriptServer::register_language(script_language_gd);
 
+	script_jobs_gd = memnew(GDScriptJobs);
+	Engine::get_singleton()->add_singleton(Engine::Singleton("GDScriptJobs", GDScriptJobs::get_singleton()));
+
 	resource_loader_gd.instance();
 	ResourceLoader::add_resource_format_loader(resource_loader_gd);
 
@@ -174,6 +180,10 @@ void unregister_gdscript_types() {
 		memdelete(script_language_gd);
 	}
 
+	if (script_jobs_gd) {
+		memdelete(script_jobs_gd);
+	}
+
 	ResourceLoader::remove_resource_format_loader(resource_loader_gd);
 	resource_loader_gd.unref();
 
@@ -233,7 +233,8 @@ void preregister_glslang_types() {
 	// initialize in case it's not initialized. This is done once per thread
 	// and it's safe to call multiple times
 	glslang::InitializeProcess();
-	RenderingDevice::shader_set_compile_function(_compile_shader_glsl);
+	// The version is part of the key of cached shaders, so they're rebuilt when glslang changes.
+	RenderingDevice::shader_set_compile_function(_compile_shader_glsl, String(glslang::GetGlslVersionString()) + " spirv-gen " + itos(glslang::GetSpirvGeneratorVersion()));
 }
 
 void register_glslang_types() {
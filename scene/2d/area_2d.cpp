@@ -205,6 +205,20 @@ void Area2D::_body_inout(int p_status, const RID &p_body, ObjectID p_instance, i
 	locked = false;
 }
 
+void Area2D::_body_inout_batch(const PackedInt32Array &p_status, const Array &p_bodies, const PackedInt64Array &p_instances, const PackedInt32Array &p_body_shapes, const PackedInt32Array &p_area_shapes) {
+	int count = p_status.size();
+	ERR_FAIL_COND(p_bodies.size() != count || p_instances.size() != count || p_body_shapes.size() != count || p_area_shapes.size() != count);
+
+	const int32_t *status = p_status.ptr();
+	const int64_t *instances = p_instances.ptr();
+	const int32_t *body_shapes = p_body_shapes.ptr();
+	const int32_t *area_shapes = p_area_shapes.ptr();
+
+	for (int i = 0; i < count; i++) {
+		_body_inout(status[i], p_bodies[i], ObjectID(uint64_t(instances[i])), body_shapes[i], area_shapes[i]);
+	}
+}
+
 void Area2D::_area_enter_tree(ObjectID p_id) {
 	Object *obj = ObjectDB::get_instance(p_id);
 	Node *node = Object::cast_to<Node>(obj);
@@ -303,6 +317,20 @@ void Area2D::_area_inout(int p_status, const RID &p_area, ObjectID p_instance, i
 	locked = false;
 }
 
+void Area2D::_area_inout_batch(const PackedInt32Array &p_status, const Array &p_areas, const PackedInt64Array &p_instances, const PackedInt32Array &p_area_shapes, const PackedInt32Array &p_self_shapes) {
+	int count = p_status.size();
+	ERR_FAIL_COND(p_areas.size() != count || p_instances.size() != count || p_area_shapes.size() != count || p_self_shapes.size() != count);
+
+	const int32_t *status = p_status.ptr();
+	const int64_t *instances = p_instances.ptr();
+	const int32_t *area_shapes = p_area_shapes.ptr();
+	const int32_t *self_shapes = p_self_shapes.ptr();
+
+	for (int i = 0; i < count; i++) {
+		_area_inout(status[i], p_areas[i], ObjectID(uint64_t(instances[i])), area_shapes[i], self_shapes[i]);
+	}
+}
+
 void Area2D::_clear_monitoring() {
 	ERR_FAIL_COND_MSG(locked, "This function can't be used during the in/out signal.");
 
@@ -380,8 +408,8 @@ void Area2D::set_monitoring(bool p_enable) {
 	monitoring = p_enable;
 
 	if (monitoring) {
-		PhysicsServer2D::get_singleton()->area_set_monitor_callback(get_rid(), this, SceneStringNames::get_singleton()->_body_inout);
-		PhysicsServer2D::get_singleton()->area_set_area_monitor_callback(get_rid(), this, SceneStringNames::get_singleton()->_area_inout);
+		PhysicsServer2D::get_singleton()->area_set_monitor_callback(get_rid(), this, SceneStringNames::get_singleton()->_body_inout_batch);
+		PhysicsServer2D::get_singleton()->area_set_area_monitor_callback(get_rid(), this, SceneStringNames::get_singleton()->_area_inout_batch);
 
 	} else {
 		PhysicsServer2D::get_singleton()->area_set_monitor_callback(get_rid(), nullptr, StringName());
@@ -601,6 +629,8 @@ void Area2D::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("_body_inout"), &Area2D::_body_inout);
 	ClassDB::bind_method(D_METHOD("_area_inout"), &Area2D::_area_inout);
+	ClassDB::bind_method(D_METHOD("_body_inout_batch"), &Area2D::_body_inout_batch);
+	ClassDB::bind_method(D_METHOD("_area_inout_batch"), &Area2D::_area_inout_batch);
 
 	ADD_SIGNAL(MethodInfo("body_shape_entered", PropertyInfo(Variant::INT, "body_id"), PropertyInfo(Variant::OBJECT, "body", PROPERTY_HINT_RESOURCE_TYPE, "Node"), PropertyInfo(Variant::INT, "body_shape"), PropertyInfo(Variant::INT, "area_shape")));
 	ADD_SIGNAL(MethodInfo("body_shape_exited", PropertyInfo(Variant::INT, "body_id"), PropertyInfo(Variant::OBJECT, "body", PROPERTY_HINT_RESOURCE_TYPE, "Node"), PropertyInfo(Variant::INT, "body_shape"), PropertyInfo(Variant::INT, "area_shape")));
@@ -652,6 +682,7 @@ Area2D::Area2D() :
 	monitorable = false;
 	collision_mask = 1;
 	collision_layer = 1;
+	PhysicsServer2D::get_singleton()->area_set_monitor_batching(get_rid(), true);
 	audio_bus_override = false;
 	set_monitoring(true);
 	set_monitorable(true);
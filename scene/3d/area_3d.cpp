@@ -205,6 +205,20 @@ void Area3D::_body_inout(int p_status, const RID &p_body, ObjectID p_instance, i
 	locked = false;
 }
 
+void Area3D::_body_inout_batch(const PackedInt32Array &p_status, const Array &p_bodies, const PackedInt64Array &p_instances, const PackedInt32Array &p_body_shapes, const PackedInt32Array &p_area_shapes) {
+	int count = p_status.size();
+	ERR_FAIL_COND(p_bodies.size() != count || p_instances.size() != count || p_body_shapes.size() != count || p_area_shapes.size() != count);
+
+	const int32_t *status = p_status.ptr();
+	const int64_t *instances = p_instances.ptr();
+	const int32_t *body_shapes = p_body_shapes.ptr();
+	const int32_t *area_shapes = p_area_shapes.ptr();
+
+	for (int i = 0; i < count; i++) {
+		_body_inout(status[i], p_bodies[i], ObjectID(uint64_t(instances[i])), body_shapes[i], area_shapes[i]);
+	}
+}
+
 void Area3D::_clear_monitoring() {
 	ERR_FAIL_COND_MSG(locked, "This function can't be used during the in/out signal.");
 
@@ -283,8 +297,8 @@ void Area3D::set_monitoring(bool p_enable) {
 	monitoring = p_enable;
 
 	if (monitoring) {
-		PhysicsServer3D::get_singleton()->area_set_monitor_callback(get_rid(), this, SceneStringNames::get_singleton()->_body_inout);
-		PhysicsServer3D::get_singleton()->area_set_area_monitor_callback(get_rid(), this, SceneStringNames::get_singleton()->_area_inout);
+		PhysicsServer3D::get_singleton()->area_set_monitor_callback(get_rid(), this, SceneStringNames::get_singleton()->_body_inout_batch);
+		PhysicsServer3D::get_singleton()->area_set_area_monitor_callback(get_rid(), this, SceneStringNames::get_singleton()->_area_inout_batch);
 	} else {
 		PhysicsServer3D::get_singleton()->area_set_monitor_callback(get_rid(), nullptr, StringName());
 		PhysicsServer3D::get_singleton()->area_set_area_monitor_callback(get_rid(), nullptr, StringName());
@@ -391,6 +405,20 @@ void Area3D::_area_inout(int p_status, const RID &p_area, ObjectID p_instance, i
 	locked = false;
 }
 
+void Area3D::_area_inout_batch(const PackedInt32Array &p_status, const Array &p_areas, const PackedInt64Array &p_instances, const PackedInt32Array &p_area_shapes, const PackedInt32Array &p_self_shapes) {
+	int count = p_status.size();
+	ERR_FAIL_COND(p_areas.size() != count || p_instances.size() != count || p_area_shapes.size() != count || p_self_shapes.size() != count);
+
+	const int32_t *status = p_status.ptr();
+	const int64_t *instances = p_instances.ptr();
+	const int32_t *area_shapes = p_area_shapes.ptr();
+	const int32_t *self_shapes = p_self_shapes.ptr();
+
+	for (int i = 0; i < count; i++) {
+		_area_inout(status[i], p_areas[i], ObjectID(uint64_t(instances[i])), area_shapes[i], self_shapes[i]);
+	}
+}
+
 bool Area3D::is_monitoring() const {
 	return monitoring;
 }
@@ -633,6 +661,8 @@ void Area3D::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("_body_inout"), &Area3D::_body_inout);
 	ClassDB::bind_method(D_METHOD("_area_inout"), &Area3D::_area_inout);
+	ClassDB::bind_method(D_METHOD("_body_inout_batch"), &Area3D::_body_inout_batch);
+	ClassDB::bind_method(D_METHOD("_area_inout_batch"), &Area3D::_area_inout_batch);
 
 	ClassDB::bind_method(D_METHOD("set_audio_bus_override", "enable"), &Area3D::set_audio_bus_override);
 	ClassDB::bind_method(D_METHOD("is_overriding_audio_bus"), &Area3D::is_overriding_audio_bus);
@@ -706,6 +736,7 @@ Area3D::Area3D() :
 	monitorable = false;
 	collision_mask = 1;
 	collision_layer = 1;
+	PhysicsServer3D::get_singleton()->area_set_monitor_batching(get_rid(), true);
 	set_monitoring(true);
 	set_monitorable(true);
 
@@ -62,6 +62,7 @@ private:
 	bool locked;
 
 	void _body_inout(int p_status, const RID &p_body, ObjectID p_instance, int p_body_shape, int p_area_shape);
+	void _body_inout_batch(const PackedInt32Array &p_status, const Array &p_bodies, const PackedInt64Array &p_instances, const PackedInt32Array &p_body_shapes, const PackedInt32Array &p_area_shapes);
 
 	void _body_enter_tree(ObjectID p_id);
 	void _body_exit_tree(ObjectID p_id);
@@ -93,6 +94,7 @@ private:
 	Map<ObjectID, BodyState> body_map;
 
 	void _area_inout(int p_status, const RID &p_area, ObjectID p_instance, int p_area_shape, int p_self_shape);
+	void _area_inout_batch(const PackedInt32Array &p_status, const Array &p_areas, const PackedInt64Array &p_instances, const PackedInt32Array &p_area_shapes, const PackedInt32Array &p_self_shapes);
 
 	void _area_enter_tree(ObjectID p_id);
 	void _area_exit_tree(ObjectID p_id);
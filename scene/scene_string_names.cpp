@@ -82,6 +82,8 @@ SceneStringNames::SceneStringNames() {
 
 	_body_inout = StaticCString::create("_body_inout");
 	_area_inout = StaticCString::create("_area_inout");
+	_body_inout_batch = StaticCString::create("_body_inout_batch");
+	_area_inout_batch = StaticCString::create("_area_inout_batch");
 
 	idle = StaticCString::create("idle");
 	iteration = StaticCString::create("iteration");
@@ -58,6 +58,8 @@ class Area2DSW : public CollisionObject2DSW {
 	ObjectID area_monitor_callback_id;
 	StringName area_monitor_callback_method;
 
+	bool monitor_batching;
+
 	SelfList<Area2DSW> monitor_query_list;
 	SelfList<Area2DSW> moved_list;
 
@@ -96,10 +98,12 @@ class Area2DSW : public CollisionObject2DSW {
 
 	//virtual void shape_changed_notify(Shape2DSW *p_shape);
 	//virtual void shape_deleted_notify(Shape2DSW *p_shape);
-	Set<Constraint2DSW *> constraints;
+	Set<Constraint2DSW *, Constraint2DSWComparator> constraints;
 
 	virtual void _shapes_changed();
 	void _queue_monitor_update();
+	static int _count_monitor_changes(const Map<BodyKey, BodyState> &p_monitored);
+	void _call_monitor_batch(const Map<BodyKey, BodyState> &p_monitored, int p_changes, Object *p_obj, const StringName &p_method);
 
 public:
 	//_FORCE_INLINE_ const Matrix32& get_inverse_transform() const { return inverse_transform; }
@@ -111,6 +115,12 @@ public:
 	void set_area_monitor_callback(ObjectID p_id, const StringName &p_method);
 	_FORCE_INLINE_ bool has_area_monitor_callback() const { return area_monitor_callback_id.is_valid(); }
 
+	_FORCE_INLINE_ void set_monitor_batching(bool p_enable) { monitor_batching = p_enable; }
+	_FORCE_INLINE_ bool is_monitor_batching() const { return monitor_batching; }
+
+	// true when overlaps with this area have no effect, so pairs don't need to be tested
+	_FORCE_INLINE_ bool is_inert() const { return !monitor_callback_id.is_valid() && space_override_mode == PhysicsServer2D::AREA_SPACE_OVERRIDE_DISABLED; }
+
 	_FORCE_INLINE_ void add_body_to_query(Body2DSW *p_body, uint32_t p_body_shape, uint32_t p_area_shape);
 	_FORCE_INLINE_ void remove_body_from_query(Body2DSW *p_body, uint32_t p_body_shape, uint32_t p_area_shape);
 
@@ -149,7 +159,7 @@ public:
 
 	_FORCE_INLINE_ void add_constraint(Constraint2DSW *p_constraint) { constraints.insert(p_constraint); }
 	_FORCE_INLINE_ void remove_constraint(Constraint2DSW *p_constraint) { constraints.erase(p_constraint); }
-	_FORCE_INLINE_ const Set<Constraint2DSW *> &get_constraints() const { return constraints; }
+	_FORCE_INLINE_ const Set<Constraint2DSW *, Constraint2DSWComparator> &get_constraints() const { return constraints; }
 	_FORCE_INLINE_ void clear_constraints() { constraints.clear(); }
 
 	void set_monitorable(bool p_monitorable);
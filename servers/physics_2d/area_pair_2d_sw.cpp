@@ -32,6 +32,11 @@
 #include "collision_solver_2d_sw.h"
 
 bool AreaPair2DSW::setup(real_t p_step) {
+	if (area->is_inert()) {
+		// nothing reacts to this overlap, and the pair is recreated if that changes
+		return false;
+	}
+
 	bool result = false;
 
 	if (area->is_shape_set_as_disabled(area_shape) || body->is_shape_set_as_disabled(body_shape)) {
@@ -73,6 +78,7 @@ AreaPair2DSW::AreaPair2DSW(Body2DSW *p_body, int p_body_shape, Area2DSW *p_area,
 	body_shape = p_body_shape;
 	area_shape = p_area_shape;
 	colliding = false;
+	set_order_key(body->get_self(), area->get_self(), (uint64_t(body_shape) << 32) | uint32_t(area_shape));
 	body->add_constraint(this, 0);
 	area->add_constraint(this);
 	if (p_body->get_mode() == PhysicsServer2D::BODY_MODE_KINEMATIC) { //need to be active to process pair
@@ -96,6 +102,10 @@ AreaPair2DSW::~AreaPair2DSW() {
 //////////////////////////////////
 
 bool Area2Pair2DSW::setup(real_t p_step) {
+	if (!area_a->has_area_monitor_callback() && !area_b->has_area_monitor_callback()) {
+		return false;
+	}
+
 	bool result = false;
 	if (area_a->is_shape_set_as_disabled(shape_a) || area_b->is_shape_set_as_disabled(shape_b)) {
 		result = false;
@@ -138,6 +148,7 @@ Area2Pair2DSW::Area2Pair2DSW(Area2DSW *p_area_a, int p_shape_a, Area2DSW *p_area
 	shape_a = p_shape_a;
 	shape_b = p_shape_b;
 	colliding = false;
+	set_order_key(area_a->get_self(), area_b->get_self(), (uint64_t(shape_a) << 32) | uint32_t(shape_b));
 	area_a->add_constraint(this);
 	area_b->add_constraint(this);
 }
@@ -98,6 +98,34 @@ void Body2DSW::update_inertias() {
 	//_update_shapes();
 }
 
+void Body2DSW::save_snapshot(Snapshot &r_snapshot) const {
+	r_snapshot.transform = get_transform();
+	r_snapshot.inv_transform = get_inv_transform();
+	r_snapshot.new_transform = new_transform;
+	r_snapshot.linear_velocity = linear_velocity;
+	r_snapshot.biased_linear_velocity = biased_linear_velocity;
+	r_snapshot.applied_force = applied_force;
+	r_snapshot.angular_velocity = angular_velocity;
+	r_snapshot.biased_angular_velocity = biased_angular_velocity;
+	r_snapshot.applied_torque = applied_torque;
+	r_snapshot.still_time = still_time;
+	r_snapshot.first_time_kinematic = first_time_kinematic;
+}
+
+void Body2DSW::load_snapshot(const Snapshot &p_snapshot) {
+	_set_transform(p_snapshot.transform);
+	_set_inv_transform(p_snapshot.inv_transform);
+	new_transform = p_snapshot.new_transform;
+	linear_velocity = p_snapshot.linear_velocity;
+	biased_linear_velocity = p_snapshot.biased_linear_velocity;
+	applied_force = p_snapshot.applied_force;
+	angular_velocity = p_snapshot.angular_velocity;
+	biased_angular_velocity = p_snapshot.biased_angular_velocity;
+	applied_torque = p_snapshot.applied_torque;
+	still_time = p_snapshot.still_time;
+	first_time_kinematic = p_snapshot.first_time_kinematic;
+}
+
 void Body2DSW::set_active(bool p_active) {
 	if (active == p_active) {
 		return;
@@ -562,7 +590,7 @@ void Body2DSW::integrate_velocities(real_t p_step) {
 }
 
 void Body2DSW::wakeup_neighbours() {
-	for (Map<Constraint2DSW *, int>::Element *E = constraint_map.front(); E; E = E->next()) {
+	for (Map<Constraint2DSW *, int, Constraint2DSWComparator>::Element *E = constraint_map.front(); E; E = E->next()) {
 		const Constraint2DSW *c = E->key();
 		Body2DSW **n = c->get_body_ptr();
 		int bc = c->get_body_count();
@@ -83,7 +83,7 @@ class Body2DSW : public CollisionObject2DSW {
 	virtual void _shapes_changed();
 	Transform2D new_transform;
 
-	Map<Constraint2DSW *, int> constraint_map;
+	Map<Constraint2DSW *, int, Constraint2DSWComparator> constraint_map;
 
 	struct AreaCMP {
 		Area2DSW *area;
@@ -131,6 +131,24 @@ class Body2DSW : public CollisionObject2DSW {
 	friend class PhysicsDirectBodyState2DSW; // i give up, too many functions to expose
 
 public:
+	// simulation state of the body, saved in space snapshots
+	struct Snapshot {
+		Transform2D transform;
+		Transform2D inv_transform;
+		Transform2D new_transform;
+		Vector2 linear_velocity;
+		Vector2 biased_linear_velocity;
+		Vector2 applied_force;
+		real_t angular_velocity;
+		real_t biased_angular_velocity;
+		real_t applied_torque;
+		real_t still_time;
+		bool first_time_kinematic;
+	};
+
+	void save_snapshot(Snapshot &r_snapshot) const;
+	void load_snapshot(const Snapshot &p_snapshot);
+
 	void set_force_integration_callback(ObjectID p_id, const StringName &p_method, const Variant &p_udata = Variant());
 
 	_FORCE_INLINE_ void add_area(Area2DSW *p_area) {
@@ -181,7 +199,7 @@ public:
 
 	_FORCE_INLINE_ void add_constraint(Constraint2DSW *p_constraint, int p_pos) { constraint_map[p_constraint] = p_pos; }
 	_FORCE_INLINE_ void remove_constraint(Constraint2DSW *p_constraint) { constraint_map.erase(p_constraint); }
-	const Map<Constraint2DSW *, int> &get_constraint_map() const { return constraint_map; }
+	const Map<Constraint2DSW *, int, Constraint2DSWComparator> &get_constraint_map() const { return constraint_map; }
 	_FORCE_INLINE_ void clear_constraint_map() { constraint_map.clear(); }
 
 	_FORCE_INLINE_ void set_omit_force_integration(bool p_omit_force_integration) { omit_force_integration = p_omit_force_integration; }
@@ -502,6 +502,36 @@ void BodyPair2DSW::solve(real_t p_step) {
 	}
 }
 
+void BodyPair2DSW::save_snapshot(uint8_t *r_data) const {
+	Snapshot snapshot;
+	snapshot.offset_B = offset_B;
+	snapshot.sep_axis = sep_axis;
+	for (int i = 0; i < MAX_CONTACTS; i++) {
+		snapshot.contacts[i] = contacts[i];
+	}
+	snapshot.contact_count = contact_count;
+	snapshot.collided = collided;
+	snapshot.oneway_disabled = oneway_disabled;
+	snapshot.cc = cc;
+
+	memcpy(r_data, &snapshot, sizeof(Snapshot));
+}
+
+void BodyPair2DSW::load_snapshot(const uint8_t *p_data) {
+	Snapshot snapshot;
+	memcpy(&snapshot, p_data, sizeof(Snapshot));
+
+	offset_B = snapshot.offset_B;
+	sep_axis = snapshot.sep_axis;
+	for (int i = 0; i < MAX_CONTACTS; i++) {
+		contacts[i] = snapshot.contacts[i];
+	}
+	contact_count = snapshot.contact_count;
+	collided = snapshot.collided;
+	oneway_disabled = snapshot.oneway_disabled;
+	cc = snapshot.cc;
+}
+
 BodyPair2DSW::BodyPair2DSW(Body2DSW *p_A, int p_shape_A, Body2DSW *p_B, int p_shape_B) :
 		Constraint2DSW(_arr, 2) {
 	A = p_A;
@@ -509,6 +539,7 @@ BodyPair2DSW::BodyPair2DSW(Body2DSW *p_A, int p_shape_A, Body2DSW *p_B, int p_sh
 	shape_A = p_shape_A;
 	shape_B = p_shape_B;
 	space = A->get_space();
+	set_order_key(A->get_self(), B->get_self(), (uint64_t(shape_A) << 32) | uint32_t(shape_B));
 	A->add_constraint(this, 0);
 	B->add_constraint(this, 1);
 	contact_count = 0;
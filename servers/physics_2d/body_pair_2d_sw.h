@@ -78,6 +78,17 @@ class BodyPair2DSW : public Constraint2DSW {
 	bool oneway_disabled;
 	int cc;
 
+	// everything above that survives between steps, copied as is into space snapshots
+	struct Snapshot {
+		Vector2 offset_B;
+		Vector2 sep_axis;
+		Contact contacts[MAX_CONTACTS];
+		int contact_count;
+		bool collided;
+		bool oneway_disabled;
+		int cc;
+	};
+
 	bool _test_ccd(real_t p_step, Body2DSW *p_A, int p_shape_A, const Transform2D &p_xform_A, Body2DSW *p_B, int p_shape_B, const Transform2D &p_xform_B, bool p_swap_result = false);
 	void _validate_contacts();
 	static void _add_contact(const Vector2 &p_point_A, const Vector2 &p_point_B, void *p_self);
@@ -87,6 +98,10 @@ public:
 	bool setup(real_t p_step);
 	void solve(real_t p_step);
 
+	virtual int get_snapshot_size() const { return sizeof(Snapshot); }
+	virtual void save_snapshot(uint8_t *r_data) const;
+	virtual void load_snapshot(const uint8_t *p_data);
+
 	BodyPair2DSW(Body2DSW *p_A, int p_shape_A, Body2DSW *p_B, int p_shape_B);
 	~BodyPair2DSW();
 };
@@ -34,7 +34,7 @@
 #define LARGE_ELEMENT_FI 1.01239812
 
 void BroadPhase2DHashGrid::_pair_attempt(Element *p_elem, Element *p_with) {
-	Map<Element *, PairData *>::Element *E = p_elem->paired.find(p_with);
+	Map<Element *, PairData *, ElementComparator>::Element *E = p_elem->paired.find(p_with);
 
 	ERR_FAIL_COND(p_elem->_static && p_with->_static);
 
@@ -48,7 +48,7 @@ void BroadPhase2DHashGrid::_pair_attempt(Element *p_elem, Element *p_with) {
 }
 
 void BroadPhase2DHashGrid::_unpair_attempt(Element *p_elem, Element *p_with) {
-	Map<Element *, PairData *>::Element *E = p_elem->paired.find(p_with);
+	Map<Element *, PairData *, ElementComparator>::Element *E = p_elem->paired.find(p_with);
 
 	ERR_FAIL_COND(!E); //this should really be paired..
 
@@ -69,7 +69,7 @@ void BroadPhase2DHashGrid::_unpair_attempt(Element *p_elem, Element *p_with) {
 }
 
 void BroadPhase2DHashGrid::_check_motion(Element *p_elem) {
-	for (Map<Element *, PairData *>::Element *E = p_elem->paired.front(); E; E = E->next()) {
+	for (Map<Element *, PairData *, ElementComparator>::Element *E = p_elem->paired.front(); E; E = E->next()) {
 		bool pairing = p_elem->aabb.intersects(E->key()->aabb);
 
 		if (pairing != E->get()->colliding) {
@@ -154,7 +154,7 @@ void BroadPhase2DHashGrid::_enter_grid(Element *p_elem, const Rect2 &p_rect, boo
 			}
 
 			if (entered) {
-				for (Map<Element *, RC>::Element *E = pb->object_set.front(); E; E = E->next()) {
+				for (Map<Element *, RC, ElementComparator>::Element *E = pb->object_set.front(); E; E = E->next()) {
 					if (E->key()->owner == p_elem->owner) {
 						continue;
 					}
@@ -162,7 +162,7 @@ void BroadPhase2DHashGrid::_enter_grid(Element *p_elem, const Rect2 &p_rect, boo
 				}
 
 				if (!p_static) {
-					for (Map<Element *, RC>::Element *E = pb->static_object_set.front(); E; E = E->next()) {
+					for (Map<Element *, RC, ElementComparator>::Element *E = pb->static_object_set.front(); E; E = E->next()) {
 						if (E->key()->owner == p_elem->owner) {
 							continue;
 						}
@@ -175,7 +175,7 @@ void BroadPhase2DHashGrid::_enter_grid(Element *p_elem, const Rect2 &p_rect, boo
 
 	//pair separatedly with large elements
 
-	for (Map<Element *, RC>::Element *E = large_elements.front(); E; E = E->next()) {
+	for (Map<Element *, RC, ElementComparator>::Element *E = large_elements.front(); E; E = E->next()) {
 		if (E->key() == p_elem) {
 			continue; // do not pair against itself
 		}
@@ -194,9 +194,9 @@ void BroadPhase2DHashGrid::_exit_grid(Element *p_elem, const Rect2 &p_rect, bool
 	Vector2 sz = (p_rect.size / cell_size * LARGE_ELEMENT_FI);
 	if (sz.width * sz.height > large_object_min_surface) {
 		//unpair all elements, instead of checking all, just check what is already paired, so we at least save from checking static vs static
-		Map<Element *, PairData *>::Element *E = p_elem->paired.front();
+		Map<Element *, PairData *, ElementComparator>::Element *E = p_elem->paired.front();
 		while (E) {
-			Map<Element *, PairData *>::Element *next = E->next();
+			Map<Element *, PairData *, ElementComparator>::Element *next = E->next();
 			_unpair_attempt(p_elem, E->key());
 			E = next;
 		}
@@ -244,7 +244,7 @@ void BroadPhase2DHashGrid::_exit_grid(Element *p_elem, const Rect2 &p_rect, bool
 			}
 
 			if (exited) {
-				for (Map<Element *, RC>::Element *E = pb->object_set.front(); E; E = E->next()) {
+				for (Map<Element *, RC, ElementComparator>::Element *E = pb->object_set.front(); E; E = E->next()) {
 					if (E->key()->owner == p_elem->owner) {
 						continue;
 					}
@@ -252,7 +252,7 @@ void BroadPhase2DHashGrid::_exit_grid(Element *p_elem, const Rect2 &p_rect, bool
 				}
 
 				if (!p_static) {
-					for (Map<Element *, RC>::Element *E = pb->static_object_set.front(); E; E = E->next()) {
+					for (Map<Element *, RC, ElementComparator>::Element *E = pb->static_object_set.front(); E; E = E->next()) {
 						if (E->key()->owner == p_elem->owner) {
 							continue;
 						}
@@ -284,7 +284,7 @@ void BroadPhase2DHashGrid::_exit_grid(Element *p_elem, const Rect2 &p_rect, bool
 		}
 	}
 
-	for (Map<Element *, RC>::Element *E = large_elements.front(); E; E = E->next()) {
+	for (Map<Element *, RC, ElementComparator>::Element *E = large_elements.front(); E; E = E->next()) {
 		if (E->key() == p_elem) {
 			continue; // do not pair against itself
 		}
@@ -413,7 +413,7 @@ void BroadPhase2DHashGrid::_cull(const Point2i p_cell, const Rect2 &p_aabb, cons
 		return;
 	}
 
-	for (Map<Element *, RC>::Element *E = pb->object_set.front(); E; E = E->next()) {
+	for (Map<Element *, RC, ElementComparator>::Element *E = pb->object_set.front(); E; E = E->next()) {
 		if (index >= p_max_results) {
 			break;
 		}
@@ -436,7 +436,7 @@ void BroadPhase2DHashGrid::_cull(const Point2i p_cell, const Rect2 &p_aabb, cons
 		index++;
 	}
 
-	for (Map<Element *, RC>::Element *E = pb->static_object_set.front(); E; E = E->next()) {
+	for (Map<Element *, RC, ElementComparator>::Element *E = pb->static_object_set.front(); E; E = E->next()) {
 		if (index >= p_max_results) {
 			break;
 		}
@@ -536,7 +536,7 @@ int BroadPhase2DHashGrid::cull_segment(const Vector2 &p_from, const Vector2 &p_t
 		}
 	}
 
-	for (Map<Element *, RC>::Element *E = large_elements.front(); E; E = E->next()) {
+	for (Map<Element *, RC, ElementComparator>::Element *E = large_elements.front(); E; E = E->next()) {
 		if (cullcount >= p_max_results) {
 			break;
 		}
@@ -576,7 +576,7 @@ int BroadPhase2DHashGrid::cull_aabb(const Rect2 &p_aabb, CollisionObject2DSW **p
 		}
 	}
 
-	for (Map<Element *, RC>::Element *E = large_elements.front(); E; E = E->next()) {
+	for (Map<Element *, RC, ElementComparator>::Element *E = large_elements.front(); E; E = E->next()) {
 		if (cullcount >= p_max_results) {
 			break;
 		}
@@ -46,6 +46,14 @@ class BroadPhase2DHashGrid : public BroadPhase2DSW {
 		}
 	};
 
+	struct Element;
+
+	// Elements are sorted by ID rather than by address, so pairs are created and cull
+	// results are returned in the same order on every run.
+	struct ElementComparator {
+		_FORCE_INLINE_ bool operator()(const Element *p_a, const Element *p_b) const { return p_a->self < p_b->self; }
+	};
+
 	struct Element {
 		ID self;
 		CollisionObject2DSW *owner;
@@ -53,7 +61,7 @@ class BroadPhase2DHashGrid : public BroadPhase2DSW {
 		Rect2 aabb;
 		int subindex;
 		uint64_t pass;
-		Map<Element *, PairData *> paired;
+		Map<Element *, PairData *, ElementComparator> paired;
 	};
 
 	struct RC {
@@ -74,7 +82,7 @@ class BroadPhase2DHashGrid : public BroadPhase2DSW {
 	};
 
 	Map<ID, Element> element_map;
-	Map<Element *, RC> large_elements;
+	Map<Element *, RC, ElementComparator> large_elements;
 
 	ID current;
 
@@ -148,8 +156,8 @@ class BroadPhase2DHashGrid : public BroadPhase2DSW {
 
 	struct PosBin {
 		PosKey key;
-		Map<Element *, RC> object_set;
-		Map<Element *, RC> static_object_set;
+		Map<Element *, RC, ElementComparator> object_set;
+		Map<Element *, RC, ElementComparator> static_object_set;
 		PosBin *next;
 	};
 
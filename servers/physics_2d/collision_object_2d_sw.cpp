@@ -29,9 +29,14 @@
 /*************************************************************************/
 
 #include "collision_object_2d_sw.h"
+#include "constraint_2d_sw.h"
 #include "servers/physics_2d/physics_server_2d_sw.h"
 #include "space_2d_sw.h"
 
+bool Constraint2DSWComparator::operator()(const Constraint2DSW *p_a, const Constraint2DSW *p_b) const {
+	return p_a->is_ordered_before(p_b);
+}
+
 void CollisionObject2DSW::add_shape(Shape2DSW *p_shape, const Transform2D &p_transform, bool p_disabled) {
 	Shape s;
 	s.shape = p_shape;
@@ -191,4 +191,16 @@ public:
 	virtual ~CollisionObject2DSW() {}
 };
 
+// Containers of objects and constraints are sorted by RID instead of by address, so
+// the simulation iterates them in the same order on every run and machine.
+struct CollisionObject2DSWComparator {
+	_FORCE_INLINE_ bool operator()(const CollisionObject2DSW *p_a, const CollisionObject2DSW *p_b) const { return p_a->get_self() < p_b->get_self(); }
+};
+
+class Constraint2DSW;
+
+struct Constraint2DSWComparator {
+	bool operator()(const Constraint2DSW *p_a, const Constraint2DSW *p_b) const;
+};
+
 #endif // COLLISION_OBJECT_2D_SW_H
@@ -43,15 +43,42 @@ class Constraint2DSW {
 
 	RID self;
 
+	// what this constraint connects, used to keep constraints sorted the same way on every run
+	RID order_a;
+	RID order_b;
+	uint64_t order_index;
+
 protected:
 	Constraint2DSW(Body2DSW **p_body_ptr = nullptr, int p_body_count = 0) {
 		_body_ptr = p_body_ptr;
 		_body_count = p_body_count;
 		island_step = 0;
 		disabled_collisions_between_bodies = true;
+		order_index = 0;
+	}
+
+	// must be called before the constraint is added to any body or area
+	_FORCE_INLINE_ void set_order_key(const RID &p_a, const RID &p_b, uint64_t p_index) {
+		order_a = p_a;
+		order_b = p_b;
+		order_index = p_index;
 	}
 
 public:
+	_FORCE_INLINE_ bool is_ordered_before(const Constraint2DSW *p_other) const {
+		if (order_a != p_other->order_a) {
+			return order_a < p_other->order_a;
+		}
+		if (order_b != p_other->order_b) {
+			return order_b < p_other->order_b;
+		}
+		return order_index < p_other->order_index;
+	}
+
+	_FORCE_INLINE_ RID get_order_a() const { return order_a; }
+	_FORCE_INLINE_ RID get_order_b() const { return order_b; }
+	_FORCE_INLINE_ uint64_t get_order_index() const { return order_index; }
+
 	_FORCE_INLINE_ void set_self(const RID &p_self) { self = p_self; }
 	_FORCE_INLINE_ RID get_self() const { return self; }
 
@@ -73,6 +100,11 @@ public:
 	virtual bool setup(real_t p_step) = 0;
 	virtual void solve(real_t p_step) = 0;
 
+	// state carried between steps (such as accumulated impulses), saved in space snapshots
+	virtual int get_snapshot_size() const { return 0; }
+	virtual void save_snapshot(uint8_t *r_data) const {}
+	virtual void load_snapshot(const uint8_t *p_data) {}
+
 	virtual ~Constraint2DSW() {}
 };
 
@@ -55,6 +55,8 @@
  * SOFTWARE.
  */
 
+uint64_t Joint2DSW::order_sequence = 0;
+
 static inline real_t k_scalar(Body2DSW *a, Body2DSW *b, const Vector2 &rA, const Vector2 &rB, const Vector2 &n) {
 	real_t value = 0;
 
@@ -191,6 +193,7 @@ PinJoint2DSW::PinJoint2DSW(const Vector2 &p_pos, Body2DSW *p_body_a, Body2DSW *p
 
 	softness = 0;
 
+	_set_joint_order_key(p_body_a, p_body_b);
 	p_body_a->add_constraint(this, 0);
 	if (p_body_b) {
 		p_body_b->add_constraint(this, 1);
@@ -334,6 +337,7 @@ GrooveJoint2DSW::GrooveJoint2DSW(const Vector2 &p_a_groove1, const Vector2 &p_a_
 	B_anchor = B->get_inv_transform().xform(p_b_anchor);
 	A_groove_normal = -(A_groove_2 - A_groove_1).normalized().tangent();
 
+	_set_joint_order_key(A, B);
 	A->add_constraint(this, 0);
 	B->add_constraint(this, 1);
 }
@@ -431,6 +435,7 @@ DampedSpringJoint2DSW::DampedSpringJoint2DSW(const Vector2 &p_anchor_a, const Ve
 	stiffness = 20;
 	damping = 1.5;
 
+	_set_joint_order_key(A, B);
 	A->add_constraint(this, 0);
 	B->add_constraint(this, 1);
 }
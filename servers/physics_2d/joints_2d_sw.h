@@ -39,6 +39,14 @@ class Joint2DSW : public Constraint2DSW {
 	real_t bias;
 	real_t max_bias;
 
+	static uint64_t order_sequence;
+
+protected:
+	// joints between the same bodies are told apart by creation order
+	_FORCE_INLINE_ void _set_joint_order_key(Body2DSW *p_body_a, Body2DSW *p_body_b) {
+		set_order_key(p_body_a->get_self(), p_body_b ? p_body_b->get_self() : RID(), (uint64_t(1) << 63) | order_sequence++);
+	}
+
 public:
 	_FORCE_INLINE_ void set_max_force(real_t p_force) { max_force = p_force; }
 	_FORCE_INLINE_ real_t get_max_force() const { return max_force; }
@@ -81,6 +89,10 @@ public:
 	virtual bool setup(real_t p_step);
 	virtual void solve(real_t p_step);
 
+	virtual int get_snapshot_size() const { return sizeof(Vector2); }
+	virtual void save_snapshot(uint8_t *r_data) const { memcpy(r_data, &P, sizeof(Vector2)); }
+	virtual void load_snapshot(const uint8_t *p_data) { memcpy(&P, p_data, sizeof(Vector2)); }
+
 	void set_param(PhysicsServer2D::PinJointParam p_param, real_t p_value);
 	real_t get_param(PhysicsServer2D::PinJointParam p_param) const;
 
@@ -118,6 +130,10 @@ public:
 	virtual bool setup(real_t p_step);
 	virtual void solve(real_t p_step);
 
+	virtual int get_snapshot_size() const { return sizeof(Vector2); }
+	virtual void save_snapshot(uint8_t *r_data) const { memcpy(r_data, &jn_acc, sizeof(Vector2)); }
+	virtual void load_snapshot(const uint8_t *p_data) { memcpy(&jn_acc, p_data, sizeof(Vector2)); }
+
 	GrooveJoint2DSW(const Vector2 &p_a_groove1, const Vector2 &p_a_groove2, const Vector2 &p_b_anchor, Body2DSW *p_body_a, Body2DSW *p_body_b);
 	~GrooveJoint2DSW();
 };
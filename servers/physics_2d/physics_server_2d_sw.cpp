@@ -281,6 +281,18 @@ int PhysicsServer2DSW::space_get_contact_count(RID p_space) const {
 	return space->get_debug_contact_count();
 }
 
+Vector<uint8_t> PhysicsServer2DSW::space_save_snapshot(RID p_space) const {
+	Space2DSW *space = space_owner.getornull(p_space);
+	ERR_FAIL_COND_V(!space, Vector<uint8_t>());
+	return space->save_snapshot();
+}
+
+void PhysicsServer2DSW::space_restore_snapshot(RID p_space, const Vector<uint8_t> &p_snapshot) {
+	Space2DSW *space = space_owner.getornull(p_space);
+	ERR_FAIL_COND(!space);
+	space->restore_snapshot(p_snapshot);
+}
+
 PhysicsDirectSpaceState2D *PhysicsServer2DSW::space_get_direct_state(RID p_space) {
 	Space2DSW *space = space_owner.getornull(p_space);
 	ERR_FAIL_COND_V(!space, nullptr);
@@ -532,6 +544,13 @@ void PhysicsServer2DSW::area_set_area_monitor_callback(RID p_area, Object *p_rec
 	area->set_area_monitor_callback(p_receiver ? p_receiver->get_instance_id() : ObjectID(), p_method);
 }
 
+void PhysicsServer2DSW::area_set_monitor_batching(RID p_area, bool p_enable) {
+	Area2DSW *area = area_owner.getornull(p_area);
+	ERR_FAIL_COND(!area);
+
+	area->set_monitor_batching(p_enable);
+}
+
 /* BODY API */
 
 RID PhysicsServer2DSW::body_create() {
@@ -120,6 +120,9 @@ public:
 	virtual Vector<Vector2> space_get_contacts(RID p_space) const;
 	virtual int space_get_contact_count(RID p_space) const;
 
+	virtual Vector<uint8_t> space_save_snapshot(RID p_space) const;
+	virtual void space_restore_snapshot(RID p_space, const Vector<uint8_t> &p_snapshot);
+
 	// this function only works on physics process, errors and returns null otherwise
 	virtual PhysicsDirectSpaceState2D *space_get_direct_state(RID p_space);
 
@@ -163,6 +166,7 @@ public:
 
 	virtual void area_set_monitor_callback(RID p_area, Object *p_receiver, const StringName &p_method);
 	virtual void area_set_area_monitor_callback(RID p_area, Object *p_receiver, const StringName &p_method);
+	virtual void area_set_monitor_batching(RID p_area, bool p_enable);
 
 	virtual void area_set_pickable(RID p_area, bool p_pickable);
 
@@ -38,9 +38,88 @@ void PhysicsServer2DWrapMT::thread_exit() {
 
 void PhysicsServer2DWrapMT::thread_step(real_t p_delta) {
 	physics_2d_server->step(p_delta);
+	_publish_body_transforms();
 	step_sem.post();
 }
 
+void PhysicsServer2DWrapMT::_publish_body_transforms() {
+	// Runs on the server thread, so no set can be applied meanwhile.
+	MutexLock lock(body_transform_mutex);
+	for (Map<RID, BodyTransform>::Element *E = body_transforms.front(); E; E = E->next()) {
+		E->get().transform = physics_2d_server->body_get_state(E->key(), BODY_STATE_TRANSFORM);
+		E->get().published = true;
+	}
+}
+
+void PhysicsServer2DWrapMT::_thread_body_set_state(RID p_body, BodyState p_state, const Variant &p_value, bool p_pending) {
+	physics_2d_server->body_set_state(p_body, p_state, p_value);
+
+	if (p_state != BODY_STATE_TRANSFORM) {
+		return;
+	}
+
+	MutexLock lock(body_transform_mutex);
+	Map<RID, BodyTransform>::Element *E = body_transforms.find(p_body);
+	if (!E) {
+		return;
+	}
+	E->get().transform = physics_2d_server->body_get_state(p_body, BODY_STATE_TRANSFORM);
+	if (p_pending) {
+		E->get().pending_sets--;
+	}
+}
+
+void PhysicsServer2DWrapMT::body_set_state(RID p_body, BodyState p_state, const Variant &p_value) {
+	if (Thread::get_caller_id() != server_thread) {
+		bool pending = false;
+		if (p_state == BODY_STATE_TRANSFORM) {
+			MutexLock lock(body_transform_mutex);
+			Map<RID, BodyTransform>::Element *E = body_transforms.find(p_body);
+			if (E) {
+				E->get().pending_sets++;
+				pending = true;
+			}
+		}
+		command_queue.push(this, &PhysicsServer2DWrapMT::_thread_body_set_state, p_body, p_state, p_value, pending);
+	} else {
+		_thread_body_set_state(p_body, p_state, p_value, false);
+	}
+}
+
+Variant PhysicsServer2DWrapMT::body_get_state(RID p_body, BodyState p_state) const {
+	if (Thread::get_caller_id() == server_thread) {
+		return physics_2d_server->body_get_state(p_body, p_state);
+	}
+
+	if (p_state == BODY_STATE_TRANSFORM) {
+		MutexLock lock(body_transform_mutex);
+		Map<RID, BodyTransform>::Element *E = body_transforms.find(p_body);
+		if (!E) {
+			// Start tracking it; it's published from the next step on.
+			body_transforms.insert(p_body, BodyTransform());
+		} else if (E->get().published && E->get().pending_sets == 0) {
+			return E->get().transform;
+		}
+	}
+
+	Variant ret;
+	command_queue.push_and_ret(physics_2d_server, &PhysicsServer2D::body_get_state, p_body, p_state, &ret);
+	return ret;
+}
+
+void PhysicsServer2DWrapMT::free(RID p_rid) {
+	{
+		MutexLock lock(body_transform_mutex);
+		body_transforms.erase(p_rid);
+	}
+
+	if (Thread::get_caller_id() != server_thread) {
+		command_queue.push(physics_2d_server, &PhysicsServer2D::free, p_rid);
+	} else {
+		physics_2d_server->free(p_rid);
+	}
+}
+
 void PhysicsServer2DWrapMT::_thread_callback(void *_instance) {
 	PhysicsServer2DWrapMT *vsmt = reinterpret_cast<PhysicsServer2DWrapMT *>(_instance);
 
@@ -72,6 +151,7 @@ void PhysicsServer2DWrapMT::step(real_t p_step) {
 	} else {
 		command_queue.flush_all(); //flush all pending from other threads
 		physics_2d_server->step(p_step);
+		_publish_body_transforms();
 	}
 }
 
@@ -88,6 +168,13 @@ void PhysicsServer2DWrapMT::sync() {
 
 void PhysicsServer2DWrapMT::flush_queries() {
 	physics_2d_server->flush_queries();
+	// Force integration callbacks run from here, and may have moved bodies
+	// through their direct state, which bypasses body_set_state().
+	if (create_thread) {
+		command_queue.push(this, &PhysicsServer2DWrapMT::_publish_body_transforms);
+	} else {
+		_publish_body_transforms();
+	}
 }
 
 void PhysicsServer2DWrapMT::end_sync() {
@@ -32,6 +32,7 @@
 #define PHYSICS2DSERVERWRAPMT_H
 
 #include "core/command_queue_mt.h"
+#include "core/map.h"
 #include "core/os/thread.h"
 #include "core/project_settings.h"
 #include "servers/physics_server_2d.h"
@@ -66,6 +67,23 @@ class PhysicsServer2DWrapMT : public PhysicsServer2D {
 
 	bool first_frame;
 
+	// Body transforms are published after each step, so that other threads
+	// can read them without waiting on the server thread. A body is tracked
+	// once its transform is read from outside the server thread; while a set
+	// of its transform is still queued, reads fall back to a synchronous call.
+	// They are published again after flush_queries(), as force integration
+	// callbacks write them through the direct body state.
+	struct BodyTransform {
+		Transform2D transform;
+		bool published = false;
+		int pending_sets = 0;
+	};
+
+	mutable Mutex body_transform_mutex;
+	mutable Map<RID, BodyTransform> body_transforms;
+	void _publish_body_transforms();
+	void _thread_body_set_state(RID p_body, BodyState p_state, const Variant &p_value, bool p_pending);
+
 	Mutex alloc_mutex;
 	int pool_max_size;
 
@@ -124,6 +142,9 @@ public:
 		return physics_2d_server->space_get_contact_count(p_space);
 	}
 
+	FUNC1RC(Vector<uint8_t>, space_save_snapshot, RID);
+	FUNC2(space_restore_snapshot, RID, const Vector<uint8_t> &);
+
 	/* AREA API */
 
 	//FUNC0RID(area);
@@ -166,6 +187,7 @@ public:
 
 	FUNC3(area_set_monitor_callback, RID, Object *, const StringName &);
 	FUNC3(area_set_area_monitor_callback, RID, Object *, const StringName &);
+	FUNC2(area_set_monitor_batching, RID, bool);
 
 	/* BODY API */
 
@@ -212,8 +234,8 @@ public:
 	FUNC3(body_set_param, RID, BodyParameter, real_t);
 	FUNC2RC(real_t, body_get_param, RID, BodyParameter);
 
-	FUNC3(body_set_state, RID, BodyState, const Variant &);
-	FUNC2RC(Variant, body_get_state, RID, BodyState);
+	virtual void body_set_state(RID p_body, BodyState p_state, const Variant &p_value);
+	virtual Variant body_get_state(RID p_body, BodyState p_state) const;
 
 	FUNC2(body_set_applied_force, RID, const Vector2 &);
 	FUNC1RC(Vector2, body_get_applied_force, RID);
@@ -294,7 +316,7 @@ public:
 
 	/* MISC */
 
-	FUNC1(free, RID);
+	virtual void free(RID p_rid);
 	FUNC1(set_active, bool);
 
 	virtual void init();
@@ -33,6 +33,7 @@
 #include "collision_solver_2d_sw.h"
 #include "core/os/os.h"
 #include "core/pair.h"
+#include "constraint_2d_sw.h"
 #include "physics_server_2d_sw.h"
 _FORCE_INLINE_ static bool _can_collide_with(CollisionObject2DSW *p_object, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas) {
 	if (!(p_object->get_collision_layer() & p_collision_mask)) {
@@ -1191,10 +1192,258 @@ void Space2DSW::remove_object(CollisionObject2DSW *p_object) {
 	objects.erase(p_object);
 }
 
-const Set<CollisionObject2DSW *> &Space2DSW::get_objects() const {
+const Set<CollisionObject2DSW *, CollisionObject2DSWComparator> &Space2DSW::get_objects() const {
 	return objects;
 }
 
+/* SNAPSHOTS */
+
+// Snapshot layout, everything in native byte order (snapshots are not meant to leave the machine):
+//  header: magic, body count, active body count, constraint count
+//  bodies, sorted by RID: RID id, Body2DSW::Snapshot
+//  active bodies, in active list order: RID id
+//  constraints with state, in constraint order: order key, data size, data
+
+#define SPACE_2D_SNAPSHOT_MAGIC 0x50533244 // "PS2D"
+
+struct _Space2DSnapshotHeader {
+	uint32_t magic;
+	uint32_t body_count;
+	uint32_t active_count;
+	uint32_t constraint_count;
+};
+
+struct _Space2DSnapshotConstraint {
+	uint64_t order_a;
+	uint64_t order_b;
+	uint64_t order_index;
+	uint32_t size;
+};
+
+Vector<uint8_t> Space2DSW::save_snapshot() const {
+	ERR_FAIL_COND_V_MSG(locked, Vector<uint8_t>(), "Can't save a snapshot of a space while it's being stepped.");
+
+	_Space2DSnapshotHeader header;
+	header.magic = SPACE_2D_SNAPSHOT_MAGIC;
+	header.body_count = 0;
+	header.active_count = 0;
+	header.constraint_count = 0;
+
+	int size = sizeof(_Space2DSnapshotHeader);
+
+	// first pass, measure
+	for (const Set<CollisionObject2DSW *, CollisionObject2DSWComparator>::Element *E = objects.front(); E; E = E->next()) {
+		if (E->get()->get_type() != CollisionObject2DSW::TYPE_BODY) {
+			continue;
+		}
+		const Body2DSW *body = static_cast<const Body2DSW *>(E->get());
+
+		header.body_count++;
+		size += sizeof(uint64_t) + sizeof(Body2DSW::Snapshot);
+
+		for (const Map<Constraint2DSW *, int, Constraint2DSWComparator>::Element *F = body->get_constraint_map().front(); F; F = F->next()) {
+			// constraints are saved once, from their first body
+			if (F->get() != 0 || F->key()->get_snapshot_size() == 0) {
+				continue;
+			}
+			header.constraint_count++;
+			size += sizeof(_Space2DSnapshotConstraint) + F->key()->get_snapshot_size();
+		}
+	}
+
+	for (const SelfList<Body2DSW> *B = active_list.first(); B; B = B->next()) {
+		header.active_count++;
+	}
+	size += header.active_count * sizeof(uint64_t);
+
+	Vector<uint8_t> snapshot;
+	snapshot.resize(size);
+	uint8_t *w = snapshot.ptrw();
+
+	memcpy(w, &header, sizeof(_Space2DSnapshotHeader));
+	w += sizeof(_Space2DSnapshotHeader);
+
+	// second pass, write
+	for (const Set<CollisionObject2DSW *, CollisionObject2DSWComparator>::Element *E = objects.front(); E; E = E->next()) {
+		if (E->get()->get_type() != CollisionObject2DSW::TYPE_BODY) {
+			continue;
+		}
+		const Body2DSW *body = static_cast<const Body2DSW *>(E->get());
+
+		uint64_t id = body->get_self().get_id();
+		memcpy(w, &id, sizeof(uint64_t));
+		w += sizeof(uint64_t);
+
+		Body2DSW::Snapshot body_snapshot;
+		body->save_snapshot(body_snapshot);
+		memcpy(w, &body_snapshot, sizeof(Body2DSW::Snapshot));
+		w += sizeof(Body2DSW::Snapshot);
+	}
+
+	for (const SelfList<Body2DSW> *B = active_list.first(); B; B = B->next()) {
+		uint64_t id = B->self()->get_self().get_id();
+		memcpy(w, &id, sizeof(uint64_t));
+		w += sizeof(uint64_t);
+	}
+
+	for (const Set<CollisionObject2DSW *, CollisionObject2DSWComparator>::Element *E = objects.front(); E; E = E->next()) {
+		if (E->get()->get_type() != CollisionObject2DSW::TYPE_BODY) {
+			continue;
+		}
+		const Body2DSW *body = static_cast<const Body2DSW *>(E->get());
+
+		for (const Map<Constraint2DSW *, int, Constraint2DSWComparator>::Element *F = body->get_constraint_map().front(); F; F = F->next()) {
+			const Constraint2DSW *constraint = F->key();
+			if (F->get() != 0 || constraint->get_snapshot_size() == 0) {
+				continue;
+			}
+
+			_Space2DSnapshotConstraint record;
+			record.order_a = constraint->get_order_a().get_id();
+			record.order_b = constraint->get_order_b().get_id();
+			record.order_index = constraint->get_order_index();
+			record.size = constraint->get_snapshot_size();
+			memcpy(w, &record, sizeof(_Space2DSnapshotConstraint));
+			w += sizeof(_Space2DSnapshotConstraint);
+
+			constraint->save_snapshot(w);
+			w += record.size;
+		}
+	}
+
+	return snapshot;
+}
+
+void Space2DSW::restore_snapshot(const Vector<uint8_t> &p_snapshot) {
+	ERR_FAIL_COND_MSG(locked, "Can't restore a snapshot of a space while it's being stepped.");
+	ERR_FAIL_COND(p_snapshot.size() < (int)sizeof(_Space2DSnapshotHeader));
+
+	const uint8_t *r = p_snapshot.ptr();
+	const uint8_t *end = r + p_snapshot.size();
+
+	_Space2DSnapshotHeader header;
+	memcpy(&header, r, sizeof(_Space2DSnapshotHeader));
+	r += sizeof(_Space2DSnapshotHeader);
+
+	ERR_FAIL_COND_MSG(header.magic != SPACE_2D_SNAPSHOT_MAGIC, "Invalid 2D space snapshot.");
+	ERR_FAIL_COND(r + header.body_count * (sizeof(uint64_t) + sizeof(Body2DSW::Snapshot)) + header.active_count * sizeof(uint64_t) > end);
+
+	// bodies, both the records and the object set are sorted by RID, so they are merged in a single pass
+	Vector<Body2DSW *> bodies;
+	bodies.resize(header.body_count);
+	Body2DSW **bodiesw = bodies.ptrw();
+	Vector<uint64_t> body_ids;
+	body_ids.resize(header.body_count);
+	uint64_t *body_idsw = body_ids.ptrw();
+
+	Set<CollisionObject2DSW *, CollisionObject2DSWComparator>::Element *E = objects.front();
+
+	for (uint32_t i = 0; i < header.body_count; i++) {
+		uint64_t id;
+		memcpy(&id, r, sizeof(uint64_t));
+		r += sizeof(uint64_t);
+		body_idsw[i] = id;
+
+		while (E && (E->get()->get_type() != CollisionObject2DSW::TYPE_BODY || E->get()->get_self().get_id() < id)) {
+			E = E->next();
+		}
+
+		if (E && E->get()->get_self().get_id() == id) {
+			Body2DSW::Snapshot body_snapshot;
+			memcpy(&body_snapshot, r, sizeof(Body2DSW::Snapshot));
+			bodiesw[i] = static_cast<Body2DSW *>(E->get());
+			bodiesw[i]->load_snapshot(body_snapshot);
+		} else {
+			bodiesw[i] = nullptr; // removed since the snapshot was taken
+		}
+
+		r += sizeof(Body2DSW::Snapshot);
+	}
+
+	// the active list decides in which order islands are built, so it's restored exactly
+	while (active_list.first()) {
+		active_list.first()->self()->set_active(false);
+	}
+
+	for (int i = int(header.active_count) - 1; i >= 0; i--) {
+		uint64_t id;
+		memcpy(&id, r + i * sizeof(uint64_t), sizeof(uint64_t));
+
+		// body records are sorted by id
+		int index = -1;
+		int low = 0;
+		int high = int(header.body_count) - 1;
+		while (low <= high) {
+			int middle = (low + high) / 2;
+			if (body_idsw[middle] == id) {
+				index = middle;
+				break;
+			} else if (body_idsw[middle] < id) {
+				low = middle + 1;
+			} else {
+				high = middle - 1;
+			}
+		}
+
+		if (index != -1 && bodiesw[index]) {
+			bodiesw[index]->set_active(true); // adds to the front of the list
+		}
+	}
+	r += header.active_count * sizeof(uint64_t);
+
+	// moving the bodies above updated the broadphase, so the same constraints exist again and
+	// can be matched with the records (both sorted by constraint order)
+	uint32_t constraint_index = 0;
+	_Space2DSnapshotConstraint record;
+	bool has_record = false;
+
+	for (E = objects.front(); E; E = E->next()) {
+		if (E->get()->get_type() != CollisionObject2DSW::TYPE_BODY) {
+			continue;
+		}
+		Body2DSW *body = static_cast<Body2DSW *>(E->get());
+
+		for (const Map<Constraint2DSW *, int, Constraint2DSWComparator>::Element *F = body->get_constraint_map().front(); F; F = F->next()) {
+			Constraint2DSW *constraint = F->key();
+			if (F->get() != 0 || constraint->get_snapshot_size() == 0) {
+				continue;
+			}
+
+			while (true) {
+				if (!has_record) {
+					if (constraint_index == header.constraint_count) {
+						break;
+					}
+					ERR_FAIL_COND(r + sizeof(_Space2DSnapshotConstraint) > end);
+					memcpy(&record, r, sizeof(_Space2DSnapshotConstraint));
+					r += sizeof(_Space2DSnapshotConstraint);
+					ERR_FAIL_COND(r + record.size > end);
+					constraint_index++;
+					has_record = true;
+				}
+
+				uint64_t a = constraint->get_order_a().get_id();
+				uint64_t b = constraint->get_order_b().get_id();
+				uint64_t index = constraint->get_order_index();
+
+				if (record.order_a < a || (record.order_a == a && (record.order_b < b || (record.order_b == b && record.order_index < index)))) {
+					// constraint no longer exists, skip its record
+					r += record.size;
+					has_record = false;
+					continue;
+				}
+
+				if (record.order_a == a && record.order_b == b && record.order_index == index && record.size == (uint32_t)constraint->get_snapshot_size()) {
+					constraint->load_snapshot(r);
+					r += record.size;
+					has_record = false;
+				}
+				break;
+			}
+		}
+	}
+}
+
 void Space2DSW::body_add_to_state_query_list(SelfList<Body2DSW> *p_body) {
 	state_query_list.add(p_body);
 }
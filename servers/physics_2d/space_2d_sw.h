@@ -94,7 +94,7 @@ private:
 	static void *_broadphase_pair(CollisionObject2DSW *A, int p_subindex_A, CollisionObject2DSW *B, int p_subindex_B, void *p_self);
 	static void _broadphase_unpair(CollisionObject2DSW *A, int p_subindex_A, CollisionObject2DSW *B, int p_subindex_B, void *p_data, void *p_self);
 
-	Set<CollisionObject2DSW *> objects;
+	Set<CollisionObject2DSW *, CollisionObject2DSWComparator> objects;
 
 	Area2DSW *area;
 
@@ -155,7 +155,10 @@ public:
 
 	void add_object(CollisionObject2DSW *p_object);
 	void remove_object(CollisionObject2DSW *p_object);
-	const Set<CollisionObject2DSW *> &get_objects() const;
+	const Set<CollisionObject2DSW *, CollisionObject2DSWComparator> &get_objects() const;
+
+	Vector<uint8_t> save_snapshot() const;
+	void restore_snapshot(const Vector<uint8_t> &p_snapshot);
 
 	_FORCE_INLINE_ real_t get_contact_recycle_radius() const { return contact_recycle_radius; }
 	_FORCE_INLINE_ real_t get_contact_max_separation() const { return contact_max_separation; }
@@ -36,7 +36,7 @@ void Step2DSW::_populate_island(Body2DSW *p_body, Body2DSW **p_island, Constrain
 	p_body->set_island_next(*p_island);
 	*p_island = p_body;
 
-	for (Map<Constraint2DSW *, int>::Element *E = p_body->get_constraint_map().front(); E; E = E->next()) {
+	for (const Map<Constraint2DSW *, int, Constraint2DSWComparator>::Element *E = p_body->get_constraint_map().front(); E; E = E->next()) {
 		Constraint2DSW *c = (Constraint2DSW *)E->key();
 		if (c->get_island_step() == _step) {
 			continue; //already processed
@@ -190,7 +190,7 @@ void Step2DSW::step(Space2DSW *p_space, real_t p_delta, int p_iterations) {
 	const SelfList<Area2DSW>::List &aml = p_space->get_moved_area_list();
 
 	while (aml.first()) {
-		for (const Set<Constraint2DSW *>::Element *E = aml.first()->self()->get_constraints().front(); E; E = E->next()) {
+		for (const Set<Constraint2DSW *, Constraint2DSWComparator>::Element *E = aml.first()->self()->get_constraints().front(); E; E = E->next()) {
 			Constraint2DSW *c = E->get();
 			if (c->get_island_step() == _step) {
 				continue;
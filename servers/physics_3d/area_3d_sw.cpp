@@ -198,14 +198,62 @@ void Area3DSW::set_monitorable(bool p_monitorable) {
 	_set_static(!monitorable);
 }
 
-void Area3DSW::call_queries() {
-	if (monitor_callback_id.is_valid() && !monitored_bodies.empty()) {
-		Variant res[5];
-		Variant *resptr[5];
-		for (int i = 0; i < 5; i++) {
-			resptr[i] = &res[i];
+void Area3DSW::_call_monitor_batch(const Map<BodyKey, BodyState> &p_monitored, int p_changes, Object *p_obj, const StringName &p_method) {
+	PackedInt32Array statuses;
+	Array rids;
+	PackedInt64Array instance_ids;
+	PackedInt32Array body_shapes;
+	PackedInt32Array area_shapes;
+
+	statuses.resize(p_changes);
+	rids.resize(p_changes);
+	instance_ids.resize(p_changes);
+	body_shapes.resize(p_changes);
+	area_shapes.resize(p_changes);
+
+	int32_t *statuses_w = statuses.ptrw();
+	int64_t *instance_ids_w = instance_ids.ptrw();
+	int32_t *body_shapes_w = body_shapes.ptrw();
+	int32_t *area_shapes_w = area_shapes.ptrw();
+
+	int idx = 0;
+	for (const Map<BodyKey, BodyState>::Element *E = p_monitored.front(); E; E = E->next()) {
+		if (E->get().state == 0) {
+			continue; //nothing happened
+		}
+
+		statuses_w[idx] = E->get().state > 0 ? PhysicsServer3D::AREA_BODY_ADDED : PhysicsServer3D::AREA_BODY_REMOVED;
+		rids[idx] = E->key().rid;
+		instance_ids_w[idx] = E->key().instance_id;
+		body_shapes_w[idx] = E->key().body_shape;
+		area_shapes_w[idx] = E->key().area_shape;
+		idx++;
+	}
+
+	Variant res[5] = { statuses, rids, instance_ids, body_shapes, area_shapes };
+	const Variant *resptr[5];
+	for (int i = 0; i < 5; i++) {
+		resptr[i] = &res[i];
+	}
+
+	Callable::CallError ce;
+	p_obj->call(p_method, resptr, 5, ce);
+}
+
+int Area3DSW::_count_monitor_changes(const Map<BodyKey, BodyState> &p_monitored) {
+	int changes = 0;
+	for (const Map<BodyKey, BodyState>::Element *E = p_monitored.front(); E; E = E->next()) {
+		if (E->get().state != 0) {
+			changes++;
 		}
+	}
+	return changes;
+}
 
+void Area3DSW::call_queries() {
+	// entries that entered and exited during the same step cancel out, only report actual changes
+	int changes = monitor_callback_id.is_valid() ? _count_monitor_changes(monitored_bodies) : 0;
+	if (changes > 0) {
 		Object *obj = ObjectDB::get_instance(monitor_callback_id);
 		if (!obj) {
 			monitored_bodies.clear();
@@ -213,31 +261,36 @@ void Area3DSW::call_queries() {
 			return;
 		}
 
-		for (Map<BodyKey, BodyState>::Element *E = monitored_bodies.front(); E; E = E->next()) {
-			if (E->get().state == 0) {
-				continue; //nothing happened
+		if (monitor_batching) {
+			_call_monitor_batch(monitored_bodies, changes, obj, monitor_callback_method);
+		} else {
+			Variant res[5];
+			Variant *resptr[5];
+			for (int i = 0; i < 5; i++) {
+				resptr[i] = &res[i];
 			}
 
-			res[0] = E->get().state > 0 ? PhysicsServer3D::AREA_BODY_ADDED : PhysicsServer3D::AREA_BODY_REMOVED;
-			res[1] = E->key().rid;
-			res[2] = E->key().instance_id;
-			res[3] = E->key().body_shape;
-			res[4] = E->key().area_shape;
+			for (Map<BodyKey, BodyState>::Element *E = monitored_bodies.front(); E; E = E->next()) {
+				if (E->get().state == 0) {
+					continue; //nothing happened
+				}
 
-			Callable::CallError ce;
-			obj->call(monitor_callback_method, (const Variant **)resptr, 5, ce);
+				res[0] = E->get().state > 0 ? PhysicsServer3D::AREA_BODY_ADDED : PhysicsServer3D::AREA_BODY_REMOVED;
+				res[1] = E->key().rid;
+				res[2] = E->key().instance_id;
+				res[3] = E->key().body_shape;
+				res[4] = E->key().area_shape;
+
+				Callable::CallError ce;
+				obj->call(monitor_callback_method, (const Variant **)resptr, 5, ce);
+			}
 		}
 	}
 
 	monitored_bodies.clear();
 
-	if (area_monitor_callback_id.is_valid() && !monitored_areas.empty()) {
-		Variant res[5];
-		Variant *resptr[5];
-		for (int i = 0; i < 5; i++) {
-			resptr[i] = &res[i];
-		}
-
+	changes = area_monitor_callback_id.is_valid() ? _count_monitor_changes(monitored_areas) : 0;
+	if (changes > 0) {
 		Object *obj = ObjectDB::get_instance(area_monitor_callback_id);
 		if (!obj) {
 			monitored_areas.clear();
@@ -245,19 +298,29 @@ void Area3DSW::call_queries() {
 			return;
 		}
 
-		for (Map<BodyKey, BodyState>::Element *E = monitored_areas.front(); E; E = E->next()) {
-			if (E->get().state == 0) {
-				continue; //nothing happened
+		if (monitor_batching) {
+			_call_monitor_batch(monitored_areas, changes, obj, area_monitor_callback_method);
+		} else {
+			Variant res[5];
+			Variant *resptr[5];
+			for (int i = 0; i < 5; i++) {
+				resptr[i] = &res[i];
 			}
 
-			res[0] = E->get().state > 0 ? PhysicsServer3D::AREA_BODY_ADDED : PhysicsServer3D::AREA_BODY_REMOVED;
-			res[1] = E->key().rid;
-			res[2] = E->key().instance_id;
-			res[3] = E->key().body_shape;
-			res[4] = E->key().area_shape;
+			for (Map<BodyKey, BodyState>::Element *E = monitored_areas.front(); E; E = E->next()) {
+				if (E->get().state == 0) {
+					continue; //nothing happened
+				}
 
-			Callable::CallError ce;
-			obj->call(area_monitor_callback_method, (const Variant **)resptr, 5, ce);
+				res[0] = E->get().state > 0 ? PhysicsServer3D::AREA_BODY_ADDED : PhysicsServer3D::AREA_BODY_REMOVED;
+				res[1] = E->key().rid;
+				res[2] = E->key().instance_id;
+				res[3] = E->key().body_shape;
+				res[4] = E->key().area_shape;
+
+				Callable::CallError ce;
+				obj->call(area_monitor_callback_method, (const Variant **)resptr, 5, ce);
+			}
 		}
 	}
 
@@ -279,6 +342,7 @@ Area3DSW::Area3DSW() :
 	angular_damp = 0.1;
 	linear_damp = 0.1;
 	priority = 0;
+	monitor_batching = false;
 	set_ray_pickable(false);
 	monitorable = false;
 }
@@ -58,6 +58,8 @@ class Area3DSW : public CollisionObject3DSW {
 	ObjectID area_monitor_callback_id;
 	StringName area_monitor_callback_method;
 
+	bool monitor_batching;
+
 	SelfList<Area3DSW> monitor_query_list;
 	SelfList<Area3DSW> moved_list;
 
@@ -101,6 +103,8 @@ class Area3DSW : public CollisionObject3DSW {
 
 	virtual void _shapes_changed();
 	void _queue_monitor_update();
+	static int _count_monitor_changes(const Map<BodyKey, BodyState> &p_monitored);
+	void _call_monitor_batch(const Map<BodyKey, BodyState> &p_monitored, int p_changes, Object *p_obj, const StringName &p_method);
 
 public:
 	//_FORCE_INLINE_ const Transform& get_inverse_transform() const { return inverse_transform; }
@@ -112,6 +116,12 @@ public:
 	void set_area_monitor_callback(ObjectID p_id, const StringName &p_method);
 	_FORCE_INLINE_ bool has_area_monitor_callback() const { return area_monitor_callback_id.is_valid(); }
 
+	_FORCE_INLINE_ void set_monitor_batching(bool p_enable) { monitor_batching = p_enable; }
+	_FORCE_INLINE_ bool is_monitor_batching() const { return monitor_batching; }
+
+	// true when overlaps with this area have no effect, so pairs don't need to be tested
+	_FORCE_INLINE_ bool is_inert() const { return !monitor_callback_id.is_valid() && space_override_mode == PhysicsServer3D::AREA_SPACE_OVERRIDE_DISABLED; }
+
 	_FORCE_INLINE_ void add_body_to_query(Body3DSW *p_body, uint32_t p_body_shape, uint32_t p_area_shape);
 	_FORCE_INLINE_ void remove_body_from_query(Body3DSW *p_body, uint32_t p_body_shape, uint32_t p_area_shape);
 
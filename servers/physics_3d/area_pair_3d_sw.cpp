@@ -32,6 +32,11 @@
 #include "collision_solver_3d_sw.h"
 
 bool AreaPair3DSW::setup(real_t p_step) {
+	if (area->is_inert()) {
+		// nothing reacts to this overlap, and the pair is recreated if that changes
+		return false;
+	}
+
 	bool result = false;
 
 	if (area->is_shape_set_as_disabled(area_shape) || body->is_shape_set_as_disabled(body_shape)) {
@@ -96,6 +101,10 @@ AreaPair3DSW::~AreaPair3DSW() {
 ////////////////////////////////////////////////////
 
 bool Area2Pair3DSW::setup(real_t p_step) {
+	if (!area_a->has_area_monitor_callback() && !area_b->has_area_monitor_callback()) {
+		return false;
+	}
+
 	bool result = false;
 	if (area_a->is_shape_set_as_disabled(shape_a) || area_b->is_shape_set_as_disabled(shape_b)) {
 		result = false;
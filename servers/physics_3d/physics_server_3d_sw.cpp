@@ -427,6 +427,13 @@ void PhysicsServer3DSW::area_set_area_monitor_callback(RID p_area, Object *p_rec
 	area->set_area_monitor_callback(p_receiver ? p_receiver->get_instance_id() : ObjectID(), p_method);
 }
 
+void PhysicsServer3DSW::area_set_monitor_batching(RID p_area, bool p_enable) {
+	Area3DSW *area = area_owner.getornull(p_area);
+	ERR_FAIL_COND(!area);
+
+	area->set_monitor_batching(p_enable);
+}
+
 /* BODY API */
 
 RID PhysicsServer3DSW::body_create(BodyMode p_mode, bool p_init_sleeping) {
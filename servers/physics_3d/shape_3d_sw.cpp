@@ -30,6 +30,7 @@
 
 #include "shape_3d_sw.h"
 
+#include "core/hash_map.h"
 #include "core/math/geometry_3d.h"
 #include "core/math/quick_hull.h"
 #include "core/sort_array.h"
@@ -1074,52 +1075,10 @@ Vector3 ConcavePolygonShape3DSW::get_support(const Vector3 &p_normal) const {
 	return vptr[vert_support_idx];
 }
 
-void ConcavePolygonShape3DSW::_cull_segment(int p_idx, _SegmentCullParams *p_params) const {
-	const BVH *bvh = &p_params->bvh[p_idx];
-
-	/*
-	if (p_params->dir.dot(bvh->aabb.get_support(-p_params->dir))>p_params->min_d)
-		return; //test against whole AABB, which isn't very costly
-	*/
-
-	//printf("addr: %p\n",bvh);
-	if (!bvh->aabb.intersects_segment(p_params->from, p_params->to)) {
-		return;
-	}
-
-	if (bvh->face_index >= 0) {
-		Vector3 res;
-		Vector3 vertices[3] = {
-			p_params->vertices[p_params->faces[bvh->face_index].indices[0]],
-			p_params->vertices[p_params->faces[bvh->face_index].indices[1]],
-			p_params->vertices[p_params->faces[bvh->face_index].indices[2]]
-		};
-
-		if (Geometry3D::segment_intersects_triangle(
-					p_params->from,
-					p_params->to,
-					vertices[0],
-					vertices[1],
-					vertices[2],
-					&res)) {
-			real_t d = p_params->dir.dot(res) - p_params->dir.dot(p_params->from);
-			//TODO, seems segmen/triangle intersection is broken :(
-			if (d > 0 && d < p_params->min_d) {
-				p_params->min_d = d;
-				p_params->result = res;
-				p_params->normal = Plane(vertices[0], vertices[1], vertices[2]).normal;
-				p_params->collisions++;
-			}
-		}
-
-	} else {
-		if (bvh->left >= 0) {
-			_cull_segment(bvh->left, p_params);
-		}
-		if (bvh->right >= 0) {
-			_cull_segment(bvh->right, p_params);
-		}
-	}
+static _FORCE_INLINE_ bool _bvh_overlaps(const ConcavePolygonShape3DSW::BVH &p_node, const uint16_t *p_min, const uint16_t *p_max) {
+	return p_node.min[0] <= p_max[0] && p_node.max[0] >= p_min[0] &&
+		   p_node.min[1] <= p_max[1] && p_node.max[1] >= p_min[1] &&
+		   p_node.min[2] <= p_max[2] && p_node.max[2] >= p_min[2];
 }
 
 bool ConcavePolygonShape3DSW::intersect_segment(const Vector3 &p_begin, const Vector3 &p_end, Vector3 &r_result, Vector3 &r_normal) const {
@@ -1131,28 +1090,49 @@ bool ConcavePolygonShape3DSW::intersect_segment(const Vector3 &p_begin, const Ve
 	const Face *fr = faces.ptr();
 	const Vector3 *vr = vertices.ptr();
 	const BVH *br = bvh.ptr();
+	const int node_count = bvh.size();
 
-	_SegmentCullParams params;
-	params.from = p_begin;
-	params.to = p_end;
-	params.collisions = 0;
-	params.dir = (p_end - p_begin).normalized();
+	// the segment AABB is used for a cheap reject in quantized space before the slab test
+	AABB segment_aabb(p_begin, Vector3());
+	segment_aabb.expand_to(p_end);
+	uint16_t qmin[3], qmax[3];
+	_quantize(segment_aabb.position, qmin, false);
+	_quantize(segment_aabb.position + segment_aabb.size, qmax, true);
 
-	params.faces = fr;
-	params.vertices = vr;
-	params.bvh = br;
+	Vector3 dir = (p_end - p_begin).normalized();
+	real_t from_d = dir.dot(p_begin);
+	real_t min_d = 1e20;
+	int collisions = 0;
 
-	params.min_d = 1e20;
-	// cull
-	_cull_segment(0, &params);
+	int idx = 0;
+	while (idx < node_count) {
+		const BVH &node = br[idx];
+		const bool leaf = node.face_or_escape >= 0;
 
-	if (params.collisions > 0) {
-		r_result = params.result;
-		r_normal = params.normal;
-		return true;
-	} else {
-		return false;
+		if (!_bvh_overlaps(node, qmin, qmax) || (!leaf && !_dequantize(node).intersects_segment(p_begin, p_end))) {
+			idx += leaf ? 1 : -node.face_or_escape;
+			continue;
+		}
+
+		if (leaf) {
+			const Face &f = fr[node.face_or_escape];
+			Vector3 res;
+			if (Geometry3D::segment_intersects_triangle(p_begin, p_end, vr[f.indices[0]], vr[f.indices[1]], vr[f.indices[2]], &res)) {
+				real_t d = dir.dot(res) - from_d;
+				//TODO, seems segmen/triangle intersection is broken :(
+				if (d > 0 && d < min_d) {
+					min_d = d;
+					r_result = res;
+					r_normal = f.normal;
+					collisions++;
+				}
+			}
+		}
+
+		idx++;
 	}
+
+	return collisions > 0;
 }
 
 bool ConcavePolygonShape3DSW::intersect_point(const Vector3 &p_point) const {
@@ -1163,59 +1143,49 @@ Vector3 ConcavePolygonShape3DSW::get_closest_point_to(const Vector3 &p_point) co
 	return Vector3();
 }
 
-void ConcavePolygonShape3DSW::_cull(int p_idx, _CullParams *p_params) const {
-	const BVH *bvh = &p_params->bvh[p_idx];
-
-	if (!p_params->aabb.intersects(bvh->aabb)) {
-		return;
-	}
-
-	if (bvh->face_index >= 0) {
-		const Face *f = &p_params->faces[bvh->face_index];
-		FaceShape3DSW *face = p_params->face;
-		face->normal = f->normal;
-		face->vertex[0] = p_params->vertices[f->indices[0]];
-		face->vertex[1] = p_params->vertices[f->indices[1]];
-		face->vertex[2] = p_params->vertices[f->indices[2]];
-		p_params->callback(p_params->userdata, face);
-
-	} else {
-		if (bvh->left >= 0) {
-			_cull(bvh->left, p_params);
-		}
-
-		if (bvh->right >= 0) {
-			_cull(bvh->right, p_params);
-		}
-	}
-}
-
 void ConcavePolygonShape3DSW::cull(const AABB &p_local_aabb, Callback p_callback, void *p_userdata) const {
 	// make matrix local to concave
 	if (faces.size() == 0) {
 		return;
 	}
 
-	AABB local_aabb = p_local_aabb;
+	if (!get_aabb().intersects(p_local_aabb)) {
+		return;
+	}
 
 	// unlock data
 	const Face *fr = faces.ptr();
 	const Vector3 *vr = vertices.ptr();
 	const BVH *br = bvh.ptr();
+	const int node_count = bvh.size();
+
+	uint16_t qmin[3], qmax[3];
+	_quantize(p_local_aabb.position, qmin, false);
+	_quantize(p_local_aabb.position + p_local_aabb.size, qmax, true);
 
 	FaceShape3DSW face; // use this to send in the callback
 
-	_CullParams params;
-	params.aabb = local_aabb;
-	params.face = &face;
-	params.faces = fr;
-	params.vertices = vr;
-	params.bvh = br;
-	params.callback = p_callback;
-	params.userdata = p_userdata;
+	int idx = 0;
+	while (idx < node_count) {
+		const BVH &node = br[idx];
+
+		if (node.face_or_escape < 0) {
+			// branch, skip the whole subtree when not overlapping
+			idx += _bvh_overlaps(node, qmin, qmax) ? 1 : -node.face_or_escape;
+			continue;
+		}
 
-	// cull
-	_cull(0, &params);
+		if (_bvh_overlaps(node, qmin, qmax)) {
+			const Face &f = fr[node.face_or_escape];
+			face.normal = f.normal;
+			face.vertex[0] = vr[f.indices[0]];
+			face.vertex[1] = vr[f.indices[1]];
+			face.vertex[2] = vr[f.indices[2]];
+			p_callback(p_userdata, &face);
+		}
+
+		idx++;
+	}
 }
 
 Vector3 ConcavePolygonShape3DSW::get_moment_of_inertia(real_t p_mass) const {
@@ -1228,173 +1198,287 @@ Vector3 ConcavePolygonShape3DSW::get_moment_of_inertia(real_t p_mass) const {
 			(p_mass / 3.0) * (extents.y * extents.y + extents.y * extents.y));
 }
 
-struct _VolumeSW_BVH_Element {
-	AABB aabb;
-	Vector3 center;
-	int face_index;
-};
-
-struct _VolumeSW_BVH_CompareX {
-	_FORCE_INLINE_ bool operator()(const _VolumeSW_BVH_Element &a, const _VolumeSW_BVH_Element &b) const {
+struct _ConcaveBVHCompareX {
+	_FORCE_INLINE_ bool operator()(const ConcavePolygonShape3DSW::_BVHBuildElement &a, const ConcavePolygonShape3DSW::_BVHBuildElement &b) const {
 		return a.center.x < b.center.x;
 	}
 };
 
-struct _VolumeSW_BVH_CompareY {
-	_FORCE_INLINE_ bool operator()(const _VolumeSW_BVH_Element &a, const _VolumeSW_BVH_Element &b) const {
+struct _ConcaveBVHCompareY {
+	_FORCE_INLINE_ bool operator()(const ConcavePolygonShape3DSW::_BVHBuildElement &a, const ConcavePolygonShape3DSW::_BVHBuildElement &b) const {
 		return a.center.y < b.center.y;
 	}
 };
 
-struct _VolumeSW_BVH_CompareZ {
-	_FORCE_INLINE_ bool operator()(const _VolumeSW_BVH_Element &a, const _VolumeSW_BVH_Element &b) const {
+struct _ConcaveBVHCompareZ {
+	_FORCE_INLINE_ bool operator()(const ConcavePolygonShape3DSW::_BVHBuildElement &a, const ConcavePolygonShape3DSW::_BVHBuildElement &b) const {
 		return a.center.z < b.center.z;
 	}
 };
 
-struct _VolumeSW_BVH {
-	AABB aabb;
-	_VolumeSW_BVH *left;
-	_VolumeSW_BVH *right;
-
-	int face_index;
+struct _ConcaveVertexHasher {
+	static _FORCE_INLINE_ uint32_t hash(const Vector3 &p_vec) {
+		uint32_t h = hash_djb2_one_float(p_vec.x);
+		h = hash_djb2_one_float(p_vec.y, h);
+		return hash_djb2_one_float(p_vec.z, h);
+	}
 };
 
-_VolumeSW_BVH *_volume_sw_build_bvh(_VolumeSW_BVH_Element *p_elements, int p_size, int &count) {
-	_VolumeSW_BVH *bvh = memnew(_VolumeSW_BVH);
+static _FORCE_INLINE_ real_t _bvh_surface_area(const AABB &p_aabb) {
+	const Vector3 &s = p_aabb.size;
+	return 2.0 * (s.x * s.y + s.y * s.z + s.z * s.x);
+}
 
-	if (p_size == 1) {
-		//leaf
-		bvh->aabb = p_elements[0].aabb;
-		bvh->left = nullptr;
-		bvh->right = nullptr;
-		bvh->face_index = p_elements->face_index;
-		count++;
-		return bvh;
-	} else {
-		bvh->face_index = -1;
-	}
+// Binned surface area heuristic. Returns the amount of elements moved to the left
+// side, or 0 when no useful split was found (all centers in the same bin).
+static int _bvh_sah_partition(ConcavePolygonShape3DSW::_BVHBuildElement *p_elements, int p_size, const AABB &p_center_aabb) {
+	const int BINS = 16;
 
-	AABB aabb;
-	for (int i = 0; i < p_size; i++) {
-		if (i == 0) {
-			aabb = p_elements[i].aabb;
-		} else {
-			aabb.merge_with(p_elements[i].aabb);
+	real_t best_cost = 1e30;
+	int best_axis = -1;
+	int best_bin = -1;
+
+	for (int axis = 0; axis < 3; axis++) {
+		real_t extent = p_center_aabb.size[axis];
+		if (extent <= CMP_EPSILON) {
+			continue;
+		}
+
+		real_t origin = p_center_aabb.position[axis];
+		real_t scale = BINS / extent;
+
+		int counts[BINS] = {};
+		AABB bounds[BINS];
+
+		for (int i = 0; i < p_size; i++) {
+			int bin = MIN(int((p_elements[i].center[axis] - origin) * scale), BINS - 1);
+			if (counts[bin] == 0) {
+				bounds[bin] = p_elements[i].aabb;
+			} else {
+				bounds[bin].merge_with(p_elements[i].aabb);
+			}
+			counts[bin]++;
+		}
+
+		// sweep from the right to know the cost of every right side
+		real_t right_area[BINS];
+		int right_count[BINS];
+		AABB accum;
+		int count = 0;
+		for (int i = BINS - 1; i > 0; i--) {
+			if (counts[i]) {
+				if (count == 0) {
+					accum = bounds[i];
+				} else {
+					accum.merge_with(bounds[i]);
+				}
+				count += counts[i];
+			}
+			right_count[i] = count;
+			right_area[i] = count ? _bvh_surface_area(accum) : 0;
+		}
+
+		count = 0;
+		for (int i = 0; i < BINS - 1; i++) {
+			if (counts[i]) {
+				if (count == 0) {
+					accum = bounds[i];
+				} else {
+					accum.merge_with(bounds[i]);
+				}
+				count += counts[i];
+			}
+
+			if (count == 0 || right_count[i + 1] == 0) {
+				continue;
+			}
+
+			real_t cost = count * _bvh_surface_area(accum) + right_count[i + 1] * right_area[i + 1];
+			if (cost < best_cost) {
+				best_cost = cost;
+				best_axis = axis;
+				best_bin = i;
+			}
 		}
 	}
-	bvh->aabb = aabb;
-	switch (aabb.get_longest_axis_index()) {
-		case 0: {
-			SortArray<_VolumeSW_BVH_Element, _VolumeSW_BVH_CompareX> sort_x;
-			sort_x.sort(p_elements, p_size);
 
-		} break;
-		case 1: {
-			SortArray<_VolumeSW_BVH_Element, _VolumeSW_BVH_CompareY> sort_y;
-			sort_y.sort(p_elements, p_size);
-		} break;
-		case 2: {
-			SortArray<_VolumeSW_BVH_Element, _VolumeSW_BVH_CompareZ> sort_z;
-			sort_z.sort(p_elements, p_size);
-		} break;
+	if (best_axis == -1) {
+		return 0;
 	}
 
-	int split = p_size / 2;
-	bvh->left = _volume_sw_build_bvh(p_elements, split, count);
-	bvh->right = _volume_sw_build_bvh(&p_elements[split], p_size - split, count);
+	real_t origin = p_center_aabb.position[best_axis];
+	real_t scale = BINS / p_center_aabb.size[best_axis];
+
+	int left = 0;
+	for (int i = 0; i < p_size; i++) {
+		int bin = MIN(int((p_elements[i].center[best_axis] - origin) * scale), BINS - 1);
+		if (bin <= best_bin) {
+			SWAP(p_elements[i], p_elements[left]);
+			left++;
+		}
+	}
 
-	//printf("branch at %p - %i: %i\n",bvh,count,bvh->face_index);
-	count++;
-	return bvh;
+	return left;
 }
 
-void ConcavePolygonShape3DSW::_fill_bvh(_VolumeSW_BVH *p_bvh_tree, BVH *p_bvh_array, int &p_idx) {
-	int idx = p_idx;
+int ConcavePolygonShape3DSW::_build_bvh(_BVHBuildElement *p_elements, int p_size, BVH *p_nodes, int p_node, int p_depth, bool p_fast) {
+	// past this depth the SAH is likely fighting a degenerate case, use median splits to keep recursion bounded
+	const int SAH_MAX_DEPTH = 64;
 
-	p_bvh_array[idx].aabb = p_bvh_tree->aabb;
-	p_bvh_array[idx].face_index = p_bvh_tree->face_index;
-	//printf("%p - %i: %i(%p)  -- %p:%p\n",%p_bvh_array[idx],p_idx,p_bvh_array[i]->face_index,&p_bvh_tree->face_index,p_bvh_tree->left,p_bvh_tree->right);
+	AABB aabb = p_elements[0].aabb;
+	AABB center_aabb(p_elements[0].center, Vector3());
+	for (int i = 1; i < p_size; i++) {
+		aabb.merge_with(p_elements[i].aabb);
+		center_aabb.expand_to(p_elements[i].center);
+	}
 
-	if (p_bvh_tree->left) {
-		p_bvh_array[idx].left = ++p_idx;
-		_fill_bvh(p_bvh_tree->left, p_bvh_array, p_idx);
+	_quantize(aabb.position, p_nodes[p_node].min, false);
+	_quantize(aabb.position + aabb.size, p_nodes[p_node].max, true);
 
-	} else {
-		p_bvh_array[p_idx].left = -1;
+	if (p_size == 1) {
+		p_nodes[p_node].face_or_escape = p_elements[0].face_index;
+		return 1;
+	}
+
+	int split = 0;
+	if (!p_fast && p_depth < SAH_MAX_DEPTH) {
+		split = _bvh_sah_partition(p_elements, p_size, center_aabb);
+	}
+
+	if (split <= 0 || split >= p_size) {
+		split = p_size / 2;
+		switch (center_aabb.get_longest_axis_index()) {
+			case 0: {
+				SortArray<_BVHBuildElement, _ConcaveBVHCompareX> sort_x;
+				sort_x.nth_element(0, p_size, split, p_elements);
+			} break;
+			case 1: {
+				SortArray<_BVHBuildElement, _ConcaveBVHCompareY> sort_y;
+				sort_y.nth_element(0, p_size, split, p_elements);
+			} break;
+			case 2: {
+				SortArray<_BVHBuildElement, _ConcaveBVHCompareZ> sort_z;
+				sort_z.nth_element(0, p_size, split, p_elements);
+			} break;
+		}
 	}
 
-	if (p_bvh_tree->right) {
-		p_bvh_array[idx].right = ++p_idx;
-		_fill_bvh(p_bvh_tree->right, p_bvh_array, p_idx);
+	int left_count = _build_bvh(p_elements, split, p_nodes, p_node + 1, p_depth + 1, p_fast);
+	int right_count = _build_bvh(&p_elements[split], p_size - split, p_nodes, p_node + 1 + left_count, p_depth + 1, p_fast);
 
-	} else {
-		p_bvh_array[p_idx].right = -1;
+	int count = 1 + left_count + right_count;
+	p_nodes[p_node].face_or_escape = -count;
+	return count;
+}
+
+void ConcavePolygonShape3DSW::_setup(const Vector<Vector3> &p_vertices, const Vector<int> &p_indices, bool p_fast_build) {
+	const bool indexed = !p_indices.empty();
+	int src_face_count = indexed ? p_indices.size() : p_vertices.size();
+
+	// validate before touching the current data, so bad input keeps the previous shape
+	ERR_FAIL_COND(src_face_count % 3);
+	if (indexed) {
+		const int *indicesr = p_indices.ptr();
+		for (int i = 0; i < p_indices.size(); i++) {
+			ERR_FAIL_INDEX(indicesr[i], p_vertices.size());
+		}
 	}
 
-	memdelete(p_bvh_tree);
-}
+	faces.clear();
+	vertices.clear();
+	bvh.clear();
 
-void ConcavePolygonShape3DSW::_setup(Vector<Vector3> p_faces) {
-	int src_face_count = p_faces.size();
 	if (src_face_count == 0) {
 		configure(AABB());
 		return;
 	}
-	ERR_FAIL_COND(src_face_count % 3);
 	src_face_count /= 3;
 
-	const Vector3 *facesr = p_faces.ptr();
-
-	Vector<_VolumeSW_BVH_Element> bvh_array;
-	bvh_array.resize(src_face_count);
-
-	_VolumeSW_BVH_Element *bvh_arrayw = bvh_array.ptrw();
-
 	faces.resize(src_face_count);
 	Face *facesw = faces.ptrw();
 
-	vertices.resize(src_face_count * 3);
+	if (indexed) {
+		// only keep the vertices referenced by an index, in order of first use
+		Vector<int> remap;
+		remap.resize(p_vertices.size());
+		int *remapw = remap.ptrw();
+		for (int i = 0; i < p_vertices.size(); i++) {
+			remapw[i] = -1;
+		}
 
-	Vector3 *verticesw = vertices.ptrw();
+		const Vector3 *verticesr = p_vertices.ptr();
+		const int *indicesr = p_indices.ptr();
+		for (int i = 0; i < p_indices.size(); i++) {
+			int index = indicesr[i];
+			if (remapw[index] < 0) {
+				remapw[index] = vertices.size();
+				vertices.push_back(verticesr[index]);
+			}
+			facesw[i / 3].indices[i % 3] = remapw[index];
+		}
+	} else {
+		// weld identical vertices, triangle soups usually share most of them
+		HashMap<Vector3, int, _ConcaveVertexHasher> vertex_map;
+		const Vector3 *facesr = p_vertices.ptr();
+		for (int i = 0; i < p_vertices.size(); i++) {
+			int *index = vertex_map.getptr(facesr[i]);
+			if (!index) {
+				index = &vertex_map[facesr[i]];
+				*index = vertices.size();
+				vertices.push_back(facesr[i]);
+			}
+			facesw[i / 3].indices[i % 3] = *index;
+		}
+	}
+
+	const Vector3 *verticesr = vertices.ptr();
+
+	Vector<_BVHBuildElement> bvh_elements;
+	bvh_elements.resize(src_face_count);
+	_BVHBuildElement *bvh_elementsw = bvh_elements.ptrw();
 
 	AABB _aabb;
 
 	for (int i = 0; i < src_face_count; i++) {
-		Face3 face(facesr[i * 3 + 0], facesr[i * 3 + 1], facesr[i * 3 + 2]);
-
-		bvh_arrayw[i].aabb = face.get_aabb();
-		bvh_arrayw[i].center = bvh_arrayw[i].aabb.position + bvh_arrayw[i].aabb.size * 0.5;
-		bvh_arrayw[i].face_index = i;
-		facesw[i].indices[0] = i * 3 + 0;
-		facesw[i].indices[1] = i * 3 + 1;
-		facesw[i].indices[2] = i * 3 + 2;
+		Face3 face(verticesr[facesw[i].indices[0]], verticesr[facesw[i].indices[1]], verticesr[facesw[i].indices[2]]);
 		facesw[i].normal = face.get_plane().normal;
-		verticesw[i * 3 + 0] = face.vertex[0];
-		verticesw[i * 3 + 1] = face.vertex[1];
-		verticesw[i * 3 + 2] = face.vertex[2];
+
+		bvh_elementsw[i].aabb = face.get_aabb();
+		bvh_elementsw[i].center = bvh_elementsw[i].aabb.position + bvh_elementsw[i].aabb.size * 0.5;
+		bvh_elementsw[i].face_index = i;
 		if (i == 0) {
-			_aabb = bvh_arrayw[i].aabb;
+			_aabb = bvh_elementsw[i].aabb;
 		} else {
-			_aabb.merge_with(bvh_arrayw[i].aabb);
+			_aabb.merge_with(bvh_elementsw[i].aabb);
 		}
 	}
 
-	int count = 0;
-	_VolumeSW_BVH *bvh_tree = _volume_sw_build_bvh(bvh_arrayw, src_face_count, count);
-
-	bvh.resize(count + 1);
-
-	BVH *bvh_arrayw2 = bvh.ptrw();
+	// quantization grid covers the shape AABB plus a small margin, so flat axes don't divide by zero
+	// and bounds touching the edges of the shape don't lose precision to clamping
+	AABB quantize_aabb = _aabb.grow(MAX(_aabb.get_longest_axis_size() * 0.001, (real_t)CMP_EPSILON));
+	bvh_quantize_origin = quantize_aabb.position;
+	for (int i = 0; i < 3; i++) {
+		bvh_quantize_scale[i] = 65535.0 / quantize_aabb.size[i];
+		bvh_dequantize_scale[i] = quantize_aabb.size[i] / 65535.0;
+	}
 
-	int idx = 0;
-	_fill_bvh(bvh_tree, bvh_arrayw2, idx);
+	// a binary tree with one face per leaf has exactly 2n-1 nodes
+	bvh.resize(src_face_count * 2 - 1);
+	_build_bvh(bvh_elementsw, src_face_count, bvh.ptrw(), 0, 0, p_fast_build);
 
 	configure(_aabb); // this type of shape has no margin
 }
 
 void ConcavePolygonShape3DSW::set_data(const Variant &p_data) {
-	_setup(p_data);
+	if (p_data.get_type() == Variant::DICTIONARY) {
+		// runtime generated meshes can pass their index buffer directly and ask for a fast (median split) build
+		Dictionary d = p_data;
+		ERR_FAIL_COND(!d.has("triangles"));
+		Vector<int> indices = d.has("indices") ? Vector<int>(d["indices"]) : Vector<int>();
+		_setup(d["triangles"], indices, d.has("fast_build") && bool(d["fast_build"]));
+	} else {
+		_setup(p_data, Vector<int>(), false);
+	}
 }
 
 Variant ConcavePolygonShape3DSW::get_data() const {
@@ -1432,8 +1516,161 @@ Vector3 HeightMapShape3DSW::get_support(const Vector3 &p_normal) const {
 	return get_aabb().get_support(p_normal);
 }
 
+void HeightMapShape3DSW::_get_cell_faces(int p_x, int p_z, Vector3 r_faces[2][3]) const {
+	Vector3 v00 = _get_vertex(p_x, p_z);
+	Vector3 v10 = _get_vertex(p_x + 1, p_z);
+	Vector3 v01 = _get_vertex(p_x, p_z + 1);
+	Vector3 v11 = _get_vertex(p_x + 1, p_z + 1);
+
+	// both faces wound so their normals point up
+	r_faces[0][0] = v00;
+	r_faces[0][1] = v10;
+	r_faces[0][2] = v01;
+	r_faces[1][0] = v10;
+	r_faces[1][1] = v11;
+	r_faces[1][2] = v01;
+}
+
+AABB HeightMapShape3DSW::_get_pyramid_aabb(int p_level, int p_x, int p_z) const {
+	const PyramidLevel &level = pyramid_levels[p_level];
+	const MinMax &mm = pyramid[level.offset + p_z * level.width + p_x];
+
+	int from_x = p_x << p_level;
+	int from_z = p_z << p_level;
+	int to_x = MIN((p_x + 1) << p_level, width - 1);
+	int to_z = MIN((p_z + 1) << p_level, depth - 1);
+
+	AABB aabb;
+	aabb.position = local_origin + Vector3(from_x * cell_size, mm.min, from_z * cell_size);
+	aabb.size = Vector3((to_x - from_x) * cell_size, mm.max - mm.min, (to_z - from_z) * cell_size);
+	return aabb;
+}
+
+void HeightMapShape3DSW::_update_pyramid(int p_from_x, int p_from_z, int p_to_x, int p_to_z) {
+	MinMax *pyramidw = pyramid.ptrw();
+	const real_t *r = heights.ptr();
+
+	{
+		const PyramidLevel &level = pyramid_levels[0];
+		for (int i = p_from_z; i <= p_to_z; i++) {
+			for (int j = p_from_x; j <= p_to_x; j++) {
+				real_t h00 = r[i * width + j];
+				real_t h10 = r[i * width + j + 1];
+				real_t h01 = r[(i + 1) * width + j];
+				real_t h11 = r[(i + 1) * width + j + 1];
+
+				MinMax &mm = pyramidw[level.offset + i * level.width + j];
+				mm.min = MIN(MIN(h00, h10), MIN(h01, h11));
+				mm.max = MAX(MAX(h00, h10), MAX(h01, h11));
+			}
+		}
+	}
+
+	for (int l = 1; l < pyramid_levels.size(); l++) {
+		const PyramidLevel &child = pyramid_levels[l - 1];
+		const PyramidLevel &level = pyramid_levels[l];
+
+		p_from_x >>= 1;
+		p_from_z >>= 1;
+		p_to_x >>= 1;
+		p_to_z >>= 1;
+
+		for (int i = p_from_z; i <= p_to_z; i++) {
+			for (int j = p_from_x; j <= p_to_x; j++) {
+				MinMax mm = pyramidw[child.offset + (i * 2) * child.width + j * 2];
+
+				for (int ci = i * 2; ci <= MIN(i * 2 + 1, child.depth - 1); ci++) {
+					for (int cj = j * 2; cj <= MIN(j * 2 + 1, child.width - 1); cj++) {
+						const MinMax &cmm = pyramidw[child.offset + ci * child.width + cj];
+						mm.min = MIN(mm.min, cmm.min);
+						mm.max = MAX(mm.max, cmm.max);
+					}
+				}
+
+				pyramidw[level.offset + i * level.width + j] = mm;
+			}
+		}
+	}
+
+	// the top of the pyramid holds the height range of the whole map
+	const MinMax &top = pyramid[pyramid_levels[pyramid_levels.size() - 1].offset];
+
+	AABB aabb;
+	aabb.position = local_origin + Vector3(0, top.min, 0);
+	aabb.size = Vector3((width - 1) * cell_size, top.max - top.min, (depth - 1) * cell_size);
+
+	configure(aabb);
+}
+
+void HeightMapShape3DSW::_cull_segment(int p_level, int p_x, int p_z, _SegmentCullParams *p_params) const {
+	Vector3 clip;
+	if (!_get_pyramid_aabb(p_level, p_x, p_z).intersects_segment(p_params->from, p_params->to, &clip)) {
+		return;
+	}
+
+	if (p_params->dir.dot(clip) - p_params->from_d > p_params->min_d) {
+		return; // entering this block after the closest hit found so far, nothing to gain here
+	}
+
+	if (p_level == 0) {
+		Vector3 faces[2][3];
+		_get_cell_faces(p_x, p_z, faces);
+
+		for (int i = 0; i < 2; i++) {
+			Vector3 res;
+			if (Geometry3D::segment_intersects_triangle(p_params->from, p_params->to, faces[i][0], faces[i][1], faces[i][2], &res)) {
+				real_t d = p_params->dir.dot(res) - p_params->from_d;
+				if (d > 0 && d < p_params->min_d) {
+					p_params->min_d = d;
+					p_params->result = res;
+					p_params->normal = Plane(faces[i][0], faces[i][1], faces[i][2]).normal;
+					p_params->collisions++;
+				}
+			}
+		}
+
+		return;
+	}
+
+	// visit the children closest to the segment origin first, so far blocks can be rejected early
+	const PyramidLevel &child = pyramid_levels[p_level - 1];
+	for (int i = 0; i < 2; i++) {
+		int cz = p_z * 2 + (p_params->dir.z < 0 ? 1 - i : i);
+		if (cz >= child.depth) {
+			continue;
+		}
+		for (int j = 0; j < 2; j++) {
+			int cx = p_x * 2 + (p_params->dir.x < 0 ? 1 - j : j);
+			if (cx >= child.width) {
+				continue;
+			}
+			_cull_segment(p_level - 1, cx, cz, p_params);
+		}
+	}
+}
+
 bool HeightMapShape3DSW::intersect_segment(const Vector3 &p_begin, const Vector3 &p_end, Vector3 &r_point, Vector3 &r_normal) const {
-	return false;
+	if (pyramid_levels.empty()) {
+		return false;
+	}
+
+	_SegmentCullParams params;
+	params.from = p_begin;
+	params.to = p_end;
+	params.dir = (p_end - p_begin).normalized();
+	params.from_d = params.dir.dot(p_begin);
+	params.min_d = 1e20;
+	params.collisions = 0;
+
+	_cull_segment(pyramid_levels.size() - 1, 0, 0, &params);
+
+	if (params.collisions > 0) {
+		r_point = params.result;
+		r_normal = params.normal;
+		return true;
+	} else {
+		return false;
+	}
 }
 
 bool HeightMapShape3DSW::intersect_point(const Vector3 &p_point) const {
@@ -1444,7 +1681,76 @@ Vector3 HeightMapShape3DSW::get_closest_point_to(const Vector3 &p_point) const {
 	return Vector3();
 }
 
+void HeightMapShape3DSW::_cull(int p_level, int p_x, int p_z, _CullParams *p_params) const {
+	int from_x = p_x << p_level;
+	int from_z = p_z << p_level;
+	int to_x = ((p_x + 1) << p_level) - 1;
+	int to_z = ((p_z + 1) << p_level) - 1;
+
+	if (from_x > p_params->to_x || to_x < p_params->from_x || from_z > p_params->to_z || to_z < p_params->from_z) {
+		return;
+	}
+
+	const PyramidLevel &level = pyramid_levels[p_level];
+	const MinMax &mm = pyramid[level.offset + p_z * level.width + p_x];
+	if (mm.min > p_params->max_y || mm.max < p_params->min_y) {
+		return;
+	}
+
+	if (p_level == 0) {
+		Vector3 faces[2][3];
+		_get_cell_faces(p_x, p_z, faces);
+
+		FaceShape3DSW *face = p_params->face;
+		for (int i = 0; i < 2; i++) {
+			face->vertex[0] = faces[i][0];
+			face->vertex[1] = faces[i][1];
+			face->vertex[2] = faces[i][2];
+			face->normal = Plane(faces[i][0], faces[i][1], faces[i][2]).normal;
+			p_params->callback(p_params->userdata, face);
+		}
+
+		return;
+	}
+
+	const PyramidLevel &child = pyramid_levels[p_level - 1];
+	for (int cz = p_z * 2; cz <= MIN(p_z * 2 + 1, child.depth - 1); cz++) {
+		for (int cx = p_x * 2; cx <= MIN(p_x * 2 + 1, child.width - 1); cx++) {
+			_cull(p_level - 1, cx, cz, p_params);
+		}
+	}
+}
+
 void HeightMapShape3DSW::cull(const AABB &p_local_aabb, Callback p_callback, void *p_userdata) const {
+	if (pyramid_levels.empty()) {
+		return;
+	}
+
+	// find the range of cells covered by the AABB
+	Vector3 from = (p_local_aabb.position - local_origin) / cell_size;
+	Vector3 to = (p_local_aabb.position + p_local_aabb.size - local_origin) / cell_size;
+
+	const int cells_x = width - 1;
+	const int cells_z = depth - 1;
+
+	if (to.x < 0 || to.z < 0 || from.x >= cells_x || from.z >= cells_z) {
+		return;
+	}
+
+	FaceShape3DSW face; // use this to send in the callback
+
+	_CullParams params;
+	params.from_x = CLAMP((int)Math::floor(from.x), 0, cells_x - 1);
+	params.from_z = CLAMP((int)Math::floor(from.z), 0, cells_z - 1);
+	params.to_x = CLAMP((int)Math::floor(to.x), 0, cells_x - 1);
+	params.to_z = CLAMP((int)Math::floor(to.z), 0, cells_z - 1);
+	params.min_y = p_local_aabb.position.y;
+	params.max_y = p_local_aabb.position.y + p_local_aabb.size.y;
+	params.callback = p_callback;
+	params.userdata = p_userdata;
+	params.face = &face;
+
+	_cull(pyramid_levels.size() - 1, 0, 0, &params);
 }
 
 Vector3 HeightMapShape3DSW::get_moment_of_inertia(real_t p_mass) const {
@@ -1457,30 +1763,90 @@ Vector3 HeightMapShape3DSW::get_moment_of_inertia(real_t p_mass) const {
 			(p_mass / 3.0) * (extents.y * extents.y + extents.y * extents.y));
 }
 
-void HeightMapShape3DSW::_setup(Vector<real_t> p_heights, int p_width, int p_depth, real_t p_cell_size) {
+void HeightMapShape3DSW::_setup(const Vector<real_t> &p_heights, int p_width, int p_depth, real_t p_cell_size) {
 	heights = p_heights;
 	width = p_width;
 	depth = p_depth;
 	cell_size = p_cell_size;
 
-	const real_t *r = heights.ptr();
+	// centered on the origin, same as the debug mesh of HeightMapShape3D
+	local_origin = Vector3((width - 1) * cell_size * -0.5, 0, (depth - 1) * cell_size * -0.5);
 
-	AABB aabb;
+	pyramid.clear();
+	pyramid_levels.clear();
 
-	for (int i = 0; i < depth; i++) {
-		for (int j = 0; j < width; j++) {
-			real_t h = r[i * width + j];
+	if (width < 2 || depth < 2) {
+		// no cells, nothing to collide against
+		const real_t *r = heights.ptr();
 
-			Vector3 pos(j * cell_size, h, i * cell_size);
-			if (i == 0 || j == 0) {
-				aabb.position = pos;
-			} else {
-				aabb.expand_to(pos);
+		AABB aabb;
+		for (int i = 0; i < depth; i++) {
+			for (int j = 0; j < width; j++) {
+				Vector3 pos = local_origin + Vector3(j * cell_size, r[i * width + j], i * cell_size);
+				if (i == 0 && j == 0) {
+					aabb.position = pos;
+				} else {
+					aabb.expand_to(pos);
+				}
 			}
 		}
+
+		configure(aabb);
+		return;
 	}
 
-	configure(aabb);
+	int level_width = width - 1;
+	int level_depth = depth - 1;
+	int size = 0;
+
+	while (true) {
+		PyramidLevel level;
+		level.width = level_width;
+		level.depth = level_depth;
+		level.offset = size;
+		pyramid_levels.push_back(level);
+		size += level_width * level_depth;
+
+		if (level_width == 1 && level_depth == 1) {
+			break;
+		}
+
+		level_width = (level_width + 1) / 2;
+		level_depth = (level_depth + 1) / 2;
+	}
+
+	pyramid.resize(size);
+
+	_update_pyramid(0, 0, width - 2, depth - 2);
+}
+
+void HeightMapShape3DSW::_update_region(const Rect2i &p_region, const Vector<real_t> &p_heights) {
+	ERR_FAIL_COND(p_region.position.x < 0 || p_region.position.y < 0);
+	ERR_FAIL_COND(p_region.size.x <= 0 || p_region.size.y <= 0);
+	ERR_FAIL_COND(p_region.position.x + p_region.size.x > width || p_region.position.y + p_region.size.y > depth);
+	ERR_FAIL_COND(p_heights.size() != p_region.size.x * p_region.size.y);
+
+	real_t *w = heights.ptrw();
+	const real_t *r = p_heights.ptr();
+
+	for (int i = 0; i < p_region.size.y; i++) {
+		for (int j = 0; j < p_region.size.x; j++) {
+			w[(p_region.position.y + i) * width + p_region.position.x + j] = r[i * p_region.size.x + j];
+		}
+	}
+
+	if (pyramid_levels.empty()) {
+		_setup(heights, width, depth, cell_size);
+		return;
+	}
+
+	// every cell touching a changed height needs to be refreshed
+	int from_x = MAX(p_region.position.x - 1, 0);
+	int from_z = MAX(p_region.position.y - 1, 0);
+	int to_x = MIN(p_region.position.x + p_region.size.x - 1, width - 2);
+	int to_z = MIN(p_region.position.y + p_region.size.y - 1, depth - 2);
+
+	_update_pyramid(from_x, from_z, to_x, to_z);
 }
 
 void HeightMapShape3DSW::set_data(const Variant &p_data) {
@@ -1488,23 +1854,35 @@ void HeightMapShape3DSW::set_data(const Variant &p_data) {
 	Dictionary d = p_data;
 	ERR_FAIL_COND(!d.has("width"));
 	ERR_FAIL_COND(!d.has("depth"));
-	ERR_FAIL_COND(!d.has("cell_size"));
 	ERR_FAIL_COND(!d.has("heights"));
 
 	int width = d["width"];
 	int depth = d["depth"];
-	real_t cell_size = d["cell_size"];
+	real_t cell_size = d.has("cell_size") ? real_t(d["cell_size"]) : 1.0;
 	Vector<real_t> heights = d["heights"];
 
 	ERR_FAIL_COND(width <= 0);
 	ERR_FAIL_COND(depth <= 0);
 	ERR_FAIL_COND(cell_size <= CMP_EPSILON);
+
+	if (d.has("region")) {
+		// partial update, only the heights inside the region are passed
+		ERR_FAIL_COND(width != this->width || depth != this->depth || cell_size != this->cell_size);
+		_update_region(d["region"], heights);
+		return;
+	}
+
 	ERR_FAIL_COND(heights.size() != (width * depth));
 	_setup(heights, width, depth, cell_size);
 }
 
 Variant HeightMapShape3DSW::get_data() const {
-	ERR_FAIL_V(Variant());
+	Dictionary d;
+	d["width"] = width;
+	d["depth"] = depth;
+	d["cell_size"] = cell_size;
+	d["heights"] = heights;
+	return d;
 }
 
 HeightMapShape3DSW::HeightMapShape3DSW() {
@@ -40,7 +40,8 @@ SHAPE_SEGMENT, ///< real_t:"length"
 SHAPE_CIRCLE, ///< real_t:"radius"
 SHAPE_RECTANGLE, ///< vec3:"extents"
 SHAPE_CONVEX_POLYGON, ///< array of planes:"planes"
-SHAPE_CONCAVE_POLYGON, ///< Vector3 array:"triangles" , or Dictionary with "indices" (int array) and "triangles" (Vector3 array)
+SHAPE_CONCAVE_POLYGON, ///< Vector3 array:"triangles" , or Dictionary with "triangles" (Vector3 array), optional "indices" (int array) and optional "fast_build" (bool)
+SHAPE_HEIGHTMAP, ///< Dictionary with "width", "depth", "heights" (real_t array) and optional "cell_size". Adding "region" (Rect2i) updates only that part of the heights
 SHAPE_CUSTOM, ///< Server-Implementation based custom shape, calling shape_create() with this value will result in an error
 
 */
@@ -276,7 +277,6 @@ public:
 	ConvexPolygonShape3DSW();
 };
 
-struct _VolumeSW_BVH;
 struct FaceShape3DSW;
 
 struct ConcavePolygonShape3DSW : public ConcaveShape3DSW {
@@ -290,46 +290,45 @@ struct ConcavePolygonShape3DSW : public ConcaveShape3DSW {
 	Vector<Face> faces;
 	Vector<Vector3> vertices;
 
+	// Compact BVH node. Bounds are quantized to 16 bits inside the shape AABB (rounded
+	// outwards by one step, so tests stay conservative) and nodes are stored in depth-first order,
+	// which allows traversing the tree without recursion or a stack.
 	struct BVH {
-		AABB aabb;
-		int left;
-		int right;
-
-		int face_index;
+		uint16_t min[3];
+		uint16_t max[3];
+		// >= 0: leaf, index of the face. < 0: branch, negated node count of its subtree.
+		int32_t face_or_escape;
 	};
 
 	Vector<BVH> bvh;
+	Vector3 bvh_quantize_origin;
+	Vector3 bvh_quantize_scale;
+	Vector3 bvh_dequantize_scale;
 
-	struct _CullParams {
+	struct _BVHBuildElement {
 		AABB aabb;
-		Callback callback;
-		void *userdata;
-		const Face *faces;
-		const Vector3 *vertices;
-		const BVH *bvh;
-		FaceShape3DSW *face;
-	};
-
-	struct _SegmentCullParams {
-		Vector3 from;
-		Vector3 to;
-		const Face *faces;
-		const Vector3 *vertices;
-		const BVH *bvh;
-		Vector3 dir;
-
-		Vector3 result;
-		Vector3 normal;
-		real_t min_d;
-		int collisions;
+		Vector3 center;
+		int face_index;
 	};
 
-	void _cull_segment(int p_idx, _SegmentCullParams *p_params) const;
-	void _cull(int p_idx, _CullParams *p_params) const;
+	_FORCE_INLINE_ void _quantize(const Vector3 &p_point, uint16_t *r_quantized, bool p_round_up) const {
+		for (int i = 0; i < 3; i++) {
+			real_t v = (p_point[i] - bvh_quantize_origin[i]) * bvh_quantize_scale[i];
+			v = p_round_up ? Math::ceil(v) + 1 : Math::floor(v) - 1;
+			r_quantized[i] = uint16_t(CLAMP(v, (real_t)0, (real_t)65535));
+		}
+	}
 
-	void _fill_bvh(_VolumeSW_BVH *p_bvh_tree, BVH *p_bvh_array, int &p_idx);
+	_FORCE_INLINE_ AABB _dequantize(const BVH &p_node) const {
+		Vector3 from(p_node.min[0], p_node.min[1], p_node.min[2]);
+		Vector3 to(p_node.max[0], p_node.max[1], p_node.max[2]);
+		from = bvh_quantize_origin + from * bvh_dequantize_scale;
+		to = bvh_quantize_origin + to * bvh_dequantize_scale;
+		return AABB(from, to - from);
+	}
 
-	void _setup(Vector<Vector3> p_faces);
+	int _build_bvh(_BVHBuildElement *p_elements, int p_size, BVH *p_nodes, int p_node, int p_depth, bool p_fast);
+	void _setup(const Vector<Vector3> &p_vertices, const Vector<int> &p_indices, bool p_fast_build);
 
 public:
 	Vector<Vector3> get_faces() const;
@@ -358,11 +357,59 @@ struct HeightMapShape3DSW : public ConcaveShape3DSW {
 	int width;
 	int depth;
 	real_t cell_size;
+	Vector3 local_origin;
+
+	// Min/max height pyramid over the cells (the quads between four heights). Level 0 has
+	// one entry per cell and every further level halves the resolution down to a single
+	// entry, so queries can skip whole blocks of terrain they can't touch.
+	struct MinMax {
+		real_t min;
+		real_t max;
+	};
+
+	struct PyramidLevel {
+		int width;
+		int depth;
+		int offset;
+	};
+
+	Vector<MinMax> pyramid;
+	Vector<PyramidLevel> pyramid_levels;
+
+	struct _CullParams {
+		int from_x, from_z;
+		int to_x, to_z;
+		real_t min_y, max_y;
+		Callback callback;
+		void *userdata;
+		FaceShape3DSW *face;
+	};
+
+	struct _SegmentCullParams {
+		Vector3 from;
+		Vector3 to;
+		Vector3 dir;
+		real_t from_d;
+
+		Vector3 result;
+		Vector3 normal;
+		real_t min_d;
+		int collisions;
+	};
+
+	_FORCE_INLINE_ Vector3 _get_vertex(int p_x, int p_z) const {
+		return local_origin + Vector3(p_x * cell_size, heights[p_z * width + p_x], p_z * cell_size);
+	}
+
+	void _get_cell_faces(int p_x, int p_z, Vector3 r_faces[2][3]) const;
+	AABB _get_pyramid_aabb(int p_level, int p_x, int p_z) const;
+	void _update_pyramid(int p_from_x, int p_from_z, int p_to_x, int p_to_z);
 
-	//void _cull_segment(int p_idx,_SegmentCullParams *p_params) const;
-	//void _cull(int p_idx,_CullParams *p_params) const;
+	void _cull_segment(int p_level, int p_x, int p_z, _SegmentCullParams *p_params) const;
+	void _cull(int p_level, int p_x, int p_z, _CullParams *p_params) const;
 
-	void _setup(Vector<real_t> p_heights, int p_width, int p_depth, real_t p_cell_size);
+	void _setup(const Vector<real_t> &p_heights, int p_width, int p_depth, real_t p_cell_size);
+	void _update_region(const Rect2i &p_region, const Vector<real_t> &p_heights);
 
 public:
 	Vector<real_t> get_heights() const;
@@ -294,6 +294,10 @@ public:
 	virtual Vector<Vector2> space_get_contacts(RID p_space) const = 0;
 	virtual int space_get_contact_count(RID p_space) const = 0;
 
+	// snapshots are only valid for the same space with the same objects, and can't be taken while it steps
+	virtual Vector<uint8_t> space_save_snapshot(RID p_space) const = 0;
+	virtual void space_restore_snapshot(RID p_space, const Vector<uint8_t> &p_snapshot) = 0;
+
 	//missing space parameters
 
 	/* AREA API */
@@ -360,6 +364,8 @@ public:
 
 	virtual void area_set_monitor_callback(RID p_area, Object *p_receiver, const StringName &p_method) = 0;
 	virtual void area_set_area_monitor_callback(RID p_area, Object *p_receiver, const StringName &p_method) = 0;
+	// when enabled, monitor callbacks are called once per step with packed arrays of the changes
+	virtual void area_set_monitor_batching(RID p_area, bool p_enable) = 0;
 
 	/* BODY API */
 
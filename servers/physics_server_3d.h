@@ -341,6 +341,8 @@ public:
 
 	virtual void area_set_monitor_callback(RID p_area, Object *p_receiver, const StringName &p_method) = 0;
 	virtual void area_set_area_monitor_callback(RID p_area, Object *p_receiver, const StringName &p_method) = 0;
+	// when enabled, monitor callbacks are called once per step with packed arrays of the changes
+	virtual void area_set_monitor_batching(RID p_area, bool p_enable) = 0;
 
 	virtual void area_set_ray_pickable(RID p_area, bool p_enable) = 0;
 	virtual bool area_is_ray_pickable(RID p_area) const = 0;
@@ -159,6 +159,7 @@ public:
 		bool redraw_if_visible : 4;
 
 		float depth; //used for sorting
+		float lod_threshold; //mesh simplification error allowed for the current camera, in mesh units
 
 		SelfList<InstanceBase> dependency_item;
 
@@ -239,6 +240,7 @@ public:
 			lightmap_slice_index = 0;
 			lightmap = nullptr;
 			lightmap_cull_index = 0;
+			lod_threshold = 0;
 		}
 
 		virtual ~InstanceBase() {
@@ -0,0 +1,352 @@
+/*************************************************************************/
+/*  rasterizer_canvas_batcher.cpp                                        */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "rasterizer_canvas_batcher.h"
+
+void RasterizerCanvasBatcher::_set_vertex(Vertex *r_vertex, const Vector2 &p_vertex, const Color &p_color, const Vector2 &p_uv) {
+	r_vertex->vertex[0] = p_vertex.x;
+	r_vertex->vertex[1] = p_vertex.y;
+	r_vertex->color[0] = p_color.r;
+	r_vertex->color[1] = p_color.g;
+	r_vertex->color[2] = p_color.b;
+	r_vertex->color[3] = p_color.a;
+	r_vertex->uv[0] = p_uv.x;
+	r_vertex->uv[1] = p_uv.y;
+}
+
+bool RasterizerCanvasBatcher::_command_get_key(const Item::Command *p_command, TextureBindingID &r_texture_binding, Color &r_specular_shininess, uint32_t &r_vertex_count) {
+	switch (p_command->type) {
+		case Item::Command::TYPE_RECT: {
+			const Item::CommandRect *rect = static_cast<const Item::CommandRect *>(p_command);
+			if (rect->flags & RasterizerCanvas::CANVAS_RECT_CLIP_UV) {
+				return false; //clipping is done by the fragment shader of the quad variant
+			}
+
+			r_texture_binding = rect->texture_binding.binding_id;
+			r_specular_shininess = rect->specular_shininess;
+			r_vertex_count = 6;
+			return true;
+		}
+		case Item::Command::TYPE_NINEPATCH: {
+			const Item::CommandNinePatch *np = static_cast<const Item::CommandNinePatch *>(p_command);
+			if (np->axis_x != RS::NINE_PATCH_STRETCH || np->axis_y != RS::NINE_PATCH_STRETCH) {
+				return false; //tiling repeats the source in the fragment shader, can't be expressed as quads
+			}
+			if (np->rect.size.x < 0 || np->rect.size.y < 0 || np->margin[MARGIN_LEFT] + np->margin[MARGIN_RIGHT] > np->rect.size.x || np->margin[MARGIN_TOP] + np->margin[MARGIN_BOTTOM] > np->rect.size.y) {
+				return false; //overlapping margins, let the shader resolve them
+			}
+
+			r_texture_binding = np->texture_binding.binding_id;
+			r_specular_shininess = np->specular_shininess;
+			r_vertex_count = np->draw_center ? 9 * 6 : 8 * 6;
+			return true;
+		}
+		case Item::Command::TYPE_PRIMITIVE: {
+			const Item::CommandPrimitive *primitive = static_cast<const Item::CommandPrimitive *>(p_command);
+			if (primitive->point_count < 3 || primitive->point_count > 4) {
+				return false; //points and lines use their own pipelines
+			}
+
+			r_texture_binding = primitive->texture_binding.binding_id;
+			r_specular_shininess = primitive->specular_shininess;
+			r_vertex_count = primitive->point_count == 4 ? 6 : 3;
+			return true;
+		}
+		default: {
+			return false;
+		}
+	}
+}
+
+uint32_t RasterizerCanvasBatcher::_command_write_vertices(const Item::Command *p_command, const Color &p_base_color, const Size2 &p_texpixel_size, Vertex *r_vertices) {
+	static const uint32_t quad_indices[6] = { 0, 1, 2, 0, 2, 3 };
+	static const Vector2 quad_base[4] = { Vector2(0, 0), Vector2(0, 1), Vector2(1, 1), Vector2(1, 0) };
+
+	switch (p_command->type) {
+		case Item::Command::TYPE_RECT: {
+			const Item::CommandRect *rect = static_cast<const Item::CommandRect *>(p_command);
+
+			//same math as the quad variant of the shader, done on the CPU
+			Rect2 src_rect = (rect->flags & RasterizerCanvas::CANVAS_RECT_REGION) ? Rect2(rect->source.position * p_texpixel_size, rect->source.size * p_texpixel_size) : Rect2(0, 0, 1, 1);
+			Rect2 dst_rect = Rect2(rect->rect.position, rect->rect.size);
+
+			if (dst_rect.size.width < 0) {
+				dst_rect.position.x += dst_rect.size.width;
+				dst_rect.size.width *= -1;
+			}
+			if (dst_rect.size.height < 0) {
+				dst_rect.position.y += dst_rect.size.height;
+				dst_rect.size.height *= -1;
+			}
+
+			if (rect->flags & RasterizerCanvas::CANVAS_RECT_FLIP_H) {
+				src_rect.size.x *= -1;
+			}
+
+			if (rect->flags & RasterizerCanvas::CANVAS_RECT_FLIP_V) {
+				src_rect.size.y *= -1;
+			}
+
+			Color color = rect->modulate * p_base_color;
+
+			for (uint32_t i = 0; i < 6; i++) {
+				Vector2 base = quad_base[quad_indices[i]];
+				Vector2 uv_base = (rect->flags & RasterizerCanvas::CANVAS_RECT_TRANSPOSE) ? Vector2(base.y, base.x) : base;
+				Vector2 vertex_base(src_rect.size.x < 0 ? 1.0 - base.x : base.x, src_rect.size.y < 0 ? 1.0 - base.y : base.y);
+
+				_set_vertex(&r_vertices[i], dst_rect.position + dst_rect.size * vertex_base, color, src_rect.position + src_rect.size.abs() * uv_base);
+			}
+
+			return 6;
+		}
+		case Item::Command::TYPE_NINEPATCH: {
+			const Item::CommandNinePatch *np = static_cast<const Item::CommandNinePatch *>(p_command);
+
+			Rect2 src_rect = Rect2(0, 0, 1, 1);
+			Size2 texpixel_size = p_texpixel_size;
+			if (np->source != Rect2()) {
+				src_rect = Rect2(np->source.position * p_texpixel_size, np->source.size * p_texpixel_size);
+				texpixel_size = Size2(1.0 / np->source.size.width, 1.0 / np->source.size.height);
+			}
+
+			//stretch mode maps each axis linearly between the margins, so the nine cells are plain quads
+			const real_t xs[4] = { 0, np->margin[MARGIN_LEFT], np->rect.size.x - np->margin[MARGIN_RIGHT], np->rect.size.x };
+			const real_t ys[4] = { 0, np->margin[MARGIN_TOP], np->rect.size.y - np->margin[MARGIN_BOTTOM], np->rect.size.y };
+			const real_t us[4] = { 0, np->margin[MARGIN_LEFT] * texpixel_size.x, 1 - np->margin[MARGIN_RIGHT] * texpixel_size.x, 1 };
+			const real_t vs[4] = { 0, np->margin[MARGIN_TOP] * texpixel_size.y, 1 - np->margin[MARGIN_BOTTOM] * texpixel_size.y, 1 };
+
+			Color color = np->color * p_base_color;
+			uint32_t vertex_count = 0;
+
+			for (uint32_t y = 0; y < 3; y++) {
+				for (uint32_t x = 0; x < 3; x++) {
+					if (x == 1 && y == 1 && !np->draw_center) {
+						continue;
+					}
+
+					for (uint32_t i = 0; i < 6; i++) {
+						Vector2 base = quad_base[quad_indices[i]];
+						uint32_t cx = x + uint32_t(base.x);
+						uint32_t cy = y + uint32_t(base.y);
+						Vector2 uv = Vector2(us[cx], vs[cy]) * src_rect.size + src_rect.position;
+
+						_set_vertex(&r_vertices[vertex_count++], np->rect.position + Vector2(xs[cx], ys[cy]), color, uv);
+					}
+				}
+			}
+
+			return vertex_count;
+		}
+		case Item::Command::TYPE_PRIMITIVE: {
+			const Item::CommandPrimitive *primitive = static_cast<const Item::CommandPrimitive *>(p_command);
+
+			uint32_t index_count = primitive->point_count == 4 ? 6 : 3;
+			for (uint32_t i = 0; i < index_count; i++) {
+				uint32_t j = quad_indices[i];
+				_set_vertex(&r_vertices[i], primitive->points[j], primitive->colors[j] * p_base_color, primitive->uvs[j]);
+			}
+
+			return index_count;
+		}
+		default: {
+			ERR_FAIL_V(0); //not batchable, should have been filtered by _command_get_key
+		}
+	}
+}
+
+bool RasterizerCanvasBatcher::_item_can_span(const Item *p_item, const Light *p_lights) const {
+	if (p_item->skeleton.is_valid()) {
+		return false;
+	}
+
+	if (p_item->material.is_valid() && material_uses_vertex_func(userdata, p_item->material)) {
+		return false; //custom vertex code expects local vertices and the item transform
+	}
+
+	//lights are bound per item
+	for (const Light *light = p_lights; light; light = light->next_ptr) {
+		if (light_affects_item(light, p_item)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void RasterizerCanvasBatcher::setup(TextureBindingSizeFunc p_texture_binding_size_func, MaterialUsesVertexFunc p_material_uses_vertex_func, void *p_userdata, uint32_t p_max_vertices, uint32_t p_min_commands) {
+	texture_binding_size_func = p_texture_binding_size_func;
+	material_uses_vertex_func = p_material_uses_vertex_func;
+	userdata = p_userdata;
+	max_vertices = p_max_vertices;
+	min_commands = MAX(p_min_commands, 1u);
+}
+
+void RasterizerCanvasBatcher::plan(Item *const *p_items, int p_item_count, const Transform2D &p_canvas_transform_inverse, const Light *p_lights) {
+	clear();
+	ERR_FAIL_COND_MSG(!texture_binding_size_func || !material_uses_vertex_func, "Canvas batcher used before setup().");
+
+	int i = 0;
+	const Item::Command *c = p_item_count > 0 ? p_items[0]->commands : nullptr;
+	bool clip_ignored = false;
+
+	while (i < p_item_count) {
+		if (!c) {
+			i++;
+			c = i < p_item_count ? p_items[i]->commands : nullptr;
+			clip_ignored = false;
+			continue;
+		}
+
+		TextureBindingID texture_binding;
+		Color specular_shininess;
+		uint32_t vertex_count;
+
+		if (!_command_get_key(c, texture_binding, specular_shininess, vertex_count)) {
+			if (c->type == Item::Command::TYPE_CLIP_IGNORE) {
+				clip_ignored = true;
+			}
+			c = c->next;
+			continue;
+		}
+
+		Size2i texture_size = texture_binding_size_func(userdata, texture_binding);
+		if (texture_size.width <= 0 || texture_size.height <= 0) {
+			c = c->next;
+			continue;
+		}
+
+		//extend the run while the following commands share the same state, into the next items if possible
+		int batch_item = i;
+		const Item *ci = p_items[i];
+		bool can_span = !clip_ignored && _item_can_span(ci, p_lights);
+
+		uint32_t command_count = 1;
+		int last_item = i;
+		int n_item = i;
+		const Item::Command *n = c->next;
+
+		while (true) {
+			if (!n) {
+				if (!can_span || n_item + 1 >= p_item_count) {
+					break;
+				}
+
+				const Item *ni = p_items[n_item + 1];
+				if (ni->material != ci->material || ni->final_clip_owner != ci->final_clip_owner || !ni->commands || !_item_can_span(ni, p_lights)) {
+					break;
+				}
+
+				n_item++;
+				n = ni->commands;
+			}
+
+			TextureBindingID n_texture_binding;
+			Color n_specular_shininess;
+			uint32_t n_vertex_count;
+
+			if (!_command_get_key(n, n_texture_binding, n_specular_shininess, n_vertex_count) || n_texture_binding != texture_binding || n_specular_shininess != specular_shininess) {
+				break;
+			}
+			if (vertices.size() + vertex_count + n_vertex_count > max_vertices) {
+				break;
+			}
+
+			vertex_count += n_vertex_count;
+			command_count++;
+			last_item = n_item;
+			n = n->next;
+		}
+
+		if (command_count < min_commands || vertices.size() + vertex_count > max_vertices) {
+			c = c->next;
+			continue;
+		}
+
+		Batch batch;
+		batch.command = c;
+		batch.command_count = command_count;
+		batch.item_to = last_item;
+		batch.end_command = n_item == last_item ? n : nullptr;
+		batch.world_baked = last_item != batch_item;
+		batch.vertex_from = vertices.size();
+		batch.vertex_count = vertex_count;
+		batch.texture_binding = texture_binding;
+		batch.specular_shininess = specular_shininess;
+		batch.texpixel_size = Size2(1.0 / texture_size.width, 1.0 / texture_size.height);
+
+		vertices.resize(batch.vertex_from + vertex_count);
+		Vertex *w = &vertices[batch.vertex_from];
+
+		for (uint32_t j = 0; j < command_count; j++) {
+			if (!c) {
+				i++;
+				c = p_items[i]->commands;
+			}
+
+			uint32_t written = _command_write_vertices(c, p_items[i]->final_modulate, batch.texpixel_size, w);
+
+			if (batch.world_baked) {
+				Transform2D xform = p_canvas_transform_inverse * p_items[i]->final_transform;
+				for (uint32_t k = 0; k < written; k++) {
+					Vector2 v = xform.xform(Vector2(w[k].vertex[0], w[k].vertex[1]));
+					w[k].vertex[0] = v.x;
+					w[k].vertex[1] = v.y;
+				}
+			}
+
+			w += written;
+			c = c->next;
+		}
+
+		batches.push_back(batch);
+
+		if (i != n_item) {
+			//the run ended at the start of a later item, which has no commands in this batch
+			i = n_item;
+			c = n;
+		}
+		if (i != batch_item) {
+			clip_ignored = false;
+		}
+	}
+}
+
+void RasterizerCanvasBatcher::clear() {
+	vertices.clear();
+	batches.clear();
+}
+
+RasterizerCanvasBatcher::RasterizerCanvasBatcher() {
+	texture_binding_size_func = nullptr;
+	material_uses_vertex_func = nullptr;
+	userdata = nullptr;
+	max_vertices = 0;
+	min_commands = 1;
+}
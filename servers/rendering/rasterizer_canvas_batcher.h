@@ -0,0 +1,101 @@
+/*************************************************************************/
+/*  rasterizer_canvas_batcher.h                                          */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2020 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2020 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef RASTERIZER_CANVAS_BATCHER_H
+#define RASTERIZER_CANVAS_BATCHER_H
+
+#include "core/local_vector.h"
+#include "servers/rendering/rasterizer.h"
+
+//plans which canvas commands are merged on the CPU into one triangle list: consecutive rect,
+//stretched nine-patch and primitive commands sharing texture and specular. Runs continue into
+//the following items when they share material and clip and are not lit, in which case the
+//item transforms are baked into the vertices and the batch is drawn untransformed.
+//Uploading and drawing the batches is left to the renderer.
+
+class RasterizerCanvasBatcher {
+public:
+	typedef RasterizerCanvas::Item Item;
+	typedef RasterizerCanvas::Light Light;
+	typedef RasterizerCanvas::TextureBindingID TextureBindingID;
+
+	struct Vertex {
+		float vertex[2];
+		float color[4];
+		float uv[2];
+	};
+
+	struct Batch {
+		const Item::Command *command; //first command merged into this batch
+		uint32_t command_count;
+		int item_to; //last item with commands in this batch
+		const Item::Command *end_command; //command of item_to following the batch, if any
+		bool world_baked;
+		uint32_t vertex_from;
+		uint32_t vertex_count;
+		TextureBindingID texture_binding;
+		Color specular_shininess;
+		Size2 texpixel_size;
+	};
+
+	//renderer state the plan depends on
+	typedef Size2i (*TextureBindingSizeFunc)(void *p_userdata, TextureBindingID p_binding);
+	typedef bool (*MaterialUsesVertexFunc)(void *p_userdata, RID p_material);
+
+private:
+	TextureBindingSizeFunc texture_binding_size_func;
+	MaterialUsesVertexFunc material_uses_vertex_func;
+	void *userdata;
+	uint32_t max_vertices;
+	uint32_t min_commands;
+
+	_FORCE_INLINE_ static void _set_vertex(Vertex *r_vertex, const Vector2 &p_vertex, const Color &p_color, const Vector2 &p_uv);
+	static bool _command_get_key(const Item::Command *p_command, TextureBindingID &r_texture_binding, Color &r_specular_shininess, uint32_t &r_vertex_count);
+	static uint32_t _command_write_vertices(const Item::Command *p_command, const Color &p_base_color, const Size2 &p_texpixel_size, Vertex *r_vertices);
+	bool _item_can_span(const Item *p_item, const Light *p_lights) const;
+
+public:
+	LocalVector<Vertex> vertices;
+	LocalVector<Batch> batches;
+
+	_FORCE_INLINE_ static bool light_affects_item(const Light *p_light, const Item *p_item) {
+		return p_light->render_index_cache >= 0 && p_item->light_mask & p_light->item_mask && p_item->z_final >= p_light->z_min && p_item->z_final <= p_light->z_max && p_item->global_rect_cache.intersects_transformed(p_light->xform_cache, p_light->rect_cache);
+	}
+
+	void setup(TextureBindingSizeFunc p_texture_binding_size_func, MaterialUsesVertexFunc p_material_uses_vertex_func, void *p_userdata, uint32_t p_max_vertices, uint32_t p_min_commands);
+
+	//fills vertices and batches, ordered by first command as the items are drawn
+	void plan(Item *const *p_items, int p_item_count, const Transform2D &p_canvas_transform_inverse, const Light *p_lights);
+	void clear();
+
+	RasterizerCanvasBatcher();
+};
+
+#endif // RASTERIZER_CANVAS_BATCHER_H
@@ -483,8 +483,48 @@ Size2i RasterizerCanvasRD::_bind_texture_binding(TextureBindingID p_binding, RD:
 	}
 }
 
+Size2i RasterizerCanvasRD::_get_texture_binding_size(TextureBindingID p_binding) const {
+	TextureBinding *const *texture_binding_ptr = bindings.texture_bindings.getptr(p_binding);
+	if (!texture_binding_ptr) {
+		return Size2i();
+	}
+	const TextureBinding *texture_binding = *texture_binding_ptr;
+
+	if (texture_binding->key.texture.is_valid()) {
+		return storage->texture_2d_get_size(texture_binding->key.texture);
+	} else {
+		return Size2i(1, 1);
+	}
+}
+
+////////////////////
+
+RID RasterizerCanvasRD::_batch_get_index_array(uint32_t p_vertex_from, uint32_t p_vertex_count) {
+	uint64_t key = (uint64_t(p_vertex_from) << 32) | p_vertex_count;
+
+	BatchIndexArray *ia = batching.index_arrays.getptr(key);
+	if (!ia) {
+		BatchIndexArray new_ia;
+		new_ia.index_array = RD::get_singleton()->index_array_create(batching.index_buffer, p_vertex_from, p_vertex_count);
+		batching.index_arrays.set(key, new_ia);
+		ia = batching.index_arrays.getptr(key);
+	}
+
+	ia->last_pass = batching.pass;
+	return ia->index_array;
+}
+
+Size2i RasterizerCanvasRD::_batch_get_texture_binding_size(void *p_userdata, TextureBindingID p_binding) {
+	return ((RasterizerCanvasRD *)p_userdata)->_get_texture_binding_size(p_binding);
+}
+
+bool RasterizerCanvasRD::_batch_material_uses_vertex(void *p_userdata, RID p_material) {
+	MaterialData *material_data = (MaterialData *)((RasterizerCanvasRD *)p_userdata)->storage->material_get_data(p_material, RasterizerStorageRD::SHADER_TYPE_2D);
+	return material_data && material_data->shader_data->uses_vertex;
+}
+
 ////////////////////
-void RasterizerCanvasRD::_render_item(RD::DrawListID p_draw_list, const Item *p_item, RD::FramebufferFormatID p_framebuffer_format, const Transform2D &p_canvas_transform_inverse, Item *&current_clip, Light *p_lights, PipelineVariants *p_pipeline_variants) {
+void RasterizerCanvasRD::_render_item(RD::DrawListID p_draw_list, const Item *p_item, const Item::Command *p_from_command, RD::FramebufferFormatID p_framebuffer_format, const Transform2D &p_canvas_transform_inverse, Item *&current_clip, Light *p_lights, PipelineVariants *p_pipeline_variants, uint32_t &r_batch_index, int &r_resume_item, const Item::Command *&r_resume_command) {
 	//create an empty push constant
 
 	PushConstant push_constant;
@@ -530,7 +570,7 @@ void RasterizerCanvasRD::_render_item(RD::DrawListID p_draw_list, const Item *p_
 		Light *light = p_lights;
 
 		while (light) {
-			if (light->render_index_cache >= 0 && p_item->light_mask & light->item_mask && p_item->z_final >= light->z_min && p_item->z_final <= light->z_max && p_item->global_rect_cache.intersects_transformed(light->xform_cache, light->rect_cache)) {
+			if (RasterizerCanvasBatcher::light_affects_item(light, p_item)) {
 				uint32_t light_index = light->render_index_cache;
 				push_constant.lights[light_count >> 2] |= light_index << ((light_count & 3) * 8);
 
@@ -684,11 +724,64 @@ void RasterizerCanvasRD::_render_item(RD::DrawListID p_draw_list, const Item *p_
 
 	bool reclip = false;
 
-	const Item::Command *c = p_item->commands;
+	const Item::Command *c = p_from_command;
 	while (c) {
 		push_constant.flags = base_flags; //reset on each command for sanity
 		push_constant.specular_shininess = 0xFFFFFFFF;
 
+		if (r_batch_index < batching.batcher.batches.size() && batching.batcher.batches[r_batch_index].command == c) {
+			const RasterizerCanvasBatcher::Batch &batch = batching.batcher.batches[r_batch_index];
+			RID index_array = batching.batch_index_arrays[r_batch_index];
+			r_batch_index++;
+
+			//bind pipeline
+			{
+				RID pipeline = pipeline_variants->variants[light_mode][PIPELINE_VARIANT_ATTRIBUTE_TRIANGLES].get_render_pipeline(batching.vertex_format, p_framebuffer_format);
+				RD::get_singleton()->draw_list_bind_render_pipeline(p_draw_list, pipeline);
+			}
+
+			_bind_texture_binding(batch.texture_binding, p_draw_list, push_constant.flags);
+
+			if (batch.specular_shininess.a < 0.999) {
+				push_constant.flags |= FLAGS_DEFAULT_SPECULAR_MAP_USED;
+			}
+
+			_update_specular_shininess(batch.specular_shininess, &push_constant.specular_shininess);
+
+			//modulation is already baked into the vertex colors
+			for (int j = 0; j < 4; j++) {
+				push_constant.modulation[j] = 1;
+				push_constant.src_rect[j] = 0;
+				push_constant.dst_rect[j] = 0;
+				push_constant.ninepatch_margins[j] = 0;
+			}
+
+			push_constant.color_texture_pixel_size[0] = batch.texpixel_size.x;
+			push_constant.color_texture_pixel_size[1] = batch.texpixel_size.y;
+
+			if (batch.world_baked) {
+				_update_transform_2d_to_mat2x3(Transform2D(), push_constant.world);
+			}
+
+			RD::get_singleton()->draw_list_set_push_constant(p_draw_list, &push_constant, sizeof(PushConstant));
+			RD::get_singleton()->draw_list_bind_vertex_array(p_draw_list, batching.vertex_array);
+			RD::get_singleton()->draw_list_bind_index_array(p_draw_list, index_array);
+			RD::get_singleton()->draw_list_draw(p_draw_list, true);
+			storage->info.render._2d_draw_call_count++;
+
+			if (batch.world_baked) {
+				//the batch took the rest of this item and continues into the next ones
+				r_resume_item = batch.item_to;
+				r_resume_command = batch.end_command;
+				break;
+			}
+
+			for (uint32_t j = 0; j < batch.command_count; j++) {
+				c = c->next;
+			}
+			continue;
+		}
+
 		switch (c->type) {
 			case Item::Command::TYPE_RECT: {
 				const Item::CommandRect *rect = static_cast<const Item::CommandRect *>(c);
@@ -742,7 +835,7 @@ void RasterizerCanvasRD::_render_item(RD::DrawListID p_draw_list, const Item *p_
 					}
 
 					if (rect->flags & CANVAS_RECT_TRANSPOSE) {
-						dst_rect.size.x *= -1; // Encoding in the dst_rect.z uniform
+						push_constant.flags |= FLAGS_TRANSPOSE_RECT;
 					}
 
 					if (rect->flags & CANVAS_RECT_CLIP_UV) {
@@ -786,6 +879,7 @@ void RasterizerCanvasRD::_render_item(RD::DrawListID p_draw_list, const Item *p_
 				RD::get_singleton()->draw_list_set_push_constant(p_draw_list, &push_constant, sizeof(PushConstant));
 				RD::get_singleton()->draw_list_bind_index_array(p_draw_list, shader.quad_index_array);
 				RD::get_singleton()->draw_list_draw(p_draw_list, true);
+				storage->info.render._2d_draw_call_count++;
 
 			} break;
 
@@ -862,6 +956,7 @@ void RasterizerCanvasRD::_render_item(RD::DrawListID p_draw_list, const Item *p_
 				RD::get_singleton()->draw_list_set_push_constant(p_draw_list, &push_constant, sizeof(PushConstant));
 				RD::get_singleton()->draw_list_bind_index_array(p_draw_list, shader.quad_index_array);
 				RD::get_singleton()->draw_list_draw(p_draw_list, true);
+				storage->info.render._2d_draw_call_count++;
 
 			} break;
 			case Item::Command::TYPE_POLYGON: {
@@ -917,6 +1012,7 @@ void RasterizerCanvasRD::_render_item(RD::DrawListID p_draw_list, const Item *p_
 					RD::get_singleton()->draw_list_bind_index_array(p_draw_list, pb->indices);
 				}
 				RD::get_singleton()->draw_list_draw(p_draw_list, pb->indices.is_valid());
+				storage->info.render._2d_draw_call_count++;
 
 			} break;
 			case Item::Command::TYPE_PRIMITIVE: {
@@ -955,6 +1051,7 @@ void RasterizerCanvasRD::_render_item(RD::DrawListID p_draw_list, const Item *p_
 				}
 				RD::get_singleton()->draw_list_set_push_constant(p_draw_list, &push_constant, sizeof(PushConstant));
 				RD::get_singleton()->draw_list_draw(p_draw_list, true);
+				storage->info.render._2d_draw_call_count++;
 
 				if (primitive->point_count == 4) {
 					for (uint32_t j = 1; j < 3; j++) {
@@ -970,6 +1067,7 @@ void RasterizerCanvasRD::_render_item(RD::DrawListID p_draw_list, const Item *p_
 
 					RD::get_singleton()->draw_list_set_push_constant(p_draw_list, &push_constant, sizeof(PushConstant));
 					RD::get_singleton()->draw_list_draw(p_draw_list, true);
+					storage->info.render._2d_draw_call_count++;
 				}
 
 			} break;
@@ -1315,6 +1413,23 @@ void RasterizerCanvasRD::_render_items(RID p_to_render_target, int p_item_count,
 
 	RD::FramebufferFormatID fb_format = RD::get_singleton()->framebuffer_get_format(framebuffer);
 
+	//batches must be uploaded before the draw list begins
+	if (batching.enabled) {
+		batching.batcher.plan(items, p_item_count, canvas_transform_inverse, p_lights);
+	} else {
+		batching.batcher.clear();
+	}
+	batching.pass++;
+
+	batching.batch_index_arrays.resize(batching.batcher.batches.size());
+	if (batching.batcher.vertices.size()) {
+		RD::get_singleton()->buffer_update(batching.vertex_buffer, 0, batching.batcher.vertices.size() * sizeof(RasterizerCanvasBatcher::Vertex), &batching.batcher.vertices[0], true);
+
+		for (uint32_t i = 0; i < batching.batcher.batches.size(); i++) {
+			batching.batch_index_arrays[i] = _batch_get_index_array(batching.batcher.batches[i].vertex_from, batching.batcher.batches[i].vertex_count);
+		}
+	}
+
 	RD::DrawListID draw_list = RD::get_singleton()->draw_list_begin(framebuffer, clear ? RD::INITIAL_ACTION_CLEAR : RD::INITIAL_ACTION_KEEP, RD::FINAL_ACTION_READ, RD::INITIAL_ACTION_KEEP, RD::FINAL_ACTION_DISCARD, clear_colors);
 
 	if (p_screen_uniform_set.is_valid()) {
@@ -1324,6 +1439,10 @@ void RasterizerCanvasRD::_render_items(RID p_to_render_target, int p_item_count,
 
 	PipelineVariants *pipeline_variants = &shader.pipeline_variants;
 
+	uint32_t batch_index = 0;
+	int resume_item = -1;
+	const Item::Command *resume_command = nullptr;
+
 	for (int i = 0; i < p_item_count; i++) {
 		Item *ci = items[i];
 
@@ -1359,12 +1478,31 @@ void RasterizerCanvasRD::_render_items(RID p_to_render_target, int p_item_count,
 			}
 		}
 
-		_render_item(draw_list, ci, fb_format, canvas_transform_inverse, current_clip, p_lights, pipeline_variants);
+		if (i > resume_item || (i == resume_item && resume_command)) {
+			//items fully drawn by a batch of a previous item are skipped
+			_render_item(draw_list, ci, i == resume_item ? resume_command : ci->commands, fb_format, canvas_transform_inverse, current_clip, p_lights, pipeline_variants, batch_index, resume_item, resume_command);
+		}
+		storage->info.render._2d_item_count++;
 
 		prev_material = ci->material;
 	}
 
 	RD::get_singleton()->draw_list_end();
+
+	batching.batcher.clear();
+	batching.batch_index_arrays.clear();
+
+	//free the index arrays no batch used for a while
+	List<uint64_t> unused_index_arrays;
+	for (const uint64_t *k = batching.index_arrays.next(nullptr); k; k = batching.index_arrays.next(k)) {
+		if (batching.index_arrays[*k].last_pass + BATCH_INDEX_ARRAY_MAX_AGE < batching.pass) {
+			unused_index_arrays.push_back(*k);
+		}
+	}
+	for (List<uint64_t>::Element *E = unused_index_arrays.front(); E; E = E->next()) {
+		RD::get_singleton()->free(batching.index_arrays[E->get()].index_array);
+		batching.index_arrays.erase(E->get());
+	}
 }
 
 void RasterizerCanvasRD::canvas_render_items(RID p_to_render_target, Item *p_item_list, const Color &p_modulate, Light *p_light_list, const Transform2D &p_canvas_transform) {
@@ -1775,6 +1913,7 @@ void RasterizerCanvasRD::ShaderData::set_code(const String &p_code) {
 	uniforms.clear();
 	uses_screen_texture = false;
 	uses_material_samplers = false;
+	uses_vertex = false;
 
 	if (code == String()) {
 		return; //just invalid, but no error
@@ -1816,6 +1955,8 @@ void RasterizerCanvasRD::ShaderData::set_code(const String &p_code) {
 		gen_code.defines.push_back("\n#define USE_MATERIAL_SAMPLERS\n");
 		uses_material_samplers = true;
 	}
+
+	uses_vertex = gen_code.vertex != String();
 #if 0
 	print_line("**compiling shader:");
 	print_line("**defines:\n");
@@ -2023,6 +2164,7 @@ RasterizerCanvasRD::ShaderData::ShaderData() {
 	valid = false;
 	uses_screen_texture = false;
 	uses_material_samplers = false;
+	uses_vertex = false;
 }
 
 RasterizerCanvasRD::ShaderData::~ShaderData() {
@@ -2426,6 +2568,59 @@ RasterizerCanvasRD::RasterizerCanvasRD(RasterizerStorageRD *p_storage) {
 		shader.quad_index_array = RD::get_singleton()->index_array_create(shader.quad_index_buffer, 0, 6);
 	}
 
+	{ //batching
+		batching.enabled = GLOBAL_GET("rendering/quality/2d/use_batching");
+		batching.pass = 0;
+		batching.batcher.setup(&RasterizerCanvasRD::_batch_get_texture_binding_size, &RasterizerCanvasRD::_batch_material_uses_vertex, this, BATCH_MAX_VERTICES, BATCH_MIN_COMMANDS);
+
+		Vector<RD::VertexAttribute> descriptions;
+		Vector<RID> buffers;
+
+		batching.vertex_buffer = RD::get_singleton()->vertex_buffer_create(BATCH_MAX_VERTICES * sizeof(RasterizerCanvasBatcher::Vertex));
+
+		RD::VertexAttribute vd;
+		vd.stride = sizeof(RasterizerCanvasBatcher::Vertex);
+
+		vd.format = RD::DATA_FORMAT_R32G32_SFLOAT;
+		vd.offset = 0;
+		vd.location = RS::ARRAY_VERTEX;
+		descriptions.push_back(vd);
+		buffers.push_back(batching.vertex_buffer);
+
+		vd.format = RD::DATA_FORMAT_R32G32B32A32_SFLOAT;
+		vd.offset = 2 * sizeof(float);
+		vd.location = RS::ARRAY_COLOR;
+		descriptions.push_back(vd);
+		buffers.push_back(batching.vertex_buffer);
+
+		vd.format = RD::DATA_FORMAT_R32G32_SFLOAT;
+		vd.offset = 6 * sizeof(float);
+		vd.location = RS::ARRAY_TEX_UV;
+		descriptions.push_back(vd);
+		buffers.push_back(batching.vertex_buffer);
+
+		vd.format = RD::DATA_FORMAT_R32G32B32A32_UINT;
+		vd.offset = 0;
+		vd.stride = 0;
+		vd.location = RS::ARRAY_BONES;
+		descriptions.push_back(vd);
+		buffers.push_back(storage->mesh_get_default_rd_buffer(RasterizerStorageRD::DEFAULT_RD_BUFFER_BONES));
+
+		batching.vertex_format = RD::get_singleton()->vertex_format_create(descriptions);
+		batching.vertex_array = RD::get_singleton()->vertex_array_create(BATCH_MAX_VERTICES, batching.vertex_format, buffers);
+
+		//batches are non indexed triangle lists, the identity index buffer only allows drawing them from an offset
+		Vector<uint8_t> pv;
+		pv.resize(BATCH_MAX_VERTICES * sizeof(uint32_t));
+		{
+			uint32_t *p32 = (uint32_t *)pv.ptrw();
+			for (uint32_t i = 0; i < BATCH_MAX_VERTICES; i++) {
+				p32[i] = i;
+			}
+		}
+		batching.index_buffer = RD::get_singleton()->index_buffer_create(BATCH_MAX_VERTICES, RenderingDevice::INDEX_BUFFER_FORMAT_UINT32, pv);
+	}
+
 	{ //primitive
 		primitive_arrays.index_array[0] = shader.quad_index_array = RD::get_singleton()->index_array_create(shader.quad_index_buffer, 0, 1);
 		primitive_arrays.index_array[1] = shader.quad_index_array = RD::get_singleton()->index_array_create(shader.quad_index_buffer, 0, 2);
@@ -2518,6 +2713,15 @@ RasterizerCanvasRD::~RasterizerCanvasRD() {
 		RD::get_singleton()->free(shader.quad_index_array);
 		RD::get_singleton()->free(shader.quad_index_buffer);
 		//primitives are erase by dependency
+
+		for (const uint64_t *k = batching.index_arrays.next(nullptr); k; k = batching.index_arrays.next(k)) {
+			RD::get_singleton()->free(batching.index_arrays[*k].index_array);
+		}
+		batching.index_arrays.clear();
+
+		RD::get_singleton()->free(batching.vertex_array);
+		RD::get_singleton()->free(batching.vertex_buffer);
+		RD::get_singleton()->free(batching.index_buffer);
 	}
 
 	//pipelines don't need freeing, they are all gone after shaders are gone
@@ -31,7 +31,10 @@
 #ifndef RASTERIZER_CANVAS_RD_H
 #define RASTERIZER_CANVAS_RD_H
 
+#include "core/hash_map.h"
+#include "core/local_vector.h"
 #include "servers/rendering/rasterizer.h"
+#include "servers/rendering/rasterizer_canvas_batcher.h"
 #include "servers/rendering/rasterizer_rd/rasterizer_storage_rd.h"
 #include "servers/rendering/rasterizer_rd/render_pipeline_vertex_format_cache_rd.h"
 #include "servers/rendering/rasterizer_rd/shader_compiler_rd.h"
@@ -101,7 +104,10 @@ class RasterizerCanvasRD : public RasterizerCanvas {
 		MAX_RENDER_ITEMS = 256 * 1024,
 		MAX_LIGHT_TEXTURES = 1024,
 		DEFAULT_MAX_LIGHTS_PER_ITEM = 16,
-		DEFAULT_MAX_LIGHTS_PER_RENDER = 256
+		DEFAULT_MAX_LIGHTS_PER_RENDER = 256,
+		BATCH_MAX_VERTICES = 65536,
+		BATCH_MIN_COMMANDS = 2,
+		BATCH_INDEX_ARRAY_MAX_AGE = 60
 	};
 
 	/****************/
@@ -179,6 +185,7 @@ class RasterizerCanvasRD : public RasterizerCanvas {
 
 		bool uses_screen_texture;
 		bool uses_material_samplers;
+		bool uses_vertex;
 
 		virtual void set_code(const String &p_Code);
 		virtual void set_default_texture_param(const StringName &p_name, RID p_texture);
@@ -450,10 +457,40 @@ class RasterizerCanvasRD : public RasterizerCanvas {
 		float skeleton_inverse[16];
 	};
 
+	/******************/
+	/**** BATCHING ****/
+	/******************/
+
+	//planning is done by RasterizerCanvasBatcher before the draw list begins, the merged
+	//commands are then drawn with the attribute pipeline in a single call per batch
+
+	struct BatchIndexArray {
+		RID index_array;
+		uint64_t last_pass;
+	};
+
+	struct {
+		bool enabled;
+		RasterizerCanvasBatcher batcher;
+		LocalVector<RID> batch_index_arrays; //parallel to batcher.batches
+		RID vertex_buffer;
+		RID vertex_array;
+		RID index_buffer;
+		RD::VertexFormatID vertex_format;
+		//index arrays over the shared index buffer, keyed by vertex range and kept while in use
+		HashMap<uint64_t, BatchIndexArray> index_arrays;
+		uint64_t pass;
+	} batching;
+
 	Item *items[MAX_RENDER_ITEMS];
 
+	Size2i _get_texture_binding_size(TextureBindingID p_binding) const;
+	static Size2i _batch_get_texture_binding_size(void *p_userdata, TextureBindingID p_binding);
+	static bool _batch_material_uses_vertex(void *p_userdata, RID p_material);
+	RID _batch_get_index_array(uint32_t p_vertex_from, uint32_t p_vertex_count);
+
 	Size2i _bind_texture_binding(TextureBindingID p_binding, RenderingDevice::DrawListID p_draw_list, uint32_t &flags);
-	void _render_item(RenderingDevice::DrawListID p_draw_list, const Item *p_item, RenderingDevice::FramebufferFormatID p_framebuffer_format, const Transform2D &p_canvas_transform_inverse, Item *&current_clip, Light *p_lights, PipelineVariants *p_pipeline_variants);
+	void _render_item(RenderingDevice::DrawListID p_draw_list, const Item *p_item, const Item::Command *p_from_command, RenderingDevice::FramebufferFormatID p_framebuffer_format, const Transform2D &p_canvas_transform_inverse, Item *&current_clip, Light *p_lights, PipelineVariants *p_pipeline_variants, uint32_t &r_batch_index, int &r_resume_item, const Item::Command *&r_resume_command);
 	void _render_items(RID p_to_render_target, int p_item_count, const Transform2D &p_canvas_transform_inverse, Light *p_lights, RID p_screen_uniform_set);
 
 	_FORCE_INLINE_ void _update_transform_2d_to_mat2x4(const Transform2D &p_transform, float *p_mat2x4);
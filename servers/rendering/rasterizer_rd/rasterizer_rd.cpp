@@ -31,6 +31,7 @@
 #include "rasterizer_rd.h"
 
 #include "core/project_settings.h"
+#include "servers/rendering/rasterizer_rd/shader_rd.h"
 
 void RasterizerRD::prepare_for_blitting_render_targets() {
 	RD::get_singleton()->prepare_screen_for_drawing();
@@ -86,6 +87,9 @@ void RasterizerRD::begin_frame(double frame_step) {
 
 	canvas->set_time(time);
 	scene->set_time(time, frame_step);
+
+	storage->info.render_final = storage->info.render;
+	storage->info.render.reset();
 }
 
 void RasterizerRD::end_frame(bool p_swap_buffers) {
@@ -158,6 +162,7 @@ ThreadWorkPool RasterizerRD::thread_work_pool;
 uint64_t RasterizerRD::frame = 1;
 
 void RasterizerRD::finalize() {
+	ShaderRD::finish_async_compiler();
 	thread_work_pool.finish();
 
 	memdelete(scene);
@@ -177,6 +182,10 @@ RasterizerRD::RasterizerRD() {
 	thread_work_pool.init();
 	time = 0;
 
+	if (GLOBAL_DEF("rendering/vulkan/shader_cache/enabled", true)) {
+		ShaderRD::set_shader_cache_dir("user://shader_cache", GLOBAL_DEF("rendering/vulkan/shader_cache/max_entries", 4096));
+	}
+
 	storage = memnew(RasterizerStorageRD);
 	canvas = memnew(RasterizerCanvasRD(storage));
 	scene = memnew(RasterizerSceneHighEndRD(storage));
@@ -102,6 +102,7 @@ void RasterizerSceneHighEndRD::ShaderData::set_code(const String &p_code) {
 
 	code = p_code;
 	valid = false;
+	compiling = false;
 	ubo_size = 0;
 	uniforms.clear();
 	uses_screen_texture = false;
@@ -112,9 +113,9 @@ void RasterizerSceneHighEndRD::ShaderData::set_code(const String &p_code) {
 
 	ShaderCompilerRD::GeneratedCode gen_code;
 
-	int blend_mode = BLEND_MODE_MIX;
+	int blend_modei = BLEND_MODE_MIX;
 	int depth_testi = DEPTH_TEST_ENABLED;
-	int cull = CULL_BACK;
+	int culli = CULL_BACK;
 
 	uses_point_size = false;
 	uses_alpha = false;
@@ -123,7 +124,7 @@ void RasterizerSceneHighEndRD::ShaderData::set_code(const String &p_code) {
 	uses_discard = false;
 	uses_roughness = false;
 	uses_normal = false;
-	bool wireframe = false;
+	wireframe = false;
 
 	unshaded = false;
 	uses_vertex = false;
@@ -140,10 +141,10 @@ void RasterizerSceneHighEndRD::ShaderData::set_code(const String &p_code) {
 
 	ShaderCompilerRD::IdentifierActions actions;
 
-	actions.render_mode_values["blend_add"] = Pair<int *, int>(&blend_mode, BLEND_MODE_ADD);
-	actions.render_mode_values["blend_mix"] = Pair<int *, int>(&blend_mode, BLEND_MODE_MIX);
-	actions.render_mode_values["blend_sub"] = Pair<int *, int>(&blend_mode, BLEND_MODE_SUB);
-	actions.render_mode_values["blend_mul"] = Pair<int *, int>(&blend_mode, BLEND_MODE_MUL);
+	actions.render_mode_values["blend_add"] = Pair<int *, int>(&blend_modei, BLEND_MODE_ADD);
+	actions.render_mode_values["blend_mix"] = Pair<int *, int>(&blend_modei, BLEND_MODE_MIX);
+	actions.render_mode_values["blend_sub"] = Pair<int *, int>(&blend_modei, BLEND_MODE_SUB);
+	actions.render_mode_values["blend_mul"] = Pair<int *, int>(&blend_modei, BLEND_MODE_MUL);
 
 	actions.render_mode_values["depth_draw_never"] = Pair<int *, int>(&depth_drawi, DEPTH_DRAW_DISABLED);
 	actions.render_mode_values["depth_draw_opaque"] = Pair<int *, int>(&depth_drawi, DEPTH_DRAW_OPAQUE);
@@ -151,9 +152,9 @@ void RasterizerSceneHighEndRD::ShaderData::set_code(const String &p_code) {
 
 	actions.render_mode_values["depth_test_disabled"] = Pair<int *, int>(&depth_testi, DEPTH_TEST_DISABLED);
 
-	actions.render_mode_values["cull_disabled"] = Pair<int *, int>(&cull, CULL_DISABLED);
-	actions.render_mode_values["cull_front"] = Pair<int *, int>(&cull, CULL_FRONT);
-	actions.render_mode_values["cull_back"] = Pair<int *, int>(&cull, CULL_BACK);
+	actions.render_mode_values["cull_disabled"] = Pair<int *, int>(&culli, CULL_DISABLED);
+	actions.render_mode_values["cull_front"] = Pair<int *, int>(&culli, CULL_FRONT);
+	actions.render_mode_values["cull_back"] = Pair<int *, int>(&culli, CULL_BACK);
 
 	actions.render_mode_flags["unshaded"] = &unshaded;
 	actions.render_mode_flags["wireframe"] = &wireframe;
@@ -194,6 +195,8 @@ void RasterizerSceneHighEndRD::ShaderData::set_code(const String &p_code) {
 
 	depth_draw = DepthDraw(depth_drawi);
 	depth_test = DepthTest(depth_testi);
+	blend_mode = BlendMode(blend_modei);
+	cull_mode = Cull(culli);
 
 #if 0
 	print_line("**compiling shader:");
@@ -208,13 +211,44 @@ void RasterizerSceneHighEndRD::ShaderData::set_code(const String &p_code) {
 	print_line("\n**fragment_code:\n" + gen_code.fragment);
 	print_line("\n**light_code:\n" + gen_code.light);
 #endif
-	scene_singleton->shader.scene_shader.version_set_code(version, gen_code.uniforms, gen_code.vertex_global, gen_code.vertex, gen_code.fragment_global, gen_code.light, gen_code.fragment, gen_code.defines);
-	ERR_FAIL_COND(!scene_singleton->shader.scene_shader.version_is_valid(version));
-
 	ubo_size = gen_code.uniform_total_size;
 	ubo_offsets = gen_code.uniform_offsets;
 	texture_uniforms = gen_code.texture_uniforms;
 
+	bool async = scene_singleton->shader.async_compilation;
+	scene_singleton->shader.scene_shader.version_set_code(version, gen_code.uniforms, gen_code.vertex_global, gen_code.vertex, gen_code.fragment_global, gen_code.light, gen_code.fragment, gen_code.defines, async);
+
+	if (async) {
+		// Materials render with the default material until is_compiling() finds it done.
+		compiling = true;
+		return;
+	}
+
+	ERR_FAIL_COND(!scene_singleton->shader.scene_shader.version_is_valid(version));
+
+	_create_pipelines();
+}
+
+bool RasterizerSceneHighEndRD::ShaderData::is_compiling() {
+	if (!compiling) {
+		return false;
+	}
+
+	RasterizerSceneHighEndRD *scene_singleton = (RasterizerSceneHighEndRD *)RasterizerSceneHighEndRD::singleton;
+	if (scene_singleton->shader.scene_shader.version_is_compiling(version)) {
+		return true;
+	}
+
+	compiling = false;
+	ERR_FAIL_COND_V(!scene_singleton->shader.scene_shader.version_is_valid(version), false);
+
+	_create_pipelines();
+	return false;
+}
+
+void RasterizerSceneHighEndRD::ShaderData::_create_pipelines() {
+	RasterizerSceneHighEndRD *scene_singleton = (RasterizerSceneHighEndRD *)RasterizerSceneHighEndRD::singleton;
+
 	//blend modes
 
 	RD::PipelineColorBlendState::Attachment blend_attachment;
@@ -288,7 +322,7 @@ void RasterizerSceneHighEndRD::ShaderData::set_code(const String &p_code) {
 			{ RD::POLYGON_CULL_DISABLED, RD::POLYGON_CULL_DISABLED, RD::POLYGON_CULL_DISABLED }
 		};
 
-		RD::PolygonCullMode cull_mode_rd = cull_mode_rd_table[i][cull];
+		RD::PolygonCullMode cull_mode_rd = cull_mode_rd_table[i][cull_mode];
 
 		for (int j = 0; j < RS::PRIMITIVE_MAX; j++) {
 			RD::RenderPrimitive primitive_rd_table[RS::PRIMITIVE_MAX] = {
@@ -502,6 +536,11 @@ void RasterizerSceneHighEndRD::MaterialData::update_parameters(const Map<StringN
 		return;
 	}
 
+	if (!shader_data->valid) {
+		// The shader is still compiling, the uniform set is created when it's done.
+		return;
+	}
+
 	if (!p_textures_dirty && uniform_set.is_valid() && RD::get_singleton()->uniform_set_is_valid(uniform_set)) {
 		//no reason to update uniform set, only UBO (or nothing) was needed to update
 		return;
@@ -955,6 +994,9 @@ void RasterizerSceneHighEndRD::_render_list(RenderingDevice::DrawListID p_draw_l
 	RID prev_pipeline_rd;
 	RID prev_xforms_uniform_set;
 
+	//lod thresholds are computed for the camera, don't use them for shadows or baking
+	bool use_mesh_lod = p_pass_mode != PASS_MODE_SHADOW && p_pass_mode != PASS_MODE_SHADOW_DP && p_pass_mode != PASS_MODE_DEPTH_MATERIAL;
+
 	PushConstant push_constant;
 	zeromem(&push_constant, sizeof(PushConstant));
 	push_constant.bake_uv2_offset[0] = p_uv_offset.x;
@@ -1059,12 +1101,12 @@ void RasterizerSceneHighEndRD::_render_list(RenderingDevice::DrawListID p_draw_l
 
 		switch (e->instance->base_type) {
 			case RS::INSTANCE_MESH: {
-				storage->mesh_surface_get_arrays_and_format(e->instance->base, e->surface_index, pipeline->get_vertex_input_mask(), vertex_array_rd, index_array_rd, vertex_format);
+				storage->mesh_surface_get_arrays_and_format(e->instance->base, e->surface_index, pipeline->get_vertex_input_mask(), vertex_array_rd, index_array_rd, vertex_format, use_mesh_lod ? e->instance->lod_threshold : 0.0);
 			} break;
 			case RS::INSTANCE_MULTIMESH: {
 				RID mesh = storage->multimesh_get_mesh(e->instance->base);
 				ERR_CONTINUE(!mesh.is_valid()); //should be a bug
-				storage->mesh_surface_get_arrays_and_format(mesh, e->surface_index, pipeline->get_vertex_input_mask(), vertex_array_rd, index_array_rd, vertex_format);
+				storage->mesh_surface_get_arrays_and_format(mesh, e->surface_index, pipeline->get_vertex_input_mask(), vertex_array_rd, index_array_rd, vertex_format, use_mesh_lod ? e->instance->lod_threshold : 0.0);
 			} break;
 			case RS::INSTANCE_IMMEDIATE: {
 				ERR_CONTINUE(true); //should be a bug
@@ -3233,6 +3275,9 @@ RasterizerSceneHighEndRD::RasterizerSceneHighEndRD(RasterizerStorageRD *p_storag
 		storage->material_set_shader(wireframe_material, wireframe_material_shader);
 	}
 
+	// The materials above are the fallbacks used while other shaders compile, so they're always built synchronously.
+	shader.async_compilation = GLOBAL_DEF("rendering/vulkan/shaders/async_compilation", false);
+
 	{
 		default_vec4_xform_buffer = RD::get_singleton()->storage_buffer_create(256);
 		Vector<RD::Uniform> uniforms;
@@ -67,6 +67,7 @@ class RasterizerSceneHighEndRD : public RasterizerSceneRD {
 	struct {
 		SceneHighEndShaderRD scene_shader;
 		ShaderCompilerRD compiler;
+		bool async_compilation = false;
 	} shader;
 
 	RasterizerStorageRD *storage;
@@ -124,6 +125,12 @@ class RasterizerSceneHighEndRD : public RasterizerSceneRD {
 
 		DepthDraw depth_draw;
 		DepthTest depth_test;
+		BlendMode blend_mode;
+		Cull cull_mode;
+		bool wireframe;
+
+		bool compiling = false;
+		void _create_pipelines();
 
 		bool uses_point_size;
 		bool uses_alpha;
@@ -156,6 +163,7 @@ class RasterizerSceneHighEndRD : public RasterizerSceneRD {
 		virtual bool is_animated() const;
 		virtual bool casts_shadows() const;
 		virtual Variant get_default_parameter(const StringName &p_parameter) const;
+		virtual bool is_compiling();
 		ShaderData();
 		virtual ~ShaderData();
 	};
@@ -1055,6 +1055,9 @@ void RasterizerStorageRD::shader_set_code(RID p_shader, const String &p_code) {
 
 	if (shader->data) {
 		shader->data->set_code(p_code);
+		if (shader->data->is_compiling()) {
+			compiling_shaders.insert(shader);
+		}
 	}
 
 	for (Set<Material *>::Element *E = shader->owners.front(); E; E = E->next()) {
@@ -1988,6 +1991,26 @@ void RasterizerStorageRD::material_force_update_textures(RID p_material, ShaderT
 	}
 }
 
+void RasterizerStorageRD::_update_compiling_shaders() {
+	Set<Shader *>::Element *E = compiling_shaders.front();
+	while (E) {
+		Set<Shader *>::Element *N = E->next();
+		Shader *shader = E->get();
+
+		if (!shader->data || !shader->data->is_compiling()) {
+			// Materials can now create their uniform sets and pipelines.
+			for (Set<Material *>::Element *F = shader->owners.front(); F; F = F->next()) {
+				Material *material = F->get();
+				material->instance_dependency.instance_notify_changed(false, true);
+				_material_queue_update(material, true, true);
+			}
+			compiling_shaders.erase(E);
+		}
+
+		E = N;
+	}
+}
+
 void RasterizerStorageRD::_update_queued_materials() {
 	Material *material = material_update_list;
 	while (material) {
@@ -5598,6 +5621,7 @@ void RasterizerStorageRD::_update_global_variables() {
 
 void RasterizerStorageRD::update_dirty_resources() {
 	_update_global_variables(); //must do before materials, so it can queue them for update
+	_update_compiling_shaders();
 	_update_queued_materials();
 	_update_dirty_multimeshes();
 	_update_dirty_skeletons();
@@ -5628,6 +5652,17 @@ bool RasterizerStorageRD::has_os_feature(const String &p_feature) const {
 	return false;
 }
 
+int RasterizerStorageRD::get_render_info(RS::RenderInfo p_info) {
+	switch (p_info) {
+		case RS::INFO_2D_ITEMS_IN_FRAME:
+			return info.render_final._2d_item_count;
+		case RS::INFO_2D_DRAW_CALLS_IN_FRAME:
+			return info.render_final._2d_draw_call_count;
+		default:
+			return 0;
+	}
+}
+
 bool RasterizerStorageRD::free(RID p_rid) {
 	if (texture_owner.owns(p_rid)) {
 		Texture *t = texture_owner.getornull(p_rid);
@@ -5673,6 +5708,7 @@ bool RasterizerStorageRD::free(RID p_rid) {
 		if (shader->data) {
 			memdelete(shader->data);
 		}
+		compiling_shaders.erase(shader);
 		shader_owner.free(p_rid);
 
 	} else if (material_owner.owns(p_rid)) {
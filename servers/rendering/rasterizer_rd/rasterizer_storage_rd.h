@@ -58,6 +58,7 @@ public:
 		virtual bool is_animated() const = 0;
 		virtual bool casts_shadows() const = 0;
 		virtual Variant get_default_parameter(const StringName &p_parameter) const = 0;
+		virtual bool is_compiling() { return false; } // still compiling in the background, checked every frame until done
 		virtual ~ShaderData() {}
 	};
 
@@ -242,6 +243,8 @@ private:
 
 	ShaderDataRequestFunction shader_data_request_func[SHADER_TYPE_MAX];
 	mutable RID_Owner<Shader> shader_owner;
+	Set<Shader *> compiling_shaders;
+	void _update_compiling_shaders();
 
 	/* Material */
 
@@ -847,7 +850,8 @@ public:
 		return mesh->surfaces[p_surface_index]->primitive;
 	}
 
-	_FORCE_INLINE_ void mesh_surface_get_arrays_and_format(RID p_mesh, uint32_t p_surface_index, uint32_t p_input_mask, RID &r_vertex_array_rd, RID &r_index_array_rd, RD::VertexFormatID &r_vertex_format) {
+	// p_lod_threshold is the simplification error, in mesh units, that can be tolerated for this draw
+	_FORCE_INLINE_ void mesh_surface_get_arrays_and_format(RID p_mesh, uint32_t p_surface_index, uint32_t p_input_mask, RID &r_vertex_array_rd, RID &r_index_array_rd, RD::VertexFormatID &r_vertex_format, float p_lod_threshold = 0.0) {
 		Mesh *mesh = mesh_owner.getornull(p_mesh);
 		ERR_FAIL_COND(!mesh);
 		ERR_FAIL_UNSIGNED_INDEX(p_surface_index, mesh->surface_count);
@@ -856,6 +860,17 @@ public:
 
 		r_index_array_rd = s->index_array;
 
+		if (p_lod_threshold > 0.0) {
+			float lod_edge_length = 0.0;
+			for (uint32_t i = 0; i < s->lod_count; i++) {
+				//use the coarsest level that still fits in the threshold
+				if (s->lods[i].edge_length <= p_lod_threshold && s->lods[i].edge_length > lod_edge_length) {
+					r_index_array_rd = s->lods[i].index_array;
+					lod_edge_length = s->lods[i].edge_length;
+				}
+			}
+		}
+
 		s->version_lock.lock();
 
 		//there will never be more than, at much, 3 or 4 versions, so iterating is the fastest way
@@ -1421,11 +1436,25 @@ public:
 
 	void set_debug_generate_wireframes(bool p_generate) {}
 
+	struct Info {
+		struct Render {
+			uint32_t _2d_item_count;
+			uint32_t _2d_draw_call_count;
+
+			void reset() {
+				_2d_item_count = 0;
+				_2d_draw_call_count = 0;
+			}
+
+			Render() { reset(); }
+		} render, render_final;
+	} info;
+
 	void render_info_begin_capture() {}
 	void render_info_end_capture() {}
 	int get_captured_render_info(RS::RenderInfo p_info) { return 0; }
 
-	int get_render_info(RS::RenderInfo p_info) { return 0; }
+	int get_render_info(RS::RenderInfo p_info);
 	String get_video_adapter_name() const { return String(); }
 	String get_video_adapter_vendor() const { return String(); }
 
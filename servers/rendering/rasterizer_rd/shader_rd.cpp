@@ -30,10 +30,18 @@
 
 #include "shader_rd.h"
 
+#include "core/io/marshalls.h"
+#include "core/os/dir_access.h"
+#include "core/os/file_access.h"
 #include "core/string_builder.h"
+#include "core/version.h"
+#include "core/version_hash.gen.h"
 #include "rasterizer_rd.h"
 #include "servers/rendering/rendering_device.h"
 
+#define SHADER_CACHE_MAGIC "GSPV"
+#define SPIRV_MAGIC_NUMBER 0x07230203
+
 void ShaderRD::setup(const char *p_vertex_code, const char *p_fragment_code, const char *p_compute_code, const char *p_name) {
 	name = p_name;
 	//split vertex and shader code (thank you, shader compiler programmers from you know what company).
@@ -183,6 +191,7 @@ RID ShaderRD::version_create() {
 	version.valid = false;
 	version.initialize_needed = true;
 	version.variants = nullptr;
+	version.async_compile = nullptr;
 	return version_owner.make_rid(version);
 }
 
@@ -198,173 +207,156 @@ void ShaderRD::_clear_version(Version *p_version) {
 	}
 }
 
-void ShaderRD::_compile_variant(uint32_t p_variant, Version *p_version) {
-	Vector<RD::ShaderStageData> stages;
+String ShaderRD::_build_stage_source(uint32_t p_variant, RD::ShaderStage p_stage, const Version *p_version) const {
+	StringBuilder builder;
 
-	String error;
-	String current_source;
-	RD::ShaderStage current_stage = RD::SHADER_STAGE_VERTEX;
-	bool build_ok = true;
+	switch (p_stage) {
+		case RD::SHADER_STAGE_VERTEX: {
+			builder.append(vertex_codev.get_data()); // version info (if exists)
+			builder.append("\n"); //make sure defines begin at newline
+			builder.append(general_defines.get_data());
+			builder.append(variant_defines[p_variant].get_data());
 
-	if (!is_compute) {
-		//vertex stage
+			for (int j = 0; j < p_version->custom_defines.size(); j++) {
+				builder.append(p_version->custom_defines[j].get_data());
+			}
 
-		StringBuilder builder;
+			builder.append(vertex_code0.get_data()); //first part of vertex
 
-		builder.append(vertex_codev.get_data()); // version info (if exists)
-		builder.append("\n"); //make sure defines begin at newline
-		builder.append(general_defines.get_data());
-		builder.append(variant_defines[p_variant].get_data());
+			builder.append(p_version->uniforms.get_data()); //uniforms (same for vertex and fragment)
 
-		for (int j = 0; j < p_version->custom_defines.size(); j++) {
-			builder.append(p_version->custom_defines[j].get_data());
-		}
+			builder.append(vertex_code1.get_data()); //second part of vertex
 
-		builder.append(vertex_code0.get_data()); //first part of vertex
+			builder.append(p_version->vertex_globals.get_data()); // vertex globals
 
-		builder.append(p_version->uniforms.get_data()); //uniforms (same for vertex and fragment)
+			builder.append(vertex_code2.get_data()); //third part of vertex
 
-		builder.append(vertex_code1.get_data()); //second part of vertex
+			builder.append(p_version->vertex_code.get_data()); // code
 
-		builder.append(p_version->vertex_globals.get_data()); // vertex globals
+			builder.append(vertex_code3.get_data()); //fourth of vertex
+		} break;
+		case RD::SHADER_STAGE_FRAGMENT: {
+			builder.append(fragment_codev.get_data()); // version info (if exists)
+			builder.append("\n"); //make sure defines begin at newline
 
-		builder.append(vertex_code2.get_data()); //third part of vertex
+			builder.append(general_defines.get_data());
+			builder.append(variant_defines[p_variant].get_data());
+			for (int j = 0; j < p_version->custom_defines.size(); j++) {
+				builder.append(p_version->custom_defines[j].get_data());
+			}
 
-		builder.append(p_version->vertex_code.get_data()); // code
+			builder.append(fragment_code0.get_data()); //first part of fragment
 
-		builder.append(vertex_code3.get_data()); //fourth of vertex
+			builder.append(p_version->uniforms.get_data()); //uniforms (same for fragment and fragment)
 
-		current_source = builder.as_string();
-		RD::ShaderStageData stage;
-		stage.spir_v = RD::get_singleton()->shader_compile_from_source(RD::SHADER_STAGE_VERTEX, current_source, RD::SHADER_LANGUAGE_GLSL, &error);
-		if (stage.spir_v.size() == 0) {
-			build_ok = false;
-		} else {
-			stage.shader_stage = RD::SHADER_STAGE_VERTEX;
-			stages.push_back(stage);
-		}
-	}
+			builder.append(fragment_code1.get_data()); //first part of fragment
 
-	if (!is_compute && build_ok) {
-		//fragment stage
-		current_stage = RD::SHADER_STAGE_FRAGMENT;
+			builder.append(p_version->fragment_globals.get_data()); // fragment globals
 
-		StringBuilder builder;
+			builder.append(fragment_code2.get_data()); //third part of fragment
 
-		builder.append(fragment_codev.get_data()); // version info (if exists)
-		builder.append("\n"); //make sure defines begin at newline
+			builder.append(p_version->fragment_light.get_data()); // fragment light
 
-		builder.append(general_defines.get_data());
-		builder.append(variant_defines[p_variant].get_data());
-		for (int j = 0; j < p_version->custom_defines.size(); j++) {
-			builder.append(p_version->custom_defines[j].get_data());
-		}
+			builder.append(fragment_code3.get_data()); //fourth part of fragment
 
-		builder.append(fragment_code0.get_data()); //first part of fragment
+			builder.append(p_version->fragment_code.get_data()); // fragment code
 
-		builder.append(p_version->uniforms.get_data()); //uniforms (same for fragment and fragment)
+			builder.append(fragment_code4.get_data()); //fourth part of fragment
+		} break;
+		case RD::SHADER_STAGE_COMPUTE: {
+			builder.append(compute_codev.get_data()); // version info (if exists)
+			builder.append("\n"); //make sure defines begin at newline
+			builder.append(general_defines.get_data());
+			builder.append(variant_defines[p_variant].get_data());
 
-		builder.append(fragment_code1.get_data()); //first part of fragment
+			for (int j = 0; j < p_version->custom_defines.size(); j++) {
+				builder.append(p_version->custom_defines[j].get_data());
+			}
 
-		builder.append(p_version->fragment_globals.get_data()); // fragment globals
+			builder.append(compute_code0.get_data()); //first part of compute
 
-		builder.append(fragment_code2.get_data()); //third part of fragment
+			builder.append(p_version->uniforms.get_data()); //uniforms (same for compute and fragment)
 
-		builder.append(p_version->fragment_light.get_data()); // fragment light
+			builder.append(compute_code1.get_data()); //second part of compute
 
-		builder.append(fragment_code3.get_data()); //fourth part of fragment
+			builder.append(p_version->compute_globals.get_data()); // compute globals
 
-		builder.append(p_version->fragment_code.get_data()); // fragment code
+			builder.append(compute_code2.get_data()); //third part of compute
 
-		builder.append(fragment_code4.get_data()); //fourth part of fragment
+			builder.append(p_version->compute_code.get_data()); // code
 
-		current_source = builder.as_string();
-		RD::ShaderStageData stage;
-		stage.spir_v = RD::get_singleton()->shader_compile_from_source(RD::SHADER_STAGE_FRAGMENT, current_source, RD::SHADER_LANGUAGE_GLSL, &error);
-		if (stage.spir_v.size() == 0) {
-			build_ok = false;
-		} else {
-			stage.shader_stage = RD::SHADER_STAGE_FRAGMENT;
-			stages.push_back(stage);
+			builder.append(compute_code3.get_data()); //fourth of compute
+		} break;
+		default: {
+			ERR_FAIL_V(String());
 		}
 	}
 
-	if (is_compute) {
-		//compute stage
-		current_stage = RD::SHADER_STAGE_COMPUTE;
-
-		StringBuilder builder;
-
-		builder.append(compute_codev.get_data()); // version info (if exists)
-		builder.append("\n"); //make sure defines begin at newline
-		builder.append(general_defines.get_data());
-		builder.append(variant_defines[p_variant].get_data());
-
-		for (int j = 0; j < p_version->custom_defines.size(); j++) {
-			builder.append(p_version->custom_defines[j].get_data());
-		}
-
-		builder.append(compute_code0.get_data()); //first part of compute
-
-		builder.append(p_version->uniforms.get_data()); //uniforms (same for compute and fragment)
+	return builder.as_string();
+}
 
-		builder.append(compute_code1.get_data()); //second part of compute
+RD::ShaderStage ShaderRD::_get_stage(uint32_t p_stage_index) const {
+	if (is_compute) {
+		return RD::SHADER_STAGE_COMPUTE;
+	}
+	return p_stage_index == 0 ? RD::SHADER_STAGE_VERTEX : RD::SHADER_STAGE_FRAGMENT;
+}
 
-		builder.append(p_version->compute_globals.get_data()); // compute globals
+void ShaderRD::_prepare_compile(const Version *p_version, CompileData *r_data) {
+	r_data->shader = this;
+	r_data->stage_count = is_compute ? 1 : 2;
 
-		builder.append(compute_code2.get_data()); //third part of compute
+	uint32_t job_count = variant_defines.size() * r_data->stage_count;
+	r_data->sources.resize(job_count);
+	r_data->errors.resize(job_count);
+	r_data->spirv.resize(job_count);
 
-		builder.append(p_version->compute_code.get_data()); // code
+	for (uint32_t i = 0; i < job_count; i++) {
+		r_data->sources.write[i] = _build_stage_source(i / r_data->stage_count, _get_stage(i % r_data->stage_count), p_version);
+	}
+}
 
-		builder.append(compute_code3.get_data()); //fourth of compute
+void ShaderRD::_compile_stage(uint32_t p_index, CompileData *p_data) {
+	RD::ShaderStage stage = _get_stage(p_index % p_data->stage_count);
+	p_data->spirv.write[p_index] = RD::get_singleton()->shader_compile_from_source(stage, p_data->sources[p_index], RD::SHADER_LANGUAGE_GLSL, &p_data->errors.write[p_index]);
+}
 
-		current_source = builder.as_string();
-		RD::ShaderStageData stage;
-		stage.spir_v = RD::get_singleton()->shader_compile_from_source(RD::SHADER_STAGE_COMPUTE, current_source, RD::SHADER_LANGUAGE_GLSL, &error);
-		if (stage.spir_v.size() == 0) {
-			build_ok = false;
-		} else {
-			stage.shader_stage = RD::SHADER_STAGE_COMPUTE;
-			stages.push_back(stage);
+void ShaderRD::_finish_compile(Version *p_version, CompileData *p_data) {
+	bool build_ok = true;
+	for (int i = 0; i < p_data->spirv.size(); i++) {
+		if (p_data->spirv[i].size()) {
+			continue;
 		}
-	}
 
-	if (!build_ok) {
-		MutexLock lock(variant_set_mutex); //properly print the errors
-		ERR_PRINT("Error compiling " + String(current_stage == RD::SHADER_STAGE_COMPUTE ? "Compute " : (current_stage == RD::SHADER_STAGE_VERTEX ? "Vertex" : "Fragment")) + " shader, variant #" + itos(p_variant) + " (" + variant_defines[p_variant].get_data() + ").");
-		ERR_PRINT(error);
+		uint32_t variant = i / p_data->stage_count;
+		RD::ShaderStage stage = _get_stage(i % p_data->stage_count);
+
+		ERR_PRINT("Error compiling " + String(stage == RD::SHADER_STAGE_COMPUTE ? "Compute " : (stage == RD::SHADER_STAGE_VERTEX ? "Vertex" : "Fragment")) + " shader, variant #" + itos(variant) + " (" + variant_defines[variant].get_data() + ").");
+		ERR_PRINT(p_data->errors[i]);
 
 #ifdef DEBUG_ENABLED
-		ERR_PRINT("code:\n" + current_source.get_with_code_lines());
+		ERR_PRINT("code:\n" + p_data->sources[i].get_with_code_lines());
 #endif
-		return;
+		build_ok = false;
 	}
 
-	RID shader = RD::get_singleton()->shader_create(stages);
-	{
-		MutexLock lock(variant_set_mutex);
-		p_version->variants[p_variant] = shader;
+	if (!build_ok) {
+		return;
 	}
-}
-
-void ShaderRD::_compile_version(Version *p_version) {
-	_clear_version(p_version);
-
-	p_version->valid = false;
-	p_version->dirty = false;
 
 	p_version->variants = memnew_arr(RID, variant_defines.size());
-#if 1
-
-	RasterizerRD::thread_work_pool.do_work(variant_defines.size(), this, &ShaderRD::_compile_variant, p_version);
-#else
-	for (int i = 0; i < variant_defines.size(); i++) {
-		_compile_variant(i, p_version);
-	}
-#endif
 
 	bool all_valid = true;
 	for (int i = 0; i < variant_defines.size(); i++) {
+		Vector<RD::ShaderStageData> stages;
+		for (uint32_t j = 0; j < p_data->stage_count; j++) {
+			RD::ShaderStageData stage;
+			stage.shader_stage = _get_stage(j);
+			stage.spir_v = p_data->spirv[i * p_data->stage_count + j];
+			stages.push_back(stage);
+		}
+
+		p_version->variants[i] = RD::get_singleton()->shader_create(stages);
 		if (p_version->variants[i].is_null()) {
 			all_valid = false;
 			break;
@@ -386,7 +378,139 @@ void ShaderRD::_compile_version(Version *p_version) {
 	p_version->valid = true;
 }
 
-void ShaderRD::version_set_code(RID p_version, const String &p_uniforms, const String &p_vertex_globals, const String &p_vertex_code, const String &p_fragment_globals, const String &p_fragment_light, const String &p_fragment_code, const Vector<String> &p_custom_defines) {
+void ShaderRD::_compile_version(Version *p_version) {
+	_cancel_async_compile(p_version);
+	_clear_version(p_version);
+
+	p_version->valid = false;
+	p_version->dirty = false;
+
+	CompileData data;
+	_prepare_compile(p_version, &data);
+
+	RasterizerRD::thread_work_pool.do_work(data.sources.size(), this, &ShaderRD::_compile_stage, &data);
+
+	_finish_compile(p_version, &data);
+}
+
+Mutex ShaderRD::async_mutex;
+Semaphore ShaderRD::async_semaphore;
+Thread *ShaderRD::async_thread = nullptr;
+bool ShaderRD::async_exit = false;
+ThreadWorkPool ShaderRD::async_work_pool;
+Vector<ShaderRD::CompileData *> ShaderRD::async_queue;
+
+void ShaderRD::AsyncPass::compile_stage(uint32_t p_index, void *p_userdata) {
+	CompileData *data = stages[p_index].first;
+	data->shader->_compile_stage(stages[p_index].second, data);
+}
+
+void ShaderRD::_async_thread_function(void *p_userdata) {
+	async_work_pool.init();
+
+	while (true) {
+		async_semaphore.wait();
+
+		Vector<CompileData *> queued;
+		AsyncPass pass;
+		{
+			MutexLock lock(async_mutex);
+			if (async_exit) {
+				break;
+			}
+
+			queued = async_queue;
+			async_queue.clear();
+
+			for (int i = 0; i < queued.size(); i++) {
+				if (queued[i]->canceled) {
+					continue;
+				}
+				for (int j = 0; j < queued[i]->sources.size(); j++) {
+					pass.stages.push_back(Pair<CompileData *, uint32_t>(queued[i], j));
+				}
+			}
+		}
+
+		if (pass.stages.size()) {
+			async_work_pool.do_work(pass.stages.size(), &pass, &AsyncPass::compile_stage, (void *)nullptr);
+		}
+
+		MutexLock lock(async_mutex);
+		for (int i = 0; i < queued.size(); i++) {
+			if (queued[i]->canceled) {
+				memdelete(queued[i]);
+			} else {
+				queued[i]->done = true;
+			}
+		}
+	}
+
+	async_work_pool.finish();
+}
+
+void ShaderRD::_compile_version_async(Version *p_version) {
+	_cancel_async_compile(p_version);
+	_clear_version(p_version);
+
+	p_version->valid = false;
+	p_version->dirty = false;
+
+	// Sources are built here, so the version can change while its stages are compiled.
+	CompileData *data = memnew(CompileData);
+	_prepare_compile(p_version, data);
+	p_version->async_compile = data;
+
+	MutexLock lock(async_mutex);
+	if (!async_thread) {
+		async_exit = false;
+		async_thread = Thread::create(_async_thread_function, nullptr);
+	}
+	async_queue.push_back(data);
+	async_semaphore.post();
+}
+
+void ShaderRD::_cancel_async_compile(Version *p_version) {
+	if (!p_version->async_compile) {
+		return;
+	}
+
+	MutexLock lock(async_mutex);
+	if (p_version->async_compile->done) {
+		memdelete(p_version->async_compile);
+	} else {
+		p_version->async_compile->canceled = true; // deleted by the compiler thread
+	}
+	p_version->async_compile = nullptr;
+}
+
+void ShaderRD::finish_async_compiler() {
+	if (!async_thread) {
+		return;
+	}
+
+	{
+		MutexLock lock(async_mutex);
+		async_exit = true;
+		async_semaphore.post();
+	}
+
+	Thread::wait_to_finish(async_thread);
+	memdelete(async_thread);
+	async_thread = nullptr;
+
+	// Whatever is left never gets compiled, and fails once its version checks on it.
+	for (int i = 0; i < async_queue.size(); i++) {
+		if (async_queue[i]->canceled) {
+			memdelete(async_queue[i]);
+		} else {
+			async_queue[i]->done = true;
+		}
+	}
+	async_queue.clear();
+}
+
+void ShaderRD::version_set_code(RID p_version, const String &p_uniforms, const String &p_vertex_globals, const String &p_vertex_code, const String &p_fragment_globals, const String &p_fragment_light, const String &p_fragment_code, const Vector<String> &p_custom_defines, bool p_async) {
 	ERR_FAIL_COND(is_compute);
 
 	Version *version = version_owner.getornull(p_version);
@@ -404,7 +528,10 @@ void ShaderRD::version_set_code(RID p_version, const String &p_uniforms, const S
 	}
 
 	version->dirty = true;
-	if (version->initialize_needed) {
+	if (p_async) {
+		_compile_version_async(version);
+		version->initialize_needed = false;
+	} else if (version->initialize_needed) {
 		_compile_version(version);
 		version->initialize_needed = false;
 	}
@@ -442,9 +569,33 @@ bool ShaderRD::version_is_valid(RID p_version) {
 	return version->valid;
 }
 
+bool ShaderRD::version_is_compiling(RID p_version) {
+	Version *version = version_owner.getornull(p_version);
+	ERR_FAIL_COND_V(!version, false);
+
+	if (!version->async_compile) {
+		return false;
+	}
+
+	{
+		MutexLock lock(async_mutex);
+		if (!version->async_compile->done) {
+			return true;
+		}
+	}
+
+	CompileData *data = version->async_compile;
+	version->async_compile = nullptr;
+	_finish_compile(version, data);
+	memdelete(data);
+
+	return false;
+}
+
 bool ShaderRD::version_free(RID p_version) {
 	if (version_owner.owns(p_version)) {
 		Version *version = version_owner.getornull(p_version);
+		_cancel_async_compile(version);
 		_clear_version(version);
 		version_owner.free(p_version);
 	} else {
@@ -463,6 +614,148 @@ void ShaderRD::initialize(const Vector<String> &p_variant_defines, const String
 	}
 }
 
+String ShaderRD::shader_cache_dir;
+
+String ShaderRD::_shader_cache_get_path(RD::ShaderStage p_stage, const String &p_source_code, RD::ShaderLanguage p_language, String &r_hash) {
+	r_hash = (itos(p_stage) + "," + itos(p_language) + "\n" + p_source_code).sha256_text();
+	return shader_cache_dir.plus_file(r_hash + ".spirv");
+}
+
+Vector<uint8_t> ShaderRD::_shader_cache_load(RD::ShaderStage p_stage, const String &p_source_code, RD::ShaderLanguage p_language) {
+	String hash;
+	String path = _shader_cache_get_path(p_stage, p_source_code, p_language, hash);
+
+	FileAccessRef f = FileAccess::open(path, FileAccess::READ);
+	if (!f) {
+		return Vector<uint8_t>();
+	}
+
+	uint8_t magic[4];
+	f->get_buffer(magic, 4);
+	if (memcmp(magic, SHADER_CACHE_MAGIC, 4) != 0 || f->get_32() != SHADER_CACHE_VERSION || f->get_32() != (uint32_t)p_stage) {
+		return Vector<uint8_t>();
+	}
+
+	CharString hash_ascii = hash.ascii();
+	uint8_t stored_hash[64];
+	if (f->get_buffer(stored_hash, 64) != 64 || memcmp(stored_hash, hash_ascii.get_data(), 64) != 0) {
+		return Vector<uint8_t>();
+	}
+
+	uint32_t size = f->get_32();
+	if (size == 0 || size % 4 != 0 || f->get_len() - f->get_position() != size) {
+		return Vector<uint8_t>(); // truncated write or garbage
+	}
+
+	Vector<uint8_t> spirv;
+	spirv.resize(size);
+	if (f->get_buffer(spirv.ptrw(), size) != (int)size || decode_uint32(spirv.ptr()) != SPIRV_MAGIC_NUMBER) {
+		return Vector<uint8_t>();
+	}
+
+	return spirv;
+}
+
+void ShaderRD::_shader_cache_store(RD::ShaderStage p_stage, const String &p_source_code, RD::ShaderLanguage p_language, const Vector<uint8_t> &p_spirv) {
+	String hash;
+	String path = _shader_cache_get_path(p_stage, p_source_code, p_language, hash);
+
+	FileAccessRef f = FileAccess::open(path, FileAccess::WRITE);
+	ERR_FAIL_COND_MSG(!f, "Can't write shader cache file: " + path + ".");
+
+	f->store_buffer((const uint8_t *)SHADER_CACHE_MAGIC, 4);
+	f->store_32(SHADER_CACHE_VERSION);
+	f->store_32(p_stage);
+	f->store_buffer((const uint8_t *)hash.ascii().get_data(), 64);
+	f->store_32(p_spirv.size());
+	f->store_buffer(p_spirv.ptr(), p_spirv.size());
+}
+
+void ShaderRD::_shader_cache_prune(const String &p_dir, const String &p_current, int p_max_entries) {
+	DirAccessRef da = DirAccess::open(p_dir);
+	ERR_FAIL_COND(!da);
+
+	// Anything but the directory of the current version was built by another
+	// engine or compiler, and can't be used anymore.
+	List<String> stale;
+	da->list_dir_begin();
+	for (String f = da->get_next(); f != String(); f = da->get_next()) {
+		if (f != "." && f != ".." && f != p_current) {
+			stale.push_back(f);
+		}
+	}
+	da->list_dir_end();
+
+	for (List<String>::Element *E = stale.front(); E; E = E->next()) {
+		String path = p_dir.plus_file(E->get());
+		if (da->dir_exists(path)) {
+			DirAccessRef sub = DirAccess::open(path);
+			if (sub) {
+				sub->erase_contents_recursive();
+			}
+		}
+		da->remove(path);
+	}
+
+	// Past the limit, the oldest entries go first.
+	String current_dir = p_dir.plus_file(p_current);
+	if (da->change_dir(current_dir) != OK) {
+		return;
+	}
+
+	struct Entry {
+		uint64_t time;
+		String path;
+		bool operator<(const Entry &p_other) const { return time < p_other.time; }
+	};
+
+	Vector<Entry> entries;
+	da->list_dir_begin();
+	for (String f = da->get_next(); f != String(); f = da->get_next()) {
+		if (!da->current_is_dir() && f.get_extension() == "spirv") {
+			Entry e;
+			e.path = current_dir.plus_file(f);
+			e.time = FileAccess::get_modified_time(e.path);
+			entries.push_back(e);
+		}
+	}
+	da->list_dir_end();
+
+	if (entries.size() <= p_max_entries) {
+		return;
+	}
+
+	entries.sort();
+	for (int i = 0; i < entries.size() - p_max_entries; i++) {
+		da->remove(entries[i].path);
+	}
+}
+
+void ShaderRD::set_shader_cache_dir(const String &p_dir, int p_max_entries) {
+	if (p_dir == String()) {
+		shader_cache_dir = String();
+		RD::shader_set_cache_function(nullptr);
+		return;
+	}
+
+	// Entries are kept in a subdirectory named after the engine and shader
+	// compiler versions, so upgrading either of them starts a new cache.
+	String version = (String(VERSION_FULL_BUILD) + "," + VERSION_HASH + "," + RD::shader_get_compiler_version()).sha256_text().substr(0, 16);
+	String dir = p_dir.plus_file(version);
+
+	DirAccessRef da = DirAccess::create_for_path(dir);
+	ERR_FAIL_COND(!da);
+	if (!da->dir_exists(dir)) {
+		Error err = da->make_dir_recursive(dir);
+		ERR_FAIL_COND_MSG(err != OK, "Can't create shader cache directory: " + dir + ".");
+	}
+
+	_shader_cache_prune(p_dir, version, MAX(p_max_entries, 0));
+
+	shader_cache_dir = dir;
+	RD::shader_set_cache_function(_shader_cache_load, _shader_cache_store);
+}
+
 ShaderRD::~ShaderRD() {
 	List<RID> remaining;
 	version_owner.get_owned_list(&remaining);
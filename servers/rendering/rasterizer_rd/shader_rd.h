@@ -34,8 +34,13 @@
 #include "core/hash_map.h"
 #include "core/map.h"
 #include "core/os/mutex.h"
+#include "core/os/semaphore.h"
+#include "core/os/thread.h"
+#include "core/pair.h"
 #include "core/rid_owner.h"
+#include "core/thread_work_pool.h"
 #include "core/variant.h"
+#include "servers/rendering/rendering_device.h"
 
 #include <stdio.h>
 /**
@@ -47,6 +52,8 @@ class ShaderRD {
 	CharString general_defines;
 	Vector<CharString> variant_defines;
 
+	struct CompileData;
+
 	struct Version {
 		CharString uniforms;
 		CharString vertex_globals;
@@ -59,6 +66,7 @@ class ShaderRD {
 		Vector<CharString> custom_defines;
 
 		RID *variants; //same size as version defines
+		CompileData *async_compile; //pending compilation on the async compiler thread, if any
 
 		bool valid;
 		bool dirty;
@@ -67,11 +75,63 @@ class ShaderRD {
 
 	Mutex variant_set_mutex;
 
-	void _compile_variant(uint32_t p_variant, Version *p_version);
+	// Compiled SPIR-V is kept on disk between runs, one file per stage, named after the hash of
+	// the final stage source (which already contains the general, variant and custom defines).
+	// It's plugged into RenderingDevice as its shader cache, so every shader compiled from source
+	// goes through it.
+	enum {
+		SHADER_CACHE_VERSION = 2, // bump when the file layout changes
+	};
+
+	static String shader_cache_dir;
+
+	static String _shader_cache_get_path(RD::ShaderStage p_stage, const String &p_source_code, RD::ShaderLanguage p_language, String &r_hash);
+	static Vector<uint8_t> _shader_cache_load(RD::ShaderStage p_stage, const String &p_source_code, RD::ShaderLanguage p_language);
+	static void _shader_cache_store(RD::ShaderStage p_stage, const String &p_source_code, RD::ShaderLanguage p_language, const Vector<uint8_t> &p_spirv);
+	static void _shader_cache_prune(const String &p_dir, const String &p_current, int p_max_entries);
+
+	// Sources and results for every stage of every variant of a version. Each stage is compiled
+	// as a separate job, so vertex and fragment stages compile concurrently too.
+	struct CompileData {
+		ShaderRD *shader = nullptr;
+		uint32_t stage_count = 0;
+		Vector<String> sources; // stage_count entries per variant
+		Vector<String> errors;
+		Vector<Vector<uint8_t>> spirv;
+
+		// Only used by asynchronous compilation, guarded by async_mutex.
+		bool done = false;
+		bool canceled = false;
+	};
+
+	RD::ShaderStage _get_stage(uint32_t p_stage_index) const;
+	String _build_stage_source(uint32_t p_variant, RD::ShaderStage p_stage, const Version *p_version) const;
+	void _prepare_compile(const Version *p_version, CompileData *r_data);
+	void _compile_stage(uint32_t p_index, CompileData *p_data);
+	void _finish_compile(Version *p_version, CompileData *p_data);
 
 	void _clear_version(Version *p_version);
 	void _compile_version(Version *p_version);
 
+	// Versions compiled asynchronously are queued for a single compiler thread. Each of its passes
+	// compiles the stages of everything queued since the previous one together, on its own pool,
+	// so the shaders of several materials set up in the same frame are built concurrently.
+	struct AsyncPass {
+		Vector<Pair<CompileData *, uint32_t>> stages;
+		void compile_stage(uint32_t p_index, void *p_userdata);
+	};
+
+	static Mutex async_mutex;
+	static Semaphore async_semaphore;
+	static Thread *async_thread;
+	static bool async_exit;
+	static ThreadWorkPool async_work_pool;
+	static Vector<CompileData *> async_queue;
+
+	static void _async_thread_function(void *p_userdata);
+	void _compile_version_async(Version *p_version);
+	void _cancel_async_compile(Version *p_version);
+
 	RID_Owner<Version> version_owner;
 
 	CharString fragment_codev; //for version and extensions
@@ -104,7 +164,7 @@ protected:
 public:
 	RID version_create();
 
-	void version_set_code(RID p_version, const String &p_uniforms, const String &p_vertex_globals, const String &p_vertex_code, const String &p_fragment_globals, const String &p_fragment_light, const String &p_fragment_code, const Vector<String> &p_custom_defines);
+	void version_set_code(RID p_version, const String &p_uniforms, const String &p_vertex_globals, const String &p_vertex_code, const String &p_fragment_globals, const String &p_fragment_light, const String &p_fragment_code, const Vector<String> &p_custom_defines, bool p_async = false);
 	void version_set_compute_code(RID p_version, const String &p_uniforms, const String &p_compute_globals, const String &p_compute_code, const Vector<String> &p_custom_defines);
 
 	_FORCE_INLINE_ RID version_get_shader(RID p_version, int p_variant) {
@@ -125,10 +185,15 @@ public:
 	}
 
 	bool version_is_valid(RID p_version);
+	// Whether the version is still being compiled asynchronously. Once its stages are ready, creates its shaders and returns false.
+	bool version_is_compiling(RID p_version);
 
 	bool version_free(RID p_version);
 
 	void initialize(const Vector<String> &p_variant_defines, const String &p_general_defines = "");
+
+	static void set_shader_cache_dir(const String &p_dir, int p_max_entries);
+	static void finish_async_compiler();
 	virtual ~ShaderRD();
 };
 
@@ -39,14 +39,22 @@ RenderingDevice *RenderingDevice::get_singleton() {
 }
 
 RenderingDevice::ShaderCompileFunction RenderingDevice::compile_function = nullptr;
+String RenderingDevice::compiler_version;
 RenderingDevice::ShaderCacheFunction RenderingDevice::cache_function = nullptr;
+RenderingDevice::ShaderCacheStoreFunction RenderingDevice::cache_store_function = nullptr;
 
-void RenderingDevice::shader_set_compile_function(ShaderCompileFunction p_function) {
+void RenderingDevice::shader_set_compile_function(ShaderCompileFunction p_function, const String &p_compiler_version) {
 	compile_function = p_function;
+	compiler_version = p_compiler_version;
 }
 
-void RenderingDevice::shader_set_cache_function(ShaderCacheFunction p_function) {
+String RenderingDevice::shader_get_compiler_version() {
+	return compiler_version;
+}
+
+void RenderingDevice::shader_set_cache_function(ShaderCacheFunction p_function, ShaderCacheStoreFunction p_store_function) {
 	cache_function = p_function;
+	cache_store_function = p_store_function;
 }
 
 Vector<uint8_t> RenderingDevice::shader_compile_from_source(ShaderStage p_stage, const String &p_source_code, ShaderLanguage p_language, String *r_error, bool p_allow_cache) {
@@ -59,7 +67,12 @@ Vector<uint8_t> RenderingDevice::shader_compile_from_source(ShaderStage p_stage,
 
 	ERR_FAIL_COND_V(!compile_function, Vector<uint8_t>());
 
-	return compile_function(p_stage, p_source_code, p_language, r_error);
+	Vector<uint8_t> spirv = compile_function(p_stage, p_source_code, p_language, r_error);
+	if (p_allow_cache && cache_store_function && spirv.size()) {
+		cache_store_function(p_stage, p_source_code, p_language, spirv);
+	}
+
+	return spirv;
 }
 
 RID RenderingDevice::_texture_create(const Ref<RDTextureFormat> &p_format, const Ref<RDTextureView> &p_view, const TypedArray<PackedByteArray> &p_data) {
@@ -72,10 +72,13 @@ public:
 
 	typedef Vector<uint8_t> (*ShaderCompileFunction)(ShaderStage p_stage, const String &p_source_code, ShaderLanguage p_language, String *r_error);
 	typedef Vector<uint8_t> (*ShaderCacheFunction)(ShaderStage p_stage, const String &p_source_code, ShaderLanguage p_language);
+	typedef void (*ShaderCacheStoreFunction)(ShaderStage p_stage, const String &p_source_code, ShaderLanguage p_language, const Vector<uint8_t> &p_spirv);
 
 private:
 	static ShaderCompileFunction compile_function;
+	static String compiler_version;
 	static ShaderCacheFunction cache_function;
+	static ShaderCacheStoreFunction cache_store_function;
 
 	static RenderingDevice *singleton;
 
@@ -584,8 +587,9 @@ public:
 
 	virtual Vector<uint8_t> shader_compile_from_source(ShaderStage p_stage, const String &p_source_code, ShaderLanguage p_language = SHADER_LANGUAGE_GLSL, String *r_error = nullptr, bool p_allow_cache = true);
 
-	static void shader_set_compile_function(ShaderCompileFunction p_function);
-	static void shader_set_cache_function(ShaderCacheFunction p_function);
+	static void shader_set_compile_function(ShaderCompileFunction p_function, const String &p_compiler_version = String());
+	static String shader_get_compiler_version();
+	static void shader_set_cache_function(ShaderCacheFunction p_function, ShaderCacheStoreFunction p_store_function = nullptr);
 
 	struct ShaderStageData {
 		ShaderStage shader_stage;
@@ -37,6 +37,33 @@
 
 static const int z_range = RS::CANVAS_ITEM_Z_MAX - RS::CANVAS_ITEM_Z_MIN + 1;
 
+// Y-sorted lists with fewer children than this are simply visited in full.
+static const int ysort_cull_threshold = 64;
+
+// Lists that were sorted last frame usually have only a few items out of place, insertion sort
+// handles that in about linear time. Fall back to a full sort when too much changed.
+template <class T, class Comparator>
+static void _sort_nearly_sorted(T *p_array, int p_len) {
+	Comparator compare;
+	int unsorted = 0;
+	for (int i = 1; i < p_len; i++) {
+		if (compare(p_array[i], p_array[i - 1])) {
+			unsorted++;
+		}
+	}
+
+	if (unsorted == 0) {
+		return;
+	}
+
+	SortArray<T, Comparator> sorter;
+	if (unsorted <= 8 + p_len / 32) {
+		sorter.insertion_sort(0, p_len, p_array);
+	} else {
+		sorter.sort(p_array, p_len);
+	}
+}
+
 void RenderingServerCanvas::_render_canvas_item_tree(RID p_to_render_target, Canvas::ChildItem *p_child_items, int p_child_item_count, Item *p_canvas_item, const Transform2D &p_transform, const Rect2 &p_clip_rect, const Color &p_modulate, RasterizerCanvas::Light *p_lights) {
 	RENDER_TIMESTAMP("Cull CanvasItem Tree");
 
@@ -78,10 +105,10 @@ void _collect_ysort_children(RenderingServerCanvas::Item *p_canvas_item, Transfo
 		if (child_items[i]->visible) {
 			if (r_items) {
 				r_items[r_index] = child_items[i];
-				child_items[i]->ysort_xform = p_transform;
-				child_items[i]->ysort_pos = p_transform.xform(child_items[i]->xform.elements[2]);
-				child_items[i]->material_owner = child_items[i]->use_parent_material ? p_material_owner : nullptr;
 			}
+			child_items[i]->ysort_xform = p_transform;
+			child_items[i]->ysort_pos = p_transform.xform(child_items[i]->xform.elements[2]);
+			child_items[i]->material_owner = child_items[i]->use_parent_material ? p_material_owner : nullptr;
 
 			r_index++;
 
@@ -99,6 +126,104 @@ void _mark_ysort_dirty(RenderingServerCanvas::Item *ysort_owner, RID_PtrOwner<Re
 	} while (ysort_owner && ysort_owner->sort_y);
 }
 
+void RenderingServerCanvas::_update_ysort_children(Item *p_canvas_item, Item *p_material_owner) {
+	Item *ci = p_canvas_item;
+
+	if (ci->ysort_children_count == -1) {
+		//hierarchy changed, collect again
+		ci->ysort_children_count = 0;
+		_collect_ysort_children(ci, Transform2D(), p_material_owner, nullptr, ci->ysort_children_count);
+
+		ci->ysort_children.resize(ci->ysort_children_count);
+		int i = 0;
+		_collect_ysort_children(ci, Transform2D(), p_material_owner, ci->ysort_children_count ? &ci->ysort_children[0] : nullptr, i);
+	} else {
+		//only refresh the transforms, the list keeps last frame's order
+		int i = 0;
+		_collect_ysort_children(ci, Transform2D(), p_material_owner, nullptr, i);
+	}
+
+	int count = ci->ysort_children.size();
+	if (count == 0) {
+		return;
+	}
+
+	Item **items = &ci->ysort_children[0];
+	_sort_nearly_sorted<Item *, ItemPtrSort>(items, count);
+
+	if (count < ysort_cull_threshold) {
+		return;
+	}
+
+	ci->ysort_unbounded.clear();
+	ci->ysort_extent_above = 0;
+	ci->ysort_extent_below = 0;
+
+	for (int i = 0; i < count; i++) {
+		Item *child = items[i];
+		child->ysort_bounded = child->child_items.empty() && !child->vp_render && !child->copy_back_buffer && !child->update_when_visible;
+		if (!child->ysort_bounded) {
+			ci->ysort_unbounded.push_back(i);
+			continue;
+		}
+
+		child->ysort_rect = (child->ysort_xform * child->xform).xform(child->get_rect());
+		ci->ysort_extent_above = MAX(ci->ysort_extent_above, child->ysort_pos.y - child->ysort_rect.position.y);
+		ci->ysort_extent_below = MAX(ci->ysort_extent_below, child->ysort_rect.position.y + child->ysort_rect.size.y - child->ysort_pos.y);
+	}
+}
+
+int RenderingServerCanvas::_cull_ysort_children(Item *p_canvas_item, const Transform2D &p_transform, const Rect2 &p_clip_rect, Item **r_items) {
+	Item *ci = p_canvas_item;
+	int count = ci->ysort_children.size();
+	Item **items = &ci->ysort_children[0];
+
+	//clip rect in the space of the children, the same test as in _cull_canvas_item (slightly grown, for precision)
+	Rect2 local_clip = p_transform.affine_inverse().xform(Rect2(Vector2(), p_clip_rect.size).grow(1.0));
+	real_t from_y = local_clip.position.y - ci->ysort_extent_below;
+	real_t to_y = local_clip.position.y + local_clip.size.y + ci->ysort_extent_above;
+
+	int from = 0;
+	int to = count;
+	while (from < to) {
+		int mid = (from + to) / 2;
+		if (items[mid]->ysort_pos.y < from_y) {
+			from = mid + 1;
+		} else {
+			to = mid;
+		}
+	}
+
+	int end = from;
+	to = count;
+	while (end < to) {
+		int mid = (end + to) / 2;
+		if (items[mid]->ysort_pos.y <= to_y) {
+			end = mid + 1;
+		} else {
+			to = mid;
+		}
+	}
+
+	//merge the range with the unbounded children, keeping the y-sorted order
+	int item_count = 0;
+	uint32_t unbounded_count = ci->ysort_unbounded.size();
+	uint32_t u = 0;
+	for (int i = from; i < end; i++) {
+		while (u < unbounded_count && (int)ci->ysort_unbounded[u] < i) {
+			r_items[item_count++] = items[ci->ysort_unbounded[u++]];
+		}
+		if (items[i]->ysort_bounded && local_clip.intersects(items[i]->ysort_rect, true)) {
+			r_items[item_count++] = items[i];
+		}
+	}
+	while (u < unbounded_count) {
+		r_items[item_count++] = items[ci->ysort_unbounded[u++]];
+	}
+
+	return item_count;
+}
+
 void RenderingServerCanvas::_cull_canvas_item(Item *p_canvas_item, const Transform2D &p_transform, const Rect2 &p_clip_rect, const Color &p_modulate, int p_z, RasterizerCanvas::Item **z_list, RasterizerCanvas::Item **z_last_list, Item *p_canvas_clip, Item *p_material_owner) {
 	Item *ci = p_canvas_item;
 
@@ -107,7 +232,9 @@ void RenderingServerCanvas::_cull_canvas_item(Item *p_canvas_item, const Transfo
 	}
 
 	if (ci->children_order_dirty) {
-		ci->child_items.sort_custom<ItemIndexSort>();
+		if (ci->child_items.size()) {
+			_sort_nearly_sorted<Item *, ItemIndexSort>(ci->child_items.ptrw(), ci->child_items.size());
+		}
 		ci->children_order_dirty = false;
 	}
 
@@ -145,19 +272,16 @@ void RenderingServerCanvas::_cull_canvas_item(Item *p_canvas_item, const Transfo
 	}
 
 	if (ci->sort_y) {
-		if (ci->ysort_children_count == -1) {
-			ci->ysort_children_count = 0;
-			_collect_ysort_children(ci, Transform2D(), p_material_owner, nullptr, ci->ysort_children_count);
-		}
+		_update_ysort_children(ci, p_material_owner);
 
-		child_item_count = ci->ysort_children_count;
-		child_items = (Item **)alloca(child_item_count * sizeof(Item *));
+		child_item_count = ci->ysort_children.size();
+		child_items = child_item_count ? &ci->ysort_children[0] : nullptr;
 
-		int i = 0;
-		_collect_ysort_children(ci, Transform2D(), p_material_owner, child_items, i);
-
-		SortArray<Item *, ItemPtrSort> sorter;
-		sorter.sort(child_items, child_item_count);
+		//with many children and no rotation, only visit the ones that can be on screen
+		if (child_item_count >= ysort_cull_threshold && Math::is_zero_approx(xform.elements[0].y) && Math::is_zero_approx(xform.elements[1].x)) {
+			child_items = (Item **)alloca(child_item_count * sizeof(Item *));
+			child_item_count = _cull_ysort_children(ci, xform, p_clip_rect, child_items);
+		}
 	}
 
 	if (ci->z_relative) {
@@ -31,6 +31,7 @@
 #ifndef VISUALSERVERCANVAS_H
 #define VISUALSERVERCANVAS_H
 
+#include "core/local_vector.h"
 #include "rasterizer.h"
 #include "rendering_server_viewport.h"
 
@@ -51,6 +52,16 @@ public:
 		Color ysort_modulate;
 		Transform2D ysort_xform;
 		Vector2 ysort_pos;
+		Rect2 ysort_rect; // bounds in the space of the y-sorting parent
+		bool ysort_bounded; // draws nothing outside ysort_rect, so it can be culled by the parent
+
+		// Persistent y-sorted list of the flattened children, only rebuilt when the hierarchy changes.
+		// Bounded children are found by position range, the rest are always visited.
+		LocalVector<Item *> ysort_children;
+		LocalVector<uint32_t> ysort_unbounded;
+		real_t ysort_extent_above;
+		real_t ysort_extent_below;
+
 		RS::CanvasItemTextureFilter texture_filter;
 		RS::CanvasItemTextureRepeat texture_repeat;
 
@@ -69,6 +80,9 @@ public:
 			ysort_children_count = -1;
 			ysort_xform = Transform2D();
 			ysort_pos = Vector2();
+			ysort_bounded = false;
+			ysort_extent_above = 0;
+			ysort_extent_below = 0;
 			texture_filter = RS::CANVAS_ITEM_TEXTURE_FILTER_DEFAULT;
 			texture_repeat = RS::CANVAS_ITEM_TEXTURE_REPEAT_DEFAULT;
 		}
@@ -158,6 +172,8 @@ public:
 private:
 	void _render_canvas_item_tree(RID p_to_render_target, Canvas::ChildItem *p_child_items, int p_child_item_count, Item *p_canvas_item, const Transform2D &p_transform, const Rect2 &p_clip_rect, const Color &p_modulate, RasterizerCanvas::Light *p_lights);
 	void _cull_canvas_item(Item *p_canvas_item, const Transform2D &p_transform, const Rect2 &p_clip_rect, const Color &p_modulate, int p_z, RasterizerCanvas::Item **z_list, RasterizerCanvas::Item **z_last_list, Item *p_canvas_clip, Item *p_material_owner);
+	void _update_ysort_children(Item *p_canvas_item, Item *p_material_owner);
+	int _cull_ysort_children(Item *p_canvas_item, const Transform2D &p_transform, const Rect2 &p_clip_rect, Item **r_items);
 	void _light_mask_canvas_items(int p_z, RasterizerCanvas::Item *p_canvas_item, RasterizerCanvas::Light *p_masked_lights);
 
 	RasterizerCanvas::Item **z_list;
@@ -466,6 +466,11 @@ public:
 	BIND2(camera_set_camera_effects, RID, RID)
 	BIND2(camera_set_use_vertical_aspect, RID, bool)
 
+	/* OCCLUDER API */
+
+	BIND0R(RID, occluder_create)
+	BIND3(occluder_set_mesh, RID, const PackedVector3Array &, const PackedInt32Array &)
+
 #undef BINDBASE
 //from now on, calls forwarded to this singleton
 #define BINDBASE RSG::viewport
@@ -607,6 +612,9 @@ public:
 	BIND3(instance_set_surface_material, RID, int, RID)
 	BIND2(instance_set_visible, RID, bool)
 
+	BIND2(instance_set_transform_bulk, const Vector<RID> &, const Vector<Transform> &)
+	BIND2(instance_set_visible_bulk, const Vector<RID> &, bool)
+
 	BIND2(instance_set_custom_aabb, RID, AABB)
 
 	BIND2(instance_attach_skeleton, RID, RID)
@@ -628,6 +636,7 @@ public:
 	BIND4(instance_geometry_set_lightmap, RID, RID, const Rect2 &, int)
 
 	BIND3(instance_geometry_set_shader_parameter, RID, const StringName &, const Variant &)
+	BIND3(instance_geometry_set_shader_parameter_bulk, const Vector<RID> &, const StringName &, const Vector<Variant> &)
 	BIND2RC(Variant, instance_geometry_get_shader_parameter, RID, const StringName &)
 	BIND2RC(Variant, instance_geometry_get_shader_parameter_default_value, RID, const StringName &)
 	BIND2C(instance_geometry_get_shader_parameter_list, RID, List<PropertyInfo> *)
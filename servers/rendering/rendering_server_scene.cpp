@@ -31,6 +31,7 @@
 #include "rendering_server_scene.h"
 
 #include "core/os/os.h"
+#include "core/project_settings.h"
 #include "rendering_server_globals.h"
 #include "rendering_server_raster.h"
 
@@ -102,9 +103,277 @@ void RenderingServerScene::camera_set_use_vertical_aspect(RID p_camera, bool p_e
 	camera->vaspect = p_enable;
 }
 
+/* OCCLUDER API */
+
+RID RenderingServerScene::occluder_create() {
+	Occluder *occluder = memnew(Occluder);
+	return occluder_owner.make_rid(occluder);
+}
+
+void RenderingServerScene::occluder_set_mesh(RID p_occluder, const PackedVector3Array &p_vertices, const PackedInt32Array &p_indices) {
+	Occluder *occluder = occluder_owner.getornull(p_occluder);
+	ERR_FAIL_COND(!occluder);
+	ERR_FAIL_COND(p_indices.size() % 3 != 0);
+
+	int vertex_count = p_vertices.size();
+	const int *indices = p_indices.ptr();
+	for (int i = 0; i < p_indices.size(); i++) {
+		ERR_FAIL_INDEX(indices[i], vertex_count);
+	}
+
+	occluder->vertices = p_vertices;
+	occluder->indices = p_indices;
+
+	AABB aabb;
+	const Vector3 *vertices = p_vertices.ptr();
+	for (int i = 0; i < vertex_count; i++) {
+		if (i == 0) {
+			aabb.position = vertices[i];
+		} else {
+			aabb.expand_to(vertices[i]);
+		}
+	}
+	occluder->aabb = aabb;
+
+	occluder->instance_dependency.instance_notify_changed(true, false);
+}
+
+/* OCCLUSION CULLING */
+
+void RenderingServerScene::OcclusionBuffer::begin(const CameraMatrix &p_view_projection, int p_width, float p_aspect) {
+	view_projection = p_view_projection;
+
+	tiles_x = MAX(1, (p_width + TILE_SIZE - 1) / TILE_SIZE);
+	tiles_y = MAX(1, int(Math::ceil(p_width / MAX(p_aspect, 0.01f) / TILE_SIZE)));
+	width = tiles_x * TILE_SIZE;
+	height = tiles_y * TILE_SIZE;
+
+	triangles.clear();
+	depth.resize(width * height);
+	tile_max_depth.resize(tiles_x * tiles_y);
+}
+
+void RenderingServerScene::OcclusionBuffer::_add_triangle(const Plane &p_a, const Plane &p_b, const Plane &p_c) {
+	// Points are in clip space, already in front of the near plane.
+	const Plane *clip[3] = { &p_a, &p_b, &p_c };
+	Triangle t;
+	for (int i = 0; i < 3; i++) {
+		float inv_w = 1.0 / clip[i]->d;
+		t.points[i].x = (clip[i]->normal.x * inv_w * 0.5 + 0.5) * width;
+		t.points[i].y = (clip[i]->normal.y * inv_w * 0.5 + 0.5) * height;
+		t.points[i].z = clip[i]->normal.z * inv_w;
+	}
+
+	float min_x = MIN(t.points[0].x, MIN(t.points[1].x, t.points[2].x));
+	float max_x = MAX(t.points[0].x, MAX(t.points[1].x, t.points[2].x));
+	float min_y = MIN(t.points[0].y, MIN(t.points[1].y, t.points[2].y));
+	float max_y = MAX(t.points[0].y, MAX(t.points[1].y, t.points[2].y));
+	if (max_x < 0 || min_x > width || max_y < 0 || min_y > height) {
+		return;
+	}
+
+	t.min_y = MAX(0, int(Math::floor(min_y)));
+	t.max_y = MIN(height - 1, int(Math::ceil(max_y)));
+	triangles.push_back(t);
+}
+
+void RenderingServerScene::OcclusionBuffer::add_occluder(const Transform &p_transform, const Occluder *p_occluder) {
+	CameraMatrix xform = view_projection * CameraMatrix(p_transform);
+
+	int vertex_count = p_occluder->vertices.size();
+	const Vector3 *vertices = p_occluder->vertices.ptr();
+	int index_count = p_occluder->indices.size();
+	const int *indices = p_occluder->indices.ptr();
+
+	for (int i = 0; i < index_count; i += 3) {
+		Plane points[3];
+		float near_dist[3];
+		int inside = 0;
+		for (int j = 0; j < 3; j++) {
+			ERR_FAIL_INDEX(indices[i + j], vertex_count);
+			points[j] = xform.xform4(Plane(vertices[indices[i + j]], 1.0));
+			near_dist[j] = points[j].normal.z + points[j].d;
+			if (near_dist[j] > CMP_EPSILON) {
+				inside++;
+			}
+		}
+
+		if (inside == 3) {
+			_add_triangle(points[0], points[1], points[2]);
+			continue;
+		} else if (inside == 0) {
+			continue;
+		}
+
+		// Clip against the near plane, which yields one or two triangles.
+		Plane clipped[4];
+		int clipped_count = 0;
+		for (int j = 0; j < 3; j++) {
+			int k = (j + 1) % 3;
+			bool j_inside = near_dist[j] > CMP_EPSILON;
+			bool k_inside = near_dist[k] > CMP_EPSILON;
+			if (j_inside) {
+				clipped[clipped_count++] = points[j];
+			}
+			if (j_inside != k_inside) {
+				float t = (near_dist[j] - CMP_EPSILON) / (near_dist[j] - near_dist[k]);
+				clipped[clipped_count].normal = points[j].normal.lerp(points[k].normal, t);
+				clipped[clipped_count].d = Math::lerp(points[j].d, points[k].d, t);
+				clipped_count++;
+			}
+		}
+
+		_add_triangle(clipped[0], clipped[1], clipped[2]);
+		if (clipped_count == 4) {
+			_add_triangle(clipped[0], clipped[2], clipped[3]);
+		}
+	}
+}
+
+void RenderingServerScene::OcclusionBuffer::rasterize_tile_row(uint32_t p_tile_row, void *p_userdata) {
+	int row_min_y = p_tile_row * TILE_SIZE;
+	int row_max_y = row_min_y + TILE_SIZE - 1;
+
+	float *row_depth = &depth[p_tile_row * tiles_x * TILE_PIXELS];
+	for (int i = 0; i < tiles_x * TILE_PIXELS; i++) {
+		row_depth[i] = Math_INF;
+	}
+
+	for (uint32_t i = 0; i < triangles.size(); i++) {
+		const Triangle &t = triangles[i];
+		if (t.max_y < row_min_y || t.min_y > row_max_y) {
+			continue;
+		}
+
+		Vector3 a = t.points[0];
+		Vector3 b = t.points[1];
+		Vector3 c = t.points[2];
+
+		float area = (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+		if (Math::abs(area) < CMP_EPSILON) {
+			continue;
+		}
+		if (area < 0) {
+			// Occluders are double sided, flip to keep the edge functions positive inside.
+			SWAP(b, c);
+			area = -area;
+		}
+		float inv_area = 1.0 / area;
+
+		int min_x = MAX(0, int(Math::floor(MIN(a.x, MIN(b.x, c.x)))));
+		int max_x = MIN(width - 1, int(Math::ceil(MAX(a.x, MAX(b.x, c.x)))));
+		int min_y = MAX(row_min_y, t.min_y);
+		int max_y = MIN(row_max_y, t.max_y);
+
+		// Edge function increments per pixel step.
+		float e0_dx = b.y - c.y, e0_dy = c.x - b.x;
+		float e1_dx = c.y - a.y, e1_dy = a.x - c.x;
+		float e2_dx = a.y - b.y, e2_dy = b.x - a.x;
+
+		// Pixels are only written when the triangle covers them entirely, so
+		// the edge functions are tested at the pixel corner furthest inside,
+		// and the depth written is the furthest one within the pixel.
+		float e0_bias = (Math::abs(e0_dx) + Math::abs(e0_dy)) * 0.5;
+		float e1_bias = (Math::abs(e1_dx) + Math::abs(e1_dy)) * 0.5;
+		float e2_bias = (Math::abs(e2_dx) + Math::abs(e2_dy)) * 0.5;
+		float z_dx = (e0_dx * a.z + e1_dx * b.z + e2_dx * c.z) * inv_area;
+		float z_dy = (e0_dy * a.z + e1_dy * b.z + e2_dy * c.z) * inv_area;
+		float z_bias = (Math::abs(z_dx) + Math::abs(z_dy)) * 0.5;
+
+		float px = min_x + 0.5;
+		for (int y = min_y; y <= max_y; y++) {
+			float py = y + 0.5;
+			float e0 = (px - b.x) * e0_dx + (py - b.y) * e0_dy;
+			float e1 = (px - c.x) * e1_dx + (py - c.y) * e1_dy;
+			float e2 = (px - a.x) * e2_dx + (py - a.y) * e2_dy;
+
+			float *tile_line = &row_depth[(y - row_min_y) * TILE_SIZE];
+
+			for (int x = min_x; x <= max_x; x++) {
+				if (e0 >= e0_bias && e1 >= e1_bias && e2 >= e2_bias) {
+					float z = (e0 * a.z + e1 * b.z + e2 * c.z) * inv_area + z_bias;
+					float &d = tile_line[(x / TILE_SIZE) * TILE_PIXELS + (x % TILE_SIZE)];
+					if (z < d) {
+						d = z;
+					}
+				}
+				e0 += e0_dx;
+				e1 += e1_dx;
+				e2 += e2_dx;
+			}
+		}
+	}
+
+	for (int i = 0; i < tiles_x; i++) {
+		const float *tile_depth = &row_depth[i * TILE_PIXELS];
+		float max_depth = tile_depth[0];
+		for (int j = 1; j < TILE_PIXELS; j++) {
+			max_depth = MAX(max_depth, tile_depth[j]);
+		}
+		tile_max_depth[p_tile_row * tiles_x + i] = max_depth;
+	}
+}
+
+bool RenderingServerScene::OcclusionBuffer::is_occluded(const AABB &p_aabb) const {
+	float min_x = 1e20, max_x = -1e20;
+	float min_y = 1e20, max_y = -1e20;
+	float min_z = 1e20;
+
+	for (int i = 0; i < 8; i++) {
+		Vector3 corner = p_aabb.position + p_aabb.size * Vector3(i & 1, (i >> 1) & 1, (i >> 2) & 1);
+
+		Plane clip = view_projection.xform4(Plane(corner, 1.0));
+		if (clip.normal.z + clip.d <= CMP_EPSILON) {
+			return false; // Crosses the near plane, can't be tested.
+		}
+
+		float inv_w = 1.0 / clip.d;
+		float x = (clip.normal.x * inv_w * 0.5 + 0.5) * width;
+		float y = (clip.normal.y * inv_w * 0.5 + 0.5) * height;
+		min_x = MIN(min_x, x);
+		max_x = MAX(max_x, x);
+		min_y = MIN(min_y, y);
+		max_y = MAX(max_y, y);
+		min_z = MIN(min_z, clip.normal.z * inv_w);
+	}
+
+	if (max_x < 0 || min_x >= width || max_y < 0 || min_y >= height) {
+		return false;
+	}
+
+	int from_x = MAX(0, int(Math::floor(min_x)));
+	int to_x = MIN(width - 1, int(Math::floor(max_x)));
+	int from_y = MAX(0, int(Math::floor(min_y)));
+	int to_y = MIN(height - 1, int(Math::floor(max_y)));
+
+	for (int ty = from_y / TILE_SIZE; ty <= to_y / TILE_SIZE; ty++) {
+		for (int tx = from_x / TILE_SIZE; tx <= to_x / TILE_SIZE; tx++) {
+			if (tile_max_depth[ty * tiles_x + tx] < min_z) {
+				continue; // Whole tile is in front of the bounds.
+			}
+
+			const float *tile_depth = &depth[(ty * tiles_x + tx) * TILE_PIXELS];
+			int y_begin = MAX(from_y, ty * TILE_SIZE) - ty * TILE_SIZE;
+			int y_end = MIN(to_y, ty * TILE_SIZE + TILE_SIZE - 1) - ty * TILE_SIZE;
+			int x_begin = MAX(from_x, tx * TILE_SIZE) - tx * TILE_SIZE;
+			int x_end = MIN(to_x, tx * TILE_SIZE + TILE_SIZE - 1) - tx * TILE_SIZE;
+
+			for (int y = y_begin; y <= y_end; y++) {
+				for (int x = x_begin; x <= x_end; x++) {
+					if (tile_depth[y * TILE_SIZE + x] >= min_z) {
+						return false;
+					}
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
 /* SCENARIO API */
 
-void *RenderingServerScene::_instance_pair(void *p_self, OctreeElementID, Instance *p_A, int, OctreeElementID, Instance *p_B, int) {
+void *RenderingServerScene::_instance_pair(void *p_self, BVHElementID, Instance *p_A, int, BVHElementID, Instance *p_B, int) {
 	//RenderingServerScene *self = (RenderingServerScene*)p_self;
 	Instance *A = p_A;
 	Instance *B = p_B;
@@ -198,7 +467,7 @@ void *RenderingServerScene::_instance_pair(void *p_self, OctreeElementID, Instan
 	return nullptr;
 }
 
-void RenderingServerScene::_instance_unpair(void *p_self, OctreeElementID, Instance *p_A, int, OctreeElementID, Instance *p_B, int, void *udata) {
+void RenderingServerScene::_instance_unpair(void *p_self, BVHElementID, Instance *p_A, int, BVHElementID, Instance *p_B, int, void *udata) {
 	//RenderingServerScene *self = (RenderingServerScene*)p_self;
 	Instance *A = p_A;
 	Instance *B = p_B;
@@ -283,8 +552,8 @@ RID RenderingServerScene::scenario_create() {
 	RID scenario_rid = scenario_owner.make_rid(scenario);
 	scenario->self = scenario_rid;
 
-	scenario->octree.set_pair_callback(_instance_pair, this);
-	scenario->octree.set_unpair_callback(_instance_unpair, this);
+	scenario->bvh.set_pair_callback(_instance_pair, this);
+	scenario->bvh.set_unpair_callback(_instance_unpair, this);
 	scenario->reflection_probe_shadow_atlas = RSG::scene_render->shadow_atlas_create();
 	RSG::scene_render->shadow_atlas_set_size(scenario->reflection_probe_shadow_atlas, 1024); //make enough shadows for close distance, don't bother with rest
 	RSG::scene_render->shadow_atlas_set_quadrant_subdivision(scenario->reflection_probe_shadow_atlas, 0, 4);
@@ -361,9 +630,9 @@ void RenderingServerScene::instance_set_base(RID p_instance, RID p_base) {
 	if (instance->base_type != RS::INSTANCE_NONE) {
 		//free anything related to that base
 
-		if (scenario && instance->octree_id) {
-			scenario->octree.erase(instance->octree_id); //make dependencies generated by the octree go away
-			instance->octree_id = 0;
+		if (scenario && instance->bvh_id) {
+			scenario->bvh.erase(instance->bvh_id); //make dependencies generated by the BVH go away
+			instance->bvh_id = 0;
 		}
 
 		switch (instance->base_type) {
@@ -435,7 +704,11 @@ void RenderingServerScene::instance_set_base(RID p_instance, RID p_base) {
 	instance->base = RID();
 
 	if (p_base.is_valid()) {
-		instance->base_type = RSG::storage->get_base_type(p_base);
+		if (occluder_owner.owns(p_base)) {
+			instance->base_type = RS::INSTANCE_OCCLUDER;
+		} else {
+			instance->base_type = RSG::storage->get_base_type(p_base);
+		}
 		ERR_FAIL_COND(instance->base_type == RS::INSTANCE_NONE);
 
 		switch (instance->base_type) {
@@ -498,7 +771,11 @@ void RenderingServerScene::instance_set_base(RID p_instance, RID p_base) {
 		instance->base = p_base;
 
 		//forcefully update the dependency now, so if for some reason it gets removed, we can immediately clear it
-		RSG::storage->base_update_dependency(p_base, instance);
+		if (instance->base_type == RS::INSTANCE_OCCLUDER) {
+			instance->update_dependency(&occluder_owner.getornull(p_base)->instance_dependency);
+		} else {
+			RSG::storage->base_update_dependency(p_base, instance);
+		}
 	}
 
 	_instance_queue_update(instance, true, true);
@@ -511,9 +788,9 @@ void RenderingServerScene::instance_set_scenario(RID p_instance, RID p_scenario)
 	if (instance->scenario) {
 		instance->scenario->instances.remove(&instance->scenario_item);
 
-		if (instance->octree_id) {
-			instance->scenario->octree.erase(instance->octree_id); //make dependencies generated by the octree go away
-			instance->octree_id = 0;
+		if (instance->bvh_id) {
+			instance->scenario->bvh.erase(instance->bvh_id); //make dependencies generated by the BVH go away
+			instance->bvh_id = 0;
 		}
 
 		switch (instance->base_type) {
@@ -596,6 +873,18 @@ void RenderingServerScene::instance_set_layer_mask(RID p_instance, uint32_t p_ma
 	instance->layer_mask = p_mask;
 }
 
+#ifdef DEBUG_ENABLED
+static bool _is_transform_finite(const Transform &p_transform) {
+	for (int i = 0; i < 4; i++) {
+		const Vector3 &v = i < 3 ? p_transform.basis.elements[i] : p_transform.origin;
+		if (Math::is_inf(v.x) || Math::is_nan(v.x) || Math::is_inf(v.y) || Math::is_nan(v.y) || Math::is_inf(v.z) || Math::is_nan(v.z)) {
+			return false;
+		}
+	}
+	return true;
+}
+#endif
+
 void RenderingServerScene::instance_set_transform(RID p_instance, const Transform &p_transform) {
 	Instance *instance = instance_owner.getornull(p_instance);
 	ERR_FAIL_COND(!instance);
@@ -605,22 +894,35 @@ void RenderingServerScene::instance_set_transform(RID p_instance, const Transfor
 	}
 
 #ifdef DEBUG_ENABLED
-
-	for (int i = 0; i < 4; i++) {
-		const Vector3 &v = i < 3 ? p_transform.basis.elements[i] : p_transform.origin;
-		ERR_FAIL_COND(Math::is_inf(v.x));
-		ERR_FAIL_COND(Math::is_nan(v.x));
-		ERR_FAIL_COND(Math::is_inf(v.y));
-		ERR_FAIL_COND(Math::is_nan(v.y));
-		ERR_FAIL_COND(Math::is_inf(v.z));
-		ERR_FAIL_COND(Math::is_nan(v.z));
-	}
-
+	ERR_FAIL_COND(!_is_transform_finite(p_transform));
 #endif
 	instance->transform = p_transform;
 	_instance_queue_update(instance, true);
 }
 
+void RenderingServerScene::instance_set_transform_bulk(const Vector<RID> &p_instances, const Vector<Transform> &p_transforms) {
+	ERR_FAIL_COND(p_instances.size() != p_transforms.size());
+
+	const RID *instances = p_instances.ptr();
+	const Transform *transforms = p_transforms.ptr();
+	int count = p_instances.size();
+
+	for (int i = 0; i < count; i++) {
+		Instance *instance = instance_owner.getornull(instances[i]);
+		ERR_CONTINUE(!instance);
+
+		if (instance->transform == transforms[i]) {
+			continue;
+		}
+
+#ifdef DEBUG_ENABLED
+		ERR_CONTINUE(!_is_transform_finite(transforms[i]));
+#endif
+		instance->transform = transforms[i];
+		_instance_queue_update(instance, true);
+	}
+}
+
 void RenderingServerScene::instance_attach_object_instance_id(RID p_instance, ObjectID p_id) {
 	Instance *instance = instance_owner.getornull(p_instance);
 	ERR_FAIL_COND(!instance);
@@ -668,32 +970,32 @@ void RenderingServerScene::instance_set_visible(RID p_instance, bool p_visible)
 
 	switch (instance->base_type) {
 		case RS::INSTANCE_LIGHT: {
-			if (RSG::storage->light_get_type(instance->base) != RS::LIGHT_DIRECTIONAL && instance->octree_id && instance->scenario) {
-				instance->scenario->octree.set_pairable(instance->octree_id, p_visible, 1 << RS::INSTANCE_LIGHT, p_visible ? RS::INSTANCE_GEOMETRY_MASK : 0);
+			if (RSG::storage->light_get_type(instance->base) != RS::LIGHT_DIRECTIONAL && instance->bvh_id && instance->scenario) {
+				instance->scenario->bvh.set_pairable(instance->bvh_id, p_visible, 1 << RS::INSTANCE_LIGHT, p_visible ? RS::INSTANCE_GEOMETRY_MASK : 0);
 			}
 
 		} break;
 		case RS::INSTANCE_REFLECTION_PROBE: {
-			if (instance->octree_id && instance->scenario) {
-				instance->scenario->octree.set_pairable(instance->octree_id, p_visible, 1 << RS::INSTANCE_REFLECTION_PROBE, p_visible ? RS::INSTANCE_GEOMETRY_MASK : 0);
+			if (instance->bvh_id && instance->scenario) {
+				instance->scenario->bvh.set_pairable(instance->bvh_id, p_visible, 1 << RS::INSTANCE_REFLECTION_PROBE, p_visible ? RS::INSTANCE_GEOMETRY_MASK : 0);
 			}
 
 		} break;
 		case RS::INSTANCE_DECAL: {
-			if (instance->octree_id && instance->scenario) {
-				instance->scenario->octree.set_pairable(instance->octree_id, p_visible, 1 << RS::INSTANCE_DECAL, p_visible ? RS::INSTANCE_GEOMETRY_MASK : 0);
+			if (instance->bvh_id && instance->scenario) {
+				instance->scenario->bvh.set_pairable(instance->bvh_id, p_visible, 1 << RS::INSTANCE_DECAL, p_visible ? RS::INSTANCE_GEOMETRY_MASK : 0);
 			}
 
 		} break;
 		case RS::INSTANCE_LIGHTMAP: {
-			if (instance->octree_id && instance->scenario) {
-				instance->scenario->octree.set_pairable(instance->octree_id, p_visible, 1 << RS::INSTANCE_LIGHTMAP, p_visible ? RS::INSTANCE_GEOMETRY_MASK : 0);
+			if (instance->bvh_id && instance->scenario) {
+				instance->scenario->bvh.set_pairable(instance->bvh_id, p_visible, 1 << RS::INSTANCE_LIGHTMAP, p_visible ? RS::INSTANCE_GEOMETRY_MASK : 0);
 			}
 
 		} break;
 		case RS::INSTANCE_GI_PROBE: {
-			if (instance->octree_id && instance->scenario) {
-				instance->scenario->octree.set_pairable(instance->octree_id, p_visible, 1 << RS::INSTANCE_GI_PROBE, p_visible ? (RS::INSTANCE_GEOMETRY_MASK | (1 << RS::INSTANCE_LIGHT)) : 0);
+			if (instance->bvh_id && instance->scenario) {
+				instance->scenario->bvh.set_pairable(instance->bvh_id, p_visible, 1 << RS::INSTANCE_GI_PROBE, p_visible ? (RS::INSTANCE_GEOMETRY_MASK | (1 << RS::INSTANCE_LIGHT)) : 0);
 			}
 
 		} break;
@@ -702,6 +1004,15 @@ void RenderingServerScene::instance_set_visible(RID p_instance, bool p_visible)
 	}
 }
 
+void RenderingServerScene::instance_set_visible_bulk(const Vector<RID> &p_instances, bool p_visible) {
+	const RID *instances = p_instances.ptr();
+	int count = p_instances.size();
+
+	for (int i = 0; i < count; i++) {
+		instance_set_visible(instances[i], p_visible);
+	}
+}
+
 inline bool is_geometry_instance(RenderingServer::InstanceType p_type) {
 	return p_type == RS::INSTANCE_MESH || p_type == RS::INSTANCE_MULTIMESH || p_type == RS::INSTANCE_PARTICLES || p_type == RS::INSTANCE_IMMEDIATE;
 }
@@ -768,7 +1079,7 @@ Vector<ObjectID> RenderingServerScene::instances_cull_aabb(const AABB &p_aabb, R
 
 	int culled = 0;
 	Instance *cull[1024];
-	culled = scenario->octree.cull_aabb(p_aabb, cull, 1024);
+	culled = scenario->bvh.cull_aabb(p_aabb, cull, 1024);
 
 	for (int i = 0; i < culled; i++) {
 		Instance *instance = cull[i];
@@ -791,7 +1102,7 @@ Vector<ObjectID> RenderingServerScene::instances_cull_ray(const Vector3 &p_from,
 
 	int culled = 0;
 	Instance *cull[1024];
-	culled = scenario->octree.cull_segment(p_from, p_from + p_to * 10000, cull, 1024);
+	culled = scenario->bvh.cull_segment(p_from, p_from + p_to * 10000, cull, 1024);
 
 	for (int i = 0; i < culled; i++) {
 		Instance *instance = cull[i];
@@ -815,7 +1126,7 @@ Vector<ObjectID> RenderingServerScene::instances_cull_convex(const Vector<Plane>
 	int culled = 0;
 	Instance *cull[1024];
 
-	culled = scenario->octree.cull_convex(p_convex, cull, 1024);
+	culled = scenario->bvh.cull_convex(p_convex, cull, 1024);
 
 	for (int i = 0; i < culled; i++) {
 		Instance *instance = cull[i];
@@ -847,14 +1158,14 @@ void RenderingServerScene::instance_geometry_set_flag(RID p_instance, RS::Instan
 				return;
 			}
 
-			if (instance->octree_id != 0) {
-				//remove from octree, it needs to be re-paired
-				instance->scenario->octree.erase(instance->octree_id);
-				instance->octree_id = 0;
+			if (instance->bvh_id != 0) {
+				//remove from BVH, it needs to be re-paired
+				instance->scenario->bvh.erase(instance->bvh_id);
+				instance->bvh_id = 0;
 				_instance_queue_update(instance, true, true);
 			}
 
-			//once out of octree, can be changed
+			//once out of BVH, can be changed
 			instance->dynamic_gi = p_enabled;
 
 		} break;
@@ -884,9 +1195,24 @@ void RenderingServerScene::instance_geometry_set_material_override(RID p_instanc
 }
 
 void RenderingServerScene::instance_geometry_set_draw_range(RID p_instance, float p_min, float p_max, float p_min_margin, float p_max_margin) {
+	Instance *instance = instance_owner.getornull(p_instance);
+	ERR_FAIL_COND(!instance);
+	ERR_FAIL_COND(p_min < 0 || p_max < 0 || p_min_margin < 0 || p_max_margin < 0);
+
+	instance->lod_begin = p_min;
+	instance->lod_end = p_max;
+	instance->lod_begin_hysteresis = p_min_margin;
+	instance->lod_end_hysteresis = p_max_margin;
+	instance->lod_in_range = true;
 }
 
 void RenderingServerScene::instance_geometry_set_as_instance_lod(RID p_instance, RID p_as_lod_of_instance) {
+	Instance *instance = instance_owner.getornull(p_instance);
+	ERR_FAIL_COND(!instance);
+	ERR_FAIL_COND(p_as_lod_of_instance == p_instance);
+	ERR_FAIL_COND(p_as_lod_of_instance.is_valid() && !instance_owner.owns(p_as_lod_of_instance));
+
+	instance->lod_instance = p_as_lod_of_instance;
 }
 
 void RenderingServerScene::instance_geometry_set_lightmap(RID p_instance, RID p_lightmap, const Rect2 &p_lightmap_uv_scale, int p_slice_index) {
@@ -932,6 +1258,18 @@ void RenderingServerScene::instance_geometry_set_shader_parameter(RID p_instance
 	}
 }
 
+void RenderingServerScene::instance_geometry_set_shader_parameter_bulk(const Vector<RID> &p_instances, const StringName &p_parameter, const Vector<Variant> &p_values) {
+	ERR_FAIL_COND(p_instances.size() != p_values.size());
+
+	const RID *instances = p_instances.ptr();
+	const Variant *values = p_values.ptr();
+	int count = p_instances.size();
+
+	for (int i = 0; i < count; i++) {
+		instance_geometry_set_shader_parameter(instances[i], p_parameter, values[i]);
+	}
+}
+
 Variant RenderingServerScene::instance_geometry_get_shader_parameter(RID p_instance, const StringName &p_parameter) const {
 	const Instance *instance = const_cast<RenderingServerScene *>(this)->instance_owner.getornull(p_instance);
 	ERR_FAIL_COND_V(!instance, Variant());
@@ -1051,7 +1389,7 @@ void RenderingServerScene::_update_instance(Instance *p_instance) {
 		return;
 	}
 
-	if (p_instance->octree_id == 0) {
+	if (p_instance->bvh_id == 0) {
 		uint32_t base_type = 1 << p_instance->base_type;
 		uint32_t pairable_mask = 0;
 		bool pairable = false;
@@ -1067,8 +1405,8 @@ void RenderingServerScene::_update_instance(Instance *p_instance) {
 			pairable = true;
 		}
 
-		// not inside octree
-		p_instance->octree_id = p_instance->scenario->octree.create(p_instance, new_aabb, 0, pairable, base_type, pairable_mask);
+		// not inside BVH
+		p_instance->bvh_id = p_instance->scenario->bvh.create(p_instance, new_aabb, 0, pairable, base_type, pairable_mask);
 
 	} else {
 		/*
@@ -1076,7 +1414,7 @@ void RenderingServerScene::_update_instance(Instance *p_instance) {
 			return;
 		*/
 
-		p_instance->scenario->octree.move(p_instance->octree_id, new_aabb);
+		p_instance->scenario->bvh.move(p_instance->bvh_id, new_aabb);
 	}
 }
 
@@ -1141,6 +1479,10 @@ void RenderingServerScene::_update_instance_aabb(Instance *p_instance) {
 		case RenderingServer::INSTANCE_LIGHTMAP: {
 			new_aabb = RSG::storage->lightmap_get_aabb(p_instance->base);
 
+		} break;
+		case RenderingServer::INSTANCE_OCCLUDER: {
+			new_aabb = occluder_owner.getornull(p_instance->base)->aabb;
+
 		} break;
 		default: {
 		}
@@ -1232,33 +1574,58 @@ void RenderingServerScene::_update_instance_lightmap_captures(Instance *p_instan
 	}
 }
 
-bool RenderingServerScene::_light_instance_update_shadow(Instance *p_instance, const Transform p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, bool p_cam_vaspect, RID p_shadow_atlas, Scenario *p_scenario) {
-	InstanceLightData *light = static_cast<InstanceLightData *>(p_instance->base_data);
+int RenderingServerScene::_cull_shadow_casters(const Scenario *p_scenario, const Vector<Plane> &p_planes, LocalVector<Instance *> &r_casters) {
+	if (r_casters.size() == 0) {
+		r_casters.resize(256);
+	}
 
-	Transform light_transform = p_instance->transform;
-	light_transform.orthonormalize(); //scale does not count on lights
+	while (true) {
+		int cull_count = p_scenario->bvh.cull_convex(p_planes, &r_casters[0], r_casters.size(), RS::INSTANCE_GEOMETRY_MASK);
+		if (cull_count < (int)r_casters.size() || r_casters.size() >= MAX_INSTANCE_CULL) {
+			return cull_count;
+		}
+		//result may have been truncated, grow and cull again (capacity is kept for the next frames)
+		r_casters.resize(MIN(r_casters.size() * 2, (uint32_t)MAX_INSTANCE_CULL));
+	}
+}
 
-	bool animated_material_found = false;
+void RenderingServerScene::_light_instance_cull_shadow(ShadowCullJob &r_job, const ShadowCullSetup &p_setup) {
+	Instance *ins = r_job.light;
+	InstanceLightData *light = static_cast<InstanceLightData *>(ins->base_data);
 
-	switch (RSG::storage->light_get_type(p_instance->base)) {
+	const Transform &cam_transform = p_setup.cam_transform;
+	const CameraMatrix &cam_projection = p_setup.cam_projection;
+	bool cam_orthogonal = p_setup.cam_orthogonal;
+	bool cam_vaspect = p_setup.cam_vaspect;
+	const Scenario *scenario = p_setup.scenario;
+
+	r_job.pass_count = 0;
+	r_job.restore_paraboloid_transform = false;
+	r_job.animated_material_found = false;
+
+	Transform light_transform = ins->transform;
+	light_transform.orthonormalize(); //scale does not count on lights
+
+	switch (RSG::storage->light_get_type(ins->base)) {
 		case RS::LIGHT_DIRECTIONAL: {
-			real_t max_distance = p_cam_projection.get_z_far();
-			real_t shadow_max = RSG::storage->light_get_param(p_instance->base, RS::LIGHT_PARAM_SHADOW_MAX_DISTANCE);
-			if (shadow_max > 0 && !p_cam_orthogonal) { //its impractical (and leads to unwanted behaviors) to set max distance in orthogonal camera
+			real_t max_distance = cam_projection.get_z_far();
+			real_t shadow_max = RSG::storage->light_get_param(ins->base, RS::LIGHT_PARAM_SHADOW_MAX_DISTANCE);
+			if (shadow_max > 0 && !cam_orthogonal) { //its impractical (and leads to unwanted behaviors) to set max distance in orthogonal camera
 				max_distance = MIN(shadow_max, max_distance);
 			}
-			max_distance = MAX(max_distance, p_cam_projection.get_z_near() + 0.001);
-			real_t min_distance = MIN(p_cam_projection.get_z_near(), max_distance);
+			max_distance = MAX(max_distance, cam_projection.get_z_near() + 0.001);
+			real_t min_distance = MIN(cam_projection.get_z_near(), max_distance);
 
-			RS::LightDirectionalShadowDepthRangeMode depth_range_mode = RSG::storage->light_directional_get_shadow_depth_range_mode(p_instance->base);
+			RS::LightDirectionalShadowDepthRangeMode depth_range_mode = RSG::storage->light_directional_get_shadow_depth_range_mode(ins->base);
 
-			real_t pancake_size = RSG::storage->light_get_param(p_instance->base, RS::LIGHT_PARAM_SHADOW_PANCAKE_SIZE);
+			real_t pancake_size = RSG::storage->light_get_param(ins->base, RS::LIGHT_PARAM_SHADOW_PANCAKE_SIZE);
 
 			if (depth_range_mode == RS::LIGHT_DIRECTIONAL_SHADOW_DEPTH_RANGE_OPTIMIZED) {
 				//optimize min/max
-				Vector<Plane> planes = p_cam_projection.get_projection_planes(p_cam_transform);
-				int cull_count = p_scenario->octree.cull_convex(planes, instance_shadow_cull_result, MAX_INSTANCE_CULL, RS::INSTANCE_GEOMETRY_MASK);
-				Plane base(p_cam_transform.origin, -p_cam_transform.basis.get_axis(2));
+				Vector<Plane> planes = cam_projection.get_projection_planes(cam_transform);
+				LocalVector<Instance *> &casters = r_job.passes[0].casters; //only used as scratch here
+				int cull_count = _cull_shadow_casters(scenario, planes, casters);
+				Plane base(cam_transform.origin, -cam_transform.basis.get_axis(2));
 				//check distance max and min
 
 				bool found_items = false;
@@ -1266,13 +1633,13 @@ bool RenderingServerScene::_light_instance_update_shadow(Instance *p_instance, c
 				real_t z_min = 1e20;
 
 				for (int i = 0; i < cull_count; i++) {
-					Instance *instance = instance_shadow_cull_result[i];
+					Instance *instance = casters[i];
 					if (!instance->visible || !((1 << instance->base_type) & RS::INSTANCE_GEOMETRY_MASK) || !static_cast<InstanceGeometryData *>(instance->base_data)->can_cast_shadows) {
 						continue;
 					}
 
 					if (static_cast<InstanceGeometryData *>(instance->base_data)->material_is_animated) {
-						animated_material_found = true;
+						r_job.animated_material_found = true;
 					}
 
 					real_t max, min;
@@ -1298,7 +1665,7 @@ bool RenderingServerScene::_light_instance_update_shadow(Instance *p_instance, c
 			real_t range = max_distance - min_distance;
 
 			int splits = 0;
-			switch (RSG::storage->light_directional_get_shadow_mode(p_instance->base)) {
+			switch (RSG::storage->light_directional_get_shadow_mode(ins->base)) {
 				case RS::LIGHT_DIRECTIONAL_SHADOW_ORTHOGONAL:
 					splits = 1;
 					break;
@@ -1314,40 +1681,38 @@ bool RenderingServerScene::_light_instance_update_shadow(Instance *p_instance, c
 
 			distances[0] = min_distance;
 			for (int i = 0; i < splits; i++) {
-				distances[i + 1] = min_distance + RSG::storage->light_get_param(p_instance->base, RS::LightParam(RS::LIGHT_PARAM_SHADOW_SPLIT_1_OFFSET + i)) * range;
+				distances[i + 1] = min_distance + RSG::storage->light_get_param(ins->base, RS::LightParam(RS::LIGHT_PARAM_SHADOW_SPLIT_1_OFFSET + i)) * range;
 			};
 
 			distances[splits] = max_distance;
 
 			real_t texture_size = RSG::scene_render->get_directional_light_shadow_size(light->instance);
 
-			bool overlap = RSG::storage->light_directional_get_blend_splits(p_instance->base);
+			bool overlap = RSG::storage->light_directional_get_blend_splits(ins->base);
 
 			real_t first_radius = 0.0;
 
 			real_t min_distance_bias_scale = pancake_size > 0 ? distances[1] / 10.0 : 0;
 
 			for (int i = 0; i < splits; i++) {
-				RENDER_TIMESTAMP("Culling Directional Light split" + itos(i));
-
 				// setup a camera matrix for that range!
 				CameraMatrix camera_matrix;
 
-				real_t aspect = p_cam_projection.get_aspect();
+				real_t aspect = cam_projection.get_aspect();
 
-				if (p_cam_orthogonal) {
-					Vector2 vp_he = p_cam_projection.get_viewport_half_extents();
+				if (cam_orthogonal) {
+					Vector2 vp_he = cam_projection.get_viewport_half_extents();
 
 					camera_matrix.set_orthogonal(vp_he.y * 2.0, aspect, distances[(i == 0 || !overlap) ? i : i - 1], distances[i + 1], false);
 				} else {
-					real_t fov = p_cam_projection.get_fov(); //this is actually yfov, because set aspect tries to keep it
+					real_t fov = cam_projection.get_fov(); //this is actually yfov, because set aspect tries to keep it
 					camera_matrix.set_perspective(fov, aspect, distances[(i == 0 || !overlap) ? i : i - 1], distances[i + 1], true);
 				}
 
 				//obtain the frustum endpoints
 
 				Vector3 endpoints[8]; // frustum plane endpoints
-				bool res = camera_matrix.get_endpoints(p_cam_transform, endpoints);
+				bool res = camera_matrix.get_endpoints(cam_transform, endpoints);
 				ERR_CONTINUE(!res);
 
 				// obtain the light frustm ranges (given endpoints)
@@ -1434,7 +1799,7 @@ bool RenderingServerScene::_light_instance_update_shadow(Instance *p_instance, c
 					z_min_cam = z_vec.dot(center) - radius;
 
 					{
-						float soft_shadow_angle = RSG::storage->light_get_param(p_instance->base, RS::LIGHT_PARAM_SIZE);
+						float soft_shadow_angle = RSG::storage->light_get_param(ins->base, RS::LIGHT_PARAM_SIZE);
 
 						if (soft_shadow_angle > 0.0 && pancake_size > 0.0) {
 							float z_range = (z_vec.dot(center) + radius + pancake_size) - z_min_cam;
@@ -1466,7 +1831,7 @@ bool RenderingServerScene::_light_instance_update_shadow(Instance *p_instance, c
 					}
 				}
 
-				//now that we now all ranges, we can proceed to make the light frustum planes, for culling octree
+				//now that we now all ranges, we can proceed to make the light frustum planes, for culling BVH
 
 				Vector<Plane> light_frustum_planes;
 				light_frustum_planes.resize(6);
@@ -1481,7 +1846,10 @@ bool RenderingServerScene::_light_instance_update_shadow(Instance *p_instance, c
 				light_frustum_planes.write[4] = Plane(z_vec, z_max + 1e6);
 				light_frustum_planes.write[5] = Plane(-z_vec, -z_min); // z_min is ok, since casters further than far-light plane are not needed
 
-				int cull_count = p_scenario->octree.cull_convex(light_frustum_planes, instance_shadow_cull_result, MAX_INSTANCE_CULL, RS::INSTANCE_GEOMETRY_MASK);
+				ShadowCullPass &shadow_pass = r_job.passes[r_job.pass_count];
+				shadow_pass.reset_transform();
+				LocalVector<Instance *> &casters = shadow_pass.casters;
+				int cull_count = _cull_shadow_casters(scenario, light_frustum_planes, casters);
 
 				// a pre pass will need to be needed to determine the actual z-near to be used
 
@@ -1490,17 +1858,15 @@ bool RenderingServerScene::_light_instance_update_shadow(Instance *p_instance, c
 				real_t cull_max = 0;
 				for (int j = 0; j < cull_count; j++) {
 					real_t min, max;
-					Instance *instance = instance_shadow_cull_result[j];
+					Instance *instance = casters[j];
 					if (!instance->visible || !((1 << instance->base_type) & RS::INSTANCE_GEOMETRY_MASK) || !static_cast<InstanceGeometryData *>(instance->base_data)->can_cast_shadows) {
 						cull_count--;
-						SWAP(instance_shadow_cull_result[j], instance_shadow_cull_result[cull_count]);
+						SWAP(casters[j], casters[cull_count]);
 						j--;
 						continue;
 					}
 
 					instance->transformed_aabb.project_range_in_plane(Plane(z_vec, 0), min, max);
-					instance->depth = near_plane.distance_to(instance->transform.origin);
-					instance->depth_layer = 0;
 					if (j == 0 || max > cull_max) {
 						cull_max = max;
 					}
@@ -1520,16 +1886,16 @@ bool RenderingServerScene::_light_instance_update_shadow(Instance *p_instance, c
 					// to do this, compare the depth of one that would have resulted from a square frustum
 
 					CameraMatrix camera_matrix_square;
-					if (p_cam_orthogonal) {
+					if (cam_orthogonal) {
 						Vector2 vp_he = camera_matrix.get_viewport_half_extents();
-						if (p_cam_vaspect) {
+						if (cam_vaspect) {
 							camera_matrix_square.set_orthogonal(vp_he.x * 2.0, 1.0, distances[(i == 0 || !overlap) ? i : i - 1], distances[i + 1], true);
 						} else {
 							camera_matrix_square.set_orthogonal(vp_he.y * 2.0, 1.0, distances[(i == 0 || !overlap) ? i : i - 1], distances[i + 1], false);
 						}
 					} else {
 						Vector2 vp_he = camera_matrix.get_viewport_half_extents();
-						if (p_cam_vaspect) {
+						if (cam_vaspect) {
 							camera_matrix_square.set_frustum(vp_he.x * 2.0, 1.0, Vector2(), distances[(i == 0 || !overlap) ? i : i - 1], distances[i + 1], true);
 						} else {
 							camera_matrix_square.set_frustum(vp_he.y * 2.0, 1.0, Vector2(), distances[(i == 0 || !overlap) ? i : i - 1], distances[i + 1], false);
@@ -1537,7 +1903,7 @@ bool RenderingServerScene::_light_instance_update_shadow(Instance *p_instance, c
 					}
 
 					Vector3 endpoints_square[8]; // frustum plane endpoints
-					res = camera_matrix_square.get_endpoints(p_cam_transform, endpoints_square);
+					res = camera_matrix_square.get_endpoints(cam_transform, endpoints_square);
 					ERR_CONTINUE(!res);
 					Vector3 center_square;
 					real_t z_max_square = 0;
@@ -1596,27 +1962,36 @@ bool RenderingServerScene::_light_instance_update_shadow(Instance *p_instance, c
 					ortho_transform.origin = x_vec * (x_min_cam + half_x) + y_vec * (y_min_cam + half_y) + z_vec * z_max;
 
 					{
-						Vector3 max_in_view = p_cam_transform.affine_inverse().xform(z_vec * cull_max);
-						Vector3 dir_in_view = p_cam_transform.xform_inv(z_vec).normalized();
+						Vector3 max_in_view = cam_transform.affine_inverse().xform(z_vec * cull_max);
+						Vector3 dir_in_view = cam_transform.xform_inv(z_vec).normalized();
 						cull_max = dir_in_view.dot(max_in_view);
 					}
 
-					RSG::scene_render->light_instance_set_shadow_transform(light->instance, ortho_camera, ortho_transform, z_max - z_min_cam, distances[i + 1], i, radius * 2.0 / texture_size, bias_scale * aspect_bias_scale * min_distance_bias_scale, z_max, uv_scale);
+					shadow_pass.projection = ortho_camera;
+					shadow_pass.transform = ortho_transform;
+					shadow_pass.far = z_max - z_min_cam;
+					shadow_pass.split = distances[i + 1];
+					shadow_pass.shadow_texel_size = radius * 2.0 / texture_size;
+					shadow_pass.bias_scale = bias_scale * aspect_bias_scale * min_distance_bias_scale;
+					shadow_pass.range_begin = z_max;
+					shadow_pass.uv_scale = uv_scale;
 				}
 
-				RSG::scene_render->render_shadow(light->instance, p_shadow_atlas, i, (RasterizerScene::InstanceBase **)instance_shadow_cull_result, cull_count);
+				shadow_pass.pass = i;
+				shadow_pass.near_plane = near_plane;
+				shadow_pass.caster_count = cull_count;
+				r_job.pass_count++;
 			}
 
 		} break;
 		case RS::LIGHT_OMNI: {
-			RS::LightOmniShadowMode shadow_mode = RSG::storage->light_omni_get_shadow_mode(p_instance->base);
+			RS::LightOmniShadowMode shadow_mode = RSG::storage->light_omni_get_shadow_mode(ins->base);
 
 			if (shadow_mode == RS::LIGHT_OMNI_SHADOW_DUAL_PARABOLOID || !RSG::scene_render->light_instances_can_render_shadow_cube()) {
 				for (int i = 0; i < 2; i++) {
 					//using this one ensures that raster deferred will have it
-					RENDER_TIMESTAMP("Culling Shadow Paraboloid" + itos(i));
 
-					real_t radius = RSG::storage->light_get_param(p_instance->base, RS::LIGHT_PARAM_RANGE);
+					real_t radius = RSG::storage->light_get_param(ins->base, RS::LIGHT_PARAM_RANGE);
 
 					real_t z = i == 0 ? -1 : 1;
 					Vector<Plane> planes;
@@ -1628,36 +2003,37 @@ bool RenderingServerScene::_light_instance_update_shadow(Instance *p_instance, c
 					planes.write[4] = light_transform.xform(Plane(Vector3(0, -1, z).normalized(), radius));
 					planes.write[5] = light_transform.xform(Plane(Vector3(0, 0, -z), 0));
 
-					int cull_count = p_scenario->octree.cull_convex(planes, instance_shadow_cull_result, MAX_INSTANCE_CULL, RS::INSTANCE_GEOMETRY_MASK);
+					ShadowCullPass &shadow_pass = r_job.passes[r_job.pass_count];
+					shadow_pass.reset_transform();
+					LocalVector<Instance *> &casters = shadow_pass.casters;
+					int cull_count = _cull_shadow_casters(scenario, planes, casters);
 					Plane near_plane(light_transform.origin, light_transform.basis.get_axis(2) * z);
 
 					for (int j = 0; j < cull_count; j++) {
-						Instance *instance = instance_shadow_cull_result[j];
+						Instance *instance = casters[j];
 						if (!instance->visible || !((1 << instance->base_type) & RS::INSTANCE_GEOMETRY_MASK) || !static_cast<InstanceGeometryData *>(instance->base_data)->can_cast_shadows) {
 							cull_count--;
-							SWAP(instance_shadow_cull_result[j], instance_shadow_cull_result[cull_count]);
+							SWAP(casters[j], casters[cull_count]);
 							j--;
-						} else {
-							if (static_cast<InstanceGeometryData *>(instance->base_data)->material_is_animated) {
-								animated_material_found = true;
-							}
-
-							instance->depth = near_plane.distance_to(instance->transform.origin);
-							instance->depth_layer = 0;
+						} else if (static_cast<InstanceGeometryData *>(instance->base_data)->material_is_animated) {
+							r_job.animated_material_found = true;
 						}
 					}
 
-					RSG::scene_render->light_instance_set_shadow_transform(light->instance, CameraMatrix(), light_transform, radius, 0, i, 0);
-					RSG::scene_render->render_shadow(light->instance, p_shadow_atlas, i, (RasterizerScene::InstanceBase **)instance_shadow_cull_result, cull_count);
+					shadow_pass.pass = i;
+					shadow_pass.transform = light_transform;
+					shadow_pass.far = radius;
+					shadow_pass.near_plane = near_plane;
+					shadow_pass.caster_count = cull_count;
+					r_job.pass_count++;
 				}
 			} else { //shadow cube
 
-				real_t radius = RSG::storage->light_get_param(p_instance->base, RS::LIGHT_PARAM_RANGE);
+				real_t radius = RSG::storage->light_get_param(ins->base, RS::LIGHT_PARAM_RANGE);
 				CameraMatrix cm;
 				cm.set_perspective(90, 1, 0.01, radius);
 
 				for (int i = 0; i < 6; i++) {
-					RENDER_TIMESTAMP("Culling Shadow Cube side" + itos(i));
 					//using this one ensures that raster deferred will have it
 
 					static const Vector3 view_normals[6] = {
@@ -1681,68 +2057,101 @@ bool RenderingServerScene::_light_instance_update_shadow(Instance *p_instance, c
 
 					Vector<Plane> planes = cm.get_projection_planes(xform);
 
-					int cull_count = p_scenario->octree.cull_convex(planes, instance_shadow_cull_result, MAX_INSTANCE_CULL, RS::INSTANCE_GEOMETRY_MASK);
+					ShadowCullPass &shadow_pass = r_job.passes[r_job.pass_count];
+					shadow_pass.reset_transform();
+					LocalVector<Instance *> &casters = shadow_pass.casters;
+					int cull_count = _cull_shadow_casters(scenario, planes, casters);
 
 					Plane near_plane(xform.origin, -xform.basis.get_axis(2));
 					for (int j = 0; j < cull_count; j++) {
-						Instance *instance = instance_shadow_cull_result[j];
+						Instance *instance = casters[j];
 						if (!instance->visible || !((1 << instance->base_type) & RS::INSTANCE_GEOMETRY_MASK) || !static_cast<InstanceGeometryData *>(instance->base_data)->can_cast_shadows) {
 							cull_count--;
-							SWAP(instance_shadow_cull_result[j], instance_shadow_cull_result[cull_count]);
+							SWAP(casters[j], casters[cull_count]);
 							j--;
-						} else {
-							if (static_cast<InstanceGeometryData *>(instance->base_data)->material_is_animated) {
-								animated_material_found = true;
-							}
-							instance->depth = near_plane.distance_to(instance->transform.origin);
-							instance->depth_layer = 0;
+						} else if (static_cast<InstanceGeometryData *>(instance->base_data)->material_is_animated) {
+							r_job.animated_material_found = true;
 						}
 					}
 
-					RSG::scene_render->light_instance_set_shadow_transform(light->instance, cm, xform, radius, 0, i, 0);
-					RSG::scene_render->render_shadow(light->instance, p_shadow_atlas, i, (RasterizerScene::InstanceBase **)instance_shadow_cull_result, cull_count);
+					shadow_pass.pass = i;
+					shadow_pass.projection = cm;
+					shadow_pass.transform = xform;
+					shadow_pass.far = radius;
+					shadow_pass.near_plane = near_plane;
+					shadow_pass.caster_count = cull_count;
+					r_job.pass_count++;
 				}
 
-				//restore the regular DP matrix
-				RSG::scene_render->light_instance_set_shadow_transform(light->instance, CameraMatrix(), light_transform, radius, 0, 0, 0);
+				//restore the regular DP matrix once rendered
+				r_job.restore_paraboloid_transform = true;
 			}
 
 		} break;
 		case RS::LIGHT_SPOT: {
-			RENDER_TIMESTAMP("Culling Spot Light");
-
-			real_t radius = RSG::storage->light_get_param(p_instance->base, RS::LIGHT_PARAM_RANGE);
-			real_t angle = RSG::storage->light_get_param(p_instance->base, RS::LIGHT_PARAM_SPOT_ANGLE);
+			real_t radius = RSG::storage->light_get_param(ins->base, RS::LIGHT_PARAM_RANGE);
+			real_t angle = RSG::storage->light_get_param(ins->base, RS::LIGHT_PARAM_SPOT_ANGLE);
 
 			CameraMatrix cm;
 			cm.set_perspective(angle * 2.0, 1.0, 0.01, radius);
 
 			Vector<Plane> planes = cm.get_projection_planes(light_transform);
-			int cull_count = p_scenario->octree.cull_convex(planes, instance_shadow_cull_result, MAX_INSTANCE_CULL, RS::INSTANCE_GEOMETRY_MASK);
+			ShadowCullPass &shadow_pass = r_job.passes[r_job.pass_count];
+			shadow_pass.reset_transform();
+			LocalVector<Instance *> &casters = shadow_pass.casters;
+			int cull_count = _cull_shadow_casters(scenario, planes, casters);
 
 			Plane near_plane(light_transform.origin, -light_transform.basis.get_axis(2));
 			for (int j = 0; j < cull_count; j++) {
-				Instance *instance = instance_shadow_cull_result[j];
+				Instance *instance = casters[j];
 				if (!instance->visible || !((1 << instance->base_type) & RS::INSTANCE_GEOMETRY_MASK) || !static_cast<InstanceGeometryData *>(instance->base_data)->can_cast_shadows) {
 					cull_count--;
-					SWAP(instance_shadow_cull_result[j], instance_shadow_cull_result[cull_count]);
+					SWAP(casters[j], casters[cull_count]);
 					j--;
-				} else {
-					if (static_cast<InstanceGeometryData *>(instance->base_data)->material_is_animated) {
-						animated_material_found = true;
-					}
-					instance->depth = near_plane.distance_to(instance->transform.origin);
-					instance->depth_layer = 0;
+				} else if (static_cast<InstanceGeometryData *>(instance->base_data)->material_is_animated) {
+					r_job.animated_material_found = true;
 				}
 			}
 
-			RSG::scene_render->light_instance_set_shadow_transform(light->instance, cm, light_transform, radius, 0, 0, 0);
-			RSG::scene_render->render_shadow(light->instance, p_shadow_atlas, 0, (RasterizerScene::InstanceBase **)instance_shadow_cull_result, cull_count);
+			shadow_pass.pass = 0;
+			shadow_pass.projection = cm;
+			shadow_pass.transform = light_transform;
+			shadow_pass.far = radius;
+			shadow_pass.near_plane = near_plane;
+			shadow_pass.caster_count = cull_count;
+			r_job.pass_count++;
 
 		} break;
 	}
+}
 
-	return animated_material_found;
+void RenderingServerScene::_light_instance_cull_shadow_job(uint32_t p_job, const ShadowCullSetup *p_setup) {
+	_light_instance_cull_shadow(shadow_cull_jobs[p_job], *p_setup);
+}
+
+void RenderingServerScene::_light_instance_render_shadow(ShadowCullJob &r_job, RID p_shadow_atlas) {
+	InstanceLightData *light = static_cast<InstanceLightData *>(r_job.light->base_data);
+
+	for (int i = 0; i < r_job.pass_count; i++) {
+		ShadowCullPass &shadow_pass = r_job.passes[i];
+
+		//depth is shared by all passes casting from the same instance, so it is only set right before rendering
+		for (int j = 0; j < shadow_pass.caster_count; j++) {
+			Instance *instance = shadow_pass.casters[j];
+			instance->depth = shadow_pass.near_plane.distance_to(instance->transform.origin);
+			instance->depth_layer = 0;
+		}
+
+		RSG::scene_render->light_instance_set_shadow_transform(light->instance, shadow_pass.projection, shadow_pass.transform, shadow_pass.far, shadow_pass.split, shadow_pass.pass, shadow_pass.shadow_texel_size, shadow_pass.bias_scale, shadow_pass.range_begin, shadow_pass.uv_scale);
+		RSG::scene_render->render_shadow(light->instance, p_shadow_atlas, shadow_pass.pass, shadow_pass.caster_count ? (RasterizerScene::InstanceBase **)&shadow_pass.casters[0] : nullptr, shadow_pass.caster_count);
+	}
+
+	if (r_job.restore_paraboloid_transform) {
+		Transform light_transform = r_job.light->transform;
+		light_transform.orthonormalize();
+		real_t radius = RSG::storage->light_get_param(r_job.light->base, RS::LIGHT_PARAM_RANGE);
+		RSG::scene_render->light_instance_set_shadow_transform(light->instance, CameraMatrix(), light_transform, radius, 0, 0, 0);
+	}
 }
 
 void RenderingServerScene::render_camera(RID p_render_buffers, RID p_camera, RID p_scenario, Size2 p_viewport_size, RID p_shadow_atlas) {
@@ -1788,7 +2197,7 @@ void RenderingServerScene::render_camera(RID p_render_buffers, RID p_camera, RID
 		} break;
 	}
 
-	_prepare_scene(camera->transform, camera_matrix, ortho, camera->vaspect, camera->env, camera->effects, camera->visible_layers, p_scenario, p_shadow_atlas, RID());
+	_prepare_scene(camera->transform, camera_matrix, ortho, camera->vaspect, camera->env, camera->effects, camera->visible_layers, p_scenario, p_shadow_atlas, RID(), true, mesh_lod_threshold / p_viewport_size.height);
 	_render_scene(p_render_buffers, camera->transform, camera_matrix, ortho, camera->env, camera->effects, p_scenario, p_shadow_atlas, RID(), -1);
 #endif
 }
@@ -1865,144 +2274,71 @@ void RenderingServerScene::render_camera(RID p_render_buffers, Ref<XRInterface>
 		mono_transform *= apply_z_shift;
 
 		// now prepare our scene with our adjusted transform projection matrix
-		_prepare_scene(mono_transform, combined_matrix, false, false, camera->env, camera->effects, camera->visible_layers, p_scenario, p_shadow_atlas, RID());
+		_prepare_scene(mono_transform, combined_matrix, false, false, camera->env, camera->effects, camera->visible_layers, p_scenario, p_shadow_atlas, RID(), true, mesh_lod_threshold / p_viewport_size.height);
 	} else if (p_eye == XRInterface::EYE_MONO) {
 		// For mono render, prepare as per usual
-		_prepare_scene(cam_transform, camera_matrix, false, false, camera->env, camera->effects, camera->visible_layers, p_scenario, p_shadow_atlas, RID());
+		_prepare_scene(cam_transform, camera_matrix, false, false, camera->env, camera->effects, camera->visible_layers, p_scenario, p_shadow_atlas, RID(), true, mesh_lod_threshold / p_viewport_size.height);
 	}
 
 	// And render our scene...
 	_render_scene(p_render_buffers, cam_transform, camera_matrix, false, camera->env, camera->effects, p_scenario, p_shadow_atlas, RID(), -1);
 };
 
-void RenderingServerScene::_prepare_scene(const Transform p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, bool p_cam_vaspect, RID p_force_environment, RID p_force_camera_effects, uint32_t p_visible_layers, RID p_scenario, RID p_shadow_atlas, RID p_reflection_probe, bool p_using_shadows) {
-	// Note, in stereo rendering:
-	// - p_cam_transform will be a transform in the middle of our two eyes
-	// - p_cam_projection is a wider frustrum that encompasses both eyes
-
-	Scenario *scenario = scenario_owner.getornull(p_scenario);
-
-	render_pass++;
-	uint32_t camera_layer_mask = p_visible_layers;
-
-	RSG::scene_render->set_scene_pass(render_pass);
-
-	RENDER_TIMESTAMP("Frustum Culling");
-
-	//rasterizer->set_camera(camera->transform, camera_matrix,ortho);
-
-	Vector<Plane> planes = p_cam_projection.get_projection_planes(p_cam_transform);
-
-	Plane near_plane(p_cam_transform.origin, -p_cam_transform.basis.get_axis(2).normalized());
-	float z_far = p_cam_projection.get_z_far();
-
-	/* STEP 2 - CULL */
-	instance_cull_count = scenario->octree.cull_convex(planes, instance_cull_result, MAX_INSTANCE_CULL);
-	light_cull_count = 0;
+bool RenderingServerScene::_instance_is_in_draw_range(Instance *p_instance, const Vector3 &p_cam_position, bool p_update_hysteresis) {
+	if (p_instance->lod_begin == 0 && p_instance->lod_end == 0) {
+		return true;
+	}
 
-	reflection_probe_cull_count = 0;
-	decal_cull_count = 0;
-	gi_probe_cull_count = 0;
-	lightmap_cull_count = 0;
+	// LOD levels of the same object measure from the same point, so they switch together
+	const Instance *reference = p_instance;
+	if (p_instance->lod_instance.is_valid()) {
+		const Instance *lod_of = instance_owner.getornull(p_instance->lod_instance);
+		if (lod_of) {
+			reference = lod_of;
+		}
+	}
 
-	//light_samplers_culled=0;
+	float distance = p_cam_position.distance_to(reference->transformed_aabb.position + reference->transformed_aabb.size * 0.5);
 
-	/*
-	print_line("OT: "+rtos( (OS::get_singleton()->get_ticks_usec()-t)/1000.0));
-	print_line("OTO: "+itos(p_scenario->octree.get_octant_count()));
-	print_line("OTE: "+itos(p_scenario->octree.get_elem_count()));
-	print_line("OTP: "+itos(p_scenario->octree.get_pair_count()));
-	*/
+	float begin = p_instance->lod_begin;
+	float end = p_instance->lod_end;
+	if (p_instance->lod_in_range) {
+		//already visible, only hide once the margins are crossed too
+		begin -= p_instance->lod_begin_hysteresis;
+		end += p_instance->lod_end_hysteresis;
+	}
 
-	/* STEP 3 - PROCESS PORTALS, VALIDATE ROOMS */
-	//removed, will replace with culling
+	bool in_range = distance >= begin && (p_instance->lod_end == 0 || distance < end);
+	if (p_update_hysteresis) {
+		p_instance->lod_in_range = in_range;
+	}
+	return in_range;
+}
 
-	/* STEP 4 - REMOVE FURTHER CULLED OBJECTS, ADD LIGHTS */
-	uint64_t frame_number = RSG::rasterizer->get_frame_number();
-	float lightmap_probe_update_speed = RSG::storage->lightmap_get_probe_capture_update_speed() * RSG::rasterizer->get_frame_delta_time();
+void RenderingServerScene::_scene_cull_chunk(uint32_t p_chunk, const SceneCullSetup *p_setup) {
+	SceneCullChunk &chunk = scene_cull_chunks[p_chunk];
+	chunk.geometry_count = 0;
+	chunk.redraw = false;
+	chunk.particles.clear();
+	chunk.others.clear();
 
-	for (int i = 0; i < instance_cull_count; i++) {
+	for (uint32_t i = chunk.from; i < chunk.to; i++) {
 		Instance *ins = instance_cull_result[i];
 
 		bool keep = false;
 
-		if ((camera_layer_mask & ins->layer_mask) == 0) {
+		if ((p_setup->camera_layer_mask & ins->layer_mask) == 0) {
 			//failure
-		} else if (ins->base_type == RS::INSTANCE_LIGHT && ins->visible) {
-			if (light_cull_count < MAX_LIGHTS_CULLED) {
-				InstanceLightData *light = static_cast<InstanceLightData *>(ins->base_data);
-
-				if (!light->geometries.empty()) {
-					//do not add this light if no geometry is affected by it..
-					light_cull_result[light_cull_count] = ins;
-					light_instance_cull_result[light_cull_count] = light->instance;
-					if (p_shadow_atlas.is_valid() && RSG::storage->light_has_shadow(ins->base)) {
-						RSG::scene_render->light_instance_mark_visible(light->instance); //mark it visible for shadow allocation later
-					}
-
-					light_cull_count++;
-				}
-			}
-		} else if (ins->base_type == RS::INSTANCE_REFLECTION_PROBE && ins->visible) {
-			if (reflection_probe_cull_count < MAX_REFLECTION_PROBES_CULLED) {
-				InstanceReflectionProbeData *reflection_probe = static_cast<InstanceReflectionProbeData *>(ins->base_data);
-
-				if (p_reflection_probe != reflection_probe->instance) {
-					//avoid entering The Matrix
-
-					if (!reflection_probe->geometries.empty()) {
-						//do not add this light if no geometry is affected by it..
-
-						if (reflection_probe->reflection_dirty || RSG::scene_render->reflection_probe_instance_needs_redraw(reflection_probe->instance)) {
-							if (!reflection_probe->update_list.in_list()) {
-								reflection_probe->render_step = 0;
-								reflection_probe_render_list.add_last(&reflection_probe->update_list);
-							}
-
-							reflection_probe->reflection_dirty = false;
-						}
-
-						if (RSG::scene_render->reflection_probe_instance_has_reflection(reflection_probe->instance)) {
-							reflection_probe_instance_cull_result[reflection_probe_cull_count] = reflection_probe->instance;
-							reflection_probe_cull_count++;
-						}
-					}
-				}
-			}
-		} else if (ins->base_type == RS::INSTANCE_DECAL && ins->visible) {
-			if (decal_cull_count < MAX_DECALS_CULLED) {
-				InstanceDecalData *decal = static_cast<InstanceDecalData *>(ins->base_data);
-
-				if (!decal->geometries.empty()) {
-					//do not add this decal if no geometry is affected by it..
-					decal_instance_cull_result[decal_cull_count] = decal->instance;
-					decal_cull_count++;
-				}
-			}
-
-		} else if (ins->base_type == RS::INSTANCE_GI_PROBE && ins->visible) {
-			InstanceGIProbeData *gi_probe = static_cast<InstanceGIProbeData *>(ins->base_data);
-			if (!gi_probe->update_element.in_list()) {
-				gi_probe_update_list.add(&gi_probe->update_element);
-			}
-
-			if (gi_probe_cull_count < MAX_GI_PROBES_CULLED) {
-				gi_probe_instance_cull_result[gi_probe_cull_count] = gi_probe->probe_instance;
-				gi_probe_cull_count++;
-			}
-		} else if (ins->base_type == RS::INSTANCE_LIGHTMAP && ins->visible) {
-			if (lightmap_cull_count < MAX_LIGHTMAPS_CULLED) {
-				lightmap_cull_result[lightmap_cull_count] = ins;
-				lightmap_cull_count++;
-			}
-
-		} else if (((1 << ins->base_type) & RS::INSTANCE_GEOMETRY_MASK) && ins->visible && ins->cast_shadows != RS::SHADOW_CASTING_SETTING_SHADOWS_ONLY) {
+		} else if (!((1 << ins->base_type) & RS::INSTANCE_GEOMETRY_MASK)) {
+			//lights, probes, decals and lightmaps go to shared lists, so they are added when merging
+			chunk.others.push_back(ins);
+		} else if (ins->visible && ins->cast_shadows != RS::SHADOW_CASTING_SETTING_SHADOWS_ONLY && _instance_is_in_draw_range(ins, p_setup->cam_transform.origin, p_setup->camera_pass) && !(p_setup->use_occlusion && occlusion_buffer.is_occluded(ins->transformed_aabb))) {
 			keep = true;
 
 			InstanceGeometryData *geom = static_cast<InstanceGeometryData *>(ins->base_data);
 
 			if (ins->redraw_if_visible) {
-				RenderingServerRaster::redraw_request();
+				chunk.redraw = true;
 			}
 
 			if (ins->base_type == RS::INSTANCE_PARTICLES) {
@@ -2011,9 +2347,8 @@ void RenderingServerScene::_prepare_scene(const Transform p_cam_transform, const
 					//but if nothing is going on, don't do it.
 					keep = false;
 				} else {
-					RSG::storage->particles_request_process(ins->base);
-					//particles visible? request redraw
-					RenderingServerRaster::redraw_request();
+					//requesting the process is not thread safe, done when merging
+					chunk.particles.push_back(ins);
 				}
 			}
 
@@ -2059,28 +2394,261 @@ void RenderingServerScene::_prepare_scene(const Transform p_cam_transform, const
 				geom->gi_probes_dirty = false;
 			}
 
-			if (ins->last_frame_pass != frame_number && !ins->lightmap_target_sh.empty() && !ins->lightmap_sh.empty()) {
+			if (ins->last_frame_pass != p_setup->frame_number && !ins->lightmap_target_sh.empty() && !ins->lightmap_sh.empty()) {
 				Color *sh = ins->lightmap_sh.ptrw();
 				const Color *target_sh = ins->lightmap_target_sh.ptr();
 				for (uint32_t j = 0; j < 9; j++) {
-					sh[j] = sh[j].lerp(target_sh[j], MIN(1.0, lightmap_probe_update_speed));
+					sh[j] = sh[j].lerp(target_sh[j], MIN(1.0, p_setup->lightmap_probe_update_speed));
 				}
 			}
 
-			ins->depth = near_plane.distance_to(ins->transform.origin);
-			ins->depth_layer = CLAMP(int(ins->depth * 16 / z_far), 0, 15);
+			ins->depth = p_setup->near_plane.distance_to(ins->transform.origin);
+			ins->depth_layer = CLAMP(int(ins->depth * 16 / p_setup->z_far), 0, 15);
+
+			ins->lod_threshold = 0;
+			if (p_setup->lod_error_scale > 0.0 && (ins->base_type == RS::INSTANCE_MESH || ins->base_type == RS::INSTANCE_MULTIMESH)) {
+				float lod_distance = 1.0;
+				if (!p_setup->cam_orthogonal) {
+					//distance to the closest point of the bounds, so big instances keep detail near the camera
+					const AABB &aabb = ins->transformed_aabb;
+					Vector3 closest;
+					for (int j = 0; j < 3; j++) {
+						closest[j] = CLAMP(p_setup->cam_transform.origin[j], aabb.position[j], aabb.position[j] + aabb.size[j]);
+					}
+					lod_distance = p_setup->cam_transform.origin.distance_to(closest);
+				}
+
+				Vector3 scale = ins->transform.basis.get_scale_abs();
+				float max_scale = MAX(scale.x, MAX(scale.y, scale.z));
+				if (max_scale > CMP_EPSILON) {
+					ins->lod_threshold = p_setup->lod_error_scale * lod_distance / max_scale;
+				}
+			}
 		}
 
-		if (!keep) {
-			// remove, no reason to keep
-			instance_cull_count--;
-			SWAP(instance_cull_result[i], instance_cull_result[instance_cull_count]);
-			i--;
-			ins->last_render_pass = 0; // make invalid
-		} else {
+		if (keep) {
+			//compact at the start of the chunk range, never past the instance being read
+			instance_cull_result[chunk.from + chunk.geometry_count] = ins;
+			chunk.geometry_count++;
 			ins->last_render_pass = render_pass;
+		} else {
+			ins->last_render_pass = 0; // make invalid
+		}
+		ins->last_frame_pass = p_setup->frame_number;
+	}
+}
+
+void RenderingServerScene::_prepare_scene(const Transform p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, bool p_cam_vaspect, RID p_force_environment, RID p_force_camera_effects, uint32_t p_visible_layers, RID p_scenario, RID p_shadow_atlas, RID p_reflection_probe, bool p_using_shadows, float p_screen_lod_threshold) {
+	// Note, in stereo rendering:
+	// - p_cam_transform will be a transform in the middle of our two eyes
+	// - p_cam_projection is a wider frustrum that encompasses both eyes
+
+	Scenario *scenario = scenario_owner.getornull(p_scenario);
+
+	render_pass++;
+	uint32_t camera_layer_mask = p_visible_layers;
+
+	RSG::scene_render->set_scene_pass(render_pass);
+
+	RENDER_TIMESTAMP("Frustum Culling");
+
+	//rasterizer->set_camera(camera->transform, camera_matrix,ortho);
+
+	Vector<Plane> planes = p_cam_projection.get_projection_planes(p_cam_transform);
+
+	Plane near_plane(p_cam_transform.origin, -p_cam_transform.basis.get_axis(2).normalized());
+	float z_far = p_cam_projection.get_z_far();
+
+	// Mesh LOD error allowed per unit of distance (or in total, for orthogonal cameras), in world units.
+	// A length L at distance d covers L * matrix[1][1] / d of the half screen height in NDC.
+	float lod_error_scale = 0.0;
+	if (p_screen_lod_threshold > 0.0 && p_cam_projection.matrix[1][1] != 0.0) {
+		lod_error_scale = 2.0 * p_screen_lod_threshold / Math::abs(p_cam_projection.matrix[1][1]);
+	}
+	bool camera_pass = p_reflection_probe.is_null();
+
+	/* STEP 2 - CULL */
+	instance_cull_count = scenario->bvh.cull_convex(planes, instance_cull_result, MAX_INSTANCE_CULL);
+	light_cull_count = 0;
+
+	reflection_probe_cull_count = 0;
+	decal_cull_count = 0;
+	gi_probe_cull_count = 0;
+	lightmap_cull_count = 0;
+
+	//light_samplers_culled=0;
+
+	/*
+	print_line("BVH: "+rtos( (OS::get_singleton()->get_ticks_usec()-t)/1000.0));
+	print_line("BVHE: "+itos(p_scenario->bvh.get_element_count()));
+	print_line("BVHP: "+itos(p_scenario->bvh.get_pair_count()));
+	*/
+
+	/* STEP 3 - RASTERIZE OCCLUDERS */
+
+	bool use_occlusion = false;
+
+	if (occlusion_buffer_width > 0) {
+		for (int i = 0; i < instance_cull_count; i++) {
+			Instance *ins = instance_cull_result[i];
+
+			if (ins->base_type != RS::INSTANCE_OCCLUDER || !ins->visible || (camera_layer_mask & ins->layer_mask) == 0) {
+				continue;
+			}
+
+			if (!use_occlusion) {
+				RENDER_TIMESTAMP("Occlusion Culling");
+				// Aspect from the projection scale factors, works for both perspective and orthogonal cameras.
+				float aspect = p_cam_projection.matrix[0][0] != 0.0 ? Math::abs(p_cam_projection.matrix[1][1] / p_cam_projection.matrix[0][0]) : 1.0;
+				occlusion_buffer.begin(p_cam_projection * CameraMatrix(p_cam_transform.affine_inverse()), occlusion_buffer_width, aspect);
+				use_occlusion = true;
+			}
+
+			occlusion_buffer.add_occluder(ins->transform, occluder_owner.getornull(ins->base));
+		}
+
+		use_occlusion = use_occlusion && occlusion_buffer.triangles.size() > 0;
+
+		if (use_occlusion) {
+#ifndef NO_THREADS
+			if (occlusion_buffer.triangles.size() >= OcclusionBuffer::PARALLEL_TRIANGLE_THRESHOLD) {
+				thread_pool.do_work(occlusion_buffer.tiles_y, &occlusion_buffer, &OcclusionBuffer::rasterize_tile_row, (void *)nullptr);
+			} else
+#endif
+			{
+				for (int i = 0; i < occlusion_buffer.tiles_y; i++) {
+					occlusion_buffer.rasterize_tile_row(i, nullptr);
+				}
+			}
+		}
+	}
+
+	/* STEP 4 - REMOVE FURTHER CULLED OBJECTS, ADD LIGHTS */
+
+	SceneCullSetup cull_setup;
+	cull_setup.cam_transform = p_cam_transform;
+	cull_setup.cam_orthogonal = p_cam_orthogonal;
+	cull_setup.camera_pass = camera_pass;
+	cull_setup.use_occlusion = use_occlusion;
+	cull_setup.camera_layer_mask = camera_layer_mask;
+	cull_setup.near_plane = near_plane;
+	cull_setup.z_far = z_far;
+	cull_setup.lod_error_scale = lod_error_scale;
+	cull_setup.frame_number = RSG::rasterizer->get_frame_number();
+	cull_setup.lightmap_probe_update_speed = RSG::storage->lightmap_get_probe_capture_update_speed() * RSG::rasterizer->get_frame_delta_time();
+
+	uint32_t chunk_count = (instance_cull_count + SCENE_CULL_CHUNK_SIZE - 1) / SCENE_CULL_CHUNK_SIZE;
+	if (scene_cull_chunks.size() < chunk_count) {
+		scene_cull_chunks.resize(chunk_count);
+	}
+	for (uint32_t i = 0; i < chunk_count; i++) {
+		scene_cull_chunks[i].from = i * SCENE_CULL_CHUNK_SIZE;
+		scene_cull_chunks[i].to = MIN((i + 1) * SCENE_CULL_CHUNK_SIZE, (uint32_t)instance_cull_count);
+	}
+
+#ifndef NO_THREADS
+	if (chunk_count > 1) {
+		thread_pool.do_work(chunk_count, this, &RenderingServerScene::_scene_cull_chunk, (const SceneCullSetup *)&cull_setup);
+	} else
+#endif
+	{
+		for (uint32_t i = 0; i < chunk_count; i++) {
+			_scene_cull_chunk(i, &cull_setup);
+		}
+	}
+
+	//merge the chunks in order, the kept geometry moves down and the rest is added to the shared lists
+	instance_cull_count = 0;
+
+	for (uint32_t i = 0; i < chunk_count; i++) {
+		SceneCullChunk &chunk = scene_cull_chunks[i];
+
+		for (uint32_t j = 0; j < chunk.geometry_count; j++) {
+			instance_cull_result[instance_cull_count++] = instance_cull_result[chunk.from + j];
+		}
+
+		if (chunk.redraw) {
+			RenderingServerRaster::redraw_request();
+		}
+
+		for (uint32_t j = 0; j < chunk.particles.size(); j++) {
+			RSG::storage->particles_request_process(chunk.particles[j]->base);
+			//particles visible? request redraw
+			RenderingServerRaster::redraw_request();
+		}
+
+		for (uint32_t j = 0; j < chunk.others.size(); j++) {
+			Instance *ins = chunk.others[j];
+
+			if (ins->base_type == RS::INSTANCE_LIGHT && ins->visible) {
+				if (light_cull_count < MAX_LIGHTS_CULLED) {
+					InstanceLightData *light = static_cast<InstanceLightData *>(ins->base_data);
+
+					if (!light->geometries.empty()) {
+						//do not add this light if no geometry is affected by it..
+						light_cull_result[light_cull_count] = ins;
+						light_instance_cull_result[light_cull_count] = light->instance;
+						if (p_shadow_atlas.is_valid() && RSG::storage->light_has_shadow(ins->base)) {
+							RSG::scene_render->light_instance_mark_visible(light->instance); //mark it visible for shadow allocation later
+						}
+
+						light_cull_count++;
+					}
+				}
+			} else if (ins->base_type == RS::INSTANCE_REFLECTION_PROBE && ins->visible) {
+				if (reflection_probe_cull_count < MAX_REFLECTION_PROBES_CULLED) {
+					InstanceReflectionProbeData *reflection_probe = static_cast<InstanceReflectionProbeData *>(ins->base_data);
+
+					if (p_reflection_probe != reflection_probe->instance) {
+						//avoid entering The Matrix
+
+						if (!reflection_probe->geometries.empty()) {
+							//do not add this light if no geometry is affected by it..
+
+							if (reflection_probe->reflection_dirty || RSG::scene_render->reflection_probe_instance_needs_redraw(reflection_probe->instance)) {
+								if (!reflection_probe->update_list.in_list()) {
+									reflection_probe->render_step = 0;
+									reflection_probe_render_list.add_last(&reflection_probe->update_list);
+								}
+
+								reflection_probe->reflection_dirty = false;
+							}
+
+							if (RSG::scene_render->reflection_probe_instance_has_reflection(reflection_probe->instance)) {
+								reflection_probe_instance_cull_result[reflection_probe_cull_count] = reflection_probe->instance;
+								reflection_probe_cull_count++;
+							}
+						}
+					}
+				}
+			} else if (ins->base_type == RS::INSTANCE_DECAL && ins->visible) {
+				if (decal_cull_count < MAX_DECALS_CULLED) {
+					InstanceDecalData *decal = static_cast<InstanceDecalData *>(ins->base_data);
+
+					if (!decal->geometries.empty()) {
+						//do not add this decal if no geometry is affected by it..
+						decal_instance_cull_result[decal_cull_count] = decal->instance;
+						decal_cull_count++;
+					}
+				}
+
+			} else if (ins->base_type == RS::INSTANCE_GI_PROBE && ins->visible) {
+				InstanceGIProbeData *gi_probe = static_cast<InstanceGIProbeData *>(ins->base_data);
+				if (!gi_probe->update_element.in_list()) {
+					gi_probe_update_list.add(&gi_probe->update_element);
+				}
+
+				if (gi_probe_cull_count < MAX_GI_PROBES_CULLED) {
+					gi_probe_instance_cull_result[gi_probe_cull_count] = gi_probe->probe_instance;
+					gi_probe_cull_count++;
+				}
+			} else if (ins->base_type == RS::INSTANCE_LIGHTMAP && ins->visible) {
+				if (lightmap_cull_count < MAX_LIGHTMAPS_CULLED) {
+					lightmap_cull_result[lightmap_cull_count] = ins;
+					lightmap_cull_count++;
+				}
+			}
 		}
-		ins->last_frame_pass = frame_number;
 	}
 
 	/* STEP 5 - PROCESS LIGHTS */
@@ -2088,10 +2656,12 @@ void RenderingServerScene::_prepare_scene(const Transform p_cam_transform, const
 	RID *directional_light_ptr = &light_instance_cull_result[light_cull_count];
 	directional_light_count = 0;
 
+	//lights whose shadows must be redrawn, directional ones first
+	uint32_t shadow_cull_job_count = 0;
+	int directional_shadow_count = 0;
+
 	// directional lights
 	{
-		Instance **lights_with_shadow = (Instance **)alloca(sizeof(Instance *) * scenario->directional_lights.size());
-		int directional_shadow_count = 0;
 
 		for (List<Instance *>::Element *E = scenario->directional_lights.front(); E; E = E->next()) {
 			if (light_cull_count + directional_light_count >= MAX_LIGHTS_CULLED) {
@@ -2108,7 +2678,11 @@ void RenderingServerScene::_prepare_scene(const Transform p_cam_transform, const
 
 			if (light) {
 				if (p_using_shadows && p_shadow_atlas.is_valid() && RSG::storage->light_has_shadow(E->get()->base)) {
-					lights_with_shadow[directional_shadow_count++] = E->get();
+					if (shadow_cull_jobs.size() <= shadow_cull_job_count) {
+						shadow_cull_jobs.resize(shadow_cull_job_count + 1);
+					}
+					shadow_cull_jobs[shadow_cull_job_count++].light = E->get();
+					directional_shadow_count++;
 				}
 				//add to list
 				directional_light_ptr[directional_light_count++] = light->instance;
@@ -2116,14 +2690,6 @@ void RenderingServerScene::_prepare_scene(const Transform p_cam_transform, const
 		}
 
 		RSG::scene_render->set_directional_shadow_count(directional_shadow_count);
-
-		for (int i = 0; i < directional_shadow_count; i++) {
-			RENDER_TIMESTAMP(">Rendering Directional Light " + itos(i));
-
-			_light_instance_update_shadow(lights_with_shadow[i], p_cam_transform, p_cam_projection, p_cam_orthogonal, p_cam_vaspect, p_shadow_atlas, scenario);
-
-			RENDER_TIMESTAMP("<Rendering Directional Light " + itos(i));
-		}
 	}
 
 	if (p_using_shadows) { //setup shadow maps
@@ -2218,9 +2784,50 @@ void RenderingServerScene::_prepare_scene(const Transform p_cam_transform, const
 
 			if (redraw) {
 				//must redraw!
-				RENDER_TIMESTAMP(">Rendering Light " + itos(i));
-				light->shadow_dirty = _light_instance_update_shadow(ins, p_cam_transform, p_cam_projection, p_cam_orthogonal, p_cam_vaspect, p_shadow_atlas, scenario);
-				RENDER_TIMESTAMP("<Rendering Light " + itos(i));
+				if (shadow_cull_jobs.size() <= shadow_cull_job_count) {
+					shadow_cull_jobs.resize(shadow_cull_job_count + 1);
+				}
+				shadow_cull_jobs[shadow_cull_job_count++].light = ins;
+			}
+		}
+	}
+
+	/* STEP 6 - CULL AND RENDER SHADOWS */
+
+	if (shadow_cull_job_count) {
+		RENDER_TIMESTAMP("Culling Shadows");
+
+		ShadowCullSetup shadow_setup;
+		shadow_setup.cam_transform = p_cam_transform;
+		shadow_setup.cam_projection = p_cam_projection;
+		shadow_setup.cam_orthogonal = p_cam_orthogonal;
+		shadow_setup.cam_vaspect = p_cam_vaspect;
+		shadow_setup.scenario = scenario;
+
+#ifndef NO_THREADS
+		if (shadow_cull_job_count > 1) {
+			thread_pool.do_work(shadow_cull_job_count, this, &RenderingServerScene::_light_instance_cull_shadow_job, (const ShadowCullSetup *)&shadow_setup);
+		} else
+#endif
+		{
+			for (uint32_t i = 0; i < shadow_cull_job_count; i++) {
+				_light_instance_cull_shadow(shadow_cull_jobs[i], shadow_setup);
+			}
+		}
+
+		for (uint32_t i = 0; i < shadow_cull_job_count; i++) {
+			ShadowCullJob &job = shadow_cull_jobs[i];
+
+			if ((int)i < directional_shadow_count) {
+				RENDER_TIMESTAMP(">Rendering Directional Light " + itos(i));
+				_light_instance_render_shadow(job, p_shadow_atlas);
+				RENDER_TIMESTAMP("<Rendering Directional Light " + itos(i));
+			} else {
+				RENDER_TIMESTAMP(">Rendering Light " + itos(i - directional_shadow_count));
+				_light_instance_render_shadow(job, p_shadow_atlas);
+				RENDER_TIMESTAMP("<Rendering Light " + itos(i - directional_shadow_count));
+
+				static_cast<InstanceLightData *>(job.light->base_data)->shadow_dirty = job.animated_material_found;
 			}
 		}
 	}
@@ -2607,7 +3214,9 @@ void RenderingServerScene::_update_dirty_instance(Instance *p_instance) {
 	if (p_instance->update_dependencies) {
 		p_instance->instance_increase_version();
 
-		if (p_instance->base.is_valid()) {
+		if (p_instance->base_type == RS::INSTANCE_OCCLUDER) {
+			p_instance->update_dependency(&occluder_owner.getornull(p_instance->base)->instance_dependency);
+		} else if (p_instance->base.is_valid()) {
 			RSG::storage->base_update_dependency(p_instance->base, p_instance);
 		}
 
@@ -2828,6 +3437,13 @@ bool RenderingServerScene::free(RID p_rid) {
 		camera_owner.free(p_rid);
 		memdelete(camera);
 
+	} else if (occluder_owner.owns(p_rid)) {
+		Occluder *occluder = occluder_owner.getornull(p_rid);
+		occluder->instance_dependency.instance_notify_deleted(p_rid);
+
+		occluder_owner.free(p_rid);
+		memdelete(occluder);
+
 	} else if (scenario_owner.owns(p_rid)) {
 		Scenario *scenario = scenario_owner.getornull(p_rid);
 
@@ -2876,7 +3492,13 @@ RenderingServerScene *RenderingServerScene::singleton = nullptr;
 RenderingServerScene::RenderingServerScene() {
 	render_pass = 1;
 	singleton = this;
+	mesh_lod_threshold = GLOBAL_GET("rendering/quality/mesh_lod/threshold_pixels");
+	occlusion_buffer_width = GLOBAL_GET("rendering/quality/occlusion_culling/buffer_width");
+#ifndef NO_THREADS
+	thread_pool.init();
+#endif
 }
 
 RenderingServerScene::~RenderingServerScene() {
+	thread_pool.finish();
 }
@@ -33,11 +33,13 @@
 
 #include "servers/rendering/rasterizer.h"
 
-#include "core/math/octree.h"
+#include "core/local_vector.h"
+#include "core/math/bvh.h"
 #include "core/os/semaphore.h"
 #include "core/os/thread.h"
 #include "core/rid_owner.h"
 #include "core/self_list.h"
+#include "core/thread_work_pool.h"
 #include "servers/xr/xr_interface.h"
 
 class RenderingServerScene {
@@ -102,6 +104,21 @@ public:
 	virtual void camera_set_camera_effects(RID p_camera, RID p_fx);
 	virtual void camera_set_use_vertical_aspect(RID p_camera, bool p_enable);
 
+	/* OCCLUDER API */
+
+	struct Occluder {
+		PackedVector3Array vertices;
+		PackedInt32Array indices;
+		AABB aabb;
+
+		RasterizerScene::InstanceDependency instance_dependency;
+	};
+
+	mutable RID_PtrOwner<Occluder> occluder_owner;
+
+	virtual RID occluder_create();
+	virtual void occluder_set_mesh(RID p_occluder, const PackedVector3Array &p_vertices, const PackedInt32Array &p_indices);
+
 	/* SCENARIO API */
 
 	struct Instance;
@@ -110,7 +127,7 @@ public:
 		RS::ScenarioDebugMode debug;
 		RID self;
 
-		Octree<Instance, true> octree;
+		BVH<Instance, true> bvh;
 
 		List<Instance *> directional_lights;
 		RID environment;
@@ -126,8 +143,8 @@ public:
 
 	mutable RID_PtrOwner<Scenario> scenario_owner;
 
-	static void *_instance_pair(void *p_self, OctreeElementID, Instance *p_A, int, OctreeElementID, Instance *p_B, int);
-	static void _instance_unpair(void *p_self, OctreeElementID, Instance *p_A, int, OctreeElementID, Instance *p_B, int, void *);
+	static void *_instance_pair(void *p_self, BVHElementID, Instance *p_A, int, BVHElementID, Instance *p_B, int);
+	static void _instance_unpair(void *p_self, BVHElementID, Instance *p_A, int, BVHElementID, Instance *p_B, int, void *);
 
 	virtual RID scenario_create();
 
@@ -146,7 +163,7 @@ public:
 	struct Instance : RasterizerScene::InstanceBase {
 		RID self;
 		//scenario stuff
-		OctreeElementID octree_id;
+		BVHElementID bvh_id;
 		Scenario *scenario;
 		SelfList<Instance> scenario_item;
 
@@ -165,6 +182,7 @@ public:
 		float lod_begin_hysteresis;
 		float lod_end_hysteresis;
 		RID lod_instance;
+		bool lod_in_range; //last draw range test result, decides which side of the hysteresis margins applies
 
 		Vector<Color> lightmap_target_sh; //target is used for incrementally changing the SH over time, this avoids pops in some corner cases and when going interior <-> exterior
 
@@ -192,7 +210,7 @@ public:
 		Instance() :
 				scenario_item(this),
 				update_item(this) {
-			octree_id = 0;
+			bvh_id = 0;
 			scenario = nullptr;
 
 			update_aabb = false;
@@ -206,6 +224,7 @@ public:
 			lod_end = 0;
 			lod_begin_hysteresis = 0;
 			lod_end_hysteresis = 0;
+			lod_in_range = true;
 
 			last_render_pass = 0;
 			last_frame_pass = 0;
@@ -377,7 +396,6 @@ public:
 
 	int instance_cull_count;
 	Instance *instance_cull_result[MAX_INSTANCE_CULL];
-	Instance *instance_shadow_cull_result[MAX_INSTANCE_CULL]; //used for generating shadowmaps
 	Instance *light_cull_result[MAX_LIGHTS_CULLED];
 	RID light_instance_cull_result[MAX_LIGHTS_CULLED];
 	int light_cull_count;
@@ -404,6 +422,9 @@ public:
 	virtual void instance_set_surface_material(RID p_instance, int p_surface, RID p_material);
 	virtual void instance_set_visible(RID p_instance, bool p_visible);
 
+	virtual void instance_set_transform_bulk(const Vector<RID> &p_instances, const Vector<Transform> &p_transforms);
+	virtual void instance_set_visible_bulk(const Vector<RID> &p_instances, bool p_visible);
+
 	virtual void instance_set_custom_aabb(RID p_instance, AABB p_aabb);
 
 	virtual void instance_attach_skeleton(RID p_instance, RID p_skeleton);
@@ -427,6 +448,7 @@ public:
 	void _update_instance_shader_parameters_from_material(Map<StringName, RasterizerScene::InstanceBase::InstanceShaderParameter> &isparams, const Map<StringName, RasterizerScene::InstanceBase::InstanceShaderParameter> &existing_isparams, RID p_material);
 
 	virtual void instance_geometry_set_shader_parameter(RID p_instance, const StringName &p_parameter, const Variant &p_value);
+	virtual void instance_geometry_set_shader_parameter_bulk(const Vector<RID> &p_instances, const StringName &p_parameter, const Vector<Variant> &p_values);
 	virtual void instance_geometry_get_shader_parameter_list(RID p_instance, List<PropertyInfo> *p_parameters) const;
 	virtual Variant instance_geometry_get_shader_parameter(RID p_instance, const StringName &p_parameter) const;
 	virtual Variant instance_geometry_get_shader_parameter_default_value(RID p_instance, const StringName &p_parameter) const;
@@ -436,10 +458,139 @@ public:
 	_FORCE_INLINE_ void _update_dirty_instance(Instance *p_instance);
 	_FORCE_INLINE_ void _update_instance_lightmap_captures(Instance *p_instance);
 
-	_FORCE_INLINE_ bool _light_instance_update_shadow(Instance *p_instance, const Transform p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, bool p_cam_vaspect, RID p_shadow_atlas, Scenario *p_scenario);
-
 	bool _render_reflection_probe_step(Instance *p_instance, int p_step);
-	void _prepare_scene(const Transform p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, bool p_cam_vaspect, RID p_force_environment, RID p_force_camera_effects, uint32_t p_visible_layers, RID p_scenario, RID p_shadow_atlas, RID p_reflection_probe, bool p_using_shadows = true);
+	_FORCE_INLINE_ bool _instance_is_in_draw_range(Instance *p_instance, const Vector3 &p_cam_position, bool p_update_hysteresis);
+
+	float mesh_lod_threshold;
+
+	/* OCCLUSION CULLING */
+
+	// Low resolution software depth buffer, filled with the occluders found in the camera frustum and
+	// used to reject geometry instances whose bounds are fully hidden behind them.
+	// Depth is stored in normalized device coordinates, in tiles of TILE_SIZE x TILE_SIZE pixels.
+	struct OcclusionBuffer {
+		enum {
+			TILE_SIZE = 8,
+			TILE_PIXELS = TILE_SIZE * TILE_SIZE,
+			PARALLEL_TRIANGLE_THRESHOLD = 256,
+		};
+
+		struct Triangle {
+			Vector3 points[3]; // x and y in pixels, z is depth
+			int min_y;
+			int max_y;
+		};
+
+		int width = 0;
+		int height = 0;
+		int tiles_x = 0;
+		int tiles_y = 0;
+
+		CameraMatrix view_projection;
+		LocalVector<Triangle> triangles;
+		LocalVector<float> depth;
+		LocalVector<float> tile_max_depth;
+
+		void begin(const CameraMatrix &p_view_projection, int p_width, float p_aspect);
+		void add_occluder(const Transform &p_transform, const Occluder *p_occluder);
+		void rasterize_tile_row(uint32_t p_tile_row, void *p_userdata);
+		bool is_occluded(const AABB &p_aabb) const;
+
+	private:
+		_FORCE_INLINE_ void _add_triangle(const Plane &p_a, const Plane &p_b, const Plane &p_c);
+	};
+
+	OcclusionBuffer occlusion_buffer;
+	int occlusion_buffer_width;
+	ThreadWorkPool thread_pool;
+
+	/* PARALLEL SCENE PREPARATION */
+
+	// Instances found by the frustum cull are classified in chunks on the worker threads.
+	// Each chunk compacts the geometry it keeps at the start of its own range, and collects
+	// everything that touches shared state so it can be merged serially afterwards.
+	struct SceneCullChunk {
+		uint32_t from = 0;
+		uint32_t to = 0;
+		uint32_t geometry_count = 0;
+		bool redraw = false;
+		LocalVector<Instance *> particles; // visible and active, must request processing
+		LocalVector<Instance *> others; // lights, probes, decals and lightmaps
+	};
+
+	struct SceneCullSetup {
+		Transform cam_transform;
+		bool cam_orthogonal;
+		bool camera_pass;
+		bool use_occlusion;
+		uint32_t camera_layer_mask;
+		Plane near_plane;
+		float z_far;
+		float lod_error_scale;
+		uint64_t frame_number;
+		float lightmap_probe_update_speed;
+	};
+
+	enum {
+		SCENE_CULL_CHUNK_SIZE = 512,
+	};
+
+	LocalVector<SceneCullChunk> scene_cull_chunks;
+
+	void _scene_cull_chunk(uint32_t p_chunk, const SceneCullSetup *p_setup);
+
+	// Shadow casters of every light that needs a redraw are culled in parallel, one job per light.
+	// Rendering the shadow passes happens serially afterwards, in the same order as before.
+	struct ShadowCullPass {
+		int pass = 0;
+		CameraMatrix projection;
+		Transform transform;
+		real_t far = 0;
+		real_t split = 0;
+		real_t shadow_texel_size = 0;
+		real_t bias_scale = 1.0;
+		real_t range_begin = 0;
+		Vector2 uv_scale;
+		Plane near_plane; // used to sort the casters by depth
+		LocalVector<Instance *> casters;
+		int caster_count = 0;
+
+		void reset_transform() {
+			projection = CameraMatrix();
+			transform = Transform();
+			far = 0;
+			split = 0;
+			shadow_texel_size = 0;
+			bias_scale = 1.0;
+			range_begin = 0;
+			uv_scale = Vector2();
+		}
+	};
+
+	struct ShadowCullJob {
+		Instance *light = nullptr;
+		ShadowCullPass passes[6]; // directional splits, paraboloids or cube sides
+		int pass_count = 0;
+		bool restore_paraboloid_transform = false;
+		bool animated_material_found = false;
+	};
+
+	struct ShadowCullSetup {
+		Transform cam_transform;
+		CameraMatrix cam_projection;
+		bool cam_orthogonal;
+		bool cam_vaspect;
+		Scenario *scenario;
+	};
+
+	LocalVector<ShadowCullJob> shadow_cull_jobs;
+
+	static int _cull_shadow_casters(const Scenario *p_scenario, const Vector<Plane> &p_planes, LocalVector<Instance *> &r_casters);
+	void _light_instance_cull_shadow(ShadowCullJob &r_job, const ShadowCullSetup &p_setup);
+	void _light_instance_cull_shadow_job(uint32_t p_job, const ShadowCullSetup *p_setup);
+	void _light_instance_render_shadow(ShadowCullJob &r_job, RID p_shadow_atlas);
+
+	void _prepare_scene(const Transform p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, bool p_cam_vaspect, RID p_force_environment, RID p_force_camera_effects, uint32_t p_visible_layers, RID p_scenario, RID p_shadow_atlas, RID p_reflection_probe, bool p_using_shadows = true, float p_screen_lod_threshold = 0.0);
 	void _render_scene(RID p_render_buffers, const Transform p_cam_transform, const CameraMatrix &p_cam_projection, bool p_cam_orthogonal, RID p_force_environment, RID p_force_camera_effects, RID p_scenario, RID p_shadow_atlas, RID p_reflection_probe, int p_reflection_probe_pass);
 	void render_empty_scene(RID p_render_buffers, RID p_scenario, RID p_shadow_atlas);
 
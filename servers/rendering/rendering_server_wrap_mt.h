@@ -377,6 +377,11 @@ public:
 	FUNC2(camera_set_camera_effects, RID, RID)
 	FUNC2(camera_set_use_vertical_aspect, RID, bool)
 
+	/* OCCLUDER API */
+
+	FUNCRID(occluder)
+	FUNC3(occluder_set_mesh, RID, const PackedVector3Array &, const PackedInt32Array &)
+
 	/* VIEWPORT TARGET API */
 
 	FUNCRID(viewport)
@@ -512,6 +517,9 @@ public:
 	FUNC3(instance_set_surface_material, RID, int, RID)
 	FUNC2(instance_set_visible, RID, bool)
 
+	FUNC2(instance_set_transform_bulk, const Vector<RID> &, const Vector<Transform> &)
+	FUNC2(instance_set_visible_bulk, const Vector<RID> &, bool)
+
 	FUNC2(instance_set_custom_aabb, RID, AABB)
 
 	FUNC2(instance_attach_skeleton, RID, RID)
@@ -533,6 +541,7 @@ public:
 	FUNC4(instance_geometry_set_lightmap, RID, RID, const Rect2 &, int)
 
 	FUNC3(instance_geometry_set_shader_parameter, RID, const StringName &, const Variant &)
+	FUNC3(instance_geometry_set_shader_parameter_bulk, const Vector<RID> &, const StringName &, const Vector<Variant> &)
 	FUNC2RC(Variant, instance_geometry_get_shader_parameter, RID, const StringName &)
 	FUNC2RC(Variant, instance_geometry_get_shader_parameter_default_value, RID, const StringName &)
 	FUNC2SC(instance_geometry_get_shader_parameter_list, RID, List<PropertyInfo> *)